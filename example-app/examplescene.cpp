@@ -60,35 +60,37 @@ void ExampleScene::draw()
   // QtkScene in Qtk desktop application is an example using custom draw logic.
 }
 
-void ExampleScene::update()
+void ExampleScene::update(float dt)
 {
+  // Rotate objects by 45 degrees per second.
+  const float angle = 45.0f * dt;
   auto top_triangle = MeshRenderer::getInstance("topTriangle");
   auto bottom_triangle = MeshRenderer::getInstance("bottomTriangle");
 
   // Pitch forward and roll sideways
   MeshRenderer::getInstance("leftTriangle")
       ->getTransform()
-      .rotate(0.75f, 1.0f, 0.0f, 0.0f);
+      .rotate(angle, 1.0f, 0.0f, 0.0f);
   MeshRenderer::getInstance("rightTriangle")
       ->getTransform()
-      .rotate(0.75f, 0.0f, 0.0f, 1.0f);
+      .rotate(angle, 0.0f, 0.0f, 1.0f);
 
   // Make the top and bottom triangles slide left-to-right.
-  static float translateX = 0.025f;
+  static float translateX = 1.5f;  // Units per second
   float limit = -9.0f;  // Origin position.x - 2.0f
   float posX = top_triangle->getTransform().getTranslation().x();
   if (posX < limit || posX > limit + 4.0f) {
     translateX = -translateX;
   }
 
-  top_triangle->getTransform().translate(translateX, 0.0f, 0.0f);
-  bottom_triangle->getTransform().translate(-translateX, 0.0f, 0.0f);
+  top_triangle->getTransform().translate(translateX * dt, 0.0f, 0.0f);
+  bottom_triangle->getTransform().translate(-translateX * dt, 0.0f, 0.0f);
 
   // Apply some rotation to the triangles as they move left-to-right.
-  top_triangle->getTransform().rotate(0.75f, 0.2f, 0.0f, 0.4f);
-  bottom_triangle->getTransform().rotate(0.75f, 0.0f, 0.2f, 0.4f);
+  top_triangle->getTransform().rotate(angle, 0.2f, 0.0f, 0.4f);
+  bottom_triangle->getTransform().rotate(angle, 0.0f, 0.2f, 0.4f);
 
   MeshRenderer::getInstance("centerCube")
       ->getTransform()
-      .rotate(0.75f, 0.2f, 0.4f, 0.6f);
+      .rotate(angle, 0.2f, 0.4f, 0.6f);
 }
@@ -34,8 +34,10 @@ class ExampleScene : public Qtk::Scene
 
     /**
      * Update objects in the scene for translation or rotation.
+     *
+     * @param dt Time in seconds to advance the scene.
      */
-    void update() override;
+    void update(float dt) override;
 };
 
 #endif  // QTK_EXAMPLE_SCENE_H
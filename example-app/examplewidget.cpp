@@ -44,8 +44,8 @@ void ExampleWidget::initializeGL()
 
 void ExampleWidget::resizeGL(int width, int height)
 {
-  Qtk::Scene::getProjectionMatrix().setToIdentity();
-  Qtk::Scene::getProjectionMatrix().perspective(
+  mScene->getProjectionMatrix().setToIdentity();
+  mScene->getProjectionMatrix().perspective(
       45.0f, float(width) / float(height), 0.1f, 1000.0f);
 }
 
@@ -57,6 +57,7 @@ void ExampleWidget::paintGL()
 
 void ExampleWidget::update()
 {
-  mScene->update();
+  // Run any fixed update steps that elapsed since the last frame.
+  mScene->tick();
   QWidget::update();
 }
@@ -7,12 +7,30 @@
 ##############################################################################*/
 
 #include <QApplication>
+#include <QSurfaceFormat>
 
 #include "qtkmainwindow.h"
 
 int main(int argc, char * argv[])
 {
   initResources();
+  // Select a render profile with --profile <name>. The debug context and
+  // depth buffer belong to the context, so the profile is set before any
+  // context is created.
+  auto profile = Qtk::QtkWidget::getRenderProfile();
+  for (int i = 1; i + 1 < argc; i++) {
+    if (QString(argv[i]) == "--profile"
+        && !Qtk::RenderProfile::get(argv[i + 1], profile)) {
+      qDebug() << "Unknown render profile" << argv[i + 1]
+               << "- expected one of" << Qtk::RenderProfile::getNames();
+    }
+  }
+  Qtk::QtkWidget::setRenderProfile(profile);
+
+  // All QtkWidgets share one OpenGL context group, so a scene shown in
+  // several views uploads its buffers, textures and shaders only once.
+  QSurfaceFormat::setDefaultFormat(Qtk::QtkWidget::getDefaultFormat());
+  QCoreApplication::setAttribute(Qt::AA_ShareOpenGLContexts);
   QApplication a(argc, argv);
 
   auto window = MainWindow::getMainWindow();
@@ -24,6 +42,11 @@ int main(int argc, char * argv[])
   // Once we can save / load scenes, this call, and QtkScene, can be removed.
   window->setScene(new AppScene);
 
+  // Draw the scene on a separate thread so a slow frame can't stall the UI.
+  if (QApplication::arguments().contains("--render-thread")) {
+    window->getQtkWidget()->setThreadedRendering(true);
+  }
+
   window->show();
 
   return QApplication::exec();
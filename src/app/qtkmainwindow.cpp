@@ -6,6 +6,9 @@
 ## Contact: shaunrd0@gmail.com  | URL: www.shaunreed.com | GitHub: shaunrd0   ##
 ##############################################################################*/
 
+#include <QActionGroup>
+
+#include "qtk/tracer.h"
 #include "qtkmainwindow.h"
 #include "ui_qtkmainwindow.h"
 
@@ -34,12 +37,19 @@ MainWindow::MainWindow(QWidget * parent) : QMainWindow(parent)
 
     // Add GUI 'view' toolbar option to show debug console.
     ui_->menuView->addAction(qtkWidget->getActionToggleConsole());
+    // Add GUI 'view' toolbar option to only redraw when the scene changes.
+    ui_->menuView->addAction(qtkWidget->getActionToggleRenderPolicy());
+    // Add GUI 'view' toolbar options to scale resolution with frame time.
+    ui_->menuView->addAction(qtkWidget->getActionToggleDynamicResolution());
+    ui_->menuView->addAction(qtkWidget->getActionTogglePostProcess());
+    // Add GUI 'view' toolbar option to show where frame time is spent.
+    ui_->menuView->addAction(qtkWidget->getActionToggleProfiler());
 
     // Refresh GUI widgets when scene or objects are updated.
     connect(qtkWidget->getScene(),
-            &Qtk::Scene::sceneUpdated,
+            &Qtk::Scene::objectsChanged,
             this,
-            &MainWindow::refreshScene);
+            &MainWindow::applySceneChanges);
 
     // Update the ToolBox details panel when an item is double-clicked.
     connect(qtkWidget,
@@ -48,6 +58,38 @@ MainWindow::MainWindow(QWidget * parent) : QMainWindow(parent)
             &Qtk::ToolBox::updateFocus);
   }
 
+  // Add GUI 'view' toolbar options to switch the render profile of all
+  // QtkWidgets without restarting.
+  auto profileMenu = ui_->menuView->addMenu("Render profile");
+  auto profileGroup = new QActionGroup(this);
+  for (const auto & name : Qtk::RenderProfile::getNames()) {
+    auto action = profileMenu->addAction(name);
+    action->setCheckable(true);
+    action->setChecked(name == Qtk::QtkWidget::getRenderProfile().mName);
+    profileGroup->addAction(action);
+    connect(action, &QAction::triggered, this, [name]() {
+      Qtk::RenderProfile profile;
+      if (Qtk::RenderProfile::get(name, profile)) {
+        Qtk::QtkWidget::setRenderProfile(profile);
+      }
+    });
+  }
+
+  // Add GUI 'view' toolbar option to record a trace of all threads.
+  auto traceAction = ui_->menuView->addAction("Record Trace");
+  traceAction->setCheckable(true);
+  connect(traceAction, &QAction::toggled, this, &MainWindow::toggleTrace);
+  // Add GUI 'view' toolbar option to save frame time percentiles and hitches.
+  connect(ui_->menuView->addAction("Export Frame Times..."),
+          &QAction::triggered,
+          this,
+          &MainWindow::exportFrameTimes);
+  // Add GUI 'view' toolbar option to log memory held by the scene.
+  connect(ui_->menuView->addAction("Memory Report"),
+          &QAction::triggered,
+          this,
+          &MainWindow::logMemoryReport);
+
   connect(ui_->actionDelete_Object,
           &QAction::triggered,
           this,
@@ -114,6 +156,15 @@ void MainWindow::refreshScene(const QString & sceneName)
   ui_->qtk__TreeView->updateView(getQtkWidget()->getScene());
 }
 
+void MainWindow::applySceneChanges(const QString & sceneName,
+                                   const QStringList & added,
+                                   const QStringList & removed)
+{
+  // TODO: Select TreeView using sceneName
+  ui_->qtk__TreeView->applyChanges(
+      getQtkWidget()->getScene(), added, removed);
+}
+
 void MainWindow::deleteObject()
 {
   if (auto object = ui_->qtk__ToolBox->getObjectFocus(); object != Q_NULLPTR) {
@@ -134,11 +185,54 @@ void MainWindow::deleteObject()
   }
 }
 
+void MainWindow::toggleTrace(bool record)
+{
+  auto & tracer = Qtk::Tracer::getInstance();
+  if (record) {
+    tracer.start();
+    return;
+  }
+
+  const QString path = QFileDialog::getSaveFileName(
+      this,
+      tr("Save Trace"),
+      QDir::home().filePath("qtk-trace.json"),
+      tr("Chrome Trace (*.json)"));
+  if (path.isEmpty()) {
+    // Keep recording rather than discarding the capture.
+    auto action = qobject_cast<QAction *>(sender());
+    if (action != Q_NULLPTR) {
+      QSignalBlocker blocker(action);
+      action->setChecked(true);
+    }
+    return;
+  }
+  tracer.stop(path);
+}
+
+void MainWindow::exportFrameTimes()
+{
+  const QString path = QFileDialog::getSaveFileName(
+      this,
+      tr("Export Frame Times"),
+      QDir::home().filePath("qtk-frame-times.json"),
+      tr("JSON (*.json);;CSV (*.csv)"));
+  if (!path.isEmpty()) {
+    getQtkWidget()->getFrameTimes().save(path);
+  }
+}
+
+void MainWindow::logMemoryReport()
+{
+  auto widget = getQtkWidget();
+  emit widget->sendLog(widget->getScene()->getMemoryReport());
+}
+
 void MainWindow::setScene(Qtk::Scene * scene)
 {
   connect(scene,
-          &Qtk::Scene::sceneUpdated,
+          &Qtk::Scene::objectsChanged,
           MainWindow::getMainWindow(),
-          &MainWindow::refreshScene);
+          &MainWindow::applySceneChanges);
   ui_->qtk__QtkWidget->setScene(scene);
 }
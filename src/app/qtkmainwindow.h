@@ -144,6 +144,16 @@ class MainWindow : public QMainWindow
      */
     void refreshScene(const QString & sceneName);
 
+    /**
+     * Apply objects added to or removed from a scene to related widgets.
+     * @param sceneName The name of the scene that has been modified.
+     * @param added Names of objects added to the scene.
+     * @param removed Names of objects removed from the scene.
+     */
+    void applySceneChanges(const QString & sceneName,
+                           const QStringList & added,
+                           const QStringList & removed);
+
 
     /**
      * Opens a QFileDialog for selecting an object file to load into the scene.
@@ -161,6 +171,26 @@ class MainWindow : public QMainWindow
      */
     void deleteObject();
 
+    /**
+     * Start recording a trace, or stop and save it as Chrome trace event
+     * JSON to a file chosen with a QFileDialog.
+     *
+     * @param record True to start recording, false to stop.
+     */
+    void toggleTrace(bool record);
+
+    /**
+     * Save the frame time percentiles and hitches of the QtkWidget to a
+     * file chosen with a QFileDialog, as CSV or JSON.
+     */
+    void exportFrameTimes();
+
+    /**
+     * Log live and peak memory of each subsystem and of each object in the
+     * scene to the DebugConsole.
+     */
+    void logMemoryReport();
+
   private:
     /***************************************************************************
      * Private Members
@@ -419,6 +419,26 @@ void QtkScene::init()
   mesh->setTexture(":/textures/crate.png");
   mesh->setUniform("uTexture", 0);
   mesh->reallocateTexCoords(mesh->getTexCoords());
+
+  // Look up objects used every frame once, instead of by name each frame.
+  mMySpartan = getHandle("My spartan");
+  mMyCube = getHandle("My cube");
+  mAlienTest = getHandle("alienTest");
+  mSpartanTest = getHandle("spartanTest");
+  mTestPhongModel = getHandle("testPhong");
+  mNoLight = getHandle("noLight");
+  mRgbNormalsCube = getHandle("rgbNormalsCube");
+  mLeftTriangle = getHandle("leftTriangle");
+  mRightTriangle = getHandle("rightTriangle");
+  mTopTriangle = getHandle("topTriangle");
+  mBottomTriangle = getHandle("bottomTriangle");
+  mCenterCube = getHandle("centerCube");
+  mPhongLight = getHandle("phongLight");
+  mDiffuseLight = getHandle("diffuseLight");
+  mSpecularLight = getHandle("specularLight");
+  mAlienTestLight = getHandle("alienTestLight");
+  mSpartanTestLight = getHandle("spartanTestLight");
+  mTestLight = getHandle("testLight");
 }
 
 void QtkScene::draw()
@@ -426,14 +446,17 @@ void QtkScene::draw()
   // WARNING: We must call the base class draw() function first.
   // + This will handle rendering core scene components like the Skybox.
   Scene::draw();
-  const QVector3D cameraPosition = getCamera().getTransform().getTranslation();
+  const QVector3D & cameraPosition = getDrawCameraPosition();
+  // Light sources are scene objects and may have been removed.
+  auto lightPosition = [this](ObjectHandle handle) {
+    auto light = getObject<MeshRenderer>(handle);
+    return light ? light->getDrawMatrix().column(3).toVector3D() : QVector3D();
+  };
 
   mTestPhong->bindShaders();
   mTestPhong->setUniform("uModelInverseTransposed",
-                         mTestPhong->getTransform().toMatrix().normalMatrix());
-  mTestPhong->setUniform(
-      "uLightPosition",
-      MeshRenderer::getInstance("phongLight")->getTransform().getTranslation());
+                         mTestPhong->getDrawMatrix().normalMatrix());
+  mTestPhong->setUniform("uLightPosition", lightPosition(mPhongLight));
   mTestPhong->setUniform("uCameraPosition", cameraPosition);
   mTestPhong->releaseShaders();
   mTestPhong->draw();
@@ -444,117 +467,129 @@ void QtkScene::draw()
   mTestAmbient->draw();
 
   mTestDiffuse->bindShaders();
-  mTestDiffuse->setUniform(
-      "uModelInverseTransposed",
-      mTestDiffuse->getTransform().toMatrix().normalMatrix());
-  mTestDiffuse->setUniform("uLightPosition",
-                           MeshRenderer::getInstance("diffuseLight")
-                               ->getTransform()
-                               .getTranslation());
+  mTestDiffuse->setUniform("uModelInverseTransposed",
+                           mTestDiffuse->getDrawMatrix().normalMatrix());
+  mTestDiffuse->setUniform("uLightPosition", lightPosition(mDiffuseLight));
   mTestDiffuse->setUniform("uCameraPosition", cameraPosition);
   mTestDiffuse->releaseShaders();
   mTestDiffuse->draw();
 
   mTestSpecular->bindShaders();
-  mTestSpecular->setUniform(
-      "uModelInverseTransposed",
-      mTestSpecular->getTransform().toMatrix().normalMatrix());
-  mTestSpecular->setUniform("uLightPosition",
-                            MeshRenderer::getInstance("specularLight")
-                                ->getTransform()
-                                .getTranslation());
+  mTestSpecular->setUniform("uModelInverseTransposed",
+                            mTestSpecular->getDrawMatrix().normalMatrix());
+  mTestSpecular->setUniform("uLightPosition", lightPosition(mSpecularLight));
   mTestSpecular->setUniform("uCameraPosition", cameraPosition);
   mTestSpecular->releaseShaders();
   mTestSpecular->draw();
 }
 
-void QtkScene::update()
+void QtkScene::beforeDraw()
 {
-  auto getModel = Model::getInstance;
-  const QVector3D cameraPosition = getCamera().getTransform().getTranslation();
+  const QVector3D & cameraPosition = getDrawCameraPosition();
+  // Models with shaders that take their lighting and MVP values as uniforms.
+  const std::pair<ObjectHandle, ObjectHandle> litModels[] = {
+      {mAlienTest, mAlienTestLight},
+      {mSpartanTest, mSpartanTestLight},
+      {mTestPhongModel, mTestLight},
+  };
 
   // Models may have failed to load, so we should check before accessing.
-  if (auto mySpartan = getModel("My spartan"); mySpartan) {
-    mySpartan->getTransform().rotate(0.75f, 0.0f, 1.0f, 0.0f);
+  for (const auto & [handle, lightHandle] : litModels) {
+    if (auto model = getObject<Model>(handle); model) {
+      if (auto light = getObject<MeshRenderer>(lightHandle); light) {
+        model->setUniform("uLight.position",
+                          light->getDrawMatrix().column(3).toVector3D());
+      }
+
+      model->setUniform("uCameraPosition", cameraPosition);
+      const QMatrix4x4 & posMatrix = model->getDrawMatrix();
+      model->setUniform("uMVP.normalMatrix", posMatrix.normalMatrix());
+      model->setUniform("uMVP.model", posMatrix);
+      model->setUniform("uMVP.view", getDrawViewMatrix());
+      model->setUniform("uMVP.projection", getDrawProjectionMatrix());
+    }
   }
+}
 
-  if (auto myCube = getModel("My cube"); myCube) {
-    myCube->getTransform().rotate(-0.75f, 0.0f, 1.0f, 0.0f);
+void QtkScene::update(float dt)
+{
+  // Rotate objects by 45 degrees per second.
+  const float angle = 45.0f * dt;
+  auto getModel = [this](ObjectHandle handle) {
+    return getObject<Model>(handle);
+  };
+
+  // Models may have failed to load, so we should check before accessing.
+  if (auto mySpartan = getModel(mMySpartan); mySpartan) {
+    mySpartan->getTransform().rotate(angle, 0.0f, 1.0f, 0.0f);
   }
 
-  QMatrix4x4 posMatrix;
-  if (auto alien = getModel("alienTest"); alien) {
-    alien->setLightPosition("alienTestLight");
-
-    alien->setUniform("uCameraPosition", cameraPosition);
-    posMatrix = alien->getTransform().toMatrix();
-    alien->setUniform("uMVP.normalMatrix", posMatrix.normalMatrix());
-    alien->setUniform("uMVP.model", posMatrix);
-    alien->setUniform("uMVP.view", QtkScene::getCamera().toMatrix());
-    alien->setUniform("uMVP.projection", QtkScene::getProjectionMatrix());
-    alien->getTransform().rotate(0.75f, 0.0f, 1.0f, 0.0f);
+  if (auto myCube = getModel(mMyCube); myCube) {
+    myCube->getTransform().rotate(-angle, 0.0f, 1.0f, 0.0f);
   }
 
-  if (auto spartan = getModel("spartanTest"); spartan) {
-    spartan->setLightPosition("spartanTestLight");
+  if (auto alien = getModel(mAlienTest); alien) {
+    alien->getTransform().rotate(angle, 0.0f, 1.0f, 0.0f);
+  }
 
-    spartan->setUniform("uCameraPosition", cameraPosition);
-    posMatrix = spartan->getTransform().toMatrix();
-    spartan->setUniform("uMVP.normalMatrix", posMatrix.normalMatrix());
-    spartan->setUniform("uMVP.model", posMatrix);
-    spartan->setUniform("uMVP.view", QtkScene::getCamera().toMatrix());
-    spartan->setUniform("uMVP.projection", QtkScene::getProjectionMatrix());
-    spartan->getTransform().rotate(0.75f, 0.0f, 1.0f, 0.0f);
+  if (auto spartan = getModel(mSpartanTest); spartan) {
+    spartan->getTransform().rotate(angle, 0.0f, 1.0f, 0.0f);
   }
 
-  if (auto phong = getModel("testPhong"); phong) {
-    phong->setLightPosition("testLight");
-
-    phong->getTransform().rotate(0.75f, 1.0f, 0.5f, 0.0f);
-    phong->bindShaders();
-    phong->setUniform("uCameraPosition", cameraPosition);
-    posMatrix = phong->getTransform().toMatrix();
-    phong->setUniform("uMVP.normalMatrix", posMatrix.normalMatrix());
-    phong->setUniform("uMVP.model", posMatrix);
-    phong->setUniform("uMVP.view", QtkScene::getCamera().toMatrix());
-    phong->setUniform("uMVP.projection", QtkScene::getProjectionMatrix());
-    phong->releaseShaders();
+  if (auto phong = getModel(mTestPhongModel); phong) {
+    phong->getTransform().rotate(angle, 1.0f, 0.5f, 0.0f);
   }
 
   // MeshRenderers are lower level opengl objects baked into the source code.
-  auto getMesh = MeshRenderer::getInstance;
+  // They may still be removed from the scene, so check before accessing.
+  auto getMesh = [this](ObjectHandle handle) {
+    return getObject<MeshRenderer>(handle);
+  };
 
   // Rotate lighting example cubes
-  mTestPhong->getTransform().rotate(0.75f, 0.5f, 0.3f, 0.2f);
-  getMesh("noLight")->getTransform().rotate(0.75f, 0.5f, 0.3f, 0.2f);
-  mTestAmbient->getTransform().rotate(0.75f, 0.5f, 0.3f, 0.2f);
-  mTestDiffuse->getTransform().rotate(0.75f, 0.5f, 0.3f, 0.2f);
-  mTestSpecular->getTransform().rotate(0.75f, 0.5f, 0.3f, 0.2f);
+  mTestPhong->getTransform().rotate(angle, 0.5f, 0.3f, 0.2f);
+  if (auto noLight = getMesh(mNoLight); noLight) {
+    noLight->getTransform().rotate(angle, 0.5f, 0.3f, 0.2f);
+  }
+  mTestAmbient->getTransform().rotate(angle, 0.5f, 0.3f, 0.2f);
+  mTestDiffuse->getTransform().rotate(angle, 0.5f, 0.3f, 0.2f);
+  mTestSpecular->getTransform().rotate(angle, 0.5f, 0.3f, 0.2f);
 
   // Examples of various translations and rotations
 
   // Rotate in multiple directions simultaneously
-  getMesh("rgbNormalsCube")->getTransform().rotate(0.75f, 0.2f, 0.4f, 0.6f);
+  if (auto rgbNormalsCube = getMesh(mRgbNormalsCube); rgbNormalsCube) {
+    rgbNormalsCube->getTransform().rotate(angle, 0.2f, 0.4f, 0.6f);
+  }
 
   // Pitch forward and roll sideways
-  getMesh("leftTriangle")->getTransform().rotate(0.75f, 1.0f, 0.0f, 0.0f);
-  getMesh("rightTriangle")->getTransform().rotate(0.75f, 0.0f, 0.0f, 1.0f);
+  if (auto leftTriangle = getMesh(mLeftTriangle); leftTriangle) {
+    leftTriangle->getTransform().rotate(angle, 1.0f, 0.0f, 0.0f);
+  }
+  if (auto rightTriangle = getMesh(mRightTriangle); rightTriangle) {
+    rightTriangle->getTransform().rotate(angle, 0.0f, 0.0f, 1.0f);
+  }
 
   // Move between two positions over time
-  static float translateX = 0.025f;
+  static float translateX = 1.5f;  // Units per second
   float limit = -9.0f;  // Origin position.x - 2.0f
-  float posX = getMesh("topTriangle")->getTransform().getTranslation().x();
-  if (posX < limit || posX > limit + 4.0f) {
-    translateX = -translateX;
+  if (auto topTriangle = getMesh(mTopTriangle); topTriangle) {
+    float posX = topTriangle->getTransform().getTranslation().x();
+    if (posX < limit || posX > limit + 4.0f) {
+      translateX = -translateX;
+    }
+    topTriangle->getTransform().translate(translateX * dt, 0.0f, 0.0f);
+    // And lets rotate the triangles in two directions at once
+    topTriangle->getTransform().rotate(angle, 0.2f, 0.0f, 0.4f);
+  }
+  if (auto bottomTriangle = getMesh(mBottomTriangle); bottomTriangle) {
+    bottomTriangle->getTransform().translate(-translateX * dt, 0.0f, 0.0f);
+    bottomTriangle->getTransform().rotate(angle, 0.0f, 0.2f, 0.4f);
   }
-  getMesh("topTriangle")->getTransform().translate(translateX, 0.0f, 0.0f);
-  getMesh("bottomTriangle")->getTransform().translate(-translateX, 0.0f, 0.0f);
-  // And lets rotate the triangles in two directions at once
-  getMesh("topTriangle")->getTransform().rotate(0.75f, 0.2f, 0.0f, 0.4f);
-  getMesh("bottomTriangle")->getTransform().rotate(0.75f, 0.0f, 0.2f, 0.4f);
-  // And make the bottom triangle green, instead of RGB
 
   // Rotate center cube in several directions simultaneously
   // + Not subject to gimbal lock since we are using quaternions :)
-  getMesh("centerCube")->getTransform().rotate(0.75f, 0.2f, 0.4f, 0.6f);
+  if (auto centerCube = getMesh(mCenterCube); centerCube) {
+    centerCube->getTransform().rotate(angle, 0.2f, 0.4f, 0.6f);
+  }
 }
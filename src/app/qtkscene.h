@@ -30,8 +30,8 @@
  * See scene.h and `init()` for more information.
  *
  * To modify the scene objects should be initialized within the `init()` public
- * method. Any required movement or updates should be applied within `draw()` or
- * `update()`.
+ * method. Any required movement should be applied within `update()`, and
+ * uniform values set within `beforeDraw()` or `draw()`.
  *
  * To create your own Scene from scratch see Qtk::Scene.
  */
@@ -61,10 +61,16 @@ class QtkScene : public Qtk::Scene
     void draw() override;
 
     /**
-     * Called when the Qt `frameSwapped` signal is caught.
-     * See definition of `QtkWidget::initializeGL()`
+     * Sets per-frame lighting and MVP uniforms for models using them.
      */
-    void update() override;
+    void beforeDraw() override;
+
+    /**
+     * Called by `Scene::tick()` once for each fixed update step.
+     *
+     * @param dt Time in seconds to advance the scene.
+     */
+    void update(float dt) override;
 
   private:
     /***************************************************************************
@@ -77,6 +83,15 @@ class QtkScene : public Qtk::Scene
     Qtk::MeshRenderer * mTestSpecular {};
     Qtk::MeshRenderer * mTestDiffuse {};
     Qtk::MeshRenderer * mTestAmbient {};
+
+    // Handles to objects moved or lit each frame, looked up once in init().
+    // + Objects may be removed from the scene, so resolve before each use.
+    Qtk::ObjectHandle mMySpartan, mMyCube, mAlienTest, mSpartanTest;
+    Qtk::ObjectHandle mTestPhongModel, mNoLight, mRgbNormalsCube;
+    Qtk::ObjectHandle mLeftTriangle, mRightTriangle, mTopTriangle;
+    Qtk::ObjectHandle mBottomTriangle, mCenterCube;
+    Qtk::ObjectHandle mPhongLight, mDiffuseLight, mSpecularLight;
+    Qtk::ObjectHandle mAlienTestLight, mSpartanTestLight, mTestLight;
 };
 
 #endif  // QTK_EXAMPLE_SCENE_H
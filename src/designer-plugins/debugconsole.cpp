@@ -6,7 +6,9 @@
 ## Contact: shaunrd0@gmail.com  | URL: www.shaunreed.com | GitHub: shaunrd0   ##
 ##############################################################################*/
 
+#include <QCheckBox>
 #include <QMainWindow>
+#include <QScrollBar>
 #include <QWindow>
 
 #include "debugconsole.h"
@@ -21,17 +23,72 @@ DebugConsole::DebugConsole(QWidget * owner, const QString & key) :
 
 DebugConsole::DebugConsole(QWidget * owner,
                            const QString & key,
-                           const QString & name)
+                           const QString & name) : mModel(new LogModel(this))
 {
   ui_ = new Ui::DebugConsole;
   ui_->setupUi(this);
   setObjectName(name);
-  mConsole = ui_->textEdit;
-  setWidget(mConsole);
+  ui_->logView->setModel(mModel);
   setWindowTitle(name + " Debug Console");
 
+  const std::pair<QCheckBox *, DebugContext> filters[] = {
+      {ui_->statusCheck, Status},
+      {ui_->debugCheck, Debug},
+      {ui_->warnCheck, Warn},
+      {ui_->errorCheck, Error},
+      {ui_->fatalCheck, Fatal},
+  };
+  for (const auto & [check, context] : filters) {
+    connect(check, &QCheckBox::toggled, this, [this, context](bool checked) {
+      mQueue.setEnabled(context, checked);
+    });
+  }
+
+  mDrainTimer.setInterval(kDrainMs);
+  connect(&mDrainTimer, &QTimer::timeout, this, &DebugConsole::drainLog);
+  mDrainTimer.start();
+
   auto qtkWidget = dynamic_cast<QtkWidget *>(owner);
   if (qtkWidget) {
-    connect(qtkWidget, &QtkWidget::sendLog, this, &DebugConsole::sendLog);
+    // Queue messages on the thread that sends them, instead of posting an
+    // event for each one.
+    connect(qtkWidget,
+            &QtkWidget::sendLog,
+            this,
+            &DebugConsole::sendLog,
+            Qt::DirectConnection);
+  }
+}
+
+DebugConsole::~DebugConsole()
+{
+  delete ui_;
+}
+
+/*******************************************************************************
+ * Private Methods
+ ******************************************************************************/
+
+void DebugConsole::drainLog()
+{
+  mQueue.drain(mDrained, kDrainSize);
+  if (auto dropped = mQueue.takeDropped(); dropped > 0) {
+    LogEntry entry;
+    entry.mContext = Warn;
+    entry.mMessage =
+        QString("%1 messages were dropped while the console was busy.")
+            .arg(dropped);
+    mDrained.push_back(std::move(entry));
+  }
+  if (mDrained.empty()) {
+    return;
+  }
+
+  // Keep following new messages unless the user scrolled up.
+  auto scrollBar = ui_->logView->verticalScrollBar();
+  bool follow = scrollBar->value() == scrollBar->maximum();
+  mModel->append(mDrained);
+  if (follow) {
+    ui_->logView->scrollToBottom();
   }
 }
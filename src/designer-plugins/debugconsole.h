@@ -11,10 +11,13 @@
 
 #include <QApplication>
 #include <QDockWidget>
-#include <QPlainTextEdit>
-#include <QVBoxLayout>
+#include <QTimer>
 
+#include <vector>
+
+#include "designer-plugins/logmodel.h"
 #include "designer-plugins/qtkwidget.h"
+#include "qtk/logqueue.h"
 
 namespace Ui
 {
@@ -23,6 +26,15 @@ namespace Ui
 
 namespace Qtk
 {
+  /**
+   * Dock widget showing log messages for a QtkWidget.
+   *
+   * Messages may be logged from any thread. They are pushed to a LogQueue
+   * and shown in batches every kDrainMs, at most kDrainSize at a time, so a
+   * flood of messages can not stall the thread that logs them or the GUI.
+   * Repeated messages are collapsed into one line, and messages for contexts
+   * unchecked in the console are discarded before they are queued.
+   */
   class DebugConsole : public QDockWidget
   {
       Q_OBJECT;
@@ -50,7 +62,7 @@ namespace Qtk
        */
       DebugConsole(QWidget * owner, const QString & key, const QString & name);
 
-      ~DebugConsole() = default;
+      ~DebugConsole();
 
     public slots:
       /*************************************************************************
@@ -58,7 +70,7 @@ namespace Qtk
        ************************************************************************/
 
       /**
-       * Log a message to the DebugConsole text view.
+       * Log a message to the DebugConsole. Thread safe.
        *
        * @param message The message to log.
        * @param context The DebugContext to use for the message.
@@ -66,8 +78,10 @@ namespace Qtk
        */
       inline void sendLog(QString message, DebugContext context = Status)
       {
-        mConsole->setTextColor(logColor(context));
-        mConsole->append(logPrefix(message, context));
+        LogEntry entry;
+        entry.mContext = context;
+        entry.mMessage = std::move(message);
+        mQueue.push(std::move(entry));
       }
 
       /**
@@ -81,66 +95,59 @@ namespace Qtk
         setWindowTitle(name + " Debug Console");
       }
 
-    private:
+    public:
+      /*************************************************************************
+       * Public Methods
+       ************************************************************************/
+
       /**
-       * @param context Log context severity level.
-       * @return QColor corresponding with the message context.
+       * Log an entry to the DebugConsole. Thread safe.
+       *
+       * @param entry The entry to log.
        */
-      [[nodiscard]] QColor logColor(const DebugContext & context) const
-      {
-        switch (context) {
-          case Status:
-            return Qt::GlobalColor::darkGray;
-          case Debug:
-            return Qt::GlobalColor::white;
-          case Warn:
-            return Qt::GlobalColor::yellow;
-          case Error:
-            return Qt::GlobalColor::red;
-          case Fatal:
-            return Qt::GlobalColor::magenta;
-          default:
-            return Qt::GlobalColor::darkYellow;
-        }
-      }
+      inline void log(LogEntry entry) { mQueue.push(std::move(entry)); }
+
+      /*************************************************************************
+       * Accessors
+       ************************************************************************/
 
       /**
-       * Prefixes a log message to add context level.
+       * Check before building a message to skip the work if it would be
+       * discarded. Thread safe.
        *
-       * @param message The message to prefix.
-       * @param context The log context severity level.
-       * @return The log message prefixed with the DebugContext level.
+       * @param context Log context severity level.
+       * @return True if messages for the context are shown.
        */
-      [[nodiscard]] QString logPrefix(QString & message,
-                                      const DebugContext & context)
+      [[nodiscard]] inline bool isLogEnabled(DebugContext context) const
       {
-        QString prefix;
-        switch (context) {
-          case Status:
-            prefix = "[Status]: ";
-            break;
-          case Debug:
-            prefix = "[Debug]: ";
-            break;
-          case Warn:
-            prefix = "[Warn]: ";
-            break;
-          case Error:
-            prefix = "[Error]: ";
-            break;
-          case Fatal:
-            prefix = "[Fatal]: ";
-            break;
-          default:
-            prefix = "[No Context]: ";
-            break;
-        }
-        message = prefix + message.replace("\n", "\t\n" + prefix);
-        return message;
+        return mQueue.isEnabled(context);
       }
 
+    private:
+      /*************************************************************************
+       * Private Methods
+       ************************************************************************/
+
+      /**
+       * Move queued messages into the log view.
+       */
+      void drainLog();
+
+      /*************************************************************************
+       * Private Members
+       ************************************************************************/
+
+      /* Time between moving queued messages into the view. */
+      static constexpr int kDrainMs = 50;
+      /* Most messages moved into the view at a time. */
+      static constexpr size_t kDrainSize = 1000;
+
       Ui::DebugConsole * ui_;
-      QTextEdit * mConsole;
+      LogModel * mModel;
+      LogQueue mQueue;
+      QTimer mDrainTimer;
+      /* Entries taken from mQueue, reused between drains. */
+      std::vector<LogEntry> mDrained {};
   };
 }  // namespace Qtk
 
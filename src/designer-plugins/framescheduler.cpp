@@ -0,0 +1,94 @@
+/*##############################################################################
+## Author: Shaun Reed                                                         ##
+## Legal: All Content (c) 2025 Shaun Reed, all rights reserved                ##
+## About: Schedules updates and repaints for all QtkWidgets                   ##
+##                                                                            ##
+## Contact: shaunrd0@gmail.com  | URL: www.shaunreed.com | GitHub: shaunrd0   ##
+##############################################################################*/
+
+#include <QCoreApplication>
+#include <QGuiApplication>
+#include <QScreen>
+
+#include <algorithm>
+#include <unordered_map>
+
+#include "qtk/input.h"
+
+#include "framescheduler.h"
+#include "qtkwidget.h"
+
+using namespace Qtk;
+
+/*******************************************************************************
+ * Constructors, Destructors
+ ******************************************************************************/
+
+FrameScheduler::FrameScheduler(QObject * parent) : QObject(parent)
+{
+  qreal refreshRate = 60.0;
+  if (auto screen = QGuiApplication::primaryScreen(); screen != Q_NULLPTR) {
+    refreshRate = std::max(screen->refreshRate(), 1.0);
+  }
+  mTimer.setTimerType(Qt::PreciseTimer);
+  mRefreshInterval = static_cast<int>(1000.0 / refreshRate);
+  mTimer.setInterval(mRefreshInterval);
+  connect(&mTimer, &QTimer::timeout, this, &FrameScheduler::tick);
+}
+
+/*******************************************************************************
+ * Public Methods
+ ******************************************************************************/
+
+FrameScheduler & FrameScheduler::getInstance()
+{
+  // Deleted with the application so the timer stops on the right thread.
+  static auto * scheduler = new FrameScheduler(QCoreApplication::instance());
+  return *scheduler;
+}
+
+void FrameScheduler::addView(QtkWidget * view)
+{
+  if (std::find(mViews.begin(), mViews.end(), view) != mViews.end()) {
+    return;
+  }
+  mViews.push_back(view);
+  if (!mTimer.isActive()) {
+    mTimer.start();
+  }
+}
+
+void FrameScheduler::removeView(QtkWidget * view)
+{
+  mViews.erase(std::remove(mViews.begin(), mViews.end(), view), mViews.end());
+  if (mViews.empty()) {
+    mTimer.stop();
+  }
+}
+
+/*******************************************************************************
+ * Private Methods
+ ******************************************************************************/
+
+void FrameScheduler::tick()
+{
+  // Input tracks mouse movement between calls, so poll it once per frame.
+  Input::update();
+
+  // Advance each scene once, even if several widgets view it.
+  std::unordered_map<Scene *, float> elapsed;
+  for (const auto & view : mViews) {
+    if (auto scene = view->getScene();
+        scene != Q_NULLPTR && elapsed.count(scene) == 0) {
+      // Updates are timed in the first view of each scene.
+      FrameProfiler::Bind profiler(view->getProfiler());
+      elapsed[scene] = scene->tick();
+    }
+  }
+
+  for (const auto & view : mViews) {
+    auto it = elapsed.find(view->getScene());
+    view->updateFrame(it != elapsed.end() ? it->second : 0.0f);
+  }
+  emit ticked();
+}
@@ -0,0 +1,125 @@
+/*##############################################################################
+## Author: Shaun Reed                                                         ##
+## Legal: All Content (c) 2025 Shaun Reed, all rights reserved                ##
+## About: Schedules updates and repaints for all QtkWidgets                   ##
+##                                                                            ##
+## Contact: shaunrd0@gmail.com  | URL: www.shaunreed.com | GitHub: shaunrd0   ##
+##############################################################################*/
+#ifndef QTK_FRAMESCHEDULER_H
+#define QTK_FRAMESCHEDULER_H
+
+#include <QObject>
+#include <QTimer>
+
+#include <vector>
+
+namespace Qtk
+{
+  class QtkWidget;
+
+  /**
+   * Drives every QtkWidget from a single timer running at the display
+   * refresh rate.
+   *
+   * Each tick polls Input once, advances each Scene once no matter how many
+   * widgets view it, and then asks each widget to draw if it is visible,
+   * dirty (see QtkWidget::RenderPolicy) and not over its frame rate cap (see
+   * QtkWidget::setMaxFrameRate). Widgets register themselves on construction.
+   */
+  class FrameScheduler : public QObject
+  {
+      Q_OBJECT
+
+    public:
+      /*************************************************************************
+       * Public Methods
+       ************************************************************************/
+
+      /**
+       * @return The scheduler shared by all QtkWidgets in the application.
+       */
+      static FrameScheduler & getInstance();
+
+      /**
+       * Start scheduling frames for a widget.
+       *
+       * @param view The widget to schedule.
+       */
+      void addView(QtkWidget * view);
+
+      /**
+       * Stop scheduling frames for a widget.
+       *
+       * @param view The widget to remove.
+       */
+      void removeView(QtkWidget * view);
+
+      /*************************************************************************
+       * Accessors
+       ************************************************************************/
+
+      /**
+       * @return All widgets driven by this scheduler.
+       */
+      [[nodiscard]] inline const std::vector<QtkWidget *> & getViews() const
+      {
+        return mViews;
+      }
+
+      /**
+       * @return Milliseconds between ticks.
+       */
+      [[nodiscard]] inline int getInterval() const
+      {
+        return mTimer.interval();
+      }
+
+      /**
+       * @return Milliseconds between refreshes of the primary screen.
+       */
+      [[nodiscard]] inline int getRefreshInterval() const
+      {
+        return mRefreshInterval;
+      }
+
+      /*************************************************************************
+       * Setters
+       ************************************************************************/
+
+      /**
+       * The interval defaults to the refresh rate of the primary screen.
+       *
+       * @param msec Milliseconds between ticks.
+       */
+      inline void setInterval(int msec) { mTimer.setInterval(msec); }
+
+    signals:
+      /**
+       * Emitted after each tick, once all due widgets were asked to draw.
+       */
+      void ticked();
+
+    private slots:
+      /**
+       * Poll input, advance scenes and request frames from due widgets.
+       */
+      void tick();
+
+    private:
+      /*************************************************************************
+       * Private Methods
+       ************************************************************************/
+
+      explicit FrameScheduler(QObject * parent);
+
+      /*************************************************************************
+       * Private Members
+       ************************************************************************/
+
+      QTimer mTimer;
+      int mRefreshInterval = 16;
+      std::vector<QtkWidget *> mViews {};
+  };
+}  // namespace Qtk
+
+#endif  // QTK_FRAMESCHEDULER_H
@@ -0,0 +1,191 @@
+/*##############################################################################
+## Author: Shaun Reed                                                         ##
+## Legal: All Content (c) 2025 Shaun Reed, all rights reserved                ##
+## About: Item model holding the most recent log messages of a console        ##
+##                                                                            ##
+## Contact: shaunrd0@gmail.com  | URL: www.shaunreed.com | GitHub: shaunrd0   ##
+##############################################################################*/
+
+#include <QBrush>
+#include <QColor>
+
+#include "logmodel.h"
+
+using namespace Qtk;
+
+/*******************************************************************************
+ * Static Helpers
+ ******************************************************************************/
+
+/**
+ * @param context Log context severity level.
+ * @return QColor corresponding with the message context.
+ */
+static QColor logColor(DebugContext context)
+{
+  switch (context) {
+    case Status:
+      return Qt::GlobalColor::darkGray;
+    case Debug:
+      return Qt::GlobalColor::white;
+    case Warn:
+      return Qt::GlobalColor::yellow;
+    case Error:
+      return Qt::GlobalColor::red;
+    case Fatal:
+      return Qt::GlobalColor::magenta;
+    default:
+      return Qt::GlobalColor::darkYellow;
+  }
+}
+
+/**
+ * @param context Log context severity level.
+ * @return Prefix showing the context level of a message.
+ */
+static const char * logPrefix(DebugContext context)
+{
+  switch (context) {
+    case Status:
+      return "[Status]: ";
+    case Debug:
+      return "[Debug]: ";
+    case Warn:
+      return "[Warn]: ";
+    case Error:
+      return "[Error]: ";
+    case Fatal:
+      return "[Fatal]: ";
+    default:
+      return "[No Context]: ";
+  }
+}
+
+/*******************************************************************************
+ * Constructors / Destructors
+ ******************************************************************************/
+
+LogModel::LogModel(QObject * parent) : QAbstractListModel(parent) {}
+
+/*******************************************************************************
+ * Public Methods
+ ******************************************************************************/
+
+void LogModel::append(std::vector<LogEntry> & entries)
+{
+  if (entries.empty()) {
+    return;
+  }
+
+  // Collapse repeats into the last line shown, then into each other.
+  bool lastChanged = false;
+  mPending.clear();
+  for (auto & entry : entries) {
+    Line * last = !mPending.empty() ? &mPending.back()
+                  : mCount > 0      ? &getLine(mCount - 1)
+                                    : Q_NULLPTR;
+    if (last != Q_NULLPTR && entry.isRepeatOf(last->mEntry)) {
+      ++last->mRepeats;
+      last->mText.clear();
+      lastChanged |= mPending.empty();
+      continue;
+    }
+    mPending.push_back({std::move(entry)});
+  }
+  entries.clear();
+
+  if (lastChanged) {
+    auto row = index(static_cast<int>(mCount) - 1);
+    emit dataChanged(row, row);
+  }
+  if (mPending.empty()) {
+    return;
+  }
+
+  // Only the newest kMaxLines of a large batch could ever be shown.
+  size_t first = mPending.size() > kMaxLines ? mPending.size() - kMaxLines : 0;
+  size_t added = mPending.size() - first;
+  if (mCount + added > kMaxLines) {
+    // From here on the buffer is used as a ring.
+    mLines.resize(kMaxLines);
+    size_t dropped = mCount + added - kMaxLines;
+    beginRemoveRows(QModelIndex(), 0, static_cast<int>(dropped) - 1);
+    for (size_t i = 0; i < dropped; i++) {
+      getLine(i) = Line();
+    }
+    mFirst = (mFirst + dropped) % mLines.size();
+    mCount -= dropped;
+    endRemoveRows();
+  }
+
+  beginInsertRows(QModelIndex(),
+                  static_cast<int>(mCount),
+                  static_cast<int>(mCount + added) - 1);
+  for (size_t i = first; i < mPending.size(); i++) {
+    if (mCount < mLines.size()) {
+      getLine(mCount) = std::move(mPending[i]);
+    } else {
+      mLines.push_back(std::move(mPending[i]));
+    }
+    ++mCount;
+  }
+  endInsertRows();
+  mPending.clear();
+}
+
+/*******************************************************************************
+ * QAbstractListModel
+ ******************************************************************************/
+
+int LogModel::rowCount(const QModelIndex & parent) const
+{
+  return parent.isValid() ? 0 : static_cast<int>(mCount);
+}
+
+QVariant LogModel::data(const QModelIndex & index, int role) const
+{
+  if (!index.isValid() || static_cast<size_t>(index.row()) >= mCount) {
+    return {};
+  }
+  const Line & line = getLine(index.row());
+  switch (role) {
+    case Qt::DisplayRole:
+      if (line.mText.isNull()) {
+        line.mText = format(line);
+      }
+      return line.mText;
+    case Qt::ToolTipRole:
+      return line.mEntry.mMessage;
+    case Qt::ForegroundRole:
+      return QBrush(logColor(line.mEntry.mContext));
+    default:
+      return {};
+  }
+}
+
+/*******************************************************************************
+ * Private Methods
+ ******************************************************************************/
+
+QString LogModel::format(const Line & line)
+{
+  const LogEntry & entry = line.mEntry;
+  QString text = logPrefix(entry.mContext);
+  if (entry.mSource != Q_NULLPTR) {
+    text += QString("(%1) ").arg(entry.mSource);
+  }
+  if (entry.mLabels[0] != Q_NULLPTR) {
+    text += QString("(%1").arg(entry.mLabels[0]);
+    if (entry.mLabels[1] != Q_NULLPTR) {
+      text += QString(" : %1").arg(entry.mLabels[1]);
+    }
+    text += ") ";
+  }
+  // Rows have a uniform height, so multi-line messages are shown on one row
+  // and in full in the tooltip.
+  text += entry.mMessage.trimmed().replace('\n', ' ');
+  if (line.mRepeats > 1) {
+    text += QString(" (repeated %1x)").arg(line.mRepeats);
+  }
+  return text;
+}
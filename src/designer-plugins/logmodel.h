@@ -0,0 +1,113 @@
+/*##############################################################################
+## Author: Shaun Reed                                                         ##
+## Legal: All Content (c) 2025 Shaun Reed, all rights reserved                ##
+## About: Item model holding the most recent log messages of a console        ##
+##                                                                            ##
+## Contact: shaunrd0@gmail.com  | URL: www.shaunreed.com | GitHub: shaunrd0   ##
+##############################################################################*/
+
+#ifndef QTK_LOGMODEL_H
+#define QTK_LOGMODEL_H
+
+#include <QAbstractListModel>
+
+#include <vector>
+
+#include "qtk/logqueue.h"
+
+namespace Qtk
+{
+  /**
+   * List model of the last kMaxLines log messages, for DebugConsole.
+   *
+   * Lines are kept in a ring buffer, so once full the oldest lines are
+   * dropped without moving the rest. A message repeating the previous line
+   * increments its repeat count instead of adding a line. Entries are only
+   * formatted when a view asks for them, so only lines scrolled into view
+   * are ever formatted.
+   */
+  class LogModel : public QAbstractListModel
+  {
+      Q_OBJECT
+
+    public:
+      /*************************************************************************
+       * Constructors / Destructors
+       ************************************************************************/
+
+      explicit LogModel(QObject * parent = nullptr);
+
+      /*************************************************************************
+       * Public Methods
+       ************************************************************************/
+
+      /**
+       * Add entries to the end of the log, collapsing repeated messages.
+       *
+       * @param entries Entries to add, oldest first. Moved from.
+       */
+      void append(std::vector<LogEntry> & entries);
+
+      /*************************************************************************
+       * QAbstractListModel
+       ************************************************************************/
+
+      [[nodiscard]] int rowCount(
+          const QModelIndex & parent = QModelIndex()) const override;
+
+      [[nodiscard]] QVariant data(const QModelIndex & index,
+                                  int role = Qt::DisplayRole) const override;
+
+    private:
+      /*************************************************************************
+       * Private Types
+       ************************************************************************/
+
+      struct Line {
+          LogEntry mEntry;
+          uint32_t mRepeats = 1;
+          /* Formatted on first display; cleared when mRepeats changes. */
+          mutable QString mText {};
+      };
+
+      /*************************************************************************
+       * Private Methods
+       ************************************************************************/
+
+      /**
+       * @param row Row in the model, 0 being the oldest line kept.
+       * @return The line shown at the row.
+       */
+      [[nodiscard]] inline Line & getLine(size_t row)
+      {
+        return mLines[(mFirst + row) % mLines.size()];
+      }
+
+      [[nodiscard]] inline const Line & getLine(size_t row) const
+      {
+        return mLines[(mFirst + row) % mLines.size()];
+      }
+
+      /**
+       * @param line The line to format.
+       * @return Text shown for the line, on one row.
+       */
+      [[nodiscard]] static QString format(const Line & line);
+
+      /*************************************************************************
+       * Private Members
+       ************************************************************************/
+
+      /* Lines kept before the oldest are dropped. */
+      static constexpr size_t kMaxLines = 10000;
+
+      /* Grows up to kMaxLines, then used as a ring starting at mFirst. */
+      std::vector<Line> mLines {};
+      size_t mFirst = 0;
+      size_t mCount = 0;
+      /* New lines collected by append() before they are inserted. */
+      std::vector<Line> mPending {};
+  };
+}  // namespace Qtk
+
+#endif  // QTK_LOGMODEL_H
@@ -6,15 +6,21 @@
 ## Contact: shaunrd0@gmail.com  | URL: www.shaunreed.com | GitHub: shaunrd0   ##
 ##############################################################################*/
 
+#include <QCoreApplication>
 #include <QKeyEvent>
 #include <QMainWindow>
 #include <QMimeData>
+#include <QOpenGLExtraFunctions>
 
+#include <algorithm>
+
+#include "qtk/frameprofiler.h"
 #include "qtk/input.h"
 #include "qtk/scene.h"
 #include "qtk/shape.h"
 
 #include "debugconsole.h"
+#include "framescheduler.h"
 #include "qtkwidget.h"
 
 using namespace Qtk;
@@ -22,6 +28,12 @@ using namespace Qtk;
 /// Static manager for all QtkWidget instances.
 QtkWidgetManager QtkWidget::mWidgetManager;
 
+#ifdef QTK_DEBUG
+RenderProfile QtkWidget::sRenderProfile = RenderProfile::debug();
+#else
+RenderProfile QtkWidget::sRenderProfile = RenderProfile::balanced();
+#endif
+
 /*******************************************************************************
  * Constructors, Destructors
  ******************************************************************************/
@@ -42,22 +54,29 @@ QtkWidget::QtkWidget(QWidget * parent, const QString & name, Scene * scene) :
 
   setAcceptDrops(true);
   setScene(scene);
-  QSurfaceFormat format;
-  format.setRenderableType(QSurfaceFormat::OpenGL);
-  format.setProfile(QSurfaceFormat::CoreProfile);
-  format.setVersion(4, 6);
-  // Set the number of samples used for glEnable(GL_MULTISAMPLING)
-  format.setSamples(4);
-  // Set the size of the depth bufer for glEnable(GL_DEPTH_TEST)
-  format.setDepthBufferSize(16);
-  // If QTK_DEBUG is set, enable debug context
-  format.setOption(QSurfaceFormat::DebugContext);
-  setFormat(format);
+  setFormat(getDefaultFormat());
   setFocusPolicy(Qt::ClickFocus);
+
+  FrameScheduler::getInstance().addView(this);
+  updateSwapInterval();
+
+  mProfilerOverlay = new QLabel(this);
+  mProfilerOverlay->setAttribute(Qt::WA_TransparentForMouseEvents);
+  mProfilerOverlay->setStyleSheet(
+      "QLabel { background: rgba(0, 0, 0, 160); color: white; padding: 4px; "
+      "font-family: monospace; }");
+  mProfilerOverlay->move(8, 8);
+  mProfilerOverlay->hide();
+  connect(this, &QOpenGLWidget::frameSwapped, this, &QtkWidget::frameDone);
+
+  mPostProcess.addStage(new UpscaleStage);
+  mResolution.setFrameTimeBudget(
+      float(FrameScheduler::getInstance().getRefreshInterval()));
 }
 
 QtkWidget::~QtkWidget()
 {
+  FrameScheduler::getInstance().removeView(this);
   makeCurrent();
   teardownGL();
 }
@@ -76,11 +95,57 @@ QAction * QtkWidget::getActionToggleConsole()
   return action;
 }
 
+QAction * QtkWidget::getActionToggleRenderPolicy()
+{
+  auto action = new QAction(mScene->getSceneName() + " on-demand rendering");
+  action->setCheckable(true);
+  action->setChecked(mRenderPolicy == QTK_RENDER_ON_DEMAND);
+  action->setStatusTip("Only redraw this QtkWidget when the scene changes.");
+  connect(action, &QAction::toggled, this, [this](bool checked) {
+    setRenderPolicy(checked ? QTK_RENDER_ON_DEMAND : QTK_RENDER_CONTINUOUS);
+  });
+  return action;
+}
+
+QAction * QtkWidget::getActionToggleDynamicResolution()
+{
+  auto action = new QAction(mScene->getSceneName() + " dynamic resolution");
+  action->setCheckable(true);
+  action->setChecked(mDynamicResolution);
+  action->setStatusTip(
+      "Lower the resolution of this QtkWidget to hold its frame time budget.");
+  connect(action, &QAction::toggled, this, &QtkWidget::setDynamicResolution);
+  return action;
+}
+
+QAction * QtkWidget::getActionToggleProfiler()
+{
+  auto action = new QAction(mScene->getSceneName() + " profiler overlay");
+  action->setCheckable(true);
+  action->setChecked(mProfilerOverlay->isVisible());
+  action->setStatusTip(
+      "Show where frame time is spent in this QtkWidget, on CPU and GPU.");
+  connect(action, &QAction::triggered, this, &QtkWidget::toggleProfiler);
+  return action;
+}
+
+QAction * QtkWidget::getActionTogglePostProcess()
+{
+  auto action = new QAction(mScene->getSceneName() + " post processing");
+  action->setCheckable(true);
+  action->setChecked(mPostProcess.isEnabled());
+  action->setStatusTip(
+      "Sharpen frames upscaled from a lower resolution in this QtkWidget.");
+  connect(action, &QAction::toggled, this, [this](bool checked) {
+    mPostProcess.setEnabled(checked);
+    requestRender();
+  });
+  return action;
+}
+
 void QtkWidget::initializeGL()
 {
   initializeOpenGLFunctions();
-  // Connect the frameSwapped signal to call the update() function
-  connect(this, SIGNAL(frameSwapped()), this, SLOT(update()));
 
   // Add the debug console widget to the window and set its hidden state.
   if (mMainWindow != nullptr) {
@@ -89,31 +154,34 @@ void QtkWidget::initializeGL()
   }
   mConsole->setHidden(!mConsoleActive);
 
-  // Initialize OpenGL debug context
-  mDebugLogger = new QOpenGLDebugLogger(this);
-  if (mDebugLogger->initialize()) {
-    qDebug() << "GL_DEBUG Debug Logger" << mDebugLogger << "\n";
-    connect(mDebugLogger,
-            SIGNAL(messageLogged(QOpenGLDebugMessage)),
-            this,
-            SLOT(messageLogged(QOpenGLDebugMessage)));
-    mDebugLogger->startLogging();
-    mConsole->sendLog(
-        "Object files such as .obj can be dragged into the scene to load new "
-        "models.",
-        DebugContext::Warn);
-    mConsole->sendLog("Click and hold LMB or RMB to move the camera with WASD.",
-                      DebugContext::Warn);
-    mConsole->sendLog(
-        "Click an object name in the side panel to view or modify properties.",
-        DebugContext::Warn);
-    mConsole->sendLog(
-        "Double click an object name to move the camera to it's position.",
-        DebugContext::Warn);
-  }
+  mConsole->sendLog(
+      "Object files such as .obj can be dragged into the scene to load new "
+      "models.",
+      DebugContext::Warn);
+  mConsole->sendLog("Click and hold LMB or RMB to move the camera with WASD.",
+                    DebugContext::Warn);
+  mConsole->sendLog(
+      "Click an object name in the side panel to view or modify properties.",
+      DebugContext::Warn);
+  mConsole->sendLog(
+      "Double click an object name to move the camera to it's position.",
+      DebugContext::Warn);
 
   printContextInformation();
 
+  // Resources are only uploaded once if every view of the scene shares them.
+  for (const auto & view : mWidgetManager.get_views(mScene)) {
+    if (view != this && view->context() != Q_NULLPTR
+        && !QOpenGLContext::areSharing(context(), view->context())) {
+      sendLog("This view does not share OpenGL resources with "
+                  + view->objectName()
+                  + ". Set Qt::AA_ShareOpenGLContexts before constructing "
+                    "the application.",
+              Error);
+      break;
+    }
+  }
+
   // Initialize opengl settings
   glEnable(GL_MULTISAMPLE);
   glEnable(GL_DEPTH_TEST);
@@ -123,43 +191,201 @@ void QtkWidget::initializeGL()
   glClearDepth(1.0f);
   glClearColor(0.0f, 0.25f, 0.0f, 0.0f);
   glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+  if (mThreadedRendering) {
+    mBlitter.create();
+    mRenderThread = new RenderThread(context());
+    mRenderThread->setProfiler(&mProfiler);
+    connect(mRenderThread,
+            &RenderThread::frameReady,
+            this,
+            qOverload<>(&QWidget::update));
+    // The render thread owns the scene from now on.
+    mRenderThread->setScene(mScene);
+    mRenderThread->setSamples(sRenderProfile.mSamples);
+    mRenderThread->resize(getRenderSize());
+    mRenderThread->start();
+    // Block on the first frame so the scene is initialized before updating.
+    mRenderThread->requestFrame(mCamera.toMatrix(), mProjection, true);
+    sendLog("Rendering on a separate thread.", Status);
+  }
+
+  updateDebugLogging();
+  logRenderProfile();
 }
 
 void QtkWidget::resizeGL(int width, int height)
 {
-  Scene::getProjectionMatrix().setToIdentity();
-  Scene::getProjectionMatrix().perspective(
-      45.0f, float(width) / float(height), 0.1f, 1000.0f);
+  requestRender();
+  mFrameEvents |= QTK_FRAME_RESIZE;
+  if (mRenderThread != Q_NULLPTR) {
+    mRenderThread->resize(getRenderSize());
+  }
+  mProjection.setToIdentity();
+  mProjection.perspective(45.0f, float(width) / float(height), 0.1f, 1000.0f);
 }
 
 void QtkWidget::paintGL()
 {
-  // Clear buffers and draw the scene if it is valid.
-  glClear(GL_DEPTH_BUFFER_BIT | GL_COLOR_BUFFER_BIT);
-  if (mScene != Q_NULLPTR) {
-    mScene->draw();
+  FrameProfiler::Bind profiler(mProfiler);
+  // The widget's GPU time is only known when it draws the scene itself.
+  FrameProfiler::Scope scope("Paint", mRenderThread == Q_NULLPTR);
+  QElapsedTimer paintTimer;
+  paintTimer.start();
+  ++mUsageFrames;
+
+  if (mRenderThread != Q_NULLPTR) {
+    glClear(GL_DEPTH_BUFFER_BIT | GL_COLOR_BUFFER_BIT);
+    // Present the latest frame drawn by the render thread.
+    if (GLuint texture = mRenderThread->lockFrontBuffer(); texture != 0) {
+      glDisable(GL_DEPTH_TEST);
+      mBlitter.bind();
+      mBlitter.blit(
+          texture, QMatrix4x4(), QOpenGLTextureBlitter::OriginBottomLeft);
+      mBlitter.release();
+      glEnable(GL_DEPTH_TEST);
+    }
+    mRenderThread->unlockFrontBuffer();
+  } else {
+    // Taken before drawing; models loaded while drawing are shown next frame.
+    mTransformRevision = Transform3D::getRevision();
+    mRenderRequested = false;
+    // Clear buffers and draw the scene if it is valid.
+    bool target = bindRenderTarget();
+    glClear(GL_DEPTH_BUFFER_BIT | GL_COLOR_BUFFER_BIT);
+    if (mScene != Q_NULLPTR) {
+      mSceneRevision = mScene->getRevision();
+      mScene->captureFrame(mCamera.toMatrix(), mProjection);
+      mScene->draw();
+    }
+    if (target) {
+      resolveRenderTarget();
+    }
   }
+
+  auto paintNs = paintTimer.nsecsElapsed();
+  mUsagePaintNs += paintNs;
+  mUsageMaxPaintNs = std::max(mUsageMaxPaintNs, paintNs);
+  if (mDynamicResolution) {
+    // GPU results arrive a few frames late, so this lags behind paintNs.
+    mGpuFrameMs = std::max(0.0f, mProfiler.getLastGpuMs("Paint"));
+    // The scale is applied to the next frame by bindRenderTarget.
+    mResolution.update(std::max(float(paintNs) / 1.0e6f, mGpuFrameMs));
+  }
+  recordFrameTime(paintNs);
+  mSwapTimer.start();
+}
+
+QSurfaceFormat QtkWidget::getDefaultFormat()
+{
+  auto format = sRenderProfile.toSurfaceFormat();
+  // Samples are set on the render target, see bindRenderTarget().
+  format.setSamples(0);
+  return format;
 }
 
 void QtkWidget::setScene(Scene * scene)
 {
-  delete mScene;
+  if (scene == mScene) {
+    return;
+  }
+
+  if (mRenderThread != Q_NULLPTR || mThreadedRendering) {
+    if (!mWidgetManager.get_views(scene).empty()) {
+      qDebug() << "[QtkWidget] A scene drawn on a render thread can't be "
+                  "shared with other views.";
+      return;
+    }
+  }
 
+  if (mRenderThread != Q_NULLPTR) {
+    // The previous scene is deleted by the render thread.
+    mRenderThread->setScene(scene);
+  } else if (mWidgetManager.get_views(mScene).size() <= 1) {
+    // Only delete the scene if this is the last view of it.
+    delete mScene;
+  }
 
   mScene = scene;
+  requestRender();
   if (mScene != Q_NULLPTR) {
+    // Each view starts where the scene places its camera.
+    mCamera = mScene->getCamera();
     mConsole->setTitle(mScene->getSceneName());
   } else {
     mConsole->setTitle("Null Scene");
   }
 }
 
+void QtkWidget::setRenderPolicy(RenderPolicy policy)
+{
+  // The FrameScheduler checks the policy each tick.
+  mRenderPolicy = policy;
+  requestRender();
+}
+
+void QtkWidget::setThreadedRendering(bool threaded)
+{
+  if (mRenderThread != Q_NULLPTR || isValid()) {
+    qDebug() << "[QtkWidget] Threaded rendering must be set before the widget "
+                "is shown.";
+    return;
+  }
+  mThreadedRendering = threaded;
+}
+
+void QtkWidget::setRenderProfile(const RenderProfile & profile)
+{
+  sRenderProfile = profile;
+  sRenderProfile.mSamples = std::max(profile.mSamples, 0);
+  sRenderProfile.mSwapInterval = std::max(profile.mSwapInterval, 0);
+  sRenderProfile.mResolutionScale =
+      std::clamp(profile.mResolutionScale, 0.1f, 1.0f);
+
+  // Widgets apply the profile when they are constructed.
+  if (QCoreApplication::instance() == Q_NULLPTR) {
+    return;
+  }
+  updateSwapInterval();
+  for (const auto & view : FrameScheduler::getInstance().getViews()) {
+    view->applyRenderProfile();
+  }
+}
+
+void QtkWidget::setDynamicResolution(bool enabled)
+{
+  if (enabled && mThreadedRendering) {
+    qDebug() << "[QtkWidget] Dynamic resolution is not supported with "
+                "threaded rendering.";
+    return;
+  }
+  mDynamicResolution = enabled;
+  mResolution.reset();
+  mGpuFrameMs = 0.0f;
+  requestRender();
+  if (enabled) {
+    sendLog("Dynamic resolution enabled with a frame time budget of "
+                + QString::number(mResolution.getFrameTimeBudget(), 'f', 1)
+                + "ms",
+            Status);
+  } else {
+    sendLog("Dynamic resolution disabled", Status);
+  }
+}
+
 void QtkWidget::toggleConsole()
 {
   mConsole->setHidden(mConsoleActive);
   mConsoleActive = !mConsoleActive;
 }
 
+void QtkWidget::toggleProfiler()
+{
+  mProfilerOverlay->setVisible(!mProfilerOverlay->isVisible());
+  // Show the latest averages instead of waiting for the next ones.
+  mProfilerRevision = 0;
+}
+
 /*******************************************************************************
  * Protected Methods
  ******************************************************************************/
@@ -223,48 +449,44 @@ void QtkWidget::mouseReleaseEvent(QMouseEvent * event)
   Input::registerMouseRelease(event->button());
 }
 
-void QtkWidget::update()
-{
-  updateCameraInput();
-
-  if (mScene != Q_NULLPTR) {
-    mScene->update();
-  }
-
-  QWidget::update();
-}
-
 void QtkWidget::messageLogged(const QOpenGLDebugMessage & msg)
 {
-  QString error;
-
   DebugContext context;
-  // Format based on severity
   switch (msg.severity()) {
     case QOpenGLDebugMessage::NotificationSeverity:
-      error += "--";
       context = Status;
       break;
     case QOpenGLDebugMessage::HighSeverity:
-      error += "!!";
       context = Fatal;
       break;
     case QOpenGLDebugMessage::MediumSeverity:
-      error += "!~";
       context = Error;
       break;
     case QOpenGLDebugMessage::LowSeverity:
-      error += "~~";
+    default:
       context = Warn;
       break;
   }
+  // Drivers can log the same message every frame; skip all formatting for
+  // messages the console discards, and let it collapse repeats by id.
+  if (!mConsole->isLogEnabled(context)) {
+    return;
+  }
 
-  error += " (";
-
-  // Format based on source
+  LogEntry entry;
+  entry.mContext = context;
+  entry.mSource = "OpenGL";
+  // Severity, source and type are single bit flags that fit in 19 bits.
+  entry.mKey = (static_cast<uint64_t>(msg.id()) << 32)
+               | (static_cast<uint64_t>(msg.type()) << 10)
+               | (static_cast<uint64_t>(msg.source()) << 4)
+               | static_cast<uint64_t>(msg.severity());
+  entry.mMessage = msg.message();
+
+  // Label based on source
 #define CASE(c)                \
   case QOpenGLDebugMessage::c: \
-    error += #c;               \
+    entry.mLabels[0] = #c;     \
     break
   switch (msg.source()) {
     CASE(APISource);
@@ -274,15 +496,15 @@ void QtkWidget::messageLogged(const QOpenGLDebugMessage & msg)
     CASE(ApplicationSource);
     CASE(OtherSource);
     CASE(InvalidSource);
+    default:
+      break;
   }
 #undef CASE
 
-  error += " : ";
-
-// Format based on type
+// Label based on type
 #define CASE(c)                \
   case QOpenGLDebugMessage::c: \
-    error += #c;               \
+    entry.mLabels[1] = #c;     \
     break
   switch (msg.type()) {
     CASE(InvalidType);
@@ -295,58 +517,356 @@ void QtkWidget::messageLogged(const QOpenGLDebugMessage & msg)
     CASE(MarkerType);
     CASE(GroupPushType);
     CASE(GroupPopType);
+    default:
+      break;
   }
 #undef CASE
 
-  error += ")\n" + msg.message() + "\n";
-  qDebug() << qPrintable(error);
-  sendLog("(OpenGL) " + error.replace("\n", "\n(OpenGL) "), context);
+  mConsole->log(std::move(entry));
 }
 
 /*******************************************************************************
  * Private Methods
  ******************************************************************************/
 
+void QtkWidget::updateFrame(float dt)
+{
+  // Frames for the render thread are captured here.
+  FrameProfiler::Bind profiler(mProfiler);
+  updateCameraInput(dt);
+
+  if (isVisible() && isFrameDue()
+      && (mRenderPolicy == QTK_RENDER_CONTINUOUS || isDirty())) {
+    mFrameClock.restart();
+    if (mRenderThread != Q_NULLPTR) {
+      // The frame is captured now, so record what it includes. The widget is
+      // repainted when the render thread emits frameReady.
+      mTransformRevision = Transform3D::getRevision();
+      mSceneRevision = mScene != Q_NULLPTR ? mScene->getRevision() : 0;
+      mRenderRequested = false;
+      mRenderThread->requestFrame(mCamera.toMatrix(), mProjection);
+    } else {
+      QWidget::update();
+    }
+  }
+  updateCpuUsage();
+}
+
+bool QtkWidget::isFrameDue() const
+{
+  if (mMaxFrameRate <= 0.0f || !mFrameClock.isValid()) {
+    return true;
+  }
+  // Allow a little slack so a cap equal to the tick rate isn't skipped.
+  const qint64 interval = static_cast<qint64>(1.0e9f / mMaxFrameRate);
+  return mFrameClock.nsecsElapsed() >= interval - 1000000;
+}
+
 void QtkWidget::teardownGL()
-{ /* Nothing to teardown yet... */
+{
+  releaseRenderTarget();
+  mPostProcess.release();
+  if (mRenderThread != Q_NULLPTR) {
+    mBlitter.destroy();
+    // Stops the thread and deletes the scene with the render context current.
+    delete mRenderThread;
+    mRenderThread = Q_NULLPTR;
+    mScene = Q_NULLPTR;
+  }
 }
 
-void QtkWidget::updateCameraInput()
+void QtkWidget::updateCameraInput(float dt)
 {
-  Input::update();
+  // Input is shared by all widgets and polled once per tick by the
+  // FrameScheduler, so only the focused view consumes it.
+  if (!hasFocus()) {
+    return;
+  }
   // Camera Transformation
   if (Input::buttonPressed(Qt::LeftButton)
       || Input::buttonPressed(Qt::RightButton)) {
-    static const float transSpeed = 0.1f;
+    // Units per second.
+    static const float transSpeed = 6.0f;
     static const float rotSpeed = 0.5f;
 
     // Handle rotations
-    Scene::getCamera().getTransform().rotate(
+    mCamera.getTransform().rotate(
         -rotSpeed * Input::mouseDelta().x(), Camera3D::LocalUp);
-    Scene::getCamera().getTransform().rotate(
-        -rotSpeed * Input::mouseDelta().y(), Scene::getCamera().getRight());
+    mCamera.getTransform().rotate(
+        -rotSpeed * Input::mouseDelta().y(), mCamera.getRight());
 
     // Handle translations
     QVector3D translation;
     if (Input::keyPressed(Qt::Key_W)) {
-      translation += Scene::getCamera().getForward();
+      translation += mCamera.getForward();
     }
     if (Input::keyPressed(Qt::Key_S)) {
-      translation -= Scene::getCamera().getForward();
+      translation -= mCamera.getForward();
     }
     if (Input::keyPressed(Qt::Key_A)) {
-      translation -= Scene::getCamera().getRight();
+      translation -= mCamera.getRight();
     }
     if (Input::keyPressed(Qt::Key_D)) {
-      translation += Scene::getCamera().getRight();
+      translation += mCamera.getRight();
     }
     if (Input::keyPressed(Qt::Key_Q)) {
-      translation -= Scene::getCamera().getUp() / 2.0f;
+      translation -= mCamera.getUp() / 2.0f;
     }
     if (Input::keyPressed(Qt::Key_E)) {
-      translation += Scene::getCamera().getUp() / 2.0f;
+      translation += mCamera.getUp() / 2.0f;
     }
-    Scene::getCamera().getTransform().translate(transSpeed * translation);
+    mCamera.getTransform().translate(transSpeed * dt * translation);
+  }
+}
+
+bool QtkWidget::isDirty() const
+{
+  if (mRenderRequested || Transform3D::getRevision() != mTransformRevision) {
+    return true;
+  }
+  return mScene != Q_NULLPTR
+         && (mScene->getRevision() != mSceneRevision
+             || !mScene->mModelLoadQueue.empty());
+}
+
+void QtkWidget::updateCpuUsage()
+{
+  if (!mUsageTimer.isValid()) {
+    mUsageTimer.start();
+    mUsageClock = std::clock();
+    return;
+  }
+
+  auto elapsed = mUsageTimer.elapsed();
+  if (elapsed < 1000) {
+    return;
+  }
+
+  // std::clock measures CPU time used by every thread in the process.
+  auto clock = std::clock();
+  mCpuUsage = 100.0f * float(clock - mUsageClock) / CLOCKS_PER_SEC
+              / (float(elapsed) / 1000.0f);
+  mFrameCost.mFrameRate = float(mUsageFrames) / (float(elapsed) / 1000.0f);
+  mFrameCost.mAverageMs =
+      mUsageFrames == 0 ? 0.0f : float(mUsagePaintNs) / mUsageFrames / 1.0e6f;
+  mFrameCost.mMaxMs = float(mUsageMaxPaintNs) / 1.0e6f;
+  mUsagePaintNs = 0;
+  mUsageMaxPaintNs = 0;
+  mUsageTimer.restart();
+  mUsageClock = clock;
+
+  bool idle = mUsageFrames == 0;
+  if (idle && !mIdle) {
+    sendLog("Rendering idle; process CPU usage "
+                + QString::number(mCpuUsage, 'f', 1) + "%",
+            Status);
+  }
+  mIdle = idle;
+  mUsageFrames = 0;
+}
+
+void QtkWidget::applyRenderProfile()
+{
+  requestRender();
+  if (mRenderThread != Q_NULLPTR) {
+    mRenderThread->setSamples(sRenderProfile.mSamples);
+    mRenderThread->resize(getRenderSize());
+  }
+  // Otherwise initializeGL applies the rest of the profile.
+  if (!isValid()) {
+    return;
+  }
+
+  makeCurrent();
+  updateDebugLogging();
+  doneCurrent();
+  logRenderProfile();
+}
+
+void QtkWidget::logRenderProfile()
+{
+  sendLog("Render profile: " + sRenderProfile.toString(), Status);
+  if (format().testOption(QSurfaceFormat::DebugContext)
+          != sRenderProfile.mDebugContext
+      || format().depthBufferSize() != sRenderProfile.mDepthBits) {
+    sendLog("The debug context and depth buffer of the '"
+                + sRenderProfile.mName
+                + "' profile apply after restarting with --profile "
+                + sRenderProfile.mName,
+            Warn);
+  }
+}
+
+void QtkWidget::updateDebugLogging()
+{
+  if (!sRenderProfile.mDebugLogging) {
+    if (mDebugLogger != Q_NULLPTR && mDebugLogger->isLogging()) {
+      mDebugLogger->stopLogging();
+    }
+    return;
+  }
+
+  if (mDebugLogger == Q_NULLPTR) {
+    mDebugLogger = new QOpenGLDebugLogger(this);
+    if (!mDebugLogger->initialize()) {
+      sendLog("OpenGL debug logging is not supported by this context.", Warn);
+      delete mDebugLogger;
+      mDebugLogger = Q_NULLPTR;
+      return;
+    }
+    qDebug() << "GL_DEBUG Debug Logger" << mDebugLogger << "\n";
+    connect(mDebugLogger,
+            SIGNAL(messageLogged(QOpenGLDebugMessage)),
+            this,
+            SLOT(messageLogged(QOpenGLDebugMessage)));
+  }
+  if (!mDebugLogger->isLogging()) {
+    mDebugLogger->startLogging();
+  }
+}
+
+void QtkWidget::updateSwapInterval()
+{
+  // Without vsync the editor still ticks once per refresh; a 0 ms timer would
+  // spin the event loop. Use qtk_bench to measure uncapped frame rates.
+  auto & scheduler = FrameScheduler::getInstance();
+  scheduler.setInterval(scheduler.getRefreshInterval()
+                        * std::max(sRenderProfile.mSwapInterval, 1));
+}
+
+float QtkWidget::getResolutionScale() const
+{
+  auto scale = sRenderProfile.mResolutionScale;
+  return mDynamicResolution ? scale * mResolution.getScale() : scale;
+}
+
+QSize QtkWidget::getRenderSize() const
+{
+  return (size() * (devicePixelRatio() * getResolutionScale()))
+      .expandedTo(QSize(1, 1));
+}
+
+bool QtkWidget::bindRenderTarget()
+{
+  // Draw straight into the widget when there is nothing to resolve or scale.
+  const int samples = sRenderProfile.mSamples;
+  if (samples == 0 && getResolutionScale() >= 1.0f) {
+    releaseRenderTarget();
+    return false;
+  }
+
+  // Multisampled framebuffers can only be resolved at the same size, so a
+  // scaled frame is resolved before it is upscaled.
+  const QSize renderSize = getRenderSize();
+  const bool resolve = samples > 0 && renderSize != size() * devicePixelRatio();
+  if (mTarget == Q_NULLPTR || mTarget->size() != renderSize
+      || mTargetSamples != samples || (mResolved != Q_NULLPTR) != resolve) {
+    releaseRenderTarget();
+    QOpenGLFramebufferObjectFormat format;
+    format.setAttachment(QOpenGLFramebufferObject::CombinedDepthStencil);
+    format.setSamples(samples);
+    mTarget = new QOpenGLFramebufferObject(renderSize, format);
+    mTargetSamples = samples;
+    if (resolve) {
+      mResolved = new QOpenGLFramebufferObject(renderSize);
+    }
+  }
+
+  mTarget->bind();
+  glViewport(0, 0, renderSize.width(), renderSize.height());
+  return true;
+}
+
+void QtkWidget::resolveRenderTarget()
+{
+  mTarget->release();
+  auto source = mTarget;
+  if (mResolved != Q_NULLPTR) {
+    QOpenGLFramebufferObject::blitFramebuffer(mResolved, mTarget);
+    source = mResolved;
+  }
+  const QSize viewSize = size() * devicePixelRatio();
+  if (source->size() != viewSize
+      && mPostProcess.process(source->texture(),
+                              source->size(),
+                              defaultFramebufferObject(),
+                              viewSize)) {
+    return;
+  }
+
+  // A null target is the widget's framebuffer while painting.
+  QOpenGLFramebufferObject::blitFramebuffer(
+      Q_NULLPTR,
+      QRect(QPoint(), viewSize),
+      source,
+      QRect(QPoint(), source->size()),
+      GL_COLOR_BUFFER_BIT,
+      GL_LINEAR);
+}
+
+void QtkWidget::releaseRenderTarget()
+{
+  delete mTarget;
+  mTarget = Q_NULLPTR;
+  delete mResolved;
+  mResolved = Q_NULLPTR;
+}
+
+void QtkWidget::frameDone()
+{
+  if (mSwapTimer.isValid()) {
+    mProfiler.record("Swap", mSwapTimer.nsecsElapsed());
+    mSwapTimer.invalidate();
+  }
+  mProfiler.endFrame();
+
+  if (mProfilerOverlay->isVisible()
+      && mProfiler.getRevision() != mProfilerRevision) {
+    mProfilerRevision = mProfiler.getRevision();
+    mProfilerOverlay->setText(mProfiler.toString() + mFrameTimes.toString());
+    mProfilerOverlay->adjustSize();
+  }
+}
+
+void QtkWidget::recordFrameTime(int64_t paintNs)
+{
+  float cpuMs = float(paintNs) / 1.0e6f;
+  float gpuMs = mProfiler.getLastGpuMs("Paint");
+  if (mRenderThread != Q_NULLPTR) {
+    // Presenting is cheap; the cost of the frame is on the render thread.
+    cpuMs = mRenderThread->getLastRenderMs();
+    gpuMs = mProfiler.getLastGpuMs("Render");
+  }
+
+  uint32_t events = mFrameEvents;
+  mFrameEvents = 0;
+  if (mScene != Q_NULLPTR) {
+    if (mScene->getRevision() != mFrameTimesRevision) {
+      mFrameTimesRevision = mScene->getRevision();
+      events |= QTK_FRAME_SCENE_CHANGE;
+    }
+    // Only counted when qtk is built with QTK_RENDER_STATS.
+    auto stats = mScene->getFrameStats();
+    if (stats.mModelLoads > 0) {
+      events |= QTK_FRAME_MODEL_LOAD;
+    }
+    if (stats.mShaderLinks > 0) {
+      events |= QTK_FRAME_SHADER_COMPILE;
+    }
+    if (stats.mTextureUploads > 0) {
+      events |= QTK_FRAME_TEXTURE_UPLOAD;
+    }
+  }
+
+  if (mFrameTimes.record(cpuMs, gpuMs, events)) {
+    auto causes = FrameTimes::getEventNames(events);
+    sendLog(QString("Hitch: frame took %1 ms on the CPU%2 (%3)")
+                .arg(cpuMs, 0, 'f', 1)
+                .arg(gpuMs >= 0.0f
+                         ? QString(", %1 ms on the GPU").arg(gpuMs, 0, 'f', 1)
+                         : QString())
+                .arg(causes.isEmpty() ? "no known cause" : causes.join(", ")),
+            Warn);
   }
 }
 
@@ -8,16 +8,28 @@
 #ifndef QTK_QTKWIDGET_H
 #define QTK_QTKWIDGET_H
 
+#include <ctime>
 #include <iostream>
 
 #include <QDockWidget>
+#include <QElapsedTimer>
+#include <QLabel>
 #include <QMatrix4x4>
 #include <QOpenGLDebugLogger>
+#include <QOpenGLFramebufferObject>
 #include <QOpenGLFunctions>
+#include <QOpenGLTextureBlitter>
 #include <QOpenGLWidget>
 #include <QPlainTextEdit>
+#include <QTimer>
 
+#include "qtk/dynamicresolution.h"
+#include "qtk/frameprofiler.h"
+#include "qtk/frametimes.h"
+#include "qtk/postprocesschain.h"
 #include "qtk/qtkapi.h"
+#include "qtk/renderprofile.h"
+#include "qtk/renderthread.h"
 #include "qtk/scene.h"
 
 namespace Qtk
@@ -29,12 +41,46 @@ namespace Qtk
    *
    * This object has a Scene attached which manages the objects to render.
    * Client input is passed through this widget to control the camera view.
+   *
+   * Several widgets can view the same Scene, each through its own camera and
+   * projection. With Qt::AA_ShareOpenGLContexts set before the application
+   * is constructed all widgets share one OpenGL context group, so the
+   * scene's buffers, textures and shaders are uploaded only once.
    */
   class QtkWidget : public QOpenGLWidget, protected QOpenGLFunctions
   {
       Q_OBJECT;
 
     public:
+      /*************************************************************************
+       * Typedefs
+       ************************************************************************/
+
+      /**
+       * Controls when the widget repaints. Input and scene updates are driven
+       * by the FrameScheduler either way.
+       *
+       * QTK_RENDER_CONTINUOUS repaints on every FrameScheduler tick, which
+       * suits scenes that animate constantly.
+       *
+       * QTK_RENDER_ON_DEMAND only repaints when something changed: a
+       * Transform3D (including the camera), the scene's objects, a pending
+       * model load, a resize, or an explicit call to `requestRender()`.
+       */
+      enum RenderPolicy { QTK_RENDER_CONTINUOUS, QTK_RENDER_ON_DEMAND };
+
+      /**
+       * Cost of the frames drawn by this widget, updated once per second.
+       */
+      struct FrameCost {
+          /* Frames drawn during the last second. */
+          float mFrameRate {};
+          /* Average and worst CPU time spent in paintGL, in milliseconds. When
+           * rendering on a RenderThread this only covers presenting frames. */
+          float mAverageMs {};
+          float mMaxMs {};
+      };
+
       /*************************************************************************
        * Contructors / Destructors
        ************************************************************************/
@@ -75,11 +121,49 @@ namespace Qtk
        */
       QAction * getActionToggleConsole();
 
+      /**
+       * Constructs a QAction to switch between continuous and on-demand
+       * rendering.
+       * @return QAction to toggle the RenderPolicy of this widget.
+       */
+      QAction * getActionToggleRenderPolicy();
+
+      /**
+       * Constructs a QAction to switch dynamic resolution on and off.
+       * @return QAction to toggle dynamic resolution for this widget.
+       */
+      QAction * getActionToggleDynamicResolution();
+
+      /**
+       * Constructs a QAction to switch the post process chain on and off.
+       * @return QAction to toggle post processing for this widget.
+       */
+      QAction * getActionTogglePostProcess();
+
+      /**
+       * Constructs a QAction to show and hide the frame profiler overlay.
+       * @return QAction to toggle the profiler overlay for this widget.
+       */
+      QAction * getActionToggleProfiler();
+
       /**
        * Called when the widget is first constructed.
        */
       void initializeGL() override;
 
+      /**
+       * Surface format requested by every QtkWidget, built from the active
+       * RenderProfile. Contexts can only share resources if their formats are
+       * compatible, so pass this to QSurfaceFormat::setDefaultFormat before
+       * constructing the application along with Qt::AA_ShareOpenGLContexts.
+       *
+       * Multisampling is done in the widget's own render target so it can
+       * change at runtime, and the returned format requests no samples.
+       *
+       * @return The QSurfaceFormat used by QtkWidgets.
+       */
+      [[nodiscard]] static QSurfaceFormat getDefaultFormat();
+
       /**
        * Called when the application window is resized.
        *
@@ -102,6 +186,24 @@ namespace Qtk
        */
       inline Qtk::Scene * getScene() { return mScene; }
 
+      /**
+       * @return The camera this widget views the scene through.
+       */
+      inline Camera3D & getCamera() { return mCamera; }
+
+      /**
+       * @return Profiler timing the frames of this view.
+       */
+      inline FrameProfiler & getProfiler() { return mProfiler; }
+
+      /**
+       * @return Projection matrix for this widget's view into the scene.
+       */
+      [[nodiscard]] inline const QMatrix4x4 & getProjectionMatrix() const
+      {
+        return mProjection;
+      }
+
       /**
        * @return Pointer to the QOpenGLDebugLogger attached to this widget.
        */
@@ -110,11 +212,105 @@ namespace Qtk
         return mDebugLogger;
       }
 
+      /**
+       * @return The RenderPolicy used by this widget.
+       */
+      [[nodiscard]] inline RenderPolicy getRenderPolicy() const
+      {
+        return mRenderPolicy;
+      }
+
+      /**
+       * @return CPU usage of the whole process over the last second, as a
+       *    percentage of one core.
+       */
+      [[nodiscard]] inline float getCpuUsage() const { return mCpuUsage; }
+
+      /**
+       * @return True if no frames were drawn during the last second.
+       */
+      [[nodiscard]] inline bool isIdle() const { return mIdle; }
+
+      /**
+       * @return Frame rate and paint cost of this widget over the last second.
+       */
+      [[nodiscard]] inline const FrameCost & getFrameCost() const
+      {
+        return mFrameCost;
+      }
+
+      /**
+       * Every frame's CPU and GPU time, and hitches with their causes. When
+       * rendering on a RenderThread these are the times of the render
+       * thread's latest frame. GPU times arrive a few frames late.
+       *
+       * @return Frame time histograms and hitches of this widget.
+       */
+      [[nodiscard]] inline FrameTimes & getFrameTimes() { return mFrameTimes; }
+
+      /**
+       * @return Maximum frames per second drawn by this widget, or 0 if the
+       *    widget may draw on every FrameScheduler tick.
+       */
+      [[nodiscard]] inline float getMaxFrameRate() const
+      {
+        return mMaxFrameRate;
+      }
+
+      /**
+       * @return True if the scene is drawn on a RenderThread.
+       */
+      [[nodiscard]] inline bool isThreadedRendering() const
+      {
+        return mThreadedRendering;
+      }
+
+      /**
+       * @return The RenderProfile used by all QtkWidgets.
+       */
+      [[nodiscard]] static inline const RenderProfile & getRenderProfile()
+      {
+        return sRenderProfile;
+      }
+
+      /**
+       * @return True if the resolution follows the frame time budget.
+       */
+      [[nodiscard]] inline bool isDynamicResolution() const
+      {
+        return mDynamicResolution;
+      }
+
+      /**
+       * @return Target time to draw each frame in milliseconds.
+       */
+      [[nodiscard]] inline float getFrameTimeBudget() const
+      {
+        return mResolution.getFrameTimeBudget();
+      }
+
+      /**
+       * @return Scale of the drawn resolution relative to the widget; the
+       *    RenderProfile's scale, times the dynamic scale if enabled.
+       */
+      [[nodiscard]] float getResolutionScale() const;
+
+      /**
+       * Stages applied when the scene is drawn below native resolution, in
+       * place of a plain bilinear blit. The chain starts with an UpscaleStage.
+       *
+       * @return The post process chain for this widget.
+       */
+      inline PostProcessChain & getPostProcessChain() { return mPostProcess; }
+
       /*************************************************************************
        * Setters
        ************************************************************************/
 
       /**
+       * The camera is reset to a copy of the scene's camera. The previous
+       * scene is deleted unless another QtkWidget is still viewing it.
+       *
        * @param scene The new scene to view.
        */
       void setScene(Qtk::Scene * scene);
@@ -124,6 +320,65 @@ namespace Qtk
        */
       void setMainWindow(QMainWindow * window) { mMainWindow = window; }
 
+      /**
+       * @param policy The RenderPolicy to use for this widget.
+       */
+      void setRenderPolicy(RenderPolicy policy);
+
+      /**
+       * Cap how often this widget draws, e.g. to keep secondary views at a
+       * low rate while the main view runs at the display refresh rate.
+       *
+       * @param fps Maximum frames per second, or 0 to remove the cap.
+       */
+      inline void setMaxFrameRate(float fps)
+      {
+        mMaxFrameRate = std::max(fps, 0.0f);
+      }
+
+      /**
+       * Draw the scene on a RenderThread with its own OpenGL context. The
+       * widget only presents finished frames, so the GUI and drawing no longer
+       * stall each other. Must be set before the widget is first shown.
+       * The render thread owns the scene, so it can't be shared with other
+       * views.
+       *
+       * @param threaded True to draw the scene on a separate thread.
+       */
+      void setThreadedRendering(bool threaded);
+
+      /**
+       * Switch the RenderProfile used by all QtkWidgets. MSAA samples,
+       * resolution scale, debug logging and frame pacing (the swap interval)
+       * apply to running widgets immediately. The debug context, depth bits
+       * and the window's swap interval belong to the OpenGL context, so they
+       * only apply to contexts created after this call; set the profile
+       * before `getDefaultFormat()` is used to apply them at startup.
+       *
+       * @param profile The RenderProfile to use.
+       */
+      static void setRenderProfile(const RenderProfile & profile);
+
+      /**
+       * Lower the resolution the scene is drawn at when frames take longer
+       * than the frame time budget, and raise it again when they are under
+       * budget. Frames are measured with CPU paint time and GPU timer
+       * queries. Only supported when drawing on the GUI thread.
+       *
+       * @param enabled True to scale the resolution with frame time.
+       */
+      void setDynamicResolution(bool enabled);
+
+      /**
+       * Defaults to the refresh interval of the primary screen.
+       *
+       * @param ms Target time to draw each frame in milliseconds.
+       */
+      inline void setFrameTimeBudget(float ms)
+      {
+        mResolution.setFrameTimeBudget(ms);
+      }
+
       /*************************************************************************
        * Public Members
        ************************************************************************/
@@ -138,6 +393,17 @@ namespace Qtk
        */
       void toggleConsole();
 
+      /**
+       * Toggle the overlay showing FrameProfiler averages over the scene.
+       */
+      void toggleProfiler();
+
+      /**
+       * Repaint the widget on the next update, even if nothing changed.
+       * Only needed when using QTK_RENDER_ON_DEMAND.
+       */
+      inline void requestRender() { mRenderRequested = true; }
+
     signals:
       /**
        * Log a message to the DebugConsole associated with this widget.
@@ -180,12 +446,6 @@ namespace Qtk
       void mouseReleaseEvent(QMouseEvent * event) override;
 
     protected slots:
-      /**
-       * Called when the `frameSwapped` signal is caught.
-       * See definition of initializeGL()
-       */
-      void update();
-
       /**
        * Called when the `messageLogged` signal is caught.
        * See definition of initializeGL()
@@ -196,34 +456,173 @@ namespace Qtk
       void messageLogged(const QOpenGLDebugMessage & msg);
 
     private:
+      friend class FrameScheduler;
+
       /*************************************************************************
        * Private Methods
        ************************************************************************/
 
+      /**
+       * Called by the FrameScheduler once per tick, after the scene was
+       * updated. Moves the camera and requests a frame if one is due.
+       *
+       * @param dt Time in seconds since the scene was last updated.
+       */
+      void updateFrame(float dt);
+
+      /**
+       * @return True if drawing now would not exceed the frame rate cap.
+       */
+      [[nodiscard]] bool isFrameDue() const;
+
       /**
        * Deconstruct any resources we have allocated for this widget.
        */
       void teardownGL();
 
       /**
-       * Callback function to update input for camera controls
+       * Callback function to update input for camera controls.
+       * Input only moves the camera of the widget with focus.
+       *
+       * @param dt Time in seconds since the last call.
        */
-      static void updateCameraInput();
+      void updateCameraInput(float dt);
 
       /**
        * Prints OpenGL context information at start of debug session.
        */
       void printContextInformation();
 
+      /**
+       * @return True if anything changed since the last frame was drawn.
+       */
+      [[nodiscard]] bool isDirty() const;
+
+      /**
+       * Sample process CPU usage and frame cost once per second.
+       */
+      void updateCpuUsage();
+
+      /**
+       * Apply the active RenderProfile to this widget and log it.
+       */
+      void applyRenderProfile();
+
+      /**
+       * Show the active RenderProfile in the DebugConsole, and warn about
+       * settings that need a new context to apply.
+       */
+      void logRenderProfile();
+
+      /**
+       * Start or stop forwarding OpenGL messages to the DebugConsole.
+       * Must be called with the widget's context current.
+       */
+      void updateDebugLogging();
+
+      /**
+       * Pace the FrameScheduler at the active profile's swap interval.
+       */
+      static void updateSwapInterval();
+
+      /**
+       * @return Size of the frames drawn with the active resolution scale.
+       */
+      [[nodiscard]] QSize getRenderSize() const;
+
+      /**
+       * Bind the render target when the active profile needs one.
+       *
+       * @return False if the scene should be drawn into the widget directly.
+       */
+      bool bindRenderTarget();
+
+      /**
+       * Resolve and scale the render target into the widget's framebuffer.
+       */
+      void resolveRenderTarget();
+
+      /**
+       * Delete the render target. Must be called with the context current.
+       */
+      void releaseRenderTarget();
+
+      /**
+       * Called once a frame is presented. Ends the frame in mProfiler and
+       * refreshes the profiler overlay.
+       */
+      void frameDone();
+
+      /**
+       * Record the time of the frame just painted in mFrameTimes, and log it
+       * to the DebugConsole if it was a hitch.
+       *
+       * @param paintNs CPU time spent in paintGL.
+       */
+      void recordFrameTime(int64_t paintNs);
+
       /*************************************************************************
        * Private Members
        ************************************************************************/
 
       QOpenGLDebugLogger * mDebugLogger;
       Qtk::Scene * mScene;
+      /* Camera and projection for this view into mScene. */
+      Camera3D mCamera;
+      QMatrix4x4 mProjection;
       Qtk::DebugConsole * mConsole;
       bool mConsoleActive = true;
       QMainWindow * mMainWindow = Q_NULLPTR;
+
+      RenderPolicy mRenderPolicy = QTK_RENDER_CONTINUOUS;
+      bool mThreadedRendering = false;
+      /* Draws the scene when threaded rendering is enabled. */
+      RenderThread * mRenderThread {};
+      /* Presents frames from mRenderThread. */
+      QOpenGLTextureBlitter mBlitter;
+      /* Multisampled and / or scaled target the scene is drawn into, and a
+       * single sampled copy used to scale multisampled frames. */
+      QOpenGLFramebufferObject * mTarget {};
+      QOpenGLFramebufferObject * mResolved {};
+      int mTargetSamples = 0;
+      PostProcessChain mPostProcess;
+
+      bool mDynamicResolution = false;
+      DynamicResolution mResolution;
+      /* Times this view's frames, so views sharing a thread don't mix. */
+      FrameProfiler mProfiler;
+      /* GPU time of the last frame measured by mProfiler. */
+      float mGpuFrameMs = 0.0f;
+      /* Time from the end of paintGL until the frame is swapped. */
+      QElapsedTimer mSwapTimer;
+      /* Shows mProfiler averages over the scene when visible. */
+      QLabel * mProfilerOverlay {};
+      uint64_t mProfilerRevision = 0;
+      FrameTimes mFrameTimes;
+      /* FrameEvents seen since the last frame, and the scene revision as of
+       * the last frame recorded. */
+      uint32_t mFrameEvents = 0;
+      uint64_t mFrameTimesRevision = 0;
+      bool mRenderRequested = true;
+      /* Frame rate cap, and time since the last frame was requested. */
+      float mMaxFrameRate = 0.0f;
+      QElapsedTimer mFrameClock;
+      /* Revisions of transforms and the scene as of the last frame drawn. */
+      uint64_t mTransformRevision = 0;
+      uint64_t mSceneRevision = 0;
+
+      QElapsedTimer mUsageTimer;
+      std::clock_t mUsageClock {};
+      uint64_t mUsageFrames = 0;
+      /* Total and worst paintGL time since usage was last sampled. */
+      int64_t mUsagePaintNs = 0;
+      int64_t mUsageMaxPaintNs = 0;
+      FrameCost mFrameCost {};
+      float mCpuUsage = 0.0f;
+      bool mIdle = false;
+
+      /* Profile shared by all QtkWidgets. */
+      static RenderProfile sRenderProfile;
   };
 
   /**
@@ -270,6 +669,21 @@ namespace Qtk
         mQtkWidgets[name] = widget;
       }
 
+      /**
+       * @param scene The scene to find views of.
+       * @return All QtkWidgets currently viewing the scene.
+       */
+      std::vector<QtkWidget *> get_views(const Scene * scene) const
+      {
+        std::vector<QtkWidget *> views;
+        for (const auto & [name, widget] : mQtkWidgets) {
+          if (scene != Q_NULLPTR && widget->getScene() == scene) {
+            views.push_back(widget);
+          }
+        }
+        return views;
+      }
+
     private:
       std::unordered_map<QString, QtkWidget *> mQtkWidgets;
   };
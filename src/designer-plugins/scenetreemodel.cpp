@@ -0,0 +1,287 @@
+/*##############################################################################
+## Author: Shaun Reed                                                         ##
+## Legal: All Content (c) 2025 Shaun Reed, all rights reserved                ##
+## About: Item model listing the objects within a scene                       ##
+##                                                                            ##
+## Contact: shaunrd0@gmail.com  | URL: www.shaunreed.com | GitHub: shaunrd0   ##
+##############################################################################*/
+
+#include <QSet>
+
+#include <utility>
+
+#include "scenetreemodel.h"
+
+using namespace Qtk;
+
+/*******************************************************************************
+ * Constructors / Destructors
+ ******************************************************************************/
+
+SceneTreeModel::SceneTreeModel(QObject * parent) : QAbstractItemModel(parent)
+{
+  mThrottle.setSingleShot(true);
+  mThrottle.setInterval(kThrottleMs);
+  connect(&mThrottle, &QTimer::timeout, this, &SceneTreeModel::flushChanges);
+  // Filters replace each other, so there is never a reason to run two.
+  mFilterPool.setMaxThreadCount(1);
+}
+
+SceneTreeModel::~SceneTreeModel()
+{
+  mFilterPool.waitForDone();
+}
+
+/*******************************************************************************
+ * Public Methods
+ ******************************************************************************/
+
+void SceneTreeModel::setScene(const Scene * scene)
+{
+  beginResetModel();
+  mScene = scene;
+  mRows.clear();
+  mPendingAdded.clear();
+  mPendingRemoved.clear();
+  mThrottle.stop();
+  if (mScene != Q_NULLPTR) {
+    auto objects = mScene->getObjects();
+    mRows.reserve(objects.size());
+    for (const auto & object : objects) {
+      mRows.push_back({object->getName(), object->getHandle()});
+    }
+  }
+  ++mFilterGeneration;
+  mFiltered = false;
+  mShown.clear();
+  resetFetched();
+  endResetModel();
+
+  if (!mFilter.isEmpty()) {
+    startFilter();
+  }
+}
+
+void SceneTreeModel::applyChanges(const QStringList & added,
+                                  const QStringList & removed)
+{
+  mPendingAdded.append(added);
+  mPendingRemoved.append(removed);
+  if (!mThrottle.isActive()) {
+    mThrottle.start();
+  }
+}
+
+void SceneTreeModel::setFilter(const QString & text)
+{
+  if (text == mFilter) {
+    return;
+  }
+  mFilter = text;
+  if (!mFilter.isEmpty()) {
+    startFilter();
+    return;
+  }
+
+  // Drop any filter still running and show every row again.
+  ++mFilterGeneration;
+  if (mFiltered) {
+    beginResetModel();
+    mFiltered = false;
+    mShown.clear();
+    resetFetched();
+    endResetModel();
+  }
+}
+
+/*******************************************************************************
+ * Accessors
+ ******************************************************************************/
+
+ObjectHandle SceneTreeModel::getHandle(const QModelIndex & index) const
+{
+  if (!index.isValid() || index.row() >= mFetched) {
+    return {};
+  }
+  return getShownRow(index.row()).mHandle;
+}
+
+/*******************************************************************************
+ * QAbstractItemModel
+ ******************************************************************************/
+
+QModelIndex SceneTreeModel::index(int row,
+                                  int column,
+                                  const QModelIndex & parent) const
+{
+  if (parent.isValid() || column != 0 || row < 0 || row >= mFetched) {
+    return {};
+  }
+  return createIndex(row, column);
+}
+
+QModelIndex SceneTreeModel::parent(const QModelIndex & index) const
+{
+  Q_UNUSED(index);
+  return {};
+}
+
+int SceneTreeModel::rowCount(const QModelIndex & parent) const
+{
+  return parent.isValid() ? 0 : mFetched;
+}
+
+int SceneTreeModel::columnCount(const QModelIndex & parent) const
+{
+  Q_UNUSED(parent);
+  return 1;
+}
+
+QVariant SceneTreeModel::data(const QModelIndex & index, int role) const
+{
+  if (!index.isValid() || index.row() >= mFetched || role != Qt::DisplayRole) {
+    return {};
+  }
+  return getShownRow(index.row()).mName;
+}
+
+bool SceneTreeModel::canFetchMore(const QModelIndex & parent) const
+{
+  return !parent.isValid() && static_cast<size_t>(mFetched) < getShownCount();
+}
+
+void SceneTreeModel::fetchMore(const QModelIndex & parent)
+{
+  if (!canFetchMore(parent)) {
+    return;
+  }
+  int count = static_cast<int>(std::min<size_t>(
+      getShownCount() - mFetched, static_cast<size_t>(kFetchSize)));
+  beginInsertRows(QModelIndex(), mFetched, mFetched + count - 1);
+  mFetched += count;
+  endInsertRows();
+}
+
+/*******************************************************************************
+ * Private Methods
+ ******************************************************************************/
+
+void SceneTreeModel::flushChanges()
+{
+  if (mScene == Q_NULLPTR) {
+    mPendingAdded.clear();
+    mPendingRemoved.clear();
+    return;
+  }
+
+  // Rows are matched by handle instead of name, so an object removed and then
+  // added again with the same name within one flush is replaced correctly.
+  // Rows are only removed once their handle no longer resolves.
+  QSet<QString> removed(mPendingRemoved.begin(), mPendingRemoved.end());
+  auto isRemoved = [this, &removed](const Row & row) {
+    return removed.contains(row.mName)
+           && mScene->getObject(row.mHandle) == Q_NULLPTR;
+  };
+
+  if (!removed.isEmpty()) {
+    // Rows views have not fetched, and every row while a filter is shown, are
+    // removed without notifying views.
+    const int notified = mFiltered ? 0 : mFetched;
+    std::vector<std::pair<int, int>> runs;
+    for (int i = 0; i < notified; i++) {
+      if (!isRemoved(mRows[i])) {
+        continue;
+      }
+      if (!runs.empty() && runs.back().second == i - 1) {
+        runs.back().second = i;
+      } else {
+        runs.emplace_back(i, i);
+      }
+    }
+
+    if (runs.size() > static_cast<size_t>(kMaxRemoveRanges)) {
+      beginResetModel();
+      mRows.erase(std::remove_if(mRows.begin(), mRows.end(), isRemoved),
+                  mRows.end());
+      resetFetched();
+      endResetModel();
+    } else {
+      // Remove from the back so earlier runs keep their positions.
+      for (auto it = runs.rbegin(); it != runs.rend(); ++it) {
+        beginRemoveRows(QModelIndex(), it->first, it->second);
+        mRows.erase(mRows.begin() + it->first, mRows.begin() + it->second + 1);
+        mFetched -= it->second - it->first + 1;
+        endRemoveRows();
+      }
+      auto tail = mRows.begin() + (mFiltered ? 0 : mFetched);
+      mRows.erase(std::remove_if(tail, mRows.end(), isRemoved), mRows.end());
+    }
+  }
+
+  std::vector<Row> added;
+  QSet<QString> seen;
+  for (const auto & name : mPendingAdded) {
+    if (seen.contains(name)) {
+      continue;
+    }
+    seen.insert(name);
+    // Objects added and removed again before the flush have no handle.
+    auto handle = mScene->getHandle(name);
+    if (handle.isValid()) {
+      added.push_back({name, handle});
+    }
+  }
+  mPendingAdded.clear();
+  mPendingRemoved.clear();
+
+  if (!added.empty()) {
+    const bool insert = !mFiltered
+                        && static_cast<size_t>(mFetched) == mRows.size()
+                        && added.size() <= static_cast<size_t>(kFetchSize);
+    if (insert) {
+      const int first = static_cast<int>(mRows.size());
+      beginInsertRows(
+          QModelIndex(), first, first + static_cast<int>(added.size()) - 1);
+      mRows.insert(mRows.end(), added.begin(), added.end());
+      mFetched += static_cast<int>(added.size());
+      endInsertRows();
+    } else {
+      // Views fetch the new rows when they scroll to them.
+      mRows.insert(mRows.end(), added.begin(), added.end());
+    }
+  }
+
+  if (!mFilter.isEmpty() && (!removed.isEmpty() || !added.empty())) {
+    startFilter();
+  }
+}
+
+void SceneTreeModel::startFilter()
+{
+  const uint64_t generation = ++mFilterGeneration;
+  // QString is implicitly shared, so copying the rows does not copy names.
+  mFilterPool.start([this, rows = mRows, text = mFilter, generation]() {
+    std::vector<Row> result;
+    for (const auto & row : rows) {
+      if (row.mName.contains(text, Qt::CaseInsensitive)) {
+        result.push_back(row);
+      }
+    }
+
+    // Swap in the result on the model's thread, unless a newer filter or
+    // scene replaced it in the meantime.
+    QMetaObject::invokeMethod(
+        this,
+        [this, result = std::move(result), generation]() mutable {
+          if (generation != mFilterGeneration) {
+            return;
+          }
+          beginResetModel();
+          mShown = std::move(result);
+          mFiltered = true;
+          resetFetched();
+          endResetModel();
+        },
+        Qt::QueuedConnection);
+  });
+}
@@ -0,0 +1,202 @@
+/*##############################################################################
+## Author: Shaun Reed                                                         ##
+## Legal: All Content (c) 2025 Shaun Reed, all rights reserved                ##
+## About: Item model listing the objects within a scene                       ##
+##                                                                            ##
+## Contact: shaunrd0@gmail.com  | URL: www.shaunreed.com | GitHub: shaunrd0   ##
+##############################################################################*/
+
+#ifndef QTK_SCENETREEMODEL_H
+#define QTK_SCENETREEMODEL_H
+
+#include <QAbstractItemModel>
+#include <QPointer>
+#include <QStringList>
+#include <QThreadPool>
+#include <QTimer>
+
+#include <algorithm>
+#include <vector>
+
+#include "qtk/scene.h"
+
+namespace Qtk
+{
+  /**
+   * Flat model of the objects in a Scene, for views such as TreeView.
+   *
+   * Built to stay responsive with very large scenes:
+   *    Rows are exposed to views in chunks through `fetchMore()`.
+   *    Changes from Scene::objectsChanged are queued and applied at most once
+   *    per kThrottleMs, inserting and removing rows instead of resetting.
+   *    Filtering runs on a worker thread and replaces the rows shown when it
+   *    finishes.
+   *
+   * Each row stores the object's handle, so views resolve objects without
+   * searching by name. See `getHandle()`.
+   */
+  class SceneTreeModel : public QAbstractItemModel
+  {
+      Q_OBJECT
+
+    public:
+      /*************************************************************************
+       * Constructors / Destructors
+       ************************************************************************/
+
+      explicit SceneTreeModel(QObject * parent = nullptr);
+
+      /**
+       * Waits for a filter in progress to finish.
+       */
+      ~SceneTreeModel() override;
+
+      /*************************************************************************
+       * Public Methods
+       ************************************************************************/
+
+      /**
+       * Load every object in a scene, replacing the current rows.
+       *
+       * @param scene The scene to list.
+       */
+      void setScene(const Scene * scene);
+
+      /**
+       * Queue objects added to or removed from the scene. Queued changes are
+       * applied together once kThrottleMs has passed.
+       *
+       * @param added Names of objects added to the scene.
+       * @param removed Names of objects removed from the scene.
+       */
+      void applyChanges(const QStringList & added, const QStringList & removed);
+
+      /**
+       * Only show objects whose name contains the text, ignoring case. The
+       * filter runs on a worker thread.
+       *
+       * @param text Text to search for, or an empty string to show all.
+       */
+      void setFilter(const QString & text);
+
+      /*************************************************************************
+       * Accessors
+       ************************************************************************/
+
+      /**
+       * @param index Index of a row in this model.
+       * @return Handle of the object shown by the row.
+       */
+      [[nodiscard]] ObjectHandle getHandle(const QModelIndex & index) const;
+
+      [[nodiscard]] inline const Scene * getScene() const { return mScene; }
+
+      /*************************************************************************
+       * QAbstractItemModel
+       ************************************************************************/
+
+      [[nodiscard]] QModelIndex index(
+          int row,
+          int column,
+          const QModelIndex & parent = QModelIndex()) const override;
+
+      [[nodiscard]] QModelIndex parent(
+          const QModelIndex & index) const override;
+
+      [[nodiscard]] int rowCount(
+          const QModelIndex & parent = QModelIndex()) const override;
+
+      [[nodiscard]] int columnCount(
+          const QModelIndex & parent = QModelIndex()) const override;
+
+      [[nodiscard]] QVariant data(const QModelIndex & index,
+                                  int role = Qt::DisplayRole) const override;
+
+      [[nodiscard]] bool canFetchMore(
+          const QModelIndex & parent) const override;
+
+      void fetchMore(const QModelIndex & parent) override;
+
+    private:
+      /*************************************************************************
+       * Private Types
+       ************************************************************************/
+
+      struct Row {
+          QString mName;
+          ObjectHandle mHandle;
+      };
+
+      /*************************************************************************
+       * Private Methods
+       ************************************************************************/
+
+      /**
+       * Apply changes queued by `applyChanges()`.
+       */
+      void flushChanges();
+
+      /**
+       * Start filtering the current rows on the worker thread.
+       */
+      void startFilter();
+
+      /**
+       * @return Number of rows shown by views once fully fetched.
+       */
+      [[nodiscard]] inline size_t getShownCount() const
+      {
+        return mFiltered ? mShown.size() : mRows.size();
+      }
+
+      /**
+       * @return Row shown at a position in the model.
+       */
+      [[nodiscard]] inline const Row & getShownRow(int row) const
+      {
+        return mFiltered ? mShown[row] : mRows[row];
+      }
+
+      /**
+       * Expose up to kFetchSize rows to views after the model is reset.
+       */
+      inline void resetFetched()
+      {
+        mFetched = static_cast<int>(
+            std::min<size_t>(getShownCount(), size_t(kFetchSize)));
+      }
+
+      /*************************************************************************
+       * Private Members
+       ************************************************************************/
+
+      /* Rows exposed to views by each call to fetchMore(). */
+      static constexpr int kFetchSize = 1000;
+      /* Minimum time between applying queued changes, about one frame. */
+      static constexpr int kThrottleMs = 16;
+      /* Above this many runs of removed rows the model is reset instead. */
+      static constexpr int kMaxRemoveRanges = 32;
+
+      /* Cleared if the scene is deleted before changes are flushed. */
+      QPointer<const Scene> mScene {};
+      std::vector<Row> mRows {};
+      /* Rows views have fetched so far. */
+      int mFetched = 0;
+
+      QStringList mPendingAdded {};
+      QStringList mPendingRemoved {};
+      QTimer mThrottle;
+
+      QString mFilter {};
+      /* Rows matching mFilter, shown instead of mRows once mFiltered is set.
+       * A copy, so changes to mRows do not disturb it until the filter runs
+       * again. */
+      std::vector<Row> mShown {};
+      bool mFiltered = false;
+      /* Incremented for each filter started, so stale results are dropped. */
+      uint64_t mFilterGeneration = 0;
+      QThreadPool mFilterPool;
+  };
+}  // namespace Qtk
+
+#endif  // QTK_SCENETREEMODEL_H
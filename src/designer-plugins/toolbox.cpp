@@ -30,6 +30,8 @@ ToolBox::ToolBox(QWidget * parent) :
   properiesForm_->addRow(objectDetails_.name.label, objectDetails_.name.value);
   properiesForm_->addRow(objectDetails_.objectType.label,
                          objectDetails_.objectType.value);
+  properiesForm_->addRow(objectDetails_.memory.label,
+                         objectDetails_.memory.value);
   properiesForm_->addRow(reinterpret_cast<QWidget *>(&transformPanel_));
   properiesForm_->addRow(reinterpret_cast<QWidget *>(&scalePanel_));
   ui->toolBox->setCurrentWidget(ui->page_properties);
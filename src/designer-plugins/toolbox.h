@@ -18,6 +18,7 @@
 #include <QLabel>
 #include <QTextEdit>
 
+#include "qtk/memorytracker.h"
 #include "qtk/object.h"
 
 
@@ -84,7 +85,8 @@ namespace Qtk
 
           /// We pass the parent widget so that Qt handles releasing memory.
           explicit ObjectDetails(QWidget * parent) :
-              name(parent, "Name:"), objectType(parent, "Object Type:")
+              name(parent, "Name:"), objectType(parent, "Object Type:"),
+              memory(parent, "Memory:")
           {
           }
 
@@ -95,15 +97,37 @@ namespace Qtk
             if (object == Q_NULLPTR) {
               name.setValue("");
               objectType.setValue("No object selected");
+              memory.setValue("");
+              memory.value->setToolTip("");
               return;
             }
             name.setItem("Name:", object->getName().toStdString().c_str());
             objectType.setItem(
                 "Type:",
                 object->getType() == Object::QTK_MESH ? "Mesh" : "Model");
+
+            // Show the total, with live and peak bytes of each category in
+            // the tooltip.
+            auto & tracker = MemoryTracker::getInstance();
+            auto total = tracker.getTotal(object);
+            memory.setValue(QString("%1 (peak %2)")
+                                .arg(MemoryTracker::formatBytes(total.mLive))
+                                .arg(MemoryTracker::formatBytes(total.mPeak))
+                                .toStdString()
+                                .c_str());
+            QStringList details;
+            for (size_t i = 0; i < QTK_MEMORY_CATEGORY_COUNT; i++) {
+              auto category = static_cast<MemoryCategory>(i);
+              auto usage = tracker.getUsage(object, category);
+              details << QString("%1: %2 (peak %3)")
+                             .arg(MemoryTracker::getCategoryName(category))
+                             .arg(MemoryTracker::formatBytes(usage.mLive))
+                             .arg(MemoryTracker::formatBytes(usage.mPeak));
+            }
+            memory.value->setToolTip(details.join('\n'));
           }
 
-          Item name, objectType;
+          Item name, objectType, memory;
       };
       ObjectDetails objectDetails_;
 
@@ -16,15 +16,16 @@
  ******************************************************************************/
 
 Qtk::TreeView::TreeView(QWidget * parent) :
-    QDockWidget(parent), ui(new Ui::TreeView)
+    QDockWidget(parent), ui(new Ui::TreeView), mModel(new SceneTreeModel(this))
 {
   ui->setupUi(this);
-  connect(
-      ui->treeWidget, &QTreeWidget::itemClicked, this, &TreeView::itemSelect);
-  connect(ui->treeWidget,
-          &QTreeWidget::itemDoubleClicked,
-          this,
-          &TreeView::itemFocus);
+  ui->treeView->setModel(mModel);
+  connect(ui->treeView, &QTreeView::clicked, this, &TreeView::itemSelect);
+  connect(ui->treeView, &QTreeView::doubleClicked, this, &TreeView::itemFocus);
+  connect(ui->filterEdit,
+          &QLineEdit::textChanged,
+          mModel,
+          &SceneTreeModel::setFilter);
 }
 
 Qtk::TreeView::~TreeView()
@@ -38,30 +39,35 @@ Qtk::TreeView::~TreeView()
 
 void Qtk::TreeView::updateView(const Qtk::Scene * scene)
 {
-  ui->treeWidget->clear();
-  ui->treeWidget->setColumnCount(1);
   mSceneName = scene->getSceneName();
-  auto objects = scene->getObjects();
-  for (const auto & object : objects) {
-    QStringList list(QStringList(QString(object->getName())));
-    ui->treeWidget->insertTopLevelItem(0, new QTreeWidgetItem(list));
+  mModel->setScene(scene);
+}
+
+void Qtk::TreeView::applyChanges(const Qtk::Scene * scene,
+                                 const QStringList & added,
+                                 const QStringList & removed)
+{
+  if (scene->getSceneName() != mSceneName || scene != mModel->getScene()) {
+    updateView(scene);
+    return;
   }
+  mModel->applyChanges(added, removed);
 }
 
-void Qtk::TreeView::itemFocus(QTreeWidgetItem * item, int column)
+void Qtk::TreeView::itemFocus(const QModelIndex & index)
 {
-  const QString & name = item->text(column);
-  auto scene = QtkWidget::mWidgetManager.get_widget()->getScene();
-  auto object = scene->getObject(name);
+  auto widget = QtkWidget::mWidgetManager.get_widget();
+  auto scene = widget->getScene();
+  auto object = scene->getObject(mModel->getHandle(index));
   // If the object is a mesh or model, focus the camera on it.
   if (object == Q_NULLPTR) {
-    qDebug() << "Attempt to get non-existing object with name '" << name
-             << "'\n";
+    qDebug() << "Attempt to get non-existing object with name '"
+             << index.data().toString() << "'\n";
     return;
   }
   const Transform3D & objectTransform = object->getTransform();
 
-  auto & camera_transform = Qtk::Scene::getCamera().getTransform();
+  auto & camera_transform = widget->getCamera().getTransform();
   auto focusScale = objectTransform.getScale();
   float width = focusScale.x() / 2.0f;
   float height = focusScale.y() / 2.0f;
@@ -72,12 +78,12 @@ void Qtk::TreeView::itemFocus(QTreeWidgetItem * item, int column)
   camera_transform.translate(0.0f, 0.0f, 3.0f);
 
   // Emit signal from qtk widget for new object focus. Triggers GUI updates.
-  emit QtkWidget::mWidgetManager.get_widget()->objectFocusChanged(name);
+  emit widget->objectFocusChanged(object->getName());
 }
 
-void Qtk::TreeView::itemSelect(QTreeWidgetItem * item, int column)
+void Qtk::TreeView::itemSelect(const QModelIndex & index)
 {
   // Emit signal from qtk widget for new object focus. Triggers GUI updates.
-  const QString & name = item->text(column);
+  const QString name = index.data().toString();
   emit QtkWidget::mWidgetManager.get_widget()->objectFocusChanged(name);
 }
@@ -13,9 +13,10 @@
 #include <QDesignerCustomWidgetInterface>
 #include <QDesignerExportWidget>
 #include <QDockWidget>
-#include <QTreeWidgetItem>
+#include <QModelIndex>
 
 #include "qtk/scene.h"
+#include "scenetreemodel.h"
 
 namespace Ui
 {
@@ -42,31 +43,41 @@ namespace Qtk
        ************************************************************************/
 
       /**
-       * Updates the QTreeWidget with all objects within the scene.
+       * Updates the view with all objects within the scene.
        * @param scene The scene to load objects from.
        */
       void updateView(const Scene * scene);
 
+      /**
+       * Add and remove rows for objects changed in the scene shown, instead
+       * of reloading every object. Changes are applied at most once per
+       * frame. Reloads the view for any other scene.
+       * Connect to Scene::objectsChanged.
+       *
+       * @param scene The scene that was modified.
+       * @param added Names of objects added to the scene.
+       * @param removed Names of objects removed from the scene.
+       */
+      void applyChanges(const Scene * scene,
+                        const QStringList & added,
+                        const QStringList & removed);
+
     public slots:
       /**
        * Focus the camera on an item when it is double clicked.
-       * Triggered by QTreeWidget::itemDoubleClicked signal.
+       * Triggered by QTreeView::doubleClicked signal.
        *
-       * @param item The item that was double clicked
-       * @param column The column of the item that was double clicked.
-       *    This param is currently not used but required for this signal.
+       * @param index The index of the item that was double clicked.
        */
-      void itemFocus(QTreeWidgetItem * item, int column);
+      void itemFocus(const QModelIndex & index);
 
       /**
        * Set the object to show details for.
-       * Triggered by QTreeWidget::itemClicked signal.
+       * Triggered by QTreeView::clicked signal.
        *
-       * @param item The item that was clicked
-       * @param column The column of the item that was double clicked.
-       *    This param is currently not used but required for this signal.
+       * @param index The index of the item that was clicked.
        */
-      void itemSelect(QTreeWidgetItem * item, int column);
+      void itemSelect(const QModelIndex & index);
 
     private:
       /*************************************************************************
@@ -76,10 +87,13 @@ namespace Qtk
       Ui::TreeView * ui;
 
       /**
-       * The name of the scene last loaded by this TreeWidget.
+       * The name of the scene last loaded by this TreeView.
        * Used to load object data from a target scene.
        */
       QString mSceneName;
+
+      /* Objects listed in the view, owned by this widget. */
+      SceneTreeModel * mModel;
   };
 }  // namespace Qtk
 
@@ -0,0 +1,66 @@
+/*##############################################################################
+## Author: Shaun Reed                                                         ##
+## Legal: All Content (c) 2025 Shaun Reed, all rights reserved                ##
+## About: Controller scaling render resolution to hold a frame time budget    ##
+##                                                                            ##
+## Contact: shaunrd0@gmail.com  | URL: www.shaunreed.com | GitHub: shaunrd0   ##
+##############################################################################*/
+
+#include <algorithm>
+#include <cmath>
+
+#include "dynamicresolution.h"
+
+using namespace Qtk;
+
+/* Scales are multiples of this step. */
+static constexpr float kScaleStep = 0.05f;
+/* Frames to wait after changing the scale; GPU timings lag a few frames. */
+static constexpr int kSettleFrames = 8;
+/* Only scale up once frames take less than this fraction of the budget. */
+static constexpr float kHeadroom = 0.8f;
+
+/*******************************************************************************
+ * Public Methods
+ ******************************************************************************/
+
+float DynamicResolution::update(float frameMs)
+{
+  // Smooth out single slow frames.
+  mAverageMs =
+      mAverageMs <= 0.0f ? frameMs : mAverageMs * 0.9f + frameMs * 0.1f;
+  if (++mFramesSinceChange < kSettleFrames || mAverageMs <= 0.0f) {
+    return mScale;
+  }
+  if (mAverageMs <= mBudgetMs && mAverageMs >= mBudgetMs * kHeadroom) {
+    return mScale;
+  }
+
+  float scale = mScale * std::sqrt(mBudgetMs / mAverageMs);
+  scale = std::round(scale / kScaleStep) * kScaleStep;
+  scale = std::clamp(std::min(scale, mScale + kScaleStep), mMinScale, 1.0f);
+  if (std::abs(scale - mScale) >= kScaleStep / 2.0f) {
+    mScale = scale;
+    mFramesSinceChange = 0;
+    // Timings at the previous scale no longer apply.
+    mAverageMs = 0.0f;
+  }
+  return mScale;
+}
+
+void DynamicResolution::reset()
+{
+  mScale = 1.0f;
+  mAverageMs = 0.0f;
+  mFramesSinceChange = 0;
+}
+
+/*******************************************************************************
+ * Setters
+ ******************************************************************************/
+
+void DynamicResolution::setMinScale(float minScale)
+{
+  mMinScale = std::clamp(minScale, kScaleStep, 1.0f);
+  mScale = std::max(mScale, mMinScale);
+}
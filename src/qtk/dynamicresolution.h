@@ -0,0 +1,93 @@
+/*##############################################################################
+## Author: Shaun Reed                                                         ##
+## Legal: All Content (c) 2025 Shaun Reed, all rights reserved                ##
+## About: Controller scaling render resolution to hold a frame time budget    ##
+##                                                                            ##
+## Contact: shaunrd0@gmail.com  | URL: www.shaunreed.com | GitHub: shaunrd0   ##
+##############################################################################*/
+
+#ifndef QTK_DYNAMICRESOLUTION_H
+#define QTK_DYNAMICRESOLUTION_H
+
+#include "qtkapi.h"
+
+namespace Qtk
+{
+  /**
+   * Picks a resolution scale from measured frame times so frames fit in a
+   * time budget.
+   *
+   * The cost of a frame is assumed to grow with its pixel count, the square
+   * of the scale. The scale changes in steps so render targets are not
+   * recreated for small changes, waits a few frames after each change for
+   * timings at the new size, and grows by at most one step at a time so it
+   * does not oscillate around the budget.
+   */
+  class QTKAPI DynamicResolution
+  {
+    public:
+      /*************************************************************************
+       * Public Methods
+       ************************************************************************/
+
+      /**
+       * Record the cost of a frame and update the scale.
+       *
+       * @param frameMs Time spent drawing the frame in milliseconds; the
+       *    larger of CPU and GPU time.
+       * @return The resolution scale to draw the next frame at.
+       */
+      float update(float frameMs);
+
+      /**
+       * Return to full resolution and forget measured frame times.
+       */
+      void reset();
+
+      /*************************************************************************
+       * Accessors
+       ************************************************************************/
+
+      [[nodiscard]] inline float getScale() const { return mScale; }
+
+      [[nodiscard]] inline float getFrameTimeBudget() const
+      {
+        return mBudgetMs;
+      }
+
+      /**
+       * @return Smoothed frame time the scale was last chosen from.
+       */
+      [[nodiscard]] inline float getAverageFrameTime() const
+      {
+        return mAverageMs;
+      }
+
+      /*************************************************************************
+       * Setters
+       ************************************************************************/
+
+      /**
+       * @param ms Target time to draw each frame in milliseconds.
+       */
+      inline void setFrameTimeBudget(float ms) { mBudgetMs = ms; }
+
+      /**
+       * @param minScale Smallest scale the controller may choose.
+       */
+      void setMinScale(float minScale);
+
+    private:
+      /*************************************************************************
+       * Private Members
+       ************************************************************************/
+
+      float mBudgetMs = 16.0f;
+      float mMinScale = 0.5f;
+      float mScale = 1.0f;
+      float mAverageMs = 0.0f;
+      int mFramesSinceChange = 0;
+  };
+}  // namespace Qtk
+
+#endif  // QTK_DYNAMICRESOLUTION_H
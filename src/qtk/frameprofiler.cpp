@@ -0,0 +1,329 @@
+/*##############################################################################
+## Author: Shaun Reed                                                         ##
+## Legal: All Content (c) 2025 Shaun Reed, all rights reserved                ##
+## About: Hierarchical CPU and GPU timers for the phases of a frame           ##
+##                                                                            ##
+## Contact: shaunrd0@gmail.com  | URL: www.shaunreed.com | GitHub: shaunrd0   ##
+##############################################################################*/
+
+#include <QOpenGLExtraFunctions>
+
+#include <functional>
+
+#include "frameprofiler.h"
+
+using namespace Qtk;
+
+/* Profiler bound on each thread, and the innermost scope open in it. */
+static thread_local FrameProfiler * tCurrentProfiler = Q_NULLPTR;
+static thread_local uint32_t tCurrentScope = 0;
+
+/*******************************************************************************
+ * Scope
+ ******************************************************************************/
+
+FrameProfiler::Scope::Scope(const char * name, bool gpu) :
+    mProfiler(getCurrent()), mParent(tCurrentScope)
+{
+  {
+    QMutexLocker lock(&mProfiler.mMutex);
+    mNode = mProfiler.getChild(mParent, name);
+  }
+  tCurrentScope = mNode;
+  mGpu = gpu && mProfiler.beginGpu(mNode);
+  mTimer.start();
+}
+
+FrameProfiler::Scope::~Scope()
+{
+  auto ns = mTimer.nsecsElapsed();
+  if (mGpu) {
+    mProfiler.endGpu();
+  }
+  tCurrentScope = mParent;
+
+  QMutexLocker lock(&mProfiler.mMutex);
+  auto & node = mProfiler.mNodes[mNode];
+  node.mCpuNs += ns;
+  ++node.mCalls;
+}
+
+/*******************************************************************************
+ * Bind
+ ******************************************************************************/
+
+FrameProfiler::Bind::Bind(FrameProfiler & profiler) :
+    mPrevious(tCurrentProfiler), mPreviousScope(tCurrentScope)
+{
+  tCurrentProfiler = &profiler;
+  tCurrentScope = kRoot;
+}
+
+FrameProfiler::Bind::~Bind()
+{
+  tCurrentProfiler = mPrevious;
+  tCurrentScope = mPreviousScope;
+}
+
+/*******************************************************************************
+ * Constructors / Destructors
+ ******************************************************************************/
+
+FrameProfiler::FrameProfiler()
+{
+  mNodes.push_back({});
+}
+
+FrameProfiler::~FrameProfiler()
+{
+  // A view's context may outlive its profiler.
+  QObject::disconnect(mContextDestroyed);
+}
+
+/*******************************************************************************
+ * Public Methods
+ ******************************************************************************/
+
+FrameProfiler & FrameProfiler::getInstance()
+{
+  static FrameProfiler profiler;
+  return profiler;
+}
+
+FrameProfiler & FrameProfiler::getCurrent()
+{
+  return tCurrentProfiler != Q_NULLPTR ? *tCurrentProfiler : getInstance();
+}
+
+void FrameProfiler::record(const char * name, int64_t ns, uint32_t calls)
+{
+  // Open scopes only belong to this profiler if it is bound on this thread.
+  auto parent = &getCurrent() == this ? tCurrentScope : kRoot;
+  QMutexLocker lock(&mMutex);
+  auto & node = mNodes[getChild(parent, name)];
+  node.mCpuNs += ns;
+  node.mCalls += calls;
+}
+
+void FrameProfiler::endFrame()
+{
+  mFrame.fetch_add(1, std::memory_order_relaxed);
+  QMutexLocker lock(&mMutex);
+  if (++mFrames < kAverageFrames) {
+    return;
+  }
+
+  // Publish parents before their children.
+  std::vector<std::vector<uint32_t>> children(mNodes.size());
+  for (uint32_t i = 1; i < mNodes.size(); i++) {
+    children[mNodes[i].mParent].push_back(i);
+  }
+  const auto frames = static_cast<float>(mFrames);
+  mStats.clear();
+  std::function<void(uint32_t)> publish = [&](uint32_t index) {
+    for (auto child : children[index]) {
+      auto & node = mNodes[child];
+      Stats stats;
+      stats.mPath = node.mPath;
+      stats.mDepth = node.mDepth;
+      stats.mCpuMs = float(node.mCpuNs) / frames / 1.0e6f;
+      if (node.mGpuTimed) {
+        stats.mGpuMs = float(node.mGpuNs) / frames / 1.0e6f;
+      }
+      stats.mCalls = float(node.mCalls) / frames;
+      mStats.push_back(stats);
+      node.mCpuNs = node.mGpuNs = 0;
+      node.mCalls = 0;
+      publish(child);
+    }
+  };
+  publish(kRoot);
+  mFrames = 0;
+  mRevision.fetch_add(1, std::memory_order_relaxed);
+}
+
+/*******************************************************************************
+ * Accessors
+ ******************************************************************************/
+
+std::vector<FrameProfiler::Stats> FrameProfiler::getStats() const
+{
+  QMutexLocker lock(&mMutex);
+  return mStats;
+}
+
+float FrameProfiler::getCpuMs(const QString & path) const
+{
+  QMutexLocker lock(&mMutex);
+  auto stats = findStats(path);
+  return stats != Q_NULLPTR ? stats->mCpuMs : 0.0f;
+}
+
+float FrameProfiler::getGpuMs(const QString & path) const
+{
+  QMutexLocker lock(&mMutex);
+  auto stats = findStats(path);
+  return stats != Q_NULLPTR ? stats->mGpuMs : -1.0f;
+}
+
+float FrameProfiler::getLastGpuMs(const QString & path) const
+{
+  QMutexLocker lock(&mMutex);
+  for (const auto & node : mNodes) {
+    if (node.mPath == path) {
+      return node.mLastGpuNs < 0 ? -1.0f : float(node.mLastGpuNs) / 1.0e6f;
+    }
+  }
+  return -1.0f;
+}
+
+QString FrameProfiler::toString() const
+{
+  QString text;
+  for (const auto & stats : getStats()) {
+    text += QString(stats.mDepth * 2, ' ')
+            + stats.mPath.section('/', -1)
+            + QString(": CPU %1 ms").arg(stats.mCpuMs, 0, 'f', 2);
+    if (stats.mGpuMs >= 0.0f) {
+      text += QString(", GPU %1 ms").arg(stats.mGpuMs, 0, 'f', 2);
+    }
+    text += "\n";
+  }
+  return text;
+}
+
+/*******************************************************************************
+ * Private Methods
+ ******************************************************************************/
+
+uint32_t FrameProfiler::getChild(uint32_t parent, const char * name)
+{
+  auto key = std::make_pair(parent, std::string_view(name));
+  if (auto it = mChildren.find(key); it != mChildren.end()) {
+    return it->second;
+  }
+
+  Node node;
+  node.mName = name;
+  node.mParent = parent;
+  node.mDepth = parent == kRoot ? 0 : mNodes[parent].mDepth + 1;
+  node.mPath = parent == kRoot ? QString(name)
+                               : mNodes[parent].mPath + "/" + QString(name);
+  auto index = static_cast<uint32_t>(mNodes.size());
+  mNodes.push_back(node);
+  mChildren.emplace(key, index);
+  return index;
+}
+
+bool FrameProfiler::beginGpu(uint32_t node)
+{
+  auto context = QOpenGLContext::currentContext();
+  if (context == Q_NULLPTR || context->isOpenGLES()) {
+    return false;
+  }
+  if (mQueryContext == Q_NULLPTR) {
+    mQueryContext = context;
+    mContextDestroyed = QObject::connect(
+        context, &QOpenGLContext::aboutToBeDestroyed, [this]() {
+          // Query names are deleted with the context.
+          mQueries = {};
+          mQueryHead = mQueryTail = 0;
+          mQueryOpen = false;
+          mGpuScopes.clear();
+          mQueryContext = Q_NULLPTR;
+        });
+  }
+  if (context != mQueryContext) {
+    return false;
+  }
+
+  if (mGpuScopes.empty()) {
+    readQueries();
+  } else {
+    // The parent's time resumes in a new query when this scope ends.
+    endQuery();
+  }
+  mGpuScopes.push_back(node);
+  beginQuery(node);
+  return true;
+}
+
+void FrameProfiler::endGpu()
+{
+  endQuery();
+  mGpuScopes.pop_back();
+  if (!mGpuScopes.empty()) {
+    beginQuery(mGpuScopes.back());
+  }
+}
+
+void FrameProfiler::beginQuery(uint32_t node)
+{
+  if (mQueryTail - mQueryHead == kMaxQueries) {
+    // Skip timing rather than waiting for the oldest result.
+    return;
+  }
+  auto gl = mQueryContext->extraFunctions();
+  auto & query = mQueries[mQueryTail % kMaxQueries];
+  if (query.mQuery == 0) {
+    gl->glGenQueries(1, &query.mQuery);
+  }
+  query.mNode = node;
+  query.mFrame = mFrame.load(std::memory_order_relaxed);
+  gl->glBeginQuery(GL_TIME_ELAPSED, query.mQuery);
+  ++mQueryTail;
+  mQueryOpen = true;
+}
+
+void FrameProfiler::endQuery()
+{
+  if (mQueryOpen) {
+    mQueryContext->extraFunctions()->glEndQuery(GL_TIME_ELAPSED);
+    mQueryOpen = false;
+  }
+}
+
+void FrameProfiler::readQueries()
+{
+  auto gl = mQueryContext->extraFunctions();
+  while (mQueryHead != mQueryTail) {
+    const auto & query = mQueries[mQueryHead % kMaxQueries];
+    GLuint available = GL_FALSE;
+    gl->glGetQueryObjectuiv(
+        query.mQuery, GL_QUERY_RESULT_AVAILABLE, &available);
+    if (available == GL_FALSE) {
+      return;
+    }
+    GLuint ns = 0;
+    gl->glGetQueryObjectuiv(query.mQuery, GL_QUERY_RESULT, &ns);
+    ++mQueryHead;
+
+    // GPU time of a scope includes the time of its children.
+    QMutexLocker lock(&mMutex);
+    for (auto index = query.mNode; index != kRoot;
+         index = mNodes[index].mParent) {
+      auto & node = mNodes[index];
+      if (node.mGpuFrame != query.mFrame) {
+        if (node.mGpuTimed) {
+          node.mLastGpuNs = node.mFrameGpuNs;
+        }
+        node.mGpuFrame = query.mFrame;
+        node.mFrameGpuNs = 0;
+      }
+      node.mFrameGpuNs += ns;
+      node.mGpuNs += ns;
+      node.mGpuTimed = true;
+    }
+  }
+}
+
+const FrameProfiler::Stats * FrameProfiler::findStats(
+    const QString & path) const
+{
+  for (const auto & stats : mStats) {
+    if (stats.mPath == path) {
+      return &stats;
+    }
+  }
+  return Q_NULLPTR;
+}
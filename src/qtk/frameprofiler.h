@@ -0,0 +1,300 @@
+/*##############################################################################
+## Author: Shaun Reed                                                         ##
+## Legal: All Content (c) 2025 Shaun Reed, all rights reserved                ##
+## About: Hierarchical CPU and GPU timers for the phases of a frame           ##
+##                                                                            ##
+## Contact: shaunrd0@gmail.com  | URL: www.shaunreed.com | GitHub: shaunrd0   ##
+##############################################################################*/
+
+#ifndef QTK_FRAMEPROFILER_H
+#define QTK_FRAMEPROFILER_H
+
+#include <QElapsedTimer>
+#include <QMutex>
+#include <QOpenGLContext>
+#include <QString>
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <string_view>
+#include <vector>
+
+#include "qtkapi.h"
+
+namespace Qtk
+{
+  /**
+   * Measures where frame time goes, with timers nested the way the phases of
+   * a frame are: `Paint/Draw/Skybox` for example.
+   *
+   * Phases are timed by constructing a `FrameProfiler::Scope` on the stack.
+   * Scopes opened while another is open on the same thread become its
+   * children. Scopes may be opened on any thread, such as a RenderThread.
+   *
+   * GPU scopes also time the commands they submit with GL_TIME_ELAPSED
+   * queries. Those queries can't nest, so an open GPU scope's query is ended
+   * when a child GPU scope begins and restarted when it ends; each result is
+   * added to the scope and its parents. Queries come from a ring and results
+   * are read a few frames later, only once they are available, so timing
+   * never stalls the pipeline. Each profiler measures GPU time on one
+   * context: the first to open a GPU scope with it. GPU scopes on other
+   * contexts are CPU only.
+   *
+   * Totals are averaged over kAverageFrames frames, then published to
+   * `getStats()` for overlays and automated frame time budgets.
+   *
+   * Each view keeps its own profiler, so frames are averaged and GPU time is
+   * measured per view. Scopes are timed by the profiler bound on their
+   * thread with `FrameProfiler::Bind`, or by `getInstance()` if none is.
+   */
+  class QTKAPI FrameProfiler
+  {
+    public:
+      /*************************************************************************
+       * Typedefs
+       ************************************************************************/
+
+      /** Averaged cost of one scope, per frame. */
+      struct Stats {
+          /* Names of the scope and its parents joined by '/'. */
+          QString mPath {};
+          /* Number of parents of the scope. */
+          int mDepth {};
+          float mCpuMs {};
+          /* Negative if the scope is not timed on the GPU. */
+          float mGpuMs = -1.0f;
+          /* Times the scope was opened per frame. */
+          float mCalls {};
+      };
+
+      /**
+       * Times the enclosing block. Open and close scopes on the same thread.
+       */
+      class QTKAPI Scope
+      {
+        public:
+          /**
+           * @param name Static name of the phase, such as "Skybox".
+           * @param gpu True to also time OpenGL commands submitted in scope.
+           *    The context timed on the GPU must be current.
+           */
+          explicit Scope(const char * name, bool gpu = false);
+
+          ~Scope();
+
+          Scope(const Scope &) = delete;
+          Scope & operator=(const Scope &) = delete;
+
+        private:
+          FrameProfiler & mProfiler;
+          uint32_t mNode;
+          uint32_t mParent;
+          bool mGpu;
+          QElapsedTimer mTimer;
+      };
+
+      /**
+       * Makes a profiler time the scopes opened on this thread until the
+       * enclosing block ends. The previous profiler is bound again after.
+       */
+      class QTKAPI Bind
+      {
+        public:
+          explicit Bind(FrameProfiler & profiler);
+
+          ~Bind();
+
+          Bind(const Bind &) = delete;
+          Bind & operator=(const Bind &) = delete;
+
+        private:
+          FrameProfiler * mPrevious;
+          uint32_t mPreviousScope;
+      };
+
+      /*************************************************************************
+       * Constructors / Destructors
+       ************************************************************************/
+
+      FrameProfiler();
+
+      ~FrameProfiler();
+
+      FrameProfiler(const FrameProfiler &) = delete;
+      FrameProfiler & operator=(const FrameProfiler &) = delete;
+
+      /*************************************************************************
+       * Public Methods
+       ************************************************************************/
+
+      /**
+       * @return Profiler for code not drawn by a view, such as tools that
+       *    draw a Scene directly. Frames must be ended by its user.
+       */
+      static FrameProfiler & getInstance();
+
+      /**
+       * @return Profiler bound on this thread, or `getInstance()`.
+       */
+      static FrameProfiler & getCurrent();
+
+      /**
+       * Add time measured without a Scope, as a child of the scope open on
+       * this thread.
+       *
+       * @param name Static name of the phase.
+       * @param ns Time spent in nanoseconds.
+       * @param calls Number of times the phase ran.
+       */
+      void record(const char * name, int64_t ns, uint32_t calls = 1);
+
+      /**
+       * Mark the end of a frame. Once kAverageFrames frames end, averages
+       * are published and the totals restart. Call once per frame presented.
+       */
+      void endFrame();
+
+      /*************************************************************************
+       * Accessors
+       ************************************************************************/
+
+      /**
+       * @return Averages of the last kAverageFrames frames, with each scope
+       *    listed after its parent. Thread safe.
+       */
+      [[nodiscard]] std::vector<Stats> getStats() const;
+
+      /**
+       * @param path Path of a scope, such as "Paint/Draw".
+       * @return Average CPU milliseconds per frame, or 0 if never timed.
+       */
+      [[nodiscard]] float getCpuMs(const QString & path) const;
+
+      /**
+       * @param path Path of a scope, such as "Paint/Draw".
+       * @return Average GPU milliseconds per frame, or a negative value if
+       *    the scope is not timed on the GPU.
+       */
+      [[nodiscard]] float getGpuMs(const QString & path) const;
+
+      /**
+       * @param path Path of a scope, such as "Paint".
+       * @return GPU milliseconds of the latest frame with results, without
+       *    averaging, or a negative value if not known yet.
+       */
+      [[nodiscard]] float getLastGpuMs(const QString & path) const;
+
+      /**
+       * @return Incremented each time new averages are published.
+       */
+      [[nodiscard]] inline uint64_t getRevision() const
+      {
+        return mRevision.load(std::memory_order_relaxed);
+      }
+
+      /**
+       * @return One line per scope with its averages, indented by depth.
+       */
+      [[nodiscard]] QString toString() const;
+
+      /** Frames averaged for each call to `getStats()`. */
+      static constexpr int kAverageFrames = 60;
+
+    private:
+      /*************************************************************************
+       * Private Types
+       ************************************************************************/
+
+      struct Node {
+          const char * mName {};
+          uint32_t mParent {};
+          int mDepth {};
+          QString mPath {};
+          /* Totals since averages were last published. */
+          int64_t mCpuNs {};
+          int64_t mGpuNs {};
+          uint32_t mCalls {};
+          bool mGpuTimed = false;
+          /* GPU time of frame mGpuFrame so far, and of the frame before. */
+          uint64_t mGpuFrame {};
+          int64_t mFrameGpuNs {};
+          int64_t mLastGpuNs = -1;
+      };
+
+      struct GpuQuery {
+          GLuint mQuery {};
+          uint32_t mNode {};
+          uint64_t mFrame {};
+      };
+
+      /*************************************************************************
+       * Private Methods
+       ************************************************************************/
+
+      /**
+       * @return Index of the named child of a node, created if needed.
+       *    mMutex must be locked.
+       */
+      uint32_t getChild(uint32_t parent, const char * name);
+
+      /**
+       * Start timing a scope on the GPU.
+       *
+       * @return False if the current context is not timed.
+       */
+      bool beginGpu(uint32_t node);
+
+      void endGpu();
+
+      /**
+       * Start a query attributed to a node, unless every query in the ring
+       * is still waiting for its result.
+       */
+      void beginQuery(uint32_t node);
+
+      void endQuery();
+
+      /**
+       * Read finished queries, oldest first, stopping at the first result
+       * not yet available.
+       */
+      void readQueries();
+
+      /**
+       * @return Published stats for a path, or Q_NULLPTR. mMutex must be
+       *    locked.
+       */
+      [[nodiscard]] const Stats * findStats(const QString & path) const;
+
+      /*************************************************************************
+       * Private Members
+       ************************************************************************/
+
+      static constexpr uint32_t kRoot = 0;
+      static constexpr size_t kMaxQueries = 256;
+
+      mutable QMutex mMutex;
+      std::vector<Node> mNodes {};
+      /* Child node of each (parent, name), compared by the name's text. */
+      std::map<std::pair<uint32_t, std::string_view>, uint32_t> mChildren {};
+      int mFrames = 0;
+      std::atomic<uint64_t> mFrame {0};
+      std::vector<Stats> mStats {};
+      std::atomic<uint64_t> mRevision {0};
+
+      /* Only used on the thread of mQueryContext. */
+      QOpenGLContext * mQueryContext {};
+      QMetaObject::Connection mContextDestroyed {};
+      std::array<GpuQuery, kMaxQueries> mQueries {};
+      /* Oldest query waiting for a result, and the next query to issue. */
+      size_t mQueryHead = 0;
+      size_t mQueryTail = 0;
+      bool mQueryOpen = false;
+      /* Nodes of the GPU scopes open, innermost last. */
+      std::vector<uint32_t> mGpuScopes {};
+  };
+}  // namespace Qtk
+
+#endif  // QTK_FRAMEPROFILER_H
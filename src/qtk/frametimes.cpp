@@ -0,0 +1,235 @@
+/*##############################################################################
+## Author: Shaun Reed                                                         ##
+## Legal: All Content (c) 2025 Shaun Reed, all rights reserved                ##
+## About: Frame time histograms with a log of slow frames and their causes    ##
+##                                                                            ##
+## Contact: shaunrd0@gmail.com  | URL: www.shaunreed.com | GitHub: shaunrd0   ##
+##############################################################################*/
+
+#include <QDebug>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+#include <algorithm>
+#include <cmath>
+
+#include "frametimes.h"
+
+using namespace Qtk;
+
+/*******************************************************************************
+ * Static Helpers
+ ******************************************************************************/
+
+/** Percentiles reported by toString() and save(). */
+static constexpr float kPercentiles[] = {50.0f, 95.0f, 99.0f};
+
+/**
+ * @param histogram Histogram to summarize.
+ * @return Percentiles and the maximum of the histogram, keyed by name.
+ */
+static QJsonObject histogramToJson(const FrameTimes::Histogram & histogram)
+{
+  QJsonObject json;
+  json["frames"] = qint64(histogram.getCount());
+  for (auto percentile : kPercentiles) {
+    json[QString("p%1").arg(percentile)] =
+        histogram.getPercentile(percentile);
+  }
+  json["max"] = histogram.getMax();
+  return json;
+}
+
+/*******************************************************************************
+ * Histogram
+ ******************************************************************************/
+
+void FrameTimes::Histogram::record(float ms)
+{
+  auto bucket = static_cast<size_t>(std::max(ms, 0.0f) / kBucketMs);
+  ++mBuckets[std::min(bucket, mBuckets.size() - 1)];
+  ++mCount;
+  mMax = std::max(mMax, ms);
+}
+
+void FrameTimes::Histogram::clear()
+{
+  mBuckets.fill(0);
+  mCount = 0;
+  mMax = 0.0f;
+}
+
+float FrameTimes::Histogram::getPercentile(float percentile) const
+{
+  if (mCount == 0) {
+    return 0.0f;
+  }
+  auto target = static_cast<uint64_t>(
+      std::ceil(double(mCount) * std::clamp(percentile, 0.0f, 100.0f) / 100.0));
+  target = std::max<uint64_t>(target, 1);
+  uint64_t count = 0;
+  for (size_t i = 0; i < mBuckets.size(); i++) {
+    count += mBuckets[i];
+    if (count >= target) {
+      // Frames over kMaxMs share the last bucket, so cap it at the maximum.
+      return std::min(float(i + 1) * kBucketMs, mMax);
+    }
+  }
+  return mMax;
+}
+
+/*******************************************************************************
+ * Public Methods
+ ******************************************************************************/
+
+bool FrameTimes::record(float cpuMs, float gpuMs, uint32_t events)
+{
+  mCpu.record(cpuMs);
+  if (gpuMs >= 0.0f) {
+    mGpu.record(gpuMs);
+  }
+  auto frame = mFrames++;
+  if (std::max(cpuMs, gpuMs) < mHitchThresholdMs) {
+    return false;
+  }
+
+  if (mHitches.size() == kMaxHitches) {
+    mHitches.pop_front();
+  }
+  mHitches.push_back(
+      {frame, QDateTime::currentDateTime(), cpuMs, gpuMs, events});
+  return true;
+}
+
+void FrameTimes::clear()
+{
+  mCpu.clear();
+  mGpu.clear();
+  mHitches.clear();
+  mFrames = 0;
+}
+
+bool FrameTimes::save(const QString & path) const
+{
+  QFile file(path);
+  if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+    qDebug() << "[FrameTimes] Failed to open" << path << "for writing.";
+    return false;
+  }
+  auto data =
+      path.endsWith(".csv", Qt::CaseInsensitive) ? toCsv() : toJson();
+  if (file.write(data) != data.size()) {
+    qDebug() << "[FrameTimes] Failed to write" << path;
+    return false;
+  }
+  return true;
+}
+
+/*******************************************************************************
+ * Accessors
+ ******************************************************************************/
+
+QString FrameTimes::toString() const
+{
+  QString text;
+  auto line = [&text](const char * name, const Histogram & histogram) {
+    text += QString("%1").arg(name);
+    for (auto percentile : kPercentiles) {
+      text += QString(" p%1 %2")
+                  .arg(percentile)
+                  .arg(histogram.getPercentile(percentile), 0, 'f', 2);
+    }
+    text += QString(" max %1 ms\n").arg(histogram.getMax(), 0, 'f', 2);
+  };
+  line("CPU", mCpu);
+  if (mGpu.getCount() > 0) {
+    line("GPU", mGpu);
+  }
+  text += QString("Hitches over %1 ms: %2")
+              .arg(mHitchThresholdMs, 0, 'f', 1)
+              .arg(mHitches.size());
+  return text;
+}
+
+QStringList FrameTimes::getEventNames(uint32_t events)
+{
+  QStringList names;
+  if (events & QTK_FRAME_MODEL_LOAD) {
+    names << "model load";
+  }
+  if (events & QTK_FRAME_SHADER_COMPILE) {
+    names << "shader compile";
+  }
+  if (events & QTK_FRAME_TEXTURE_UPLOAD) {
+    names << "texture upload";
+  }
+  if (events & QTK_FRAME_SCENE_CHANGE) {
+    names << "scene change";
+  }
+  if (events & QTK_FRAME_RESIZE) {
+    names << "resize";
+  }
+  return names;
+}
+
+/*******************************************************************************
+ * Private Methods
+ ******************************************************************************/
+
+QByteArray FrameTimes::toCsv() const
+{
+  // One row per hitch, after a row per histogram with its percentiles.
+  QByteArray csv = "record,frame,time,cpu_ms,gpu_ms,events\n";
+  auto summary = [&csv](const char * name, const Histogram & histogram) {
+    for (auto percentile : kPercentiles) {
+      csv += QString("%1_p%2,,,%3,,\n")
+                 .arg(name)
+                 .arg(percentile)
+                 .arg(histogram.getPercentile(percentile))
+                 .toUtf8();
+    }
+    csv += QString("%1_max,,,%2,,\n")
+               .arg(name)
+               .arg(histogram.getMax())
+               .toUtf8();
+  };
+  summary("cpu", mCpu);
+  summary("gpu", mGpu);
+  for (const auto & hitch : mHitches) {
+    csv += QString("hitch,%1,%2,%3,%4,%5\n")
+               .arg(hitch.mFrame)
+               .arg(hitch.mTime.toString(Qt::ISODateWithMs))
+               .arg(hitch.mCpuMs)
+               .arg(hitch.mGpuMs >= 0.0f ? QString::number(hitch.mGpuMs)
+                                         : QString())
+               .arg(getEventNames(hitch.mEvents).join(';'))
+               .toUtf8();
+  }
+  return csv;
+}
+
+QByteArray FrameTimes::toJson() const
+{
+  QJsonArray hitches;
+  for (const auto & hitch : mHitches) {
+    QJsonObject json;
+    json["frame"] = qint64(hitch.mFrame);
+    json["time"] = hitch.mTime.toString(Qt::ISODateWithMs);
+    json["cpuMs"] = hitch.mCpuMs;
+    if (hitch.mGpuMs >= 0.0f) {
+      json["gpuMs"] = hitch.mGpuMs;
+    }
+    json["events"] =
+        QJsonArray::fromStringList(getEventNames(hitch.mEvents));
+    hitches.append(json);
+  }
+
+  QJsonObject json;
+  json["hitchThresholdMs"] = mHitchThresholdMs;
+  json["cpu"] = histogramToJson(mCpu);
+  json["gpu"] = histogramToJson(mGpu);
+  json["hitches"] = hitches;
+  return QJsonDocument(json).toJson();
+}
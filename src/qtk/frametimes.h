@@ -0,0 +1,187 @@
+/*##############################################################################
+## Author: Shaun Reed                                                         ##
+## Legal: All Content (c) 2025 Shaun Reed, all rights reserved                ##
+## About: Frame time histograms with a log of slow frames and their causes    ##
+##                                                                            ##
+## Contact: shaunrd0@gmail.com  | URL: www.shaunreed.com | GitHub: shaunrd0   ##
+##############################################################################*/
+
+#ifndef QTK_FRAMETIMES_H
+#define QTK_FRAMETIMES_H
+
+#include <QDateTime>
+#include <QString>
+#include <QStringList>
+
+#include <array>
+#include <cstdint>
+#include <deque>
+
+#include "qtkapi.h"
+
+namespace Qtk
+{
+  /**
+   * Work done during a frame that commonly makes it slow. Combined as flags
+   * in FrameTimes::Hitch::mEvents.
+   */
+  enum FrameEvent {
+    QTK_FRAME_MODEL_LOAD = 1 << 0,
+    QTK_FRAME_SHADER_COMPILE = 1 << 1,
+    QTK_FRAME_TEXTURE_UPLOAD = 1 << 2,
+    QTK_FRAME_SCENE_CHANGE = 1 << 3,
+    QTK_FRAME_RESIZE = 1 << 4,
+  };
+
+  /**
+   * Records the CPU and GPU time of every frame into histograms, so
+   * percentiles show the spikes an average frame rate hides.
+   *
+   * Frames slower than the hitch threshold are also kept as Hitch records
+   * naming the FrameEvents of that frame. Percentiles and hitches can be
+   * saved as CSV or JSON to track frame times across releases.
+   */
+  class QTKAPI FrameTimes
+  {
+    public:
+      /*************************************************************************
+       * Typedefs
+       ************************************************************************/
+
+      /** A frame slower than the hitch threshold. */
+      struct Hitch {
+          /* Number of frames recorded before this one. */
+          uint64_t mFrame {};
+          QDateTime mTime {};
+          float mCpuMs {};
+          /* Negative if the GPU time is not known. */
+          float mGpuMs = -1.0f;
+          /* FrameEvent flags. */
+          uint32_t mEvents {};
+      };
+
+      /** Counts of frame times in buckets of kBucketMs. */
+      class QTKAPI Histogram
+      {
+        public:
+          void record(float ms);
+
+          void clear();
+
+          /**
+           * @param percentile Percent of frames, from 0 to 100.
+           * @return Time that the given percent of frames took at most,
+           *    rounded up to a bucket. 0 if nothing was recorded.
+           */
+          [[nodiscard]] float getPercentile(float percentile) const;
+
+          [[nodiscard]] inline float getMax() const { return mMax; }
+
+          [[nodiscard]] inline uint64_t getCount() const { return mCount; }
+
+          /** Width of each bucket in milliseconds. */
+          static constexpr float kBucketMs = 0.05f;
+          /** Frames slower than this are counted in the last bucket. */
+          static constexpr float kMaxMs = 250.0f;
+
+        private:
+          std::array<uint32_t, size_t(kMaxMs / kBucketMs)> mBuckets {};
+          uint64_t mCount = 0;
+          float mMax = 0.0f;
+      };
+
+      /*************************************************************************
+       * Public Methods
+       ************************************************************************/
+
+      /**
+       * Record the time of a frame.
+       *
+       * @param cpuMs CPU time of the frame in milliseconds.
+       * @param gpuMs GPU time of the frame, or a negative value if unknown.
+       * @param events FrameEvent flags for work done during the frame.
+       * @return True if the frame was recorded as a hitch.
+       */
+      bool record(float cpuMs, float gpuMs, uint32_t events);
+
+      /**
+       * Forget all recorded frames and hitches.
+       */
+      void clear();
+
+      /**
+       * Save percentiles and hitches to a file, as CSV if the file name
+       * ends in .csv and as JSON otherwise.
+       *
+       * @param path File to write.
+       * @return False if the file could not be written.
+       */
+      bool save(const QString & path) const;
+
+      /*************************************************************************
+       * Accessors
+       ************************************************************************/
+
+      [[nodiscard]] inline const Histogram & getCpu() const { return mCpu; }
+
+      [[nodiscard]] inline const Histogram & getGpu() const { return mGpu; }
+
+      /**
+       * @return The last kMaxHitches hitches, oldest first.
+       */
+      [[nodiscard]] inline const std::deque<Hitch> & getHitches() const
+      {
+        return mHitches;
+      }
+
+      [[nodiscard]] inline float getHitchThreshold() const
+      {
+        return mHitchThresholdMs;
+      }
+
+      /**
+       * @return Percentiles of CPU and GPU time on one line each.
+       */
+      [[nodiscard]] QString toString() const;
+
+      /**
+       * @param events FrameEvent flags.
+       * @return Names of the events, such as "model load".
+       */
+      [[nodiscard]] static QStringList getEventNames(uint32_t events);
+
+      /*************************************************************************
+       * Setters
+       ************************************************************************/
+
+      /**
+       * @param ms Frames slower than this on the CPU or GPU are hitches.
+       */
+      inline void setHitchThreshold(float ms) { mHitchThresholdMs = ms; }
+
+      /** Hitches kept before the oldest are dropped. */
+      static constexpr size_t kMaxHitches = 1000;
+
+    private:
+      /*************************************************************************
+       * Private Methods
+       ************************************************************************/
+
+      [[nodiscard]] QByteArray toCsv() const;
+
+      [[nodiscard]] QByteArray toJson() const;
+
+      /*************************************************************************
+       * Private Members
+       ************************************************************************/
+
+      Histogram mCpu;
+      Histogram mGpu;
+      std::deque<Hitch> mHitches {};
+      uint64_t mFrames = 0;
+      /* Two frames at 60Hz. */
+      float mHitchThresholdMs = 33.3f;
+  };
+}  // namespace Qtk
+
+#endif  // QTK_FRAMETIMES_H
@@ -0,0 +1,370 @@
+/*##############################################################################
+## Author: Shaun Reed                                                         ##
+## Legal: All Content (c) 2025 Shaun Reed, all rights reserved                ##
+## About: Sub-allocator for OpenGL buffer memory                              ##
+##                                                                            ##
+## Contact: shaunrd0@gmail.com  | URL: www.shaunreed.com | GitHub: shaunrd0   ##
+##############################################################################*/
+
+#include <algorithm>
+
+#include "gpuallocator.h"
+#include "renderstats.h"
+
+using namespace Qtk;
+
+QHash<QOpenGLContextGroup *, GpuAllocator *> GpuAllocator::sAllocators;
+QMutex GpuAllocator::sAllocatorsMutex;
+
+/*******************************************************************************
+ * Constructors / Destructors
+ ******************************************************************************/
+
+GpuAllocator::GpuAllocator()
+{
+  initializeOpenGLFunctions();
+}
+
+/*******************************************************************************
+ * Public Methods
+ ******************************************************************************/
+
+GpuHandle GpuAllocator::allocate(GpuCategory category,
+                                 GLsizeiptr size,
+                                 GLsizei granule)
+{
+  granule = std::max(granule, 1);
+  auto blockSize = getSizeClass(size, granule);
+  QMutexLocker lock(&mMutex);
+  auto [heap, offset] = reserve(category, blockSize, granule);
+
+  uint32_t index;
+  if (!mFreeBlocks.empty()) {
+    index = mFreeBlocks.back();
+    mFreeBlocks.pop_back();
+  } else {
+    index = mBlocks.size();
+    mBlocks.emplace_back();
+  }
+
+  auto & block = mBlocks[index];
+  block.mHeap = heap;
+  block.mOffset = offset;
+  block.mSize = blockSize;
+  block.mRequested = size;
+  block.mLive = true;
+  // Generations start at 1 so a default constructed handle is never valid.
+  ++block.mGeneration;
+
+  mLive[category] += blockSize;
+  mPeak[category] = std::max(mPeak[category], mLive[category]);
+  return {this, index, block.mGeneration};
+}
+
+bool GpuAllocator::write(const GpuHandle & handle,
+                         const void * data,
+                         GLsizeiptr size,
+                         GLintptr offset)
+{
+  QMutexLocker lock(&mMutex);
+  auto block = getBlock(handle);
+  if (block == nullptr || offset + size > block->mSize) {
+    qDebug() << "[GpuAllocator] Invalid write of " << size << " bytes.";
+    return false;
+  }
+
+  // Copy targets are never used for drawing, so writing through them leaves
+  // any bound VAO untouched.
+  glBindBuffer(GL_COPY_WRITE_BUFFER, mHeaps[block->mHeap].mBuffer);
+  glBufferSubData(GL_COPY_WRITE_BUFFER, block->mOffset + offset, size, data);
+  glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+  QTK_RENDER_STAT(mBufferBytes, size);
+  return true;
+}
+
+void GpuAllocator::free(GpuHandle & handle)
+{
+  auto allocator = handle.mAllocator;
+  if (allocator == nullptr) {
+    return;
+  }
+  // Objects may be destroyed on any thread while another collects.
+  QMutexLocker lock(&allocator->mMutex);
+  if (allocator->getBlock(handle) == nullptr) {
+    handle = {};
+    return;
+  }
+
+  auto & block = allocator->mBlocks[handle.mIndex];
+  auto & heap = allocator->mHeaps[block.mHeap];
+  block.mLive = false;
+  // Invalidate all copies of this handle.
+  ++block.mGeneration;
+  allocator->mFreeBlocks.push_back(handle.mIndex);
+
+  heap.mLive -= block.mSize;
+  allocator->mLive[heap.mCategory] -= block.mSize;
+  if (!heap.mEvacuating) {
+    if (block.mOffset + block.mSize == heap.mTop) {
+      heap.mTop = block.mOffset;
+    } else {
+      heap.mFree[block.mSize].push_back(block.mOffset);
+    }
+  }
+  handle = {};
+}
+
+void GpuAllocator::collect(GLsizeiptr budget)
+{
+  QMutexLocker lock(&mMutex);
+  // Return heaps with no live allocations to the driver.
+  for (auto & heap : mHeaps) {
+    if (heap.mBuffer != 0 && heap.mLive == 0) {
+      glDeleteBuffers(1, &heap.mBuffer);
+      heap = Heap();
+    }
+  }
+
+  // Find a heap to evacuate if we are not already working on one.
+  // A heap qualifies when over half of its used region is free blocks.
+  auto evacuating = std::find_if(mHeaps.begin(),
+                                 mHeaps.end(),
+                                 [](const Heap & h) { return h.mEvacuating; });
+  if (evacuating == mHeaps.end()) {
+    for (auto it = mHeaps.begin(); it != mHeaps.end(); ++it) {
+      GLsizeiptr holes = it->mTop - it->mLive;
+      if (it->mBuffer != 0 && holes * 2 > it->mTop
+          && holes >= budget) {
+        it->mEvacuating = true;
+        it->mFree.clear();
+        evacuating = it;
+        break;
+      }
+    }
+  }
+  if (evacuating == mHeaps.end()) {
+    return;
+  }
+
+  // Move live blocks out of the evacuating heap. New space is packed at the
+  // top of other heaps, so holes are not carried over.
+  uint32_t source = std::distance(mHeaps.begin(), evacuating);
+  GLsizeiptr moved = 0;
+  for (auto & block : mBlocks) {
+    if (moved >= budget) {
+      break;
+    }
+    if (!block.mLive || block.mHeap != source) {
+      continue;
+    }
+
+    auto [heap, offset] = reserve(
+        mHeaps[source].mCategory, block.mSize, mHeaps[source].mGranule);
+    glBindBuffer(GL_COPY_READ_BUFFER, mHeaps[source].mBuffer);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, mHeaps[heap].mBuffer);
+    glCopyBufferSubData(GL_COPY_READ_BUFFER,
+                        GL_COPY_WRITE_BUFFER,
+                        block.mOffset,
+                        offset,
+                        block.mRequested);
+    mHeaps[source].mLive -= block.mSize;
+    block.mHeap = heap;
+    block.mOffset = offset;
+    moved += block.mSize;
+  }
+  glBindBuffer(GL_COPY_READ_BUFFER, 0);
+  glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+  if (moved > 0) {
+    mEpoch.fetch_add(1, std::memory_order_release);
+  }
+}
+
+/*******************************************************************************
+ * Accessors
+ ******************************************************************************/
+
+GpuAllocator & GpuAllocator::getInstance()
+{
+  auto context = QOpenGLContext::currentContext();
+  if (context == Q_NULLPTR) {
+    qFatal("[GpuAllocator] getInstance() requires a current OpenGL context.");
+  }
+  auto group = context->shareGroup();
+  QMutexLocker lock(&sAllocatorsMutex);
+  auto it = sAllocators.find(group);
+  if (it == sAllocators.end()) {
+    it = sAllocators.insert(group, new GpuAllocator);
+    // The allocator itself is kept alive so objects that outlive the context
+    // can still free their handles. Buffers are destroyed with the group.
+    QObject::connect(group, &QObject::destroyed, [group]() {
+      QMutexLocker lock(&sAllocatorsMutex);
+      sAllocators.remove(group);
+    });
+  }
+  return **it;
+}
+
+bool GpuAllocator::isValid(const GpuHandle & handle)
+{
+  if (handle.mAllocator == nullptr) {
+    return false;
+  }
+  QMutexLocker lock(&handle.mAllocator->mMutex);
+  return handle.mAllocator->getBlock(handle) != nullptr;
+}
+
+GLuint GpuAllocator::getBuffer(const GpuHandle & handle) const
+{
+  QMutexLocker lock(&mMutex);
+  auto block = getBlock(handle);
+  return block == nullptr ? 0 : mHeaps[block->mHeap].mBuffer;
+}
+
+GLintptr GpuAllocator::getOffset(const GpuHandle & handle) const
+{
+  QMutexLocker lock(&mMutex);
+  auto block = getBlock(handle);
+  return block == nullptr ? 0 : block->mOffset;
+}
+
+GLsizeiptr GpuAllocator::getSize(const GpuHandle & handle) const
+{
+  QMutexLocker lock(&mMutex);
+  auto block = getBlock(handle);
+  return block == nullptr ? 0 : block->mSize;
+}
+
+GpuAllocator::Stats GpuAllocator::getStats(GpuCategory category) const
+{
+  QMutexLocker lock(&mMutex);
+  Stats stats;
+  stats.mLiveBytes = mLive[category];
+  stats.mPeakBytes = mPeak[category];
+
+  for (const auto & heap : mHeaps) {
+    if (heap.mBuffer == 0 || heap.mCategory != category) {
+      continue;
+    }
+    ++stats.mHeaps;
+    stats.mReservedBytes += heap.mCapacity;
+    for (const auto & [size, offsets] : heap.mFree) {
+      stats.mFragmentedBytes += size * offsets.size();
+    }
+  }
+
+  for (const auto & block : mBlocks) {
+    if (block.mLive && mHeaps[block.mHeap].mCategory == category) {
+      ++stats.mAllocations;
+      stats.mFragmentedBytes += block.mSize - block.mRequested;
+    }
+  }
+  return stats;
+}
+
+const char * GpuAllocator::getCategoryName(GpuCategory category)
+{
+  switch (category) {
+    case QTK_GPU_VERTEX:
+      return "Vertex";
+    case QTK_GPU_INDEX:
+      return "Index";
+    case QTK_GPU_ATTRIBUTE:
+      return "Attribute";
+    case QTK_GPU_BATCH:
+      return "Static Batch";
+    default:
+      return "Unknown";
+  }
+}
+
+/*******************************************************************************
+ * Private Methods
+ ******************************************************************************/
+
+GLsizeiptr GpuAllocator::getSizeClass(GLsizeiptr size, GLsizei granule)
+{
+  GLsizeiptr sizeClass = 64;
+  if (size > sizeClass) {
+    GLsizeiptr power = sizeClass;
+    while (power * 2 <= size) {
+      power *= 2;
+    }
+    GLsizeiptr step = power / 4;
+    sizeClass = (size + step - 1) / step * step;
+  }
+  return (sizeClass + granule - 1) / granule * granule;
+}
+
+std::pair<uint32_t, GLintptr> GpuAllocator::reserve(GpuCategory category,
+                                                    GLsizeiptr size,
+                                                    GLsizei granule)
+{
+  auto matches = [&](const Heap & heap) {
+    return heap.mBuffer != 0 && !heap.mEvacuating
+           && heap.mCategory == category && heap.mGranule == granule;
+  };
+
+  // Prefer reusing a freed block of the same size class.
+  for (uint32_t i = 0; i < mHeaps.size(); i++) {
+    auto & heap = mHeaps[i];
+    if (!matches(heap)) {
+      continue;
+    }
+    auto it = heap.mFree.find(size);
+    if (it != heap.mFree.end()) {
+      GLintptr offset = it->second.back();
+      it->second.pop_back();
+      if (it->second.empty()) {
+        heap.mFree.erase(it);
+      }
+      heap.mLive += size;
+      return {i, offset};
+    }
+  }
+
+  // Otherwise take space from the top of an existing heap.
+  for (uint32_t i = 0; i < mHeaps.size(); i++) {
+    auto & heap = mHeaps[i];
+    if (matches(heap) && heap.mTop + size <= heap.mCapacity) {
+      GLintptr offset = heap.mTop;
+      heap.mTop += size;
+      heap.mLive += size;
+      return {i, offset};
+    }
+  }
+
+  Heap heap;
+  heap.mCategory = category;
+  heap.mGranule = granule;
+  heap.mCapacity = std::max(kHeapSize / granule * granule, size);
+  heap.mTop = size;
+  heap.mLive = size;
+  glGenBuffers(1, &heap.mBuffer);
+  glBindBuffer(GL_COPY_WRITE_BUFFER, heap.mBuffer);
+  glBufferData(GL_COPY_WRITE_BUFFER, heap.mCapacity, nullptr, GL_DYNAMIC_DRAW);
+  glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+  auto unused = std::find_if(mHeaps.begin(),
+                             mHeaps.end(),
+                             [](const Heap & h) { return h.mBuffer == 0; });
+  if (unused != mHeaps.end()) {
+    *unused = std::move(heap);
+    return {static_cast<uint32_t>(std::distance(mHeaps.begin(), unused)), 0};
+  }
+  mHeaps.push_back(std::move(heap));
+  return {static_cast<uint32_t>(mHeaps.size() - 1), 0};
+}
+
+const GpuAllocator::Block * GpuAllocator::getBlock(
+    const GpuHandle & handle) const
+{
+  if (handle.mAllocator != this || handle.mIndex >= mBlocks.size()) {
+    return nullptr;
+  }
+  const auto & block = mBlocks[handle.mIndex];
+  if (!block.mLive || block.mGeneration != handle.mGeneration) {
+    return nullptr;
+  }
+  return &block;
+}
@@ -0,0 +1,280 @@
+/*##############################################################################
+## Author: Shaun Reed                                                         ##
+## Legal: All Content (c) 2025 Shaun Reed, all rights reserved                ##
+## About: Sub-allocator for OpenGL buffer memory                              ##
+##                                                                            ##
+## Contact: shaunrd0@gmail.com  | URL: www.shaunreed.com | GitHub: shaunrd0   ##
+##############################################################################*/
+
+#ifndef QTK_GPUALLOCATOR_H
+#define QTK_GPUALLOCATOR_H
+
+#include <QHash>
+#include <QMutex>
+#include <QOpenGLContext>
+#include <QOpenGLExtraFunctions>
+
+#include <atomic>
+#include <map>
+#include <vector>
+
+#include "qtkapi.h"
+
+namespace Qtk
+{
+  /**
+   * Categories used to account for GPU memory usage.
+   */
+  enum GpuCategory {
+    QTK_GPU_VERTEX,
+    QTK_GPU_INDEX,
+    QTK_GPU_ATTRIBUTE,
+    QTK_GPU_BATCH,
+    QTK_GPU_CATEGORY_COUNT
+  };
+
+  class GpuAllocator;
+
+  /**
+   * Handle to a sub-allocation within a GpuAllocator heap.
+   * Handles are plain values; copying a handle does not copy the allocation.
+   * A handle is invalidated when it is freed, so stale copies can be detected.
+   */
+  struct QTKAPI GpuHandle {
+      GpuAllocator * mAllocator {};
+      uint32_t mIndex {};
+      uint32_t mGeneration {};
+
+      [[nodiscard]] inline bool isNull() const { return mAllocator == nullptr; }
+  };
+
+  /**
+   * Sub-allocates OpenGL buffer memory out of large shared buffers (heaps).
+   *
+   * Allocations are rounded up to a size class and carved out of a heap
+   * shared with other allocations of the same category and granule. Freed
+   * blocks are reused by later allocations of the same size class. When a
+   * heap becomes sparse it is evacuated into other heaps a little at a time
+   * by `collect()`, and released to the driver once empty.
+   *
+   * The offset of every allocation is a multiple of its granule. Using the
+   * vertex stride as the granule allows offsets to be used as a base vertex.
+   *
+   * Allocations may move during `collect()`. Callers that cache buffer IDs or
+   * offsets (in a VAO for example) must compare `getEpoch()` before drawing.
+   *
+   * There is one allocator for each OpenGL context share group. Contexts in
+   * a group may draw on different threads, and handles may be freed on any
+   * thread, so every method locks the allocator.
+   */
+  class QTKAPI GpuAllocator : protected QOpenGLExtraFunctions
+  {
+    public:
+      /*************************************************************************
+       * Typedefs
+       ************************************************************************/
+
+      /** Memory usage for a single GpuCategory. */
+      struct Stats {
+          /* Bytes in use by live allocations, including size class padding. */
+          size_t mLiveBytes {};
+          /* Highest value mLiveBytes has reached. */
+          size_t mPeakBytes {};
+          /* Padding and free blocks that can't be used for new allocations. */
+          size_t mFragmentedBytes {};
+          /* Total size of all heaps owned by this category. */
+          size_t mReservedBytes {};
+          size_t mAllocations {};
+          size_t mHeaps {};
+      };
+
+      /*************************************************************************
+       * Public Methods
+       ************************************************************************/
+
+      /**
+       * Allocate GPU memory. Requires a current OpenGL context.
+       *
+       * @param category Category used to account for this allocation.
+       * @param size Size of the allocation in bytes.
+       * @param granule Alignment of the allocation offset in bytes.
+       * @return Handle to the new allocation.
+       */
+      GpuHandle allocate(GpuCategory category,
+                         GLsizeiptr size,
+                         GLsizei granule = 4);
+
+      /**
+       * Write data to an allocation. Requires a current OpenGL context.
+       * Buffer bindings for GL_ARRAY_BUFFER and GL_ELEMENT_ARRAY_BUFFER are not
+       * modified, so this is safe to call while a VAO is bound.
+       *
+       * @param handle The allocation to write to.
+       * @param data Pointer to the data to write.
+       * @param size Size of the data in bytes.
+       * @param offset Offset within the allocation to write the data.
+       * @return False if the handle was invalid or the data does not fit.
+       */
+      bool write(const GpuHandle & handle,
+                 const void * data,
+                 GLsizeiptr size,
+                 GLintptr offset = 0);
+
+      /**
+       * Free an allocation and reset the handle. Freed memory is reused by
+       * later allocations; no OpenGL calls are made, so this is safe to call
+       * without a current context.
+       *
+       * @param handle The allocation to free.
+       */
+      static void free(GpuHandle & handle);
+
+      /**
+       * Return heaps to the driver once empty and move a bounded number of
+       * bytes out of sparse heaps. Call once per frame with a current context.
+       *
+       * @param budget Maximum number of bytes to copy during this call.
+       */
+      void collect(GLsizeiptr budget = kCompactionBudget);
+
+      /*************************************************************************
+       * Accessors
+       ************************************************************************/
+
+      /**
+       * Requires a current OpenGL context; calling without one is fatal.
+       *
+       * @return The allocator for the current OpenGL context's share group.
+       */
+      static GpuAllocator & getInstance();
+
+      /**
+       * @param handle The allocation to check.
+       * @return True if the handle refers to a live allocation.
+       */
+      [[nodiscard]] static bool isValid(const GpuHandle & handle);
+
+      /**
+       * @return OpenGL buffer ID containing the allocation, or 0 if invalid.
+       */
+      [[nodiscard]] GLuint getBuffer(const GpuHandle & handle) const;
+
+      /**
+       * @return Byte offset of the allocation within its buffer.
+       */
+      [[nodiscard]] GLintptr getOffset(const GpuHandle & handle) const;
+
+      /**
+       * @return Usable size of the allocation in bytes.
+       */
+      [[nodiscard]] GLsizeiptr getSize(const GpuHandle & handle) const;
+
+      /**
+       * @return Counter incremented each time allocations are moved.
+       */
+      [[nodiscard]] inline uint64_t getEpoch() const
+      {
+        return mEpoch.load(std::memory_order_acquire);
+      }
+
+      /**
+       * @param category The category to report.
+       * @return Memory usage for the category.
+       */
+      [[nodiscard]] Stats getStats(GpuCategory category) const;
+
+      /**
+       * @return Human readable name for a GpuCategory.
+       */
+      [[nodiscard]] static const char * getCategoryName(GpuCategory category);
+
+      /*************************************************************************
+       * Public Members
+       ************************************************************************/
+
+      /* Default size of a new heap. Larger allocations get a dedicated heap. */
+      static constexpr GLsizeiptr kHeapSize = 4 * 1024 * 1024;
+      /* Default number of bytes moved per call to collect(). */
+      static constexpr GLsizeiptr kCompactionBudget = 256 * 1024;
+
+    private:
+      /*************************************************************************
+       * Private Types
+       ************************************************************************/
+
+      struct Block {
+          uint32_t mHeap {};
+          uint32_t mGeneration {};
+          GLintptr mOffset {};
+          /* Size of the block, rounded up to a size class. */
+          GLsizeiptr mSize {};
+          /* Size requested by the caller. */
+          GLsizeiptr mRequested {};
+          bool mLive = false;
+      };
+
+      struct Heap {
+          GLuint mBuffer {};
+          GpuCategory mCategory {};
+          GLsizei mGranule {};
+          GLsizeiptr mCapacity {};
+          /* End of the region that has ever been handed out. */
+          GLsizeiptr mTop {};
+          GLsizeiptr mLive {};
+          /* Free blocks below mTop, keyed by size class. */
+          std::map<GLsizeiptr, std::vector<GLintptr>> mFree {};
+          /* True while live blocks are being moved out of this heap. */
+          bool mEvacuating = false;
+      };
+
+      /*************************************************************************
+       * Private Methods
+       ************************************************************************/
+
+      GpuAllocator();
+
+      /**
+       * Round an allocation size up to its size class.
+       * Classes are spaced four to each power of two, so padding is at most
+       * 25% of the allocation.
+       */
+      static GLsizeiptr getSizeClass(GLsizeiptr size, GLsizei granule);
+
+      /**
+       * Find space for a block of the given size class, creating a new heap if
+       * needed.
+       *
+       * @return The heap index and offset of the block.
+       */
+      std::pair<uint32_t, GLintptr> reserve(GpuCategory category,
+                                            GLsizeiptr size,
+                                            GLsizei granule);
+
+      /**
+       * @return The live block of a handle, or nullptr. mMutex must be
+       *    locked.
+       */
+      [[nodiscard]] const Block * getBlock(const GpuHandle & handle) const;
+
+      /*************************************************************************
+       * Private Members
+       ************************************************************************/
+
+      /* Guards all members below but mEpoch. */
+      mutable QMutex mMutex;
+      std::vector<Block> mBlocks {};
+      /* Indices of unused entries in mBlocks. */
+      std::vector<uint32_t> mFreeBlocks {};
+      std::vector<Heap> mHeaps {};
+      /* Live and peak bytes for each category. */
+      size_t mLive[QTK_GPU_CATEGORY_COUNT] {};
+      size_t mPeak[QTK_GPU_CATEGORY_COUNT] {};
+      std::atomic<uint64_t> mEpoch {0};
+
+      static QHash<QOpenGLContextGroup *, GpuAllocator *> sAllocators;
+      /* Guards sAllocators; each share group may render on its own thread. */
+      static QMutex sAllocatorsMutex;
+  };
+}  // namespace Qtk
+
+#endif  // QTK_GPUALLOCATOR_H
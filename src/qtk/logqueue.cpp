@@ -0,0 +1,116 @@
+/*##############################################################################
+## Author: Shaun Reed                                                         ##
+## Legal: All Content (c) 2025 Shaun Reed, all rights reserved                ##
+## About: Lock-free queue of log messages from any thread                     ##
+##                                                                            ##
+## Contact: shaunrd0@gmail.com  | URL: www.shaunreed.com | GitHub: shaunrd0   ##
+##############################################################################*/
+
+#include <cstring>
+
+#include "logqueue.h"
+
+using namespace Qtk;
+
+/*******************************************************************************
+ * LogEntry
+ ******************************************************************************/
+
+bool LogEntry::isRepeatOf(const LogEntry & other) const
+{
+  if (mContext != other.mContext || mKey != other.mKey) {
+    return false;
+  }
+  if (mKey != 0) {
+    return true;
+  }
+  auto same = [](const char * a, const char * b) {
+    return a == b || (a != Q_NULLPTR && b != Q_NULLPTR && !std::strcmp(a, b));
+  };
+  return same(mSource, other.mSource) && same(mLabels[0], other.mLabels[0])
+         && same(mLabels[1], other.mLabels[1]) && mMessage == other.mMessage;
+}
+
+/*******************************************************************************
+ * Constructors / Destructors
+ ******************************************************************************/
+
+LogQueue::LogQueue(size_t capacity)
+{
+  size_t size = 2;
+  while (size < capacity) {
+    size <<= 1;
+  }
+  mMask = size - 1;
+  mSlots = std::make_unique<Slot[]>(size);
+  for (size_t i = 0; i < size; i++) {
+    mSlots[i].mSequence.store(i, std::memory_order_relaxed);
+  }
+}
+
+/*******************************************************************************
+ * Public Methods
+ ******************************************************************************/
+
+bool LogQueue::push(LogEntry entry)
+{
+  if (!isEnabled(entry.mContext)) {
+    return false;
+  }
+
+  // Claim the slot at the tail, unless it still holds an unread entry.
+  size_t position = mTail.load(std::memory_order_relaxed);
+  Slot * slot;
+  while (true) {
+    slot = &mSlots[position & mMask];
+    size_t sequence = slot->mSequence.load(std::memory_order_acquire);
+    auto difference =
+        static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+    if (difference == 0) {
+      if (mTail.compare_exchange_weak(
+              position, position + 1, std::memory_order_relaxed)) {
+        break;
+      }
+    } else if (difference < 0) {
+      mDropped.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    } else {
+      position = mTail.load(std::memory_order_relaxed);
+    }
+  }
+
+  slot->mEntry = std::move(entry);
+  slot->mSequence.store(position + 1, std::memory_order_release);
+  return true;
+}
+
+size_t LogQueue::drain(std::vector<LogEntry> & entries, size_t max)
+{
+  size_t count = 0;
+  while (count < max) {
+    Slot & slot = mSlots[mHead & mMask];
+    if (slot.mSequence.load(std::memory_order_acquire) != mHead + 1) {
+      break;
+    }
+    entries.push_back(std::move(slot.mEntry));
+    slot.mEntry = LogEntry();
+    // Hand the slot back to producers for the next lap around the ring.
+    slot.mSequence.store(mHead + mMask + 1, std::memory_order_release);
+    ++mHead;
+    ++count;
+  }
+  return count;
+}
+
+/*******************************************************************************
+ * Setters
+ ******************************************************************************/
+
+void LogQueue::setEnabled(DebugContext context, bool enabled)
+{
+  if (enabled) {
+    mEnabled.fetch_or(1u << context, std::memory_order_relaxed);
+  } else {
+    mEnabled.fetch_and(~(1u << context), std::memory_order_relaxed);
+  }
+}
@@ -0,0 +1,154 @@
+/*##############################################################################
+## Author: Shaun Reed                                                         ##
+## Legal: All Content (c) 2025 Shaun Reed, all rights reserved                ##
+## About: Lock-free queue of log messages from any thread                     ##
+##                                                                            ##
+## Contact: shaunrd0@gmail.com  | URL: www.shaunreed.com | GitHub: shaunrd0   ##
+##############################################################################*/
+
+#ifndef QTK_LOGQUEUE_H
+#define QTK_LOGQUEUE_H
+
+#include <QString>
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "qtkapi.h"
+
+namespace Qtk
+{
+  /**
+   * A log message as produced, before it is formatted for display.
+   *
+   * Producers only fill in these fields; prefixes, labels and repeat counts
+   * are formatted by the consumer, once per message actually shown.
+   */
+  struct QTKAPI LogEntry {
+      DebugContext mContext = Status;
+      /* Repeats of a message with the same nonzero key are collapsed. Entries
+       * with no key are collapsed if their text and labels match. */
+      uint64_t mKey = 0;
+      /* Static strings only, such as "OpenGL"; never freed. */
+      const char * mSource = Q_NULLPTR;
+      std::array<const char *, 2> mLabels {};
+      QString mMessage {};
+
+      /**
+       * @param other The entry logged before this one.
+       * @return True if this entry repeats the other.
+       */
+      [[nodiscard]] bool isRepeatOf(const LogEntry & other) const;
+  };
+
+  /**
+   * Bounded multi-producer, single-consumer queue of LogEntry.
+   *
+   * `push()` is lock-free and may be called from any thread. It never
+   * allocates; the message string is moved into a preallocated slot. When
+   * the queue is full the entry is dropped and counted instead of blocking
+   * the producer. Entries for disabled contexts are rejected before they are
+   * queued.
+   *
+   * `drain()` must only be called from one thread at a time.
+   */
+  class QTKAPI LogQueue
+  {
+    public:
+      /*************************************************************************
+       * Constructors / Destructors
+       ************************************************************************/
+
+      /**
+       * @param capacity Entries held before new ones are dropped. Rounded up
+       *    to a power of two.
+       */
+      explicit LogQueue(size_t capacity = 4096);
+
+      LogQueue(const LogQueue &) = delete;
+      LogQueue & operator=(const LogQueue &) = delete;
+
+      /*************************************************************************
+       * Public Methods
+       ************************************************************************/
+
+      /**
+       * Queue an entry. Thread safe.
+       *
+       * @param entry The entry to queue.
+       * @return True if queued; false if its context is disabled or the
+       *    queue is full.
+       */
+      bool push(LogEntry entry);
+
+      /**
+       * Move queued entries to the end of a list, oldest first.
+       *
+       * @param entries Receives the entries.
+       * @param max Most entries to move.
+       * @return Number of entries moved.
+       */
+      size_t drain(std::vector<LogEntry> & entries, size_t max);
+
+      /**
+       * @return Entries dropped because the queue was full since the last
+       *    call, resetting the count.
+       */
+      inline uint64_t takeDropped() { return mDropped.exchange(0); }
+
+      /*************************************************************************
+       * Setters
+       ************************************************************************/
+
+      /**
+       * Accept or reject entries for a context. Thread safe.
+       *
+       * @param context The context to change.
+       * @param enabled True to accept entries for the context.
+       */
+      void setEnabled(DebugContext context, bool enabled);
+
+      /*************************************************************************
+       * Accessors
+       ************************************************************************/
+
+      /**
+       * Check before building an entry to skip the work for a disabled
+       * context. Thread safe.
+       */
+      [[nodiscard]] inline bool isEnabled(DebugContext context) const
+      {
+        return mEnabled.load(std::memory_order_relaxed) & (1u << context);
+      }
+
+      [[nodiscard]] inline size_t getCapacity() const { return mMask + 1; }
+
+    private:
+      /*************************************************************************
+       * Private Members
+       ************************************************************************/
+
+      /* The sequence of a slot equals the position that may write it next,
+       * and that position plus one once written and ready to read. */
+      struct Slot {
+          std::atomic<size_t> mSequence;
+          LogEntry mEntry;
+      };
+
+      std::unique_ptr<Slot[]> mSlots;
+      size_t mMask;
+
+      /* Written by producers and the consumer; kept on separate cache lines
+       * so they do not contend. */
+      alignas(64) std::atomic<size_t> mTail {0};
+      alignas(64) size_t mHead = 0;
+
+      std::atomic<uint32_t> mEnabled {~0u};
+      std::atomic<uint64_t> mDropped {0};
+  };
+}  // namespace Qtk
+
+#endif  // QTK_LOGQUEUE_H
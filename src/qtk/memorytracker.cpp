@@ -0,0 +1,238 @@
+/*##############################################################################
+## Author: Shaun Reed                                                         ##
+## Legal: All Content (c) 2025 Shaun Reed, all rights reserved                ##
+## About: Live and peak memory of each subsystem and object                   ##
+##                                                                            ##
+## Contact: shaunrd0@gmail.com  | URL: www.shaunreed.com | GitHub: shaunrd0   ##
+##############################################################################*/
+
+#include <QOpenGLContext>
+#include <QOpenGLFunctions>
+
+#include <algorithm>
+
+#include "memorytracker.h"
+
+using namespace Qtk;
+
+/*******************************************************************************
+ * Static Helpers
+ ******************************************************************************/
+
+/** Query for the size of a linked program binary, from OpenGL 4.1 / ES 3.0. */
+static constexpr GLenum kProgramBinaryLength = 0x8741;
+
+/**
+ * @param format Texture format to measure.
+ * @return Bytes of a single texel; 4 for formats not listed.
+ */
+static uint64_t getTexelBytes(QOpenGLTexture::TextureFormat format)
+{
+  switch (format) {
+    case QOpenGLTexture::R8_UNorm:
+    case QOpenGLTexture::R8U:
+    case QOpenGLTexture::R8I:
+      return 1;
+    case QOpenGLTexture::RG8_UNorm:
+    case QOpenGLTexture::R16F:
+    case QOpenGLTexture::D16:
+      return 2;
+    case QOpenGLTexture::RGB8_UNorm:
+    case QOpenGLTexture::SRGB8:
+      return 3;
+    case QOpenGLTexture::RGB16F:
+      return 6;
+    case QOpenGLTexture::RGBA16F:
+    case QOpenGLTexture::RG32F:
+      return 8;
+    case QOpenGLTexture::RGB32F:
+      return 12;
+    case QOpenGLTexture::RGBA32F:
+      return 16;
+    default:
+      return 4;
+  }
+}
+
+/**
+ * @param usage Usage to update.
+ * @param live New live bytes, which may raise the peak.
+ */
+static void setLive(MemoryTracker::Usage & usage, uint64_t live)
+{
+  usage.mLive = live;
+  usage.mPeak = std::max(usage.mPeak, live);
+}
+
+/*******************************************************************************
+ * Public Methods
+ ******************************************************************************/
+
+MemoryTracker & MemoryTracker::getInstance()
+{
+  static MemoryTracker tracker;
+  return tracker;
+}
+
+void MemoryTracker::setUsage(const void * owner,
+                             MemoryCategory category,
+                             uint64_t bytes)
+{
+  QMutexLocker lock(&mMutex);
+  auto & usage = mOwners[owner];
+  auto & current = usage.mCategories[category];
+  auto & total = mCategories[category];
+  setLive(total, total.mLive - current.mLive + bytes);
+  setLive(current, bytes);
+
+  uint64_t ownerLive = 0, live = 0;
+  for (size_t i = 0; i < QTK_MEMORY_CATEGORY_COUNT; i++) {
+    ownerLive += usage.mCategories[i].mLive;
+    live += mCategories[i].mLive;
+  }
+  usage.mPeak = std::max(usage.mPeak, ownerLive);
+  mPeak = std::max(mPeak, live);
+}
+
+void MemoryTracker::release(const void * owner)
+{
+  QMutexLocker lock(&mMutex);
+  auto it = mOwners.find(owner);
+  if (it == mOwners.end()) {
+    return;
+  }
+  for (size_t i = 0; i < QTK_MEMORY_CATEGORY_COUNT; i++) {
+    mCategories[i].mLive -= it->second.mCategories[i].mLive;
+  }
+  mOwners.erase(it);
+}
+
+/*******************************************************************************
+ * Accessors
+ ******************************************************************************/
+
+MemoryTracker::Usage MemoryTracker::getUsage(MemoryCategory category) const
+{
+  QMutexLocker lock(&mMutex);
+  return mCategories[category];
+}
+
+MemoryTracker::Usage MemoryTracker::getUsage(const void * owner,
+                                             MemoryCategory category) const
+{
+  QMutexLocker lock(&mMutex);
+  auto it = mOwners.find(owner);
+  return it == mOwners.end() ? Usage {} : it->second.mCategories[category];
+}
+
+MemoryTracker::Usage MemoryTracker::getTotal(const void * owner) const
+{
+  QMutexLocker lock(&mMutex);
+  auto it = mOwners.find(owner);
+  if (it == mOwners.end()) {
+    return {};
+  }
+  Usage total {0, it->second.mPeak};
+  for (const auto & usage : it->second.mCategories) {
+    total.mLive += usage.mLive;
+  }
+  return total;
+}
+
+MemoryTracker::Usage MemoryTracker::getTotal() const
+{
+  QMutexLocker lock(&mMutex);
+  Usage total {0, mPeak};
+  for (const auto & usage : mCategories) {
+    total.mLive += usage.mLive;
+  }
+  return total;
+}
+
+QString MemoryTracker::toString() const
+{
+  QString text;
+  for (size_t i = 0; i < QTK_MEMORY_CATEGORY_COUNT; i++) {
+    auto usage = getUsage(static_cast<MemoryCategory>(i));
+    text += QString("%1: %2 (peak %3)\n")
+                .arg(getCategoryName(static_cast<MemoryCategory>(i)))
+                .arg(formatBytes(usage.mLive))
+                .arg(formatBytes(usage.mPeak));
+  }
+  auto total = getTotal();
+  text += QString("Total: %1 (peak %2)")
+              .arg(formatBytes(total.mLive))
+              .arg(formatBytes(total.mPeak));
+  return text;
+}
+
+const char * MemoryTracker::getCategoryName(MemoryCategory category)
+{
+  switch (category) {
+    case QTK_MEMORY_MESH_CPU:
+      return "Mesh CPU";
+    case QTK_MEMORY_MESH_GPU:
+      return "Mesh GPU";
+    case QTK_MEMORY_TEXTURE_GPU:
+      return "Texture GPU";
+    case QTK_MEMORY_SHADER:
+      return "Shaders";
+    case QTK_MEMORY_SCENE_OBJECTS:
+      return "Scene objects";
+    case QTK_MEMORY_IMPORT_SCRATCH:
+      return "Import scratch";
+    default:
+      return "Unknown";
+  }
+}
+
+QString MemoryTracker::formatBytes(uint64_t bytes)
+{
+  if (bytes < 1024) {
+    return QString("%1 B").arg(bytes);
+  }
+  if (bytes < 1024 * 1024) {
+    return QString("%1 KB").arg(double(bytes) / 1024.0, 0, 'f', 1);
+  }
+  return QString("%1 MB").arg(double(bytes) / (1024.0 * 1024.0), 0, 'f', 2);
+}
+
+uint64_t MemoryTracker::getTextureBytes(const QOpenGLTexture & texture)
+{
+  if (!texture.isCreated()) {
+    return 0;
+  }
+  uint64_t texels = 0;
+  for (int level = 0; level < std::max(texture.mipLevels(), 1); level++) {
+    texels += uint64_t(std::max(texture.width() >> level, 1))
+              * std::max(texture.height() >> level, 1)
+              * std::max(texture.depth() >> level, 1);
+  }
+  return texels * std::max(texture.faces(), 1) * std::max(texture.layers(), 1)
+         * getTexelBytes(texture.format());
+}
+
+uint64_t MemoryTracker::getProgramBytes(const QOpenGLShaderProgram & program)
+{
+  auto context = QOpenGLContext::currentContext();
+  if (context != Q_NULLPTR && program.isLinked()) {
+    // Only query binaries where the driver is known to support it.
+    auto version = context->format().version();
+    bool binaries = context->isOpenGLES() ? version >= qMakePair(3, 0)
+                                          : version >= qMakePair(4, 1);
+    if (binaries) {
+      GLint length = 0;
+      context->functions()->glGetProgramiv(
+          program.programId(), kProgramBinaryLength, &length);
+      if (length > 0) {
+        return length;
+      }
+    }
+  }
+
+  uint64_t bytes = 0;
+  for (const auto * shader : program.shaders()) {
+    bytes += shader->sourceCode().size();
+  }
+  return bytes;
+}
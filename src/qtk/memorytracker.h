@@ -0,0 +1,184 @@
+/*##############################################################################
+## Author: Shaun Reed                                                         ##
+## Legal: All Content (c) 2025 Shaun Reed, all rights reserved                ##
+## About: Live and peak memory of each subsystem and object                   ##
+##                                                                            ##
+## Contact: shaunrd0@gmail.com  | URL: www.shaunreed.com | GitHub: shaunrd0   ##
+##############################################################################*/
+
+#ifndef QTK_MEMORYTRACKER_H
+#define QTK_MEMORYTRACKER_H
+
+#include <QMutex>
+#include <QOpenGLShaderProgram>
+#include <QOpenGLTexture>
+#include <QString>
+
+#include <array>
+#include <cstdint>
+#include <unordered_map>
+
+#include "qtkapi.h"
+
+namespace Qtk
+{
+  /**
+   * Subsystems that memory is reported for.
+   */
+  enum MemoryCategory {
+    /* Vertex and index data kept on the CPU after upload. */
+    QTK_MEMORY_MESH_CPU,
+    /* Vertex and index data in GpuAllocator buffers. */
+    QTK_MEMORY_MESH_GPU,
+    QTK_MEMORY_TEXTURE_GPU,
+    /* Linked shader program binaries. */
+    QTK_MEMORY_SHADER,
+    /* Object instances and their per-mesh bookkeeping. */
+    QTK_MEMORY_SCENE_OBJECTS,
+    /* Assimp scene data held while a model is imported. */
+    QTK_MEMORY_IMPORT_SCRATCH,
+    QTK_MEMORY_CATEGORY_COUNT
+  };
+
+  /**
+   * Keeps the live and peak bytes of each MemoryCategory, in total and for
+   * each owner, usually an Object.
+   *
+   * Owners report their current size in a category with `setUsage()` after
+   * each allocation or upload, instead of every allocation being hooked, so
+   * the numbers are estimates of what the owner holds. GPU sizes are
+   * computed from texture formats and buffer sizes, since OpenGL has no
+   * portable query for driver memory.
+   */
+  class QTKAPI MemoryTracker
+  {
+    public:
+      /*************************************************************************
+       * Typedefs
+       ************************************************************************/
+
+      struct Usage {
+          uint64_t mLive {};
+          uint64_t mPeak {};
+      };
+
+      /*************************************************************************
+       * Public Methods
+       ************************************************************************/
+
+      static MemoryTracker & getInstance();
+
+      /**
+       * Replace the bytes an owner holds in a category.
+       *
+       * @param owner Object or other owner of the memory.
+       * @param category Subsystem the memory belongs to.
+       * @param bytes Bytes the owner now holds in the category.
+       */
+      void setUsage(const void * owner,
+                    MemoryCategory category,
+                    uint64_t bytes);
+
+      /**
+       * Remove all usage of an owner, such as when an Object is destroyed.
+       * Peaks are kept in the category totals.
+       *
+       * @param owner Owner passed to `setUsage()`.
+       */
+      void release(const void * owner);
+
+      /*************************************************************************
+       * Accessors
+       ************************************************************************/
+
+      /**
+       * @param category Subsystem to get memory of.
+       * @return Bytes held by all owners in the category.
+       */
+      [[nodiscard]] Usage getUsage(MemoryCategory category) const;
+
+      /**
+       * @param owner Owner passed to `setUsage()`.
+       * @param category Subsystem to get memory of.
+       * @return Bytes held by the owner in the category.
+       */
+      [[nodiscard]] Usage getUsage(const void * owner,
+                                   MemoryCategory category) const;
+
+      /**
+       * @param owner Owner passed to `setUsage()`.
+       * @return Bytes held by the owner across all categories.
+       */
+      [[nodiscard]] Usage getTotal(const void * owner) const;
+
+      /**
+       * @return Bytes held across all categories.
+       */
+      [[nodiscard]] Usage getTotal() const;
+
+      /**
+       * @return Live and peak bytes of each category, one per line.
+       */
+      [[nodiscard]] QString toString() const;
+
+      /**
+       * @param category Category to name.
+       * @return Name of the category, such as "Mesh GPU".
+       */
+      [[nodiscard]] static const char * getCategoryName(
+          MemoryCategory category);
+
+      /**
+       * @param bytes Size to format.
+       * @return Size in B, KB or MB for display.
+       */
+      [[nodiscard]] static QString formatBytes(uint64_t bytes);
+
+      /**
+       * @param texture Created texture to measure.
+       * @return Estimated bytes of all faces, layers and mip levels.
+       */
+      [[nodiscard]] static uint64_t getTextureBytes(
+          const QOpenGLTexture & texture);
+
+      /**
+       * Requires the context the program was linked in to be current.
+       *
+       * @param program Linked shader program to measure.
+       * @return Size of the program binary, or of its sources if the driver
+       *    doesn't report binaries.
+       */
+      [[nodiscard]] static uint64_t getProgramBytes(
+          const QOpenGLShaderProgram & program);
+
+    private:
+      /*************************************************************************
+       * Private Types
+       ************************************************************************/
+
+      typedef std::array<Usage, QTK_MEMORY_CATEGORY_COUNT> Categories;
+
+      struct Owner {
+          Categories mCategories {};
+          /* Peak of the sum of all categories. */
+          uint64_t mPeak {};
+      };
+
+      /*************************************************************************
+       * Constructors / Destructors
+       ************************************************************************/
+
+      MemoryTracker() = default;
+
+      /*************************************************************************
+       * Private Members
+       ************************************************************************/
+
+      mutable QMutex mMutex;
+      Categories mCategories {};
+      uint64_t mPeak {};
+      std::unordered_map<const void *, Owner> mOwners {};
+  };
+}  // namespace Qtk
+
+#endif  // QTK_MEMORYTRACKER_H
@@ -7,16 +7,24 @@
 ##############################################################################*/
 
 #include <QImageReader>
+#include <QOpenGLExtraFunctions>
 
+#include <algorithm>
+
+#include "gpuallocator.h"
+#include "memorytracker.h"
 #include "meshrenderer.h"
+#include "renderstats.h"
 #include "scene.h"
 #include "shaders.h"
 #include "texture.h"
+#include "tracer.h"
 
 using namespace Qtk;
 
 // Static QHash that holds all MeshRenderer instances using their mName as keys
 Qtk::MeshRenderer::MeshManager Qtk::MeshRenderer::sInstances;
+QMutex Qtk::MeshRenderer::sInstancesMutex;
 
 /*******************************************************************************
  * Constructors / Destructors
@@ -40,12 +48,20 @@ MeshRenderer::MeshRenderer(const char * name, const ShapeBase & shape) :
 {
   mShape = Shape(shape);
   init();
+  QMutexLocker lock(&sInstancesMutex);
   sInstances.insert(name, this);
 }
 
 MeshRenderer::~MeshRenderer()
 {
-  sInstances.remove(mName);
+  {
+    QMutexLocker lock(&sInstancesMutex);
+    sInstances.remove(mName, this);
+  }
+  GpuAllocator::free(mVertexAllocation);
+  GpuAllocator::free(mIndexAllocation);
+  GpuAllocator::free(mAttributeAllocation);
+  delete mInstancedProgram;
 }
 
 /*******************************************************************************
@@ -54,135 +70,205 @@ MeshRenderer::~MeshRenderer()
 
 void MeshRenderer::init()
 {
-  if (mVAO.isCreated()) {
-    mVAO.destroy();
-  }
+  mVAO.destroy();
   if (mProgram.isLinked()) {
     mProgram.removeAllShaders();
   }
-  if (mVBO.isCreated()) {
-    mVBO.destroy();
+  // Attribute location 1 is reset to use vertex colors.
+  GpuAllocator::free(mAttributeAllocation);
+
+  {
+    Tracer::Span link("Shader Link", "shader");
+    QTK_RENDER_STAT(mShaderLinks, 1);
+    mProgram.create();
+    // If no shader is provided, use a default one.
+    if (mVertexShader.empty()) {
+      mProgram.addShaderFromSourceCode(QOpenGLShader::Vertex,
+                                       QTK_SHADER_VERTEX_MESH);
+    } else {
+      mProgram.addShaderFromSourceFile(QOpenGLShader::Vertex,
+                                       mVertexShader.c_str());
+    }
+
+    if (mFragmentShader.empty()) {
+      mProgram.addShaderFromSourceCode(QOpenGLShader::Fragment,
+                                       QTK_SHADER_FRAGMENT_MESH);
+    } else {
+      mProgram.addShaderFromSourceFile(QOpenGLShader::Fragment,
+                                       mFragmentShader.c_str());
+    }
+    mProgram.link();
   }
+  mProgram.bind();
 
-  mVAO.create();
-  mVAO.bind();
+  uploadVertices();
 
-  mProgram.create();
-  // If no shader is provided, use a default one.
-  if (mVertexShader.empty()) {
-    mProgram.addShaderFromSourceCode(QOpenGLShader::Vertex,
-                                     QTK_SHADER_VERTEX_MESH);
-  } else {
-    mProgram.addShaderFromSourceFile(QOpenGLShader::Vertex,
-                                     mVertexShader.c_str());
+  mProgram.release();
+  MemoryTracker::getInstance().setUsage(
+      this, QTK_MEMORY_SHADER, MemoryTracker::getProgramBytes(mProgram));
+}
+
+void MeshRenderer::draw()
+{
+  // Rebind attributes if the GpuAllocator moved our buffers.
+  if (auto allocator = mVertexAllocation.mAllocator;
+      allocator != nullptr && allocator->getEpoch() != mEpoch) {
+    mVAO.invalidate();
   }
 
-  if (mFragmentShader.empty()) {
-    mProgram.addShaderFromSourceCode(QOpenGLShader::Fragment,
-                                     QTK_SHADER_FRAGMENT_MESH);
-  } else {
-    mProgram.addShaderFromSourceFile(QOpenGLShader::Fragment,
-                                     mFragmentShader.c_str());
+  bindShaders();
+  if (mVAO.bind()) {
+    bindBuffers();
   }
-  mProgram.link();
-  mProgram.bind();
 
-  mVBO.create();
-  mVBO.setUsagePattern(QOpenGLBuffer::StaticDraw);
-  mVBO.bind();
+  mTexture.bind();
+
+  // TODO: Automate uniforms some other way
+  setUniformMVP();
+  QTK_RENDER_STAT(mUniformUploads, 3);
 
-  // Combine position and color data into one vector, allowing us to use one VBO
-  Vertices combined;
-  combined.reserve(getVertices().size() + getColors().size());
-  combined.insert(combined.end(), getVertices().begin(), getVertices().end());
-  combined.insert(combined.end(), getColors().begin(), getColors().end());
+  drawGeometry();
 
-  mVBO.allocate(combined.data(), combined.size() * sizeof(combined[0]));
+  mVAO.release();
+  releaseShaders();
+}
 
-  // Enable position attribute
-  mProgram.enableAttributeArray(0);
-  mProgram.setAttributeBuffer(0, GL_FLOAT, 0, 3, sizeof(QVector3D));
-  // Enable color attribute, setting offset to total size of vertices()
-  mProgram.enableAttributeArray(1);
-  mProgram.setAttributeBuffer(1,
-                              GL_FLOAT,
-                              getVertices().size() * sizeof(getVertices()[0]),
-                              3,
-                              sizeof(QVector3D));
+void MeshRenderer::draw(QOpenGLShaderProgram & shader)
+{
+  if (auto allocator = mVertexAllocation.mAllocator;
+      allocator != nullptr && allocator->getEpoch() != mEpoch) {
+    mVAO.invalidate();
+  }
 
-  mVBO.release();
+  if (mVAO.bind()) {
+    bindBuffers();
+  }
+  shader.bind();
+  shader.setUniformValue("uModel", mDrawMatrix);
+  shader.setUniformValue("uView", Scene::getDrawViewMatrix());
+  shader.setUniformValue("uProjection", Scene::getDrawProjectionMatrix());
+  QTK_RENDER_STAT(mProgramBinds, 1);
+  QTK_RENDER_STAT(mUniformUploads, 3);
 
-  mProgram.release();
+  drawGeometry();
+
+  shader.release();
   mVAO.release();
 }
 
-void MeshRenderer::draw()
+void MeshRenderer::draw(const GLfloat * matrices, size_t count)
 {
-  bindShaders();
-  mVAO.bind();
+  if (auto allocator = mVertexAllocation.mAllocator;
+      allocator != nullptr && allocator->getEpoch() != mEpoch) {
+    mVAO.invalidate();
+  }
 
+  bindShaders();
+  if (mVAO.bind()) {
+    bindBuffers();
+  }
   mTexture.bind();
 
-  // TODO: Automate uniforms some other way
-  setUniformMVP();
+  mProgram.setUniformValue("uProjection", Scene::getDrawProjectionMatrix());
+  mProgram.setUniformValue("uView", Scene::getDrawViewMatrix());
+  QTK_RENDER_STAT(mUniformUploads, 2 + count);
+  auto gl = QOpenGLContext::currentContext()->functions();
+  const int model = mProgram.uniformLocation("uModel");
+  for (size_t i = 0; i < count; i++) {
+    gl->glUniformMatrix4fv(model, 1, GL_FALSE, &matrices[i * 16]);
+    drawGeometry();
+  }
 
-  if (mShape.mDrawMode == QTK_DRAW_ARRAYS) {
-    glDrawArrays(mDrawType, 0, getVertices().size());
-  } else if (mShape.mDrawMode == QTK_DRAW_ELEMENTS
-             || mShape.mDrawMode == QTK_DRAW_ELEMENTS_NORMALS) {
-    glDrawElements(mDrawType,
-                   mShape.mIndices.size(),
-                   GL_UNSIGNED_INT,
-                   mShape.mIndices.data());
+  mVAO.release();
+  releaseShaders();
+}
+
+void MeshRenderer::drawInstanced(QOpenGLBuffer & instances,
+                                 GLintptr offset,
+                                 GLsizei count)
+{
+  if (mInstancedProgram == Q_NULLPTR) {
+    Tracer::Span link("Shader Link", "shader");
+    QTK_RENDER_STAT(mShaderLinks, 1);
+    mInstancedProgram = new QOpenGLShaderProgram;
+    mInstancedProgram->addShaderFromSourceCode(
+        QOpenGLShader::Vertex, QTK_SHADER_VERTEX_MESH_INSTANCED);
+    mInstancedProgram->addShaderFromSourceCode(QOpenGLShader::Fragment,
+                                               QTK_SHADER_FRAGMENT_MESH);
+    mInstancedProgram->link();
+  }
+  if (auto allocator = mVertexAllocation.mAllocator;
+      allocator != nullptr && allocator->getEpoch() != mEpoch) {
+    mVAO.invalidate();
   }
 
+  // Both programs use the same attribute locations, so the VAO is shared.
+  if (mVAO.bind()) {
+    bindBuffers();
+  }
+  mInstancedProgram->bind();
   mTexture.bind();
+  mInstancedProgram->setUniformValue("uProjection",
+                                     Scene::getDrawProjectionMatrix());
+  mInstancedProgram->setUniformValue("uView", Scene::getDrawViewMatrix());
+  QTK_RENDER_STAT(mProgramBinds, 1);
+  QTK_RENDER_STAT(mUniformUploads, 2);
+
+  // The range of the buffer drawn changes each frame, so the matrix
+  // attribute is pointed at it for each draw.
+  auto gl = QOpenGLContext::currentContext()->extraFunctions();
+  instances.bind();
+  for (GLuint column = 0; column < 4; column++) {
+    const GLuint location = kInstanceLocation + column;
+    gl->glEnableVertexAttribArray(location);
+    gl->glVertexAttribPointer(
+        location,
+        4,
+        GL_FLOAT,
+        GL_FALSE,
+        16 * sizeof(GLfloat),
+        reinterpret_cast<const void *>(offset + column * 4 * sizeof(GLfloat)));
+    gl->glVertexAttribDivisor(location, 1);
+  }
+  instances.release();
+
+  drawGeometry(count);
 
+  // Leave the VAO as draw() expects it.
+  for (GLuint column = 0; column < 4; column++) {
+    gl->glDisableVertexAttribArray(kInstanceLocation + column);
+  }
+  mInstancedProgram->release();
   mVAO.release();
-  releaseShaders();
 }
 
 void MeshRenderer::enableAttributeArray(int location)
 {
-  ShaderBindScope lock(&mProgram, mBound);
-  mVAO.bind();
-  mProgram.enableAttributeArray(location);
-  mVAO.release();
+  getAttribute(location).mEnabled = true;
+  // Each context enables the attribute the next time its VAO is bound.
+  mVAO.invalidate();
 }
 
 void MeshRenderer::reallocateTexCoords(const TexCoords & t, unsigned dims)
 {
-  mVAO.bind();
-  mNBO.destroy();
-  mNBO.create();
-  mNBO.bind();
-  mNBO.allocate(t.data(), t.size() * sizeof(t[0]));
-  enableAttributeArray(1);
-  if (dims == 2) {
-    setAttributeBuffer(1, GL_FLOAT, 0, 2, sizeof(QVector2D));
-  } else if (dims == 3) {
-    setAttributeBuffer(1, GL_FLOAT, 0, 3, sizeof(QVector3D));
-  }
-  mNBO.release();
-  mVAO.release();
+  reallocateAttribute(t.data(), t.size() * sizeof(t[0]), dims);
 }
 
 void MeshRenderer::reallocateNormals(const Normals & n, unsigned dims)
 {
-  // TODO: Store state to track if buffer objects are bound
-  mVAO.bind();
-  mNBO.destroy();
-  mNBO.create();
-  mNBO.bind();
-  mNBO.allocate(n.data(), n.size() * sizeof(n[0]));
-  enableAttributeArray(1);
-  if (dims == 2) {
-    setAttributeBuffer(1, GL_FLOAT, 0, 2, sizeof(QVector2D));
-  } else if (dims == 3) {
-    setAttributeBuffer(1, GL_FLOAT, 0, 3, sizeof(QVector3D));
-  }
-  mNBO.release();
-  mVAO.release();
+  reallocateAttribute(n.data(), n.size() * sizeof(n[0]), dims);
+}
+
+void MeshRenderer::setName(const QString & name)
+{
+  auto previous = mName;
+  Object::setName(name);
+  if (mName == previous) {
+    return;
+  }
+  QMutexLocker lock(&sInstancesMutex);
+  sInstances.remove(previous, this);
+  sInstances.insert(mName, this);
 }
 
 void MeshRenderer::setShaders(const std::string & vert,
@@ -198,9 +284,9 @@ void MeshRenderer::setUniformMVP(const char * model,
                                  const char * projection)
 {
   ShaderBindScope lock(&mProgram, mBound);
-  mProgram.setUniformValue(projection, Scene::getProjectionMatrix());
-  mProgram.setUniformValue(view, Scene::getViewMatrix());
-  mProgram.setUniformValue(model, mTransform.toMatrix());
+  mProgram.setUniformValue(projection, Scene::getDrawProjectionMatrix());
+  mProgram.setUniformValue(view, Scene::getDrawViewMatrix());
+  mProgram.setUniformValue(model, mDrawMatrix);
 }
 
 void MeshRenderer::setShape(const Shape & value)
@@ -220,17 +306,230 @@ void MeshRenderer::setColor(const QVector3D & color)
       mShape.mColors[i] = color;
     }
   }
-  // TODO: Factor this out so we don't need to reinitialize
-  init();
+  uploadVertices();
 }
 
 void MeshRenderer::setAttributeBuffer(
     int location, GLenum type, int offset, int tupleSize, int stride)
 {
+  auto & attribute = getAttribute(location);
+  attribute.mType = type;
+  attribute.mOffset = offset;
+  attribute.mTupleSize = tupleSize;
+  attribute.mStride = stride;
+  mVAO.invalidate();
+}
+
+void MeshRenderer::setTexture(const char * path, bool flipX, bool flipY)
+{
+  Object::setTexture(path, flipX, flipY);
+  updateMemoryUsage();
+}
+
+void MeshRenderer::setTexture(const Texture & t)
+{
+  Object::setTexture(t);
+  updateMemoryUsage();
+}
+
+void MeshRenderer::setCubeMap(const char * path)
+{
+  Object::setCubeMap(path);
+  updateMemoryUsage();
+}
+
+/*******************************************************************************
+ * Private Methods
+ ******************************************************************************/
+
+MeshRenderer::Attribute & MeshRenderer::getAttribute(int location)
+{
+  auto it = std::find_if(
+      mAttributes.begin(), mAttributes.end(), [location](const auto & a) {
+        return a.mLocation == location;
+      });
+  if (it != mAttributes.end()) {
+    return *it;
+  }
+  Attribute attribute;
+  attribute.mLocation = location;
+  return mAttributes.emplace_back(attribute);
+}
+
+void MeshRenderer::uploadVertices()
+{
+  // Combine position and color data into one vector, allowing us to use one
+  // allocation.
+  Vertices combined;
+  combined.reserve(getVertices().size() + getColors().size());
+  combined.insert(combined.end(), getVertices().begin(), getVertices().end());
+  combined.insert(combined.end(), getColors().begin(), getColors().end());
+  GLsizeiptr size = combined.size() * sizeof(combined[0]);
+
+  // Reuse the existing allocation if the new data fits.
+  auto & allocator = GpuAllocator::getInstance();
+  if (allocator.getSize(mVertexAllocation) < size) {
+    GpuAllocator::free(mVertexAllocation);
+    mVertexAllocation =
+        allocator.allocate(QTK_GPU_VERTEX, size, sizeof(QVector3D));
+  }
+  allocator.write(mVertexAllocation, combined.data(), size);
+
+  const auto & indices = mShape.mIndices;
+  GLsizeiptr indexSize = indices.size() * sizeof(GLuint);
+  if (indices.empty()) {
+    GpuAllocator::free(mIndexAllocation);
+  } else {
+    if (allocator.getSize(mIndexAllocation) < indexSize) {
+      GpuAllocator::free(mIndexAllocation);
+      mIndexAllocation =
+          allocator.allocate(QTK_GPU_INDEX, indexSize, sizeof(GLuint));
+    }
+    allocator.write(mIndexAllocation, indices.data(), indexSize);
+  }
+  // Attributes are pointed at the new data the next time the VAO is bound.
+  mVAO.invalidate();
+
+  mBounds = {};
+  for (const auto & vertex : getVertices()) {
+    mBounds.expand(vertex);
+  }
+  ++mBoundsRevision;
+
+  // Static batches hold a copy of this geometry and must be rebuilt.
+  if (mStatic) {
+    ++sStaticRevision;
+  }
+  updateMemoryUsage();
+}
+
+void MeshRenderer::reallocateAttribute(const void * data,
+                                       GLsizeiptr size,
+                                       unsigned dims)
+{
+  auto & allocator = GpuAllocator::getInstance();
+  if (allocator.getSize(mAttributeAllocation) < size) {
+    GpuAllocator::free(mAttributeAllocation);
+    mAttributeAllocation = allocator.allocate(
+        QTK_GPU_ATTRIBUTE, size, static_cast<GLsizei>(dims * sizeof(GLfloat)));
+  }
+  allocator.write(mAttributeAllocation, data, size);
+  mAttributeDims = dims;
+  mVAO.invalidate();
+  updateMemoryUsage();
+}
+
+void MeshRenderer::bindBuffers()
+{
+  auto & allocator = GpuAllocator::getInstance();
+  auto gl = QOpenGLContext::currentContext()->functions();
   ShaderBindScope lock(&mProgram, mBound);
-  mVAO.bind();
-  mProgram.setAttributeBuffer(location, type, offset, tupleSize, stride);
-  mVAO.release();
+
+  // Enable position attribute
+  GLintptr offset = allocator.getOffset(mVertexAllocation);
+  gl->glBindBuffer(GL_ARRAY_BUFFER, allocator.getBuffer(mVertexAllocation));
+  mProgram.enableAttributeArray(0);
+  mProgram.setAttributeBuffer(0, GL_FLOAT, offset, 3, sizeof(QVector3D));
+
+  // Location 1 uses reallocated normals or texture coordinates if provided.
+  // Otherwise it uses the color data that follows all vertices.
+  mProgram.enableAttributeArray(1);
+  if (GpuAllocator::isValid(mAttributeAllocation)) {
+    gl->glBindBuffer(GL_ARRAY_BUFFER,
+                     allocator.getBuffer(mAttributeAllocation));
+    mProgram.setAttributeBuffer(1,
+                                GL_FLOAT,
+                                allocator.getOffset(mAttributeAllocation),
+                                mAttributeDims,
+                                mAttributeDims * sizeof(GLfloat));
+  } else {
+    mProgram.setAttributeBuffer(
+        1,
+        GL_FLOAT,
+        offset + getVertices().size() * sizeof(getVertices()[0]),
+        3,
+        sizeof(QVector3D));
+  }
+
+  // Replay attributes set up by callers, which may replace the above.
+  gl->glBindBuffer(GL_ARRAY_BUFFER, allocator.getBuffer(mVertexAllocation));
+  for (const auto & attribute : mAttributes) {
+    if (attribute.mEnabled) {
+      mProgram.enableAttributeArray(attribute.mLocation);
+    }
+    if (attribute.mTupleSize > 0) {
+      mProgram.setAttributeBuffer(attribute.mLocation,
+                                  attribute.mType,
+                                  offset + attribute.mOffset,
+                                  attribute.mTupleSize,
+                                  attribute.mStride);
+    }
+  }
+
+  // The element buffer binding is stored in the VAO.
+  gl->glBindBuffer(GL_ELEMENT_ARRAY_BUFFER,
+                   allocator.getBuffer(mIndexAllocation));
+
+  gl->glBindBuffer(GL_ARRAY_BUFFER, 0);
+  mEpoch = allocator.getEpoch();
+}
+
+void MeshRenderer::drawGeometry(GLsizei instances)
+{
+  size_t count = 0;
+  if (mShape.mDrawMode == QTK_DRAW_ARRAYS) {
+    count = getVertices().size();
+    if (instances == 1) {
+      glDrawArrays(mDrawType, 0, count);
+    } else {
+      auto gl = QOpenGLContext::currentContext()->extraFunctions();
+      gl->glDrawArraysInstanced(mDrawType, 0, count, instances);
+    }
+  } else if (mShape.mDrawMode == QTK_DRAW_ELEMENTS
+             || mShape.mDrawMode == QTK_DRAW_ELEMENTS_NORMALS) {
+    count = mShape.mIndices.size();
+    // Indices are read from the element buffer bound in our VAO.
+    auto offset = reinterpret_cast<const void *>(
+        GpuAllocator::getInstance().getOffset(mIndexAllocation));
+    if (instances == 1) {
+      glDrawElements(mDrawType, count, GL_UNSIGNED_INT, offset);
+    } else {
+      auto gl = QOpenGLContext::currentContext()->extraFunctions();
+      gl->glDrawElementsInstanced(
+          mDrawType, count, GL_UNSIGNED_INT, offset, instances);
+    }
+  } else {
+    return;
+  }
+  QTK_RENDER_STAT(mDrawCalls, 1);
+  QTK_RENDER_STAT(
+      mTriangles,
+      RenderStats::countTriangles(mDrawType, count) * uint64_t(instances));
+}
+
+void MeshRenderer::updateMemoryUsage() const
+{
+  auto & allocator = GpuAllocator::getInstance();
+  auto & memory = MemoryTracker::getInstance();
+  memory.setUsage(
+      this,
+      QTK_MEMORY_MESH_CPU,
+      mShape.mVertices.capacity() * sizeof(QVector3D)
+          + mShape.mColors.capacity() * sizeof(QVector3D)
+          + mShape.mIndices.capacity() * sizeof(GLuint)
+          + mShape.mTexCoords.capacity() * sizeof(QVector2D)
+          + mShape.mNormals.capacity() * sizeof(QVector3D));
+  memory.setUsage(this,
+                  QTK_MEMORY_MESH_GPU,
+                  allocator.getSize(mVertexAllocation)
+                      + allocator.getSize(mIndexAllocation)
+                      + allocator.getSize(mAttributeAllocation));
+  memory.setUsage(this,
+                  QTK_MEMORY_TEXTURE_GPU,
+                  mTexture.hasTexture() ? MemoryTracker::getTextureBytes(
+                                              mTexture.getOpenGLTexture())
+                                        : 0);
+  memory.setUsage(this, QTK_MEMORY_SCENE_OBJECTS, sizeof(*this));
 }
 
 /*******************************************************************************
@@ -240,6 +539,7 @@ void MeshRenderer::setAttributeBuffer(
 // Static member function to retrieve instances of MeshRenderers
 MeshRenderer * MeshRenderer::getInstance(const QString & name)
 {
+  QMutexLocker lock(&sInstancesMutex);
   if (!sInstances.contains(name)) {
 #if QTK_DEBUG
     qDebug() << "Attempt to access MeshRenderer instance that does not exist! ("
@@ -247,5 +547,6 @@ MeshRenderer * MeshRenderer::getInstance(const QString & name)
 #endif
     return nullptr;
   }
-  return sInstances[name];
+  return sInstances.value(name);
 }
+
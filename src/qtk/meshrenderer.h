@@ -10,6 +10,9 @@
 
 #include <utility>
 
+#include <QMutex>
+
+#include "gpuallocator.h"
 #include "object.h"
 #include "qtkapi.h"
 #include "shape.h"
@@ -23,8 +26,11 @@ namespace Qtk
        * Typedefs
        ************************************************************************/
 
-      /** Static QHash of all mesh objects within the scene. */
-      typedef QHash<QString, MeshRenderer *> MeshManager;
+      /**
+       * Static QMultiHash of all mesh objects by name.
+       * Objects in different scenes may share a name.
+       */
+      typedef QMultiHash<QString, MeshRenderer *> MeshManager;
 
       /*************************************************************************
        * Constructors / Destructors
@@ -79,14 +85,48 @@ namespace Qtk
        */
       void draw();
 
+      /**
+       * Draws this MeshRenderer using a custom shader program.
+       * Only vertex positions at attribute location 0 are guaranteed to be
+       * bound, and the uModel, uView and uProjection uniforms are set.
+       *
+       * @param shader Shader program to use to draw the MeshRenderer.
+       */
+      void draw(QOpenGLShaderProgram & shader);
+
+      /**
+       * Draws this MeshRenderer once for each model matrix, binding its
+       * shaders and buffers only once. Used to draw Registry entities when
+       * the MeshRenderer can't be drawn instanced.
+       *
+       * @param matrices Column major model matrices, 16 floats each.
+       * @param count Number of matrices.
+       */
+      void draw(const GLfloat * matrices, size_t count);
+
+      /**
+       * Draws an instance of this MeshRenderer for each model matrix in a
+       * buffer with a single draw call. Used to draw Registry entities.
+       * Requires `supportsInstancing()`.
+       *
+       * @param instances Buffer of column major model matrices.
+       * @param offset Offset of the first matrix in the buffer, in bytes.
+       * @param count Number of matrices.
+       */
+      void drawInstanced(QOpenGLBuffer & instances,
+                         GLintptr offset,
+                         GLsizei count);
+
       /**
        * Enables shader attribute array from the MeshRenderer's VAO.
+       * The attribute is kept and enabled again whenever the VAO is set up,
+       * such as in another context or after buffers move.
        * @param location Index location of the attribute array to enable.
        */
       void enableAttributeArray(int location);
 
       /**
-       * Reallocates texture coordinates to the mNBO member object.
+       * Reallocates texture coordinates to attribute location 1.
        *
        * @param t Texture coordinates to reallocate.
        * @param dims Number of dimensions to use for the coordinates.
@@ -94,7 +134,7 @@ namespace Qtk
       void reallocateTexCoords(const TexCoords & t, unsigned dims = 2);
 
       /**
-       * Reallocates normals to the mNBO member object.
+       * Reallocates normals to attribute location 1.
        *
        * @param n Normal coordinate to reallocate.
        * @param dims Number of dimensions to use for the coordinates.
@@ -105,6 +145,13 @@ namespace Qtk
        * Setters
        ************************************************************************/
 
+      /**
+       * Renames this MeshRenderer and updates its MeshManager entry.
+       *
+       * @param name The new name for this MeshRenderer.
+       */
+      void setName(const QString & name) override;
+
       /**
        * Set OpenGL draw type. GL_TRIANGLES, GL_POINTS, GL_LINES, etc.
        *
@@ -187,13 +234,14 @@ namespace Qtk
       void setColor(const QVector3D & color);
 
       /**
-       * Updates an attribute buffer. This should be called whenever related
-       * buffers are reallocated. If the new buffer uses an identical format
-       * this may not be required.
+       * Points an attribute at the vertex data of this MeshRenderer:
+       * positions, followed by colors. The layout is kept and set up again
+       * whenever the VAO is, such as in another context or after the
+       * GpuAllocator moves the vertex data.
        *
        * @param location Index location of the attribute buffer to set.
        * @param type The type of the values within the attribute buffer.
-       * @param offset Offset to the beginning of the buffer.
+       * @param offset Offset from the beginning of the vertex data.
        * @param tupleSize Size of each group of elements in the buffer.
        *    For (x, y) positions this would be 2, (x, y, z) would be 3, etc.
        * @param stride Stride between groups of elements in the buffer.
@@ -202,17 +250,43 @@ namespace Qtk
       void setAttributeBuffer(
           int location, GLenum type, int offset, int tupleSize, int stride = 0);
 
+      /**
+       * Replaces the texture of this MeshRenderer, updating its memory usage
+       * reported to MemoryTracker.
+       *
+       * @param path Path to the new texture to load.
+       * @param flipX True if texture is to be flipped on the X axis.
+       * @param flipY True if texture is to be flipped on the Y axis.
+       */
+      void setTexture(const char * path,
+                      bool flipX = false,
+                      bool flipY = false) override;
+
+      void setTexture(const Texture & t) override;
+
+      void setCubeMap(const char * path) override;
+
       /*************************************************************************
        * Accessors
        ************************************************************************/
 
       /**
-       * Retrieve a mesh by name stored within static QHash private member
+       * Retrieve a mesh by name stored within static QMultiHash private member
+       * Names are shared by every scene; if meshes in different scenes share
+       * a name the most recently added mesh is returned. Prefer
+       * Scene::getObject with an ObjectHandle, especially in code that runs
+       * every frame.
+       *
        * @param name The name of the MeshRenderer we want to retrieve.
        * @return Pointer to the MeshRenderer, or nullptr if not found.
        */
       static MeshRenderer * getInstance(const QString & name);
 
+      /**
+       * @return OpenGL draw type. GL_TRIANGLES, GL_POINTS, GL_LINES, etc.
+       */
+      [[nodiscard]] inline int getDrawType() const { return mDrawType; }
+
       /**
        * @return Transform3D attached to this MeshRenderer.
        */
@@ -228,15 +302,102 @@ namespace Qtk
         return mFragmentShader;
       }
 
+      /**
+       * @return True if `drawInstanced()` is supported. The model matrix of
+       *    custom shaders is a uniform, so only the default shaders are.
+       */
+      [[nodiscard]] inline bool supportsInstancing() const
+      {
+        return mVertexShader.empty() && mFragmentShader.empty();
+      }
+
     private:
+      /*************************************************************************
+       * Private Types
+       ************************************************************************/
+
+      /** Attribute set up by a caller, replayed by `bindBuffers()`. */
+      struct Attribute {
+          int mLocation {};
+          bool mEnabled = false;
+          /* Layout within the vertex data; unused if mTupleSize is 0. */
+          GLenum mType {};
+          int mOffset {};
+          int mTupleSize {};
+          int mStride {};
+      };
+
+      /*************************************************************************
+       * Private Methods
+       ************************************************************************/
+
+      /**
+       * @return The recorded attribute for a location, added if needed.
+       */
+      Attribute & getAttribute(int location);
+
+      /**
+       * Write vertex positions, colors and indices to GPU memory, reusing the
+       * current allocations if the data fits.
+       */
+      void uploadVertices();
+
+      /**
+       * Write normals or texture coordinates used by attribute location 1.
+       *
+       * @param data Pointer to the attribute data.
+       * @param size Size of the attribute data in bytes.
+       * @param dims Number of dimensions for each element.
+       */
+      void reallocateAttribute(const void * data,
+                               GLsizeiptr size,
+                               unsigned dims);
+
+      /**
+       * Point VAO attributes at the current location of our allocations,
+       * including attributes recorded in mAttributes.
+       * Called with the VAO bound when `mVAO.bind()` requires it.
+       */
+      void bindBuffers();
+
+      /**
+       * Issue the draw call for this shape. The VAO must be bound.
+       *
+       * @param instances Number of instances to draw.
+       */
+      void drawGeometry(GLsizei instances = 1);
+
+      /**
+       * Report the memory held by this MeshRenderer to MemoryTracker.
+       */
+      void updateMemoryUsage() const;
+
       /*************************************************************************
        * Private Members
        ************************************************************************/
 
       static MeshManager sInstances;
+      /* Guards sInstances, which may be used from several render threads. */
+      static QMutex sInstancesMutex;
+      /* First of the four attribute locations of the instance model matrix. */
+      static constexpr GLuint kInstanceLocation = 8;
 
       int mDrawType {};
       std::string mVertexShader {}, mFragmentShader {};
+      /* Positions followed by colors. */
+      GpuHandle mVertexAllocation {};
+      /* Indices for QTK_DRAW_ELEMENTS and QTK_DRAW_ELEMENTS_NORMALS. */
+      GpuHandle mIndexAllocation {};
+      /* Normals or texture coordinates for attribute location 1. */
+      GpuHandle mAttributeAllocation {};
+      unsigned mAttributeDims = 3;
+      /* Attributes set up with enableAttributeArray or setAttributeBuffer. */
+      std::vector<Attribute> mAttributes {};
+      /* GpuAllocator epoch our VAO was last bound with. */
+      uint64_t mEpoch = 0;
+      /* Default shaders with QTK_SHADER_VERTEX_MESH_INSTANCED, linked the
+       * first time this MeshRenderer is drawn instanced. */
+      QOpenGLShaderProgram * mInstancedProgram {};
   };
 }  // namespace Qtk
 
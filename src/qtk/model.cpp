@@ -7,15 +7,22 @@
 ## Contact: shaunrd0@gmail.com  | URL: www.shaunreed.com | GitHub: shaunrd0   ##
 ##############################################################################*/
 
+#include <algorithm>
+#include <numeric>
+
+#include "memorytracker.h"
 #include "model.h"
 #include "qtkiosystem.h"
+#include "renderstats.h"
 #include "scene.h"
 #include "texture.h"
+#include "tracer.h"
 
 using namespace Qtk;
 
 /** Static QHash used to store and access models globally. */
 Model::ModelManager Model::mManager;
+QMutex Model::sManagerMutex;
 
 /*******************************************************************************
  * Public Member Functions
@@ -23,20 +30,31 @@ Model::ModelManager Model::mManager;
 
 void Model::draw()
 {
-  for (auto & mesh : mMeshes) {
-    mesh.mTransform = mTransform;
-    mesh.draw();
+  for (const auto & index : mDrawOrder) {
+    mMeshes[index].draw();
   }
 }
 
 void Model::draw(QOpenGLShaderProgram & shader)
 {
-  for (auto & mesh : mMeshes) {
-    mesh.mTransform = mTransform;
-    mesh.draw(shader);
+  for (const auto & index : mDrawOrder) {
+    mMeshes[index].draw(shader);
   }
 }
 
+void Model::sortModelMeshes(const QMatrix4x4 & modelView)
+{
+  // Distance along the view direction to the center of each mesh.
+  auto depth = [&modelView](const ModelMesh & mesh) {
+    return -modelView.map(mesh.mBounds.getCenter()).z();
+  };
+  std::sort(mDrawOrder.begin(),
+            mDrawOrder.end(),
+            [this, &depth](size_t a, size_t b) {
+              return depth(mMeshes[a]) < depth(mMeshes[b]);
+            });
+}
+
 void Model::flipTexture(const std::string & fileName, bool flipX, bool flipY)
 {
   bool modified = false;
@@ -53,13 +71,27 @@ void Model::flipTexture(const std::string & fileName, bool flipX, bool flipY)
   if (!modified) {
     qDebug() << "Attempt to flip texture that doesn't exist: "
              << fullPath.c_str() << "\n";
+  } else {
+    updateMemoryUsage();
   }
 }
 
+void Model::setName(const QString & name)
+{
+  auto previous = mName;
+  Object::setName(name);
+  if (mName == previous) {
+    return;
+  }
+  QMutexLocker lock(&sManagerMutex);
+  mManager.remove(previous, this);
+  mManager.insert(mName, this);
+}
+
 void Model::setLightPosition(const QString & lightName, const char * uniform)
 {
   if (auto light = MeshRenderer::getInstance(lightName); light) {
-    QVector3D position = light->getTransform().getTranslation();
+    QVector3D position = light->getDrawMatrix().column(3).toVector3D();
     setUniform(uniform, position);
   } else {
     qDebug() << "[QtkScene] Failed to set " << mName
@@ -70,7 +102,8 @@ void Model::setLightPosition(const QString & lightName, const char * uniform)
 // Static function to access ModelManager for getting Models by name
 Model * Model::getInstance(const char * name)
 {
-  return mManager[name];
+  QMutexLocker lock(&sManagerMutex);
+  return mManager.value(name);
 }
 
 /*******************************************************************************
@@ -79,6 +112,8 @@ Model * Model::getInstance(const char * name)
 
 void Model::loadModel(const std::string & path)
 {
+  Tracer::Span span("Model::loadModel", "load");
+  QTK_RENDER_STAT(mModelLoads, 1);
   Assimp::Importer import;
   // If using a Qt Resource path, use QtkIOSystem for file handling.
   if (path.front() == ':') {
@@ -90,11 +125,16 @@ void Model::loadModel(const std::string & path)
   // Import the model, converting non-triangular geometry to triangles
   // + And flipping texture UVs, etc..
   // Assimp options: http://assimp.sourceforge.net/lib_html/postprocess_8h.html
-  const aiScene * scene = import.ReadFile(
-      path.c_str(),
-      aiProcess_Triangulate | aiProcess_FlipUVs | aiProcess_GenSmoothNormals
-          | aiProcess_CalcTangentSpace | aiProcess_OptimizeMeshes
-          | aiProcess_SplitLargeMeshes);
+  const aiScene * scene = Q_NULLPTR;
+  {
+    Tracer::Span parse("Assimp::ReadFile", "load");
+    scene = import.ReadFile(path.c_str(),
+                            aiProcess_Triangulate | aiProcess_FlipUVs
+                                | aiProcess_GenSmoothNormals
+                                | aiProcess_CalcTangentSpace
+                                | aiProcess_OptimizeMeshes
+                                | aiProcess_SplitLargeMeshes);
+  }
 
   // If there were errors, print and return
   if (!scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE
@@ -103,19 +143,65 @@ void Model::loadModel(const std::string & path)
     return;
   }
 
+  // The imported scene is held until the meshes are processed.
+  auto & memory = MemoryTracker::getInstance();
+  aiMemoryInfo scratch;
+  import.GetMemoryRequirements(scratch);
+  memory.setUsage(this, QTK_MEMORY_IMPORT_SCRATCH, scratch.total);
+
   // Pass the pointers to the root node and the scene to recursive function
   // + Base case breaks when no nodes left to process on model
   processNode(scene->mRootNode, scene);
 
-  // Sort models by their distance from the camera
-  // Optimizes drawing so that overlapping objects are not overwritten
-  // + Since the topmost object will be drawn first
-  sortModelMeshes();
+  for (auto & mesh : mMeshes) {
+    // Meshes are drawn with the matrix the Scene sets on this Model.
+    mesh.mModelMatrix = &mDrawMatrix;
+    if (mesh.mBounds.mValid) {
+      mBounds.expand(mesh.mBounds.mMin);
+      mBounds.expand(mesh.mBounds.mMax);
+    }
+  }
+
+  // Meshes are drawn in load order until the scene sorts them.
+  mDrawOrder.resize(mMeshes.size());
+  std::iota(mDrawOrder.begin(), mDrawOrder.end(), 0);
+
+  updateMemoryUsage();
+  memory.setUsage(this, QTK_MEMORY_IMPORT_SCRATCH, 0);
 
   // Object finished loading, insert it into ModelManager
+  QMutexLocker lock(&sManagerMutex);
   mManager.insert(getName(), this);
 }
 
+void Model::updateMemoryUsage() const
+{
+  auto & allocator = GpuAllocator::getInstance();
+  uint64_t meshCpu = 0, meshGpu = 0, shaders = 0, textures = 0;
+  uint64_t objects = sizeof(*this) + mDrawOrder.capacity() * sizeof(size_t)
+                     + mTexturesLoaded.capacity() * sizeof(ModelTexture);
+  for (const auto & mesh : mMeshes) {
+    meshCpu += mesh.mVertices.capacity() * sizeof(ModelVertex)
+               + mesh.mIndices.capacity() * sizeof(GLuint);
+    meshGpu += allocator.getSize(mesh.mVertexAllocation)
+               + allocator.getSize(mesh.mIndexAllocation);
+    shaders += MemoryTracker::getProgramBytes(*mesh.mProgram);
+    objects += sizeof(ModelMesh) + sizeof(VertexArray)
+               + mesh.mTextures.capacity() * sizeof(ModelTexture);
+  }
+  // Meshes share the textures in mTexturesLoaded, so count each once.
+  for (const auto & texture : mTexturesLoaded) {
+    textures += MemoryTracker::getTextureBytes(*texture.mTexture);
+  }
+
+  auto & memory = MemoryTracker::getInstance();
+  memory.setUsage(this, QTK_MEMORY_MESH_CPU, meshCpu);
+  memory.setUsage(this, QTK_MEMORY_MESH_GPU, meshGpu);
+  memory.setUsage(this, QTK_MEMORY_TEXTURE_GPU, textures);
+  memory.setUsage(this, QTK_MEMORY_SHADER, shaders);
+  memory.setUsage(this, QTK_MEMORY_SCENE_OBJECTS, objects);
+}
+
 void Model::processNode(aiNode * node, const aiScene * scene)
 {
   // Process each mesh that is available for this node
@@ -132,6 +218,7 @@ void Model::processNode(aiNode * node, const aiScene * scene)
 
 ModelMesh Model::processMesh(aiMesh * mesh, const aiScene * scene)
 {
+  Tracer::Span span("Model::processMesh", "load");
   ModelMesh::Vertices vertices;
   ModelMesh::Indices indices;
   ModelMesh::Textures textures;
@@ -269,14 +356,3 @@ ModelMesh::Textures Model::loadMaterialTextures(aiMaterial * mat,
   // Return the resulting textures
   return textures;
 }
-
-void Model::sortModelMeshes()
-{
-  auto cameraPos = Scene::getCamera().getTransform().getTranslation();
-  auto cameraDistance = [&cameraPos](const ModelMesh & a, const ModelMesh & b) {
-    // Sort by the first vertex position in the model
-    return cameraPos.distanceToPoint(a.mVertices[0].mPosition)
-           < cameraPos.distanceToPoint(b.mVertices[0].mPosition);
-  };
-  std::sort(mMeshes.begin(), mMeshes.end(), cameraDistance);
-}
@@ -19,6 +19,7 @@
 
 // Qtk
 #include <QFileInfo>
+#include <QMutex>
 
 
 #include "modelmesh.h"
@@ -37,8 +38,11 @@ namespace Qtk
        * Typedefs
        ************************************************************************/
 
-      /** ModelManager typedef that will manage global model access. */
-      typedef QHash<QString, Model *> ModelManager;
+      /**
+       * ModelManager typedef that will manage global model access.
+       * Models in different scenes may share a name.
+       */
+      typedef QMultiHash<QString, Model *> ModelManager;
 
       /*************************************************************************
        * Constructors, Destructors
@@ -63,7 +67,16 @@ namespace Qtk
         loadModel(mModelPath);
       }
 
-      inline ~Model() override { mManager.remove(getName()); }
+      inline ~Model() override
+      {
+        {
+          QMutexLocker lock(&sManagerMutex);
+          mManager.remove(getName(), this);
+        }
+        for (auto & mesh : mMeshes) {
+          mesh.release();
+        }
+      }
 
       /*************************************************************************
        * Public Methods
@@ -92,10 +105,26 @@ namespace Qtk
                        bool flipX = false,
                        bool flipY = true);
 
+      /**
+       * Sorts the meshes in this Model front to back for the current view.
+       * Drawing the closest meshes first lets the depth test reject hidden
+       * fragments before they are shaded. Called by the Scene each frame.
+       *
+       * @param modelView Model view matrix for this Model.
+       */
+      void sortModelMeshes(const QMatrix4x4 & modelView);
+
       /*************************************************************************
        * Setters
        ************************************************************************/
 
+      /**
+       * Renames this Model and updates its ModelManager entry.
+       *
+       * @param name The new name for this Model.
+       */
+      void setName(const QString & name) override;
+
       /**
        * Sets a uniform value for each ModelMesh within this Model.
        *
@@ -115,6 +144,8 @@ namespace Qtk
 
       /**
        * Sets the position of a light used in GLSL unfiroms.
+       * The light's position in the frame being drawn is used, so call this
+       * from Scene::beforeDraw.
        *
        * @param lightName Object name of the light
        */
@@ -128,12 +159,24 @@ namespace Qtk
       /**
        * Accessor function for retrieving a ModelMesh globally.
        * The mesh is retrieved from the mManager private member.
+       * Names are shared by every scene; if models in different scenes share
+       * a name the most recently loaded model is returned. Prefer
+       * Scene::getObject with an ObjectHandle, especially in code that runs
+       * every frame.
        *
        * @param name The name of the model to load as it was constructed.
        * @return Pointer to the model stored within the scene.
        */
       [[nodiscard]] static Model * getInstance(const char * name);
 
+      /**
+       * @return All ModelMeshes loaded for this Model.
+       */
+      [[nodiscard]] inline const std::vector<ModelMesh> & getMeshes() const
+      {
+        return mMeshes;
+      }
+
       /**
        * @return Transform3D attached to this Model.
        */
@@ -168,6 +211,11 @@ namespace Qtk
        */
       void loadModel(const std::string & path);
 
+      /**
+       * Report the memory held by this Model and its meshes to MemoryTracker.
+       */
+      void updateMemoryUsage() const;
+
       /**
        * Process a node in the model's geometry using Assimp.
        *
@@ -201,25 +249,21 @@ namespace Qtk
                                                aiTextureType type,
                                                const std::string & typeName);
 
-      /**
-       * Sorts each mesh in the Model based on distance from the camera.
-       * This is for efficient drawing in OpenGL by preventing the drawing of
-       * objects not visible due to being partially or entirely behind another
-       * object.
-       */
-      void sortModelMeshes();
-
       /*************************************************************************
        * Private Members
        ************************************************************************/
 
       /** Static QHash used to store and access models globally. */
       static ModelManager mManager;
+      /** Guards mManager, which may be used from several render threads. */
+      static QMutex sManagerMutex;
 
       /** Container to store N loaded textures for this model. */
       ModelMesh::Textures mTexturesLoaded {};
       /** Container to store N loaded meshes for this model. */
       std::vector<ModelMesh> mMeshes {};
+      /** Indices into mMeshes in the order they are drawn. */
+      std::vector<size_t> mDrawOrder {};
       /** The directory this model and it's textures are stored. */
       std::string mDirectory {};
       /** File names for shaders and 3D model on disk. */
@@ -7,8 +7,10 @@
 ##############################################################################*/
 
 #include "modelmesh.h"
+#include "renderstats.h"
 #include "scene.h"
 #include "shaders.h"
+#include "tracer.h"
 
 using namespace Qtk;
 
@@ -18,14 +20,26 @@ using namespace Qtk;
 
 void ModelMesh::draw(QOpenGLShaderProgram & shader)
 {
-  mVAO->bind();
+  // Rebind buffers if the GpuAllocator moved our allocations.
+  if (auto allocator = mVertexAllocation.mAllocator;
+      allocator != nullptr && allocator->getEpoch() != mEpoch) {
+    mVAO->invalidate();
+  }
+
+  if (mVAO->bind()) {
+    bindBuffers();
+  }
   // Bind shader
   shader.bind();
 
   // Set Model View Projection values
-  shader.setUniformValue("uModel", mTransform.toMatrix());
-  shader.setUniformValue("uView", Scene::getViewMatrix());
-  shader.setUniformValue("uProjection", Scene::getProjectionMatrix());
+  shader.setUniformValue(
+      "uModel", mModelMatrix != nullptr ? *mModelMatrix : QMatrix4x4());
+  shader.setUniformValue("uView", Scene::getDrawViewMatrix());
+  shader.setUniformValue("uProjection", Scene::getDrawProjectionMatrix());
+  QTK_RENDER_STAT(mProgramBinds, 1);
+  QTK_RENDER_STAT(mUniformUploads, 3 + mTextures.size());
+  QTK_RENDER_STAT(mTextureBinds, mTextures.size());
 
   GLuint diffuseCount = 1;
   GLuint specularCount = 1;
@@ -58,9 +72,14 @@ void ModelMesh::draw(QOpenGLShaderProgram & shader)
   // This is important for models with no textures.
   glActiveTexture(GL_TEXTURE0);
 
-  // Draw the mesh
-  glDrawElements(
-      GL_TRIANGLES, mIndices.size(), GL_UNSIGNED_INT, mIndices.data());
+  // Draw the mesh using indices stored in the element buffer.
+  auto offset = mIndexAllocation.mAllocator->getOffset(mIndexAllocation);
+  glDrawElements(GL_TRIANGLES,
+                 mIndices.size(),
+                 GL_UNSIGNED_INT,
+                 reinterpret_cast<const void *>(offset));
+  QTK_RENDER_STAT(mDrawCalls, 1);
+  QTK_RENDER_STAT(mTriangles, mIndices.size() / 3);
 
   // Release shader, textures
   for (const auto & texture : mTextures) {
@@ -70,6 +89,13 @@ void ModelMesh::draw(QOpenGLShaderProgram & shader)
   mVAO->release();
 }
 
+void ModelMesh::release()
+{
+  GpuAllocator::free(mVertexAllocation);
+  GpuAllocator::free(mIndexAllocation);
+  mVAO->destroy();
+}
+
 /*******************************************************************************
  * Private Member Functions
  ******************************************************************************/
@@ -78,26 +104,28 @@ void ModelMesh::initMesh(const std::string & vert, const std::string & frag)
 {
   initializeOpenGLFunctions();
 
-  // Create VAO, VBO, EBO
-  mVAO->create();
-  mVBO->create();
-  mEBO->create();
-
-  mVAO->bind();
-
-  // Allocate VBO
-  mVBO->setUsagePattern(QOpenGLBuffer::StaticDraw);
-  mVBO->bind();
-
-  mVBO->allocate(mVertices.data(), mVertices.size() * sizeof(mVertices[0]));
+  for (const auto & vertex : mVertices) {
+    mBounds.expand(vertex.mPosition);
+  }
 
-  // Allocate EBO
-  mEBO->setUsagePattern(QOpenGLBuffer::StaticDraw);
-  mEBO->bind();
-  mEBO->allocate(mIndices.data(), mIndices.size() * sizeof(mIndices[0]));
-  mEBO->release();
+  // Allocate vertex and index data from shared GPU buffers.
+  {
+    Tracer::Span upload("Mesh Upload", "gpu");
+    auto & allocator = GpuAllocator::getInstance();
+    GLsizeiptr vertexSize = mVertices.size() * sizeof(mVertices[0]);
+    mVertexAllocation =
+        allocator.allocate(QTK_GPU_VERTEX, vertexSize, sizeof(ModelVertex));
+    allocator.write(mVertexAllocation, mVertices.data(), vertexSize);
+
+    GLsizeiptr indexSize = mIndices.size() * sizeof(mIndices[0]);
+    mIndexAllocation =
+        allocator.allocate(QTK_GPU_INDEX, indexSize, sizeof(mIndices[0]));
+    allocator.write(mIndexAllocation, mIndices.data(), indexSize);
+  }
 
   // Load and link shaders
+  Tracer::Span link("Shader Link", "shader");
+  QTK_RENDER_STAT(mShaderLinks, 1);
   if (!vert.empty()) {
     mProgram->addShaderFromSourceFile(QOpenGLShader::Vertex, vert.c_str());
   } else {
@@ -115,39 +143,64 @@ void ModelMesh::initMesh(const std::string & vert, const std::string & frag)
   if (!mProgram->link()) {
     qDebug() << "Failed to link shader: " << mProgram->log();
   }
+
+  // Attributes are set up by each context the first time it draws the mesh.
+}
+
+void ModelMesh::bindBuffers()
+{
+  auto & allocator = GpuAllocator::getInstance();
+  auto offset = allocator.getOffset(mVertexAllocation);
+
   if (!mProgram->bind()) {
     qDebug() << "Failed to bind shader: " << mProgram->log();
   }
+  glBindBuffer(GL_ARRAY_BUFFER, allocator.getBuffer(mVertexAllocation));
 
   // Positions
   mProgram->enableAttributeArray(0);
-  mProgram->setAttributeBuffer(
-      0, GL_FLOAT, offsetof(ModelVertex, mPosition), 3, sizeof(ModelVertex));
+  mProgram->setAttributeBuffer(0,
+                               GL_FLOAT,
+                               offset + offsetof(ModelVertex, mPosition),
+                               3,
+                               sizeof(ModelVertex));
 
   // Normals
   mProgram->enableAttributeArray(1);
-  mProgram->setAttributeBuffer(
-      1, GL_FLOAT, offsetof(ModelVertex, mNormal), 3, sizeof(ModelVertex));
+  mProgram->setAttributeBuffer(1,
+                               GL_FLOAT,
+                               offset + offsetof(ModelVertex, mNormal),
+                               3,
+                               sizeof(ModelVertex));
 
   // Texture Coordinates
   mProgram->enableAttributeArray(2);
   mProgram->setAttributeBuffer(2,
                                GL_FLOAT,
-                               offsetof(ModelVertex, mTextureCoord),
+                               offset + offsetof(ModelVertex, mTextureCoord),
                                2,
                                sizeof(ModelVertex));
 
   // Vertex tangents
   mProgram->enableAttributeArray(3);
-  mProgram->setAttributeBuffer(
-      3, GL_FLOAT, offsetof(ModelVertex, mTangent), 3, sizeof(ModelVertex));
+  mProgram->setAttributeBuffer(3,
+                               GL_FLOAT,
+                               offset + offsetof(ModelVertex, mTangent),
+                               3,
+                               sizeof(ModelVertex));
 
   // Vertex bitangents
   mProgram->enableAttributeArray(4);
-  mProgram->setAttributeBuffer(
-      4, GL_FLOAT, offsetof(ModelVertex, mBitangent), 3, sizeof(ModelVertex));
+  mProgram->setAttributeBuffer(4,
+                               GL_FLOAT,
+                               offset + offsetof(ModelVertex, mBitangent),
+                               3,
+                               sizeof(ModelVertex));
+
+  // The element buffer binding is stored in the VAO.
+  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, allocator.getBuffer(mIndexAllocation));
 
   mProgram->release();
-  mVBO->release();
-  mVAO->release();
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+  mEpoch = allocator.getEpoch();
 }
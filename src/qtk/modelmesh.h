@@ -13,6 +13,7 @@
 
 #include <QOpenGLFunctions>
 
+#include "gpuallocator.h"
 #include "object.h"
 #include "transform3D.h"
 
@@ -100,11 +101,8 @@ namespace Qtk
                 const char * vertexShader = "",
                 const char * fragmentShader = "") :
           mProgram(new QOpenGLShaderProgram),
-          mVAO(new QOpenGLVertexArrayObject),
-          mVBO(new QOpenGLBuffer(QOpenGLBuffer::VertexBuffer)),
-          mEBO(new QOpenGLBuffer(QOpenGLBuffer::IndexBuffer)),
-          mVertices(std::move(vertices)), mIndices(std::move(indices)),
-          mTextures(std::move(textures))
+          mVAO(new VertexArray), mVertices(std::move(vertices)),
+          mIndices(std::move(indices)), mTextures(std::move(textures))
       {
         initMesh(vertexShader, fragmentShader);
       }
@@ -126,6 +124,12 @@ namespace Qtk
        */
       void draw(QOpenGLShaderProgram & shader);
 
+      /**
+       * Free GPU memory used by this mesh.
+       * ModelMesh is copied freely by Model, so this is not done on destruction.
+       */
+      void release();
+
       /*************************************************************************
        * Public Members
        ************************************************************************/
@@ -133,7 +137,11 @@ namespace Qtk
       Vertices mVertices {};
       Indices mIndices {};
       Textures mTextures {};
-      Transform3D mTransform;
+      /** Draw matrix of the Model that owns this mesh, set once by the Model
+       * so the matrix is never copied per mesh. */
+      const QMatrix4x4 * mModelMatrix {};
+      /** Bounds of mVertices in object space. */
+      BoundingBox mBounds {};
 
     private:
       /*************************************************************************
@@ -148,12 +156,21 @@ namespace Qtk
        */
       void initMesh(const std::string & vert, const std::string & frag);
 
+      /**
+       * Point VAO attributes and the element buffer at the current location of
+       * our allocations. Called with the VAO bound when `mVAO->bind()`
+       * requires it.
+       */
+      void bindBuffers();
+
       /*************************************************************************
        * Private Members
        ************************************************************************/
 
-      QOpenGLBuffer *mVBO, *mEBO;
-      QOpenGLVertexArrayObject * mVAO;
+      GpuHandle mVertexAllocation {}, mIndexAllocation {};
+      /* GpuAllocator epoch our VAO was last bound with. */
+      uint64_t mEpoch = 0;
+      VertexArray * mVAO;
       QOpenGLShaderProgram * mProgram;
   };
 }  // namespace Qtk
@@ -6,10 +6,72 @@
 ## Contact: shaunrd0@gmail.com  | URL: www.shaunreed.com | GitHub: shaunrd0   ##
 ##############################################################################*/
 
+#include <algorithm>
+
+#include "memorytracker.h"
 #include "object.h"
 
 using namespace Qtk;
 
+std::atomic<uint64_t> Object::sStaticRevision = 0;
+
+/*******************************************************************************
+ * Constructors / Destructors
+ ******************************************************************************/
+
+Object::~Object()
+{
+  detachAll();
+  MemoryTracker::getInstance().release(this);
+}
+
+/*******************************************************************************
+ * Public Methods
+ ******************************************************************************/
+
+void Object::setName(const QString & name)
+{
+  if (mHandle.isValid()) {
+    qDebug() << "[Object] Can't rename" << mName << "to" << name
+             << "while it is in a scene.";
+    return;
+  }
+  mName = name;
+}
+
+bool Object::attachTo(Object * parent)
+{
+  if (parent == mParentObject) {
+    return true;
+  }
+  if (!getTransform().setParent(parent != Q_NULLPTR ? &parent->getTransform()
+                                                     : Q_NULLPTR)) {
+    qDebug() << "[Object] Can't attach" << getName() << "to its descendant"
+             << parent->getName();
+    return false;
+  }
+
+  if (mParentObject != Q_NULLPTR) {
+    auto & siblings = mParentObject->mChildObjects;
+    siblings.erase(std::remove(siblings.begin(), siblings.end(), this),
+                   siblings.end());
+  }
+  mParentObject = parent;
+  if (mParentObject != Q_NULLPTR) {
+    mParentObject->mChildObjects.push_back(this);
+  }
+  return true;
+}
+
+void Object::detachAll()
+{
+  attachTo(Q_NULLPTR);
+  // Children keep their local transform, now relative to the world.
+  while (!mChildObjects.empty()) {
+    mChildObjects.back()->attachTo(Q_NULLPTR);
+  }
+}
+
 std::string Object::getShaderSourceCode(
     QOpenGLShader::ShaderType shader_type) const
 {
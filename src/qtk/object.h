@@ -11,15 +11,104 @@
 #include <QOpenGLBuffer>
 #include <QOpenGLShaderProgram>
 #include <QOpenGLTexture>
-#include <QOpenGLVertexArrayObject>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <vector>
 
 #include "qtkapi.h"
 #include "shape.h"
 #include "texture.h"
+#include "vertexarray.h"
 
 namespace Qtk
 {
   class Model;
+  class OcclusionCuller;
+  class Scene;
+  class StaticBatch;
+
+  /**
+   * Axis aligned bounding box for an object's geometry in object space.
+   */
+  struct QTKAPI BoundingBox {
+      QVector3D mMin {}, mMax {};
+      bool mValid = false;
+
+      /**
+       * Grow the box to contain a point.
+       *
+       * @param point The point to include in the box.
+       */
+      inline void expand(const QVector3D & point)
+      {
+        if (!mValid) {
+          mMin = mMax = point;
+          mValid = true;
+          return;
+        }
+        mMin = QVector3D(std::min(mMin.x(), point.x()),
+                         std::min(mMin.y(), point.y()),
+                         std::min(mMin.z(), point.z()));
+        mMax = QVector3D(std::max(mMax.x(), point.x()),
+                         std::max(mMax.y(), point.y()),
+                         std::max(mMax.z(), point.z()));
+      }
+
+      /**
+       * @return The center of the box, or the origin if the box is empty.
+       */
+      [[nodiscard]] inline QVector3D getCenter() const
+      {
+        return mValid ? (mMin + mMax) * 0.5f : QVector3D();
+      }
+
+      /**
+       * @param index Index of the corner to get, from 0 to 7.
+       * @return A corner of the box.
+       */
+      [[nodiscard]] inline QVector3D getCorner(int index) const
+      {
+        return {index & 1 ? mMax.x() : mMin.x(),
+                index & 2 ? mMax.y() : mMin.y(),
+                index & 4 ? mMax.z() : mMin.z()};
+      }
+  };
+
+  /**
+   * Stable reference to an object within a Scene.
+   *
+   * A handle is an index into the scene's object table and the generation of
+   * that slot when the object was added. Removing the object bumps the
+   * generation, so stale handles resolve to nullptr instead of a freed or
+   * reused object. Handles are only meaningful to the scene that issued them.
+   */
+  struct QTKAPI ObjectHandle {
+      static constexpr uint32_t kInvalidIndex = ~uint32_t(0);
+
+      uint32_t mIndex = kInvalidIndex;
+      uint32_t mGeneration = 0;
+
+      /**
+       * @return True if this handle was issued by a scene. It may still be
+       *    stale; resolve it with Scene::getObject to know.
+       */
+      [[nodiscard]] inline bool isValid() const
+      {
+        return mIndex != kInvalidIndex;
+      }
+
+      inline bool operator==(const ObjectHandle & other) const
+      {
+        return mIndex == other.mIndex && mGeneration == other.mGeneration;
+      }
+
+      inline bool operator!=(const ObjectHandle & other) const
+      {
+        return !(*this == other);
+      }
+  };
 
   /**
    * Object base class for objects that can exist within a scene.
@@ -36,6 +125,9 @@ namespace Qtk
 
       friend MeshRenderer;
       friend Model;
+      friend OcclusionCuller;
+      friend Scene;
+      friend StaticBatch;
 
       /**
        * Enum flag to identify Object type without casting.
@@ -48,21 +140,22 @@ namespace Qtk
 
       // Initialize an object with no shape data assigned
       explicit Object(const char * name, Type type) :
-          mName(name), mVBO(QOpenGLBuffer::VertexBuffer), mBound(false),
-          mType(type)
+          mName(name), mBound(false), mType(type)
       {
         setObjectName(name);
       }
 
       // Initialize an object with shape data assigned
       Object(const char * name, const ShapeBase & shape, Type type) :
-          mName(name), mVBO(QOpenGLBuffer::VertexBuffer), mShape(shape),
-          mBound(false), mType(type)
+          mName(name), mShape(shape), mBound(false), mType(type)
       {
         setObjectName(name);
       }
 
-      ~Object() override = default;
+      /**
+       * Detaches this object from its parent and its children.
+       */
+      ~Object() override;
 
       /*************************************************************************
        * Accessors
@@ -104,6 +197,99 @@ namespace Qtk
 
       [[nodiscard]] inline const Type & getType() const { return mType; }
 
+      /**
+       * @return Handle to this object in the Scene it was added to, or an
+       *    invalid handle if it is not in a scene.
+       */
+      [[nodiscard]] inline ObjectHandle getHandle() const { return mHandle; }
+
+      /**
+       * @return True if this object was flagged as static geometry.
+       */
+      [[nodiscard]] inline bool isStatic() const { return mStatic; }
+
+      /**
+       * @return True if this object is currently drawn by a StaticBatch.
+       */
+      [[nodiscard]] inline bool isBatched() const { return mBatched; }
+
+      /**
+       * @return Bounding box of this object's geometry in object space.
+       */
+      [[nodiscard]] inline const BoundingBox & getBounds() const
+      {
+        return mBounds;
+      }
+
+      /**
+       * @return Revision of getBounds(), bumped when the geometry changes.
+       */
+      [[nodiscard]] inline uint64_t getBoundsRevision() const
+      {
+        return mBoundsRevision;
+      }
+
+      /**
+       * @return False if the scene should not draw this object.
+       */
+      [[nodiscard]] inline bool isVisible() const { return mVisible; }
+
+      /**
+       * @return True if this object was tagged as an occluder.
+       */
+      [[nodiscard]] inline bool isOccluder() const { return mOccluder; }
+
+      /**
+       * @return True if the last occlusion culling pass found this object
+       *    hidden behind occluders.
+       */
+      [[nodiscard]] inline bool isCulled() const { return mCulled; }
+
+      /**
+       * @return Model matrix this object is drawn with. This is a copy of the
+       *    transform taken by the Scene when the frame was captured, so it is
+       *    safe to use while drawing on another thread.
+       */
+      [[nodiscard]] inline const QMatrix4x4 & getDrawMatrix() const
+      {
+        return mDrawMatrix;
+      }
+
+      /**
+       * @return Revision of the world matrix this object is drawn with. See
+       *    Transform3D::getWorldRevision.
+       */
+      [[nodiscard]] inline uint64_t getDrawRevision() const
+      {
+        return mDrawRevision;
+      }
+
+      /**
+       * @return The object this object is attached to, or nullptr.
+       */
+      [[nodiscard]] inline Object * getParentObject() const
+      {
+        return mParentObject;
+      }
+
+      /**
+       * @return Objects attached to this object.
+       */
+      [[nodiscard]] inline const std::vector<Object *> & getChildObjects()
+          const
+      {
+        return mChildObjects;
+      }
+
+      /**
+       * @return Counter incremented each time any object's static flag changes.
+       *    Scenes compare this to know when static batches must be rebuilt.
+       */
+      [[nodiscard]] inline static uint64_t getStaticRevision()
+      {
+        return sStaticRevision;
+      }
+
       [[nodiscard]] inline virtual const Transform3D & getTransform() const
       {
         return mTransform;
@@ -143,7 +329,13 @@ namespace Qtk
        * Setters
        ************************************************************************/
 
-      virtual inline void setName(const QString & name) { mName = name; }
+      /**
+       * Scenes index objects by name, so an object can't be renamed while it
+       * belongs to a Scene. Remove it from the scene first to rename it.
+       *
+       * @param name The new name for this object.
+       */
+      virtual void setName(const QString & name);
 
       virtual inline void setColors(const Colors & value)
       {
@@ -189,6 +381,47 @@ namespace Qtk
         mShape.mVertices = value;
       }
 
+      /**
+       * Flag this object as static geometry. If static batching is enabled on
+       * the Scene, static objects are submitted through a StaticBatch instead
+       * of drawing individually.
+       *
+       * @param isStatic True if this object's geometry will not change.
+       */
+      inline void setStatic(bool isStatic)
+      {
+        if (mStatic != isStatic) {
+          mStatic = isStatic;
+          ++sStaticRevision;
+        }
+      }
+
+      /**
+       * Hide or show this object. Hidden objects are not drawn by the Scene,
+       * but Registry entities may still draw their geometry.
+       *
+       * @param visible True if the scene should draw this object.
+       */
+      inline void setVisible(bool visible)
+      {
+        if (mVisible != visible) {
+          mVisible = visible;
+          // Static batches only hold visible objects.
+          if (mStatic) {
+            ++sStaticRevision;
+          }
+        }
+      }
+
+      /**
+       * Tag this object as an occluder. If occlusion culling is enabled on the
+       * Scene, occluders are rasterized to hide objects behind them.
+       * Large opaque objects like walls and floors make good occluders.
+       *
+       * @param occluder True if this object should be used as an occluder.
+       */
+      inline void setOccluder(bool occluder) { mOccluder = occluder; }
+
       inline void setScaleX(double x)
       {
         mTransform.setScale(
@@ -232,10 +465,27 @@ namespace Qtk
        * Public Methods
        ************************************************************************/
 
+      /**
+       * Attach this object to a parent so it moves with it, for example a
+       * light following a model. This object's transform becomes relative to
+       * the parent's. Both objects must belong to the same Scene.
+       *
+       * @param parent The object to attach to, or nullptr to detach.
+       * @return False if the parent is attached to this object.
+       */
+      bool attachTo(Object * parent);
+
+      /**
+       * Detach this object from its parent, and its children from it.
+       * Called by the Scene when the object is removed.
+       */
+      void detachAll();
+
       virtual inline void bindShaders()
       {
         mBound = true;
         mProgram.bind();
+        QTK_RENDER_STAT(mProgramBinds, 1);
       }
 
       virtual inline void releaseShaders()
@@ -267,14 +517,34 @@ namespace Qtk
        ************************************************************************/
 
       QOpenGLShaderProgram mProgram;
-      QOpenGLBuffer mVBO, mNBO;
-      QOpenGLVertexArrayObject mVAO;
+      VertexArray mVAO;
       Transform3D mTransform;
       Shape mShape;
       Texture mTexture;
       QString mName;
       bool mBound;
       Type mType = QTK_OBJECT;
+      /* True if the object's geometry is static and can be batched. */
+      bool mStatic = false;
+      /* True if a StaticBatch is currently drawing this object. */
+      bool mBatched = false;
+      BoundingBox mBounds {};
+      uint64_t mBoundsRevision = 0;
+      bool mVisible = true;
+      /* True if this object was tagged as an occluder. */
+      bool mOccluder = false;
+      /* True if this object was hidden by the last occlusion culling pass. */
+      bool mCulled = false;
+      /* Set by the Scene from its frame snapshot before drawing. */
+      QMatrix4x4 mDrawMatrix {};
+      uint64_t mDrawRevision = 0;
+      /* Scene graph links, mirroring the links between transforms. */
+      Object * mParentObject {};
+      std::vector<Object *> mChildObjects {};
+      /* Set by the Scene while the object belongs to it. */
+      ObjectHandle mHandle {};
+
+      static std::atomic<uint64_t> sStaticRevision;
   };
 }  // namespace Qtk
 
@@ -0,0 +1,415 @@
+/*##############################################################################
+## Author: Shaun Reed                                                         ##
+## Legal: All Content (c) 2025 Shaun Reed, all rights reserved                ##
+## About: Software occlusion culling for scene objects                        ##
+##                                                                            ##
+## Contact: shaunrd0@gmail.com  | URL: www.shaunreed.com | GitHub: shaunrd0   ##
+##############################################################################*/
+
+#include <QElapsedTimer>
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define QTK_OCCLUSION_SSE2
+#endif
+
+#include "meshrenderer.h"
+#include "model.h"
+#include "occlusionculler.h"
+
+using namespace Qtk;
+
+/* Smallest screen area, as a fraction of the buffer, for automatic occluders */
+static constexpr float kMinOccluderArea = 0.02f;
+
+/*******************************************************************************
+ * Constructors / Destructors
+ ******************************************************************************/
+
+OcclusionCuller::OcclusionCuller(int width, int height)
+{
+  setResolution(width, height);
+}
+
+/*******************************************************************************
+ * Public Methods
+ ******************************************************************************/
+
+void OcclusionCuller::cull(const QMatrix4x4 & viewProjection,
+                           const std::vector<Object *> & objects)
+{
+  QElapsedTimer timer;
+  timer.start();
+  mStats = {};
+
+  // Project all bounds first; screen area is used to pick occluders.
+  std::vector<ScreenRect> rects(objects.size());
+  std::vector<size_t> candidates;
+  for (size_t i = 0; i < objects.size(); i++) {
+    auto object = objects[i];
+    rects[i] = project(object->getBounds(),
+                       viewProjection * object->getDrawMatrix());
+    if (!object->mOccluder && rects[i].mValid) {
+      candidates.push_back(i);
+    }
+  }
+
+  auto area = [&rects](size_t i) {
+    return (rects[i].mMaxX - rects[i].mMinX)
+           * (rects[i].mMaxY - rects[i].mMinY);
+  };
+  size_t autoCount = std::min(mAutoOccluders, candidates.size());
+  std::partial_sort(candidates.begin(),
+                    candidates.begin() + autoCount,
+                    candidates.end(),
+                    [&area](size_t a, size_t b) { return area(a) > area(b); });
+  candidates.resize(autoCount);
+
+  // Occluders are never culled; they would otherwise hide themselves.
+  std::vector<bool> occluders(objects.size(), false);
+  float minArea = kMinOccluderArea * mWidth * mHeight;
+  mTriangles.clear();
+  for (size_t i = 0; i < objects.size(); i++) {
+    if (objects[i]->mOccluder) {
+      occluders[i] = true;
+    }
+  }
+  for (const auto & i : candidates) {
+    if (area(i) >= minArea) {
+      occluders[i] = true;
+    }
+  }
+  for (size_t i = 0; i < objects.size(); i++) {
+    if (occluders[i]) {
+      addOccluder(objects[i], viewProjection);
+      ++mStats.mOccluders;
+    }
+  }
+  mStats.mOccluderTriangles = mTriangles.size();
+
+  // Rasterize in row bands, one for each thread.
+  std::fill(mDepth.begin(), mDepth.end(), 1.0f);
+  if (!mTriangles.empty()) {
+    int bands = std::max(1, std::min(mPool.maxThreadCount(), mHeight / 8));
+    int rows = (mHeight + bands - 1) / bands;
+    for (int band = 1; band < bands; band++) {
+      int first = band * rows;
+      int last = std::min(mHeight, first + rows);
+      mPool.start([this, first, last]() { rasterize(first, last); });
+    }
+    // This thread rasterizes the first band.
+    rasterize(0, std::min(mHeight, rows));
+    mPool.waitForDone();
+  }
+  buildHierarchy();
+  mStats.mRasterMs = timer.nsecsElapsed() / 1.0e6f;
+
+  timer.restart();
+  for (size_t i = 0; i < objects.size(); i++) {
+    if (occluders[i]) {
+      objects[i]->mCulled = false;
+      continue;
+    }
+    ++mStats.mTested;
+    objects[i]->mCulled = isOccluded(rects[i]);
+    if (objects[i]->mCulled) {
+      ++mStats.mCulled;
+    }
+  }
+  mStats.mTestMs = timer.nsecsElapsed() / 1.0e6f;
+}
+
+void OcclusionCuller::reset(const std::vector<Object *> & objects)
+{
+  for (const auto & object : objects) {
+    object->mCulled = false;
+  }
+}
+
+/*******************************************************************************
+ * Setters
+ ******************************************************************************/
+
+void OcclusionCuller::setResolution(int width, int height)
+{
+  // Rows are filled four pixels at a time.
+  mWidth = (std::max(width, 4) + 3) / 4 * 4;
+  mHeight = std::max(height, 1);
+  mDepth.assign(mWidth * mHeight, 1.0f);
+}
+
+/*******************************************************************************
+ * Private Methods
+ ******************************************************************************/
+
+OcclusionCuller::ScreenRect OcclusionCuller::project(
+    const BoundingBox & bounds, const QMatrix4x4 & mvp) const
+{
+  ScreenRect rect {FLT_MAX, FLT_MAX, -FLT_MAX, -FLT_MAX, FLT_MAX, false};
+  if (!bounds.mValid) {
+    return rect;
+  }
+
+  for (int i = 0; i < 8; i++) {
+    QVector4D clip = mvp * QVector4D(bounds.getCorner(i), 1.0f);
+    // Bounds crossing the near plane can't be tested; treat them as visible.
+    if (clip.w() <= 1e-5f || clip.z() < -clip.w()) {
+      return rect;
+    }
+    float x = (clip.x() / clip.w() * 0.5f + 0.5f) * mWidth;
+    float y = (clip.y() / clip.w() * 0.5f + 0.5f) * mHeight;
+    float z = clip.z() / clip.w() * 0.5f + 0.5f;
+    rect.mMinX = std::min(rect.mMinX, x);
+    rect.mMaxX = std::max(rect.mMaxX, x);
+    rect.mMinY = std::min(rect.mMinY, y);
+    rect.mMaxY = std::max(rect.mMaxY, y);
+    rect.mMinZ = std::min(rect.mMinZ, z);
+  }
+  rect.mValid = true;
+  return rect;
+}
+
+void OcclusionCuller::addOccluder(Object * object,
+                                  const QMatrix4x4 & viewProjection)
+{
+  QMatrix4x4 mvp = viewProjection * object->getDrawMatrix();
+  if (object->getType() == Object::QTK_MESH) {
+    auto mesh = static_cast<MeshRenderer *>(object);
+    if (mesh->getDrawType() != GL_TRIANGLES) {
+      return;
+    }
+    if (mesh->getShape().getDrawMode() == QTK_DRAW_ARRAYS) {
+      addMesh(mesh->getVertices(), nullptr, mesh->getVertices().size(), mvp);
+    } else {
+      addMesh(mesh->getVertices(),
+              mesh->getIndexData().data(),
+              mesh->getIndexData().size(),
+              mvp);
+    }
+  } else if (object->getType() == Object::QTK_MODEL) {
+    for (const auto & mesh : static_cast<Model *>(object)->getMeshes()) {
+      mPositions.resize(mesh.mVertices.size());
+      for (size_t i = 0; i < mesh.mVertices.size(); i++) {
+        mPositions[i] = mesh.mVertices[i].mPosition;
+      }
+      addMesh(mPositions, mesh.mIndices.data(), mesh.mIndices.size(), mvp);
+    }
+  }
+}
+
+void OcclusionCuller::addMesh(const std::vector<QVector3D> & positions,
+                              const GLuint * indices,
+                              size_t indexCount,
+                              const QMatrix4x4 & mvp)
+{
+  mClip.resize(positions.size());
+  for (size_t i = 0; i < positions.size(); i++) {
+    mClip[i] = mvp * QVector4D(positions[i], 1.0f);
+  }
+
+  for (size_t i = 0; i + 2 < indexCount; i += 3) {
+    Triangle triangle {};
+    bool visible = true;
+    for (int v = 0; v < 3; v++) {
+      size_t index = indices != nullptr ? indices[i + v] : i + v;
+      if (index >= mClip.size()) {
+        visible = false;
+        break;
+      }
+      const QVector4D & clip = mClip[index];
+      // Occluders must not hide anything they don't really cover, so skip
+      // triangles that are clipped by the near plane instead of clipping them.
+      if (clip.w() <= 1e-5f || clip.z() < -clip.w()) {
+        visible = false;
+        break;
+      }
+      triangle.mX[v] = (clip.x() / clip.w() * 0.5f + 0.5f) * mWidth;
+      triangle.mY[v] = (clip.y() / clip.w() * 0.5f + 0.5f) * mHeight;
+      triangle.mZ[v] = clip.z() / clip.w() * 0.5f + 0.5f;
+    }
+    if (visible) {
+      mTriangles.push_back(triangle);
+    }
+  }
+}
+
+void OcclusionCuller::rasterize(int firstRow, int lastRow)
+{
+  for (auto triangle : mTriangles) {
+    // Edge function for the edge (a, b) evaluated at point p.
+    auto edge = [](float ax, float ay, float bx, float by, float px, float py) {
+      return (bx - ax) * (py - ay) - (by - ay) * (px - ax);
+    };
+
+    float area = edge(triangle.mX[0],
+                      triangle.mY[0],
+                      triangle.mX[1],
+                      triangle.mY[1],
+                      triangle.mX[2],
+                      triangle.mY[2]);
+    if (std::fabs(area) < 1e-6f) {
+      continue;
+    }
+    // Occluders are treated as double sided; order vertices counter-clockwise.
+    if (area < 0.0f) {
+      std::swap(triangle.mX[1], triangle.mX[2]);
+      std::swap(triangle.mY[1], triangle.mY[2]);
+      std::swap(triangle.mZ[1], triangle.mZ[2]);
+      area = -area;
+    }
+
+    const auto & x = triangle.mX;
+    const auto & y = triangle.mY;
+    int minX = std::max(0, (int)std::floor(std::min({x[0], x[1], x[2]})));
+    int maxX =
+        std::min(mWidth - 1, (int)std::ceil(std::max({x[0], x[1], x[2]})));
+    int minY =
+        std::max(firstRow, (int)std::floor(std::min({y[0], y[1], y[2]})));
+    int maxY =
+        std::min(lastRow - 1, (int)std::ceil(std::max({y[0], y[1], y[2]})));
+    if (minX > maxX || minY > maxY) {
+      continue;
+    }
+    // Start on a multiple of four so rows can be filled with aligned groups.
+    minX &= ~3;
+
+    // Barycentric weights change linearly across x and y.
+    float invArea = 1.0f / area;
+    float stepX[3] = {y[1] - y[2], y[2] - y[0], y[0] - y[1]};
+
+    for (int row = minY; row <= maxY; row++) {
+      float px = minX + 0.5f;
+      float py = row + 0.5f;
+      float w[3] = {edge(x[1], y[1], x[2], y[2], px, py),
+                    edge(x[2], y[2], x[0], y[0], px, py),
+                    edge(x[0], y[0], x[1], y[1], px, py)};
+      float * depth = &mDepth[row * mWidth];
+
+#ifdef QTK_OCCLUSION_SSE2
+      const __m128 lanes = _mm_set_ps(3.0f, 2.0f, 1.0f, 0.0f);
+      const __m128 zero = _mm_setzero_ps();
+      __m128 w0 = _mm_add_ps(_mm_set1_ps(w[0]),
+                             _mm_mul_ps(lanes, _mm_set1_ps(stepX[0])));
+      __m128 w1 = _mm_add_ps(_mm_set1_ps(w[1]),
+                             _mm_mul_ps(lanes, _mm_set1_ps(stepX[1])));
+      __m128 w2 = _mm_add_ps(_mm_set1_ps(w[2]),
+                             _mm_mul_ps(lanes, _mm_set1_ps(stepX[2])));
+      const __m128 step0 = _mm_set1_ps(stepX[0] * 4.0f);
+      const __m128 step1 = _mm_set1_ps(stepX[1] * 4.0f);
+      const __m128 step2 = _mm_set1_ps(stepX[2] * 4.0f);
+      const __m128 z0 = _mm_set1_ps(triangle.mZ[0] * invArea);
+      const __m128 z1 = _mm_set1_ps(triangle.mZ[1] * invArea);
+      const __m128 z2 = _mm_set1_ps(triangle.mZ[2] * invArea);
+      for (int col = minX; col <= maxX; col += 4) {
+        __m128 inside = _mm_and_ps(
+            _mm_and_ps(_mm_cmpge_ps(w0, zero), _mm_cmpge_ps(w1, zero)),
+            _mm_cmpge_ps(w2, zero));
+        if (_mm_movemask_ps(inside) != 0) {
+          __m128 z = _mm_add_ps(
+              _mm_add_ps(_mm_mul_ps(w0, z0), _mm_mul_ps(w1, z1)),
+              _mm_mul_ps(w2, z2));
+          __m128 current = _mm_loadu_ps(depth + col);
+          __m128 nearest = _mm_min_ps(current, z);
+          _mm_storeu_ps(depth + col,
+                        _mm_or_ps(_mm_and_ps(inside, nearest),
+                                  _mm_andnot_ps(inside, current)));
+        }
+        w0 = _mm_add_ps(w0, step0);
+        w1 = _mm_add_ps(w1, step1);
+        w2 = _mm_add_ps(w2, step2);
+      }
+#else
+      for (int col = minX; col <= maxX; col++) {
+        if (w[0] >= 0.0f && w[1] >= 0.0f && w[2] >= 0.0f) {
+          float z = (w[0] * triangle.mZ[0] + w[1] * triangle.mZ[1]
+                     + w[2] * triangle.mZ[2])
+                    * invArea;
+          depth[col] = std::min(depth[col], z);
+        }
+        w[0] += stepX[0];
+        w[1] += stepX[1];
+        w[2] += stepX[2];
+      }
+#endif
+    }
+  }
+}
+
+void OcclusionCuller::buildHierarchy()
+{
+  mLevels.resize(1);
+  mLevels[0].mWidth = mWidth;
+  mLevels[0].mHeight = mHeight;
+  mLevels[0].mMin = mDepth;
+  mLevels[0].mMax = mDepth;
+
+  while (mLevels.back().mWidth > 1 || mLevels.back().mHeight > 1) {
+    const Level & previous = mLevels.back();
+    Level level;
+    level.mWidth = (previous.mWidth + 1) / 2;
+    level.mHeight = (previous.mHeight + 1) / 2;
+    level.mMin.resize(level.mWidth * level.mHeight);
+    level.mMax.resize(level.mWidth * level.mHeight);
+    for (int y = 0; y < level.mHeight; y++) {
+      for (int x = 0; x < level.mWidth; x++) {
+        float minDepth = 1.0f, maxDepth = 0.0f;
+        for (int dy = 0; dy < 2; dy++) {
+          for (int dx = 0; dx < 2; dx++) {
+            int sx = std::min(x * 2 + dx, previous.mWidth - 1);
+            int sy = std::min(y * 2 + dy, previous.mHeight - 1);
+            minDepth = std::min(minDepth,
+                                previous.mMin[sy * previous.mWidth + sx]);
+            maxDepth = std::max(maxDepth,
+                                previous.mMax[sy * previous.mWidth + sx]);
+          }
+        }
+        level.mMin[y * level.mWidth + x] = minDepth;
+        level.mMax[y * level.mWidth + x] = maxDepth;
+      }
+    }
+    mLevels.push_back(std::move(level));
+  }
+}
+
+bool OcclusionCuller::isOccluded(const ScreenRect & rect) const
+{
+  if (!rect.mValid) {
+    return false;
+  }
+  // Entirely off screen.
+  if (rect.mMaxX < 0.0f || rect.mMaxY < 0.0f || rect.mMinX >= mWidth
+      || rect.mMinY >= mHeight) {
+    return true;
+  }
+
+  int minX = std::max(0, (int)rect.mMinX);
+  int minY = std::max(0, (int)rect.mMinY);
+  int maxX = std::min(mWidth - 1, (int)rect.mMaxX);
+  int maxY = std::min(mHeight - 1, (int)rect.mMaxY);
+
+  // Choose a level where the rect covers at most 2x2 texels.
+  int size = std::max(maxX - minX, maxY - minY) + 1;
+  size_t index = 0;
+  while ((1 << index) < size && index + 1 < mLevels.size()) {
+    index++;
+  }
+
+  const Level & level = mLevels[index];
+  float nearest = 1.0f, farthest = 0.0f;
+  for (int y = minY >> index; y <= (maxY >> index); y++) {
+    for (int x = minX >> index; x <= (maxX >> index); x++) {
+      nearest = std::min(nearest, level.mMin[y * level.mWidth + x]);
+      farthest = std::max(farthest, level.mMax[y * level.mWidth + x]);
+    }
+  }
+
+  // In front of every occluder in the region, so it's visible.
+  if (rect.mMinZ <= nearest) {
+    return false;
+  }
+  return rect.mMinZ > farthest;
+}
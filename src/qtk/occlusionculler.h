@@ -0,0 +1,207 @@
+/*##############################################################################
+## Author: Shaun Reed                                                         ##
+## Legal: All Content (c) 2025 Shaun Reed, all rights reserved                ##
+## About: Software occlusion culling for scene objects                        ##
+##                                                                            ##
+## Contact: shaunrd0@gmail.com  | URL: www.shaunreed.com | GitHub: shaunrd0   ##
+##############################################################################*/
+
+#ifndef QTK_OCCLUSIONCULLER_H
+#define QTK_OCCLUSIONCULLER_H
+
+#include <QMatrix4x4>
+#include <QThreadPool>
+
+#include <vector>
+
+#include "object.h"
+#include "qtkapi.h"
+
+namespace Qtk
+{
+  /**
+   * Hides objects that are fully behind occluders, using only the CPU.
+   *
+   * Occluders are rasterized into a low resolution depth buffer, split into
+   * row bands across a thread pool. Each row is filled four pixels at a time
+   * with SSE2 when available. A min/max depth hierarchy is built from the
+   * buffer, and the screen-space bounding box of every other object is tested
+   * against it. Objects that fail the test are flagged with Object::isCulled.
+   *
+   * Occluders are objects tagged with Object::setOccluder, plus the largest
+   * objects on screen if automatic selection is enabled.
+   *
+   * No OpenGL calls are made, so this also works headless.
+   */
+  class QTKAPI OcclusionCuller
+  {
+    public:
+      /*************************************************************************
+       * Typedefs
+       ************************************************************************/
+
+      /** Results from the last call to `cull()`. */
+      struct Stats {
+          size_t mOccluders {};
+          size_t mOccluderTriangles {};
+          size_t mTested {};
+          size_t mCulled {};
+          /* Time spent rasterizing occluders, in milliseconds. */
+          float mRasterMs {};
+          /* Time spent testing objects against the hierarchy, in ms. */
+          float mTestMs {};
+      };
+
+      /*************************************************************************
+       * Constructors / Destructors
+       ************************************************************************/
+
+      /**
+       * @param width Width of the depth buffer. Rounded up to a multiple of 4.
+       * @param height Height of the depth buffer.
+       */
+      explicit OcclusionCuller(int width = 256, int height = 128);
+
+      ~OcclusionCuller() = default;
+
+      /*************************************************************************
+       * Public Methods
+       ************************************************************************/
+
+      /**
+       * Rasterize occluders and flag all objects hidden behind them.
+       *
+       * @param viewProjection View projection matrix for the current view.
+       * @param objects Objects to consider as occluders and to test.
+       */
+      void cull(const QMatrix4x4 & viewProjection,
+                const std::vector<Object *> & objects);
+
+      /**
+       * Clear the culled flag on all objects.
+       *
+       * @param objects The objects to reset.
+       */
+      static void reset(const std::vector<Object *> & objects);
+
+      /*************************************************************************
+       * Accessors
+       ************************************************************************/
+
+      [[nodiscard]] inline const Stats & getStats() const { return mStats; }
+
+      [[nodiscard]] inline int getWidth() const { return mWidth; }
+
+      [[nodiscard]] inline int getHeight() const { return mHeight; }
+
+      /**
+       * @return Occluder depth for each pixel from the last call to `cull()`.
+       *    Values are in the range [0, 1] where 1 is the far plane.
+       */
+      [[nodiscard]] inline const std::vector<float> & getDepthBuffer() const
+      {
+        return mDepth;
+      }
+
+      /*************************************************************************
+       * Setters
+       ************************************************************************/
+
+      /**
+       * @param width Width of the depth buffer. Rounded up to a multiple of 4.
+       * @param height Height of the depth buffer.
+       */
+      void setResolution(int width, int height);
+
+      /**
+       * @param count Number of the largest objects on screen to use as
+       *    occluders in addition to tagged objects. Use 0 to only use tagged
+       *    objects.
+       */
+      inline void setAutoOccluders(size_t count) { mAutoOccluders = count; }
+
+      /**
+       * @param threads Maximum number of threads used to rasterize occluders.
+       */
+      inline void setThreadCount(int threads)
+      {
+        mPool.setMaxThreadCount(std::max(threads, 1));
+      }
+
+    private:
+      /*************************************************************************
+       * Private Types
+       ************************************************************************/
+
+      /** Triangle in screen space with depth in the range [0, 1]. */
+      struct Triangle {
+          float mX[3], mY[3], mZ[3];
+      };
+
+      /** Screen-space bounds of an object. */
+      struct ScreenRect {
+          float mMinX, mMinY, mMaxX, mMaxY, mMinZ;
+          /* False if the bounds cross the near plane. */
+          bool mValid;
+      };
+
+      /** A level of the depth hierarchy. */
+      struct Level {
+          int mWidth {}, mHeight {};
+          std::vector<float> mMin {}, mMax {};
+      };
+
+      /*************************************************************************
+       * Private Methods
+       ************************************************************************/
+
+      /**
+       * Project an object's bounding box to the screen.
+       */
+      [[nodiscard]] ScreenRect project(const BoundingBox & bounds,
+                                       const QMatrix4x4 & mvp) const;
+
+      /**
+       * Transform the triangles of an occluder to screen space.
+       */
+      void addOccluder(Object * object, const QMatrix4x4 & viewProjection);
+
+      /**
+       * Transform indexed triangles to screen space to be rasterized.
+       * If indices is null, vertices are drawn in order.
+       */
+      void addMesh(const std::vector<QVector3D> & positions,
+                   const GLuint * indices,
+                   size_t indexCount,
+                   const QMatrix4x4 & mvp);
+
+      /**
+       * Rasterize all triangles into rows [firstRow, lastRow).
+       */
+      void rasterize(int firstRow, int lastRow);
+
+      void buildHierarchy();
+
+      /**
+       * @return True if the rect is hidden behind occluders.
+       */
+      [[nodiscard]] bool isOccluded(const ScreenRect & rect) const;
+
+      /*************************************************************************
+       * Private Members
+       ************************************************************************/
+
+      int mWidth {}, mHeight {};
+      size_t mAutoOccluders = 8;
+      std::vector<float> mDepth {};
+      std::vector<Level> mLevels {};
+      std::vector<Triangle> mTriangles {};
+      /* Scratch memory for transforming occluder vertices. */
+      std::vector<QVector3D> mPositions {};
+      std::vector<QVector4D> mClip {};
+      QThreadPool mPool;
+      Stats mStats {};
+  };
+}  // namespace Qtk
+
+#endif  // QTK_OCCLUSIONCULLER_H
@@ -0,0 +1,186 @@
+/*##############################################################################
+## Author: Shaun Reed                                                         ##
+## Legal: All Content (c) 2025 Shaun Reed, all rights reserved                ##
+## About: Renders a Scene to an image without a window                        ##
+##                                                                            ##
+## Contact: shaunrd0@gmail.com  | URL: www.shaunreed.com | GitHub: shaunrd0   ##
+##############################################################################*/
+
+#include <QThread>
+
+#include "offscreenrenderer.h"
+#include "scene.h"
+
+using namespace Qtk;
+
+/*******************************************************************************
+ * Constructors / Destructors
+ ******************************************************************************/
+
+OffscreenRenderer::OffscreenRenderer(const QSize & size,
+                                     int samples,
+                                     QOpenGLContext * shareContext) :
+    mSize(size), mSamples(samples)
+{
+  mContext = new QOpenGLContext;
+  mContext->setFormat(shareContext != Q_NULLPTR ? shareContext->format()
+                                                : getDefaultFormat());
+  mContext->setShareContext(shareContext);
+  if (!mContext->create()) {
+    qDebug() << "[OffscreenRenderer] Failed to create OpenGL context.";
+  }
+
+  mSurface = new QOffscreenSurface;
+  mSurface->setFormat(mContext->format());
+  mSurface->create();
+  if (!mSurface->isValid()) {
+    qDebug() << "[OffscreenRenderer] Failed to create offscreen surface.";
+  }
+}
+
+OffscreenRenderer::~OffscreenRenderer()
+{
+  if (mContext->thread() == QThread::currentThread() && makeCurrent()) {
+    delete mTarget;
+    delete mResolved;
+    doneCurrent();
+  }
+  delete mContext;
+  delete mSurface;
+}
+
+/*******************************************************************************
+ * Public Methods
+ ******************************************************************************/
+
+bool OffscreenRenderer::makeCurrent()
+{
+  if (QOpenGLContext::currentContext() == mContext) {
+    return true;
+  }
+  if (!isValid() || !mContext->makeCurrent(mSurface)) {
+    qDebug() << "[OffscreenRenderer] Failed to make context current.";
+    return false;
+  }
+  if (!mInitialized) {
+    initializeOpenGLFunctions();
+    mInitialized = true;
+  }
+  return true;
+}
+
+void OffscreenRenderer::doneCurrent()
+{
+  mContext->doneCurrent();
+}
+
+void OffscreenRenderer::moveToThread(QThread * thread)
+{
+  mContext->moveToThread(thread);
+}
+
+bool OffscreenRenderer::render(Scene * scene)
+{
+  if (scene == Q_NULLPTR) {
+    return false;
+  }
+  return render(scene, scene->getViewMatrix(), scene->getProjectionMatrix());
+}
+
+bool OffscreenRenderer::render(Scene * scene,
+                               const QMatrix4x4 & view,
+                               const QMatrix4x4 & projection)
+{
+  if (scene == Q_NULLPTR || mSize.isEmpty() || !makeCurrent()) {
+    return false;
+  }
+  updateBuffers();
+
+  mTarget->bind();
+  // Match the OpenGL settings used by QtkWidget.
+  glEnable(GL_DEPTH_TEST);
+  glDepthMask(GL_TRUE);
+  glDepthFunc(GL_LEQUAL);
+  glDepthRangef(0.1f, 1.0f);
+  glClearDepthf(1.0f);
+  glClearColor(0.0f, 0.25f, 0.0f, 0.0f);
+  glViewport(0, 0, mSize.width(), mSize.height());
+  glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+  // Initialize first so objects created by Scene::init are in this frame.
+  scene->initialize();
+  scene->captureFrame(view, projection);
+  scene->draw();
+
+  mTarget->release();
+  QOpenGLFramebufferObject::blitFramebuffer(mResolved, mTarget);
+  ++mFrameCount;
+  return true;
+}
+
+QImage OffscreenRenderer::toImage()
+{
+  if (mResolved == Q_NULLPTR || !makeCurrent()) {
+    return {};
+  }
+  return mResolved->toImage(false);
+}
+
+void OffscreenRenderer::readPixels(std::vector<uchar> & pixels)
+{
+  if (mResolved == Q_NULLPTR || !makeCurrent()) {
+    pixels.clear();
+    return;
+  }
+  const auto size = mResolved->size();
+  pixels.resize(size_t(size.width()) * size.height() * 4);
+  mResolved->bind();
+  glPixelStorei(GL_PACK_ALIGNMENT, 1);
+  glReadPixels(0,
+               0,
+               size.width(),
+               size.height(),
+               GL_RGBA,
+               GL_UNSIGNED_BYTE,
+               pixels.data());
+  mResolved->release();
+}
+
+/*******************************************************************************
+ * Accessors
+ ******************************************************************************/
+
+bool OffscreenRenderer::isValid() const
+{
+  return mContext->isValid() && mSurface->isValid();
+}
+
+QSurfaceFormat OffscreenRenderer::getDefaultFormat()
+{
+  QSurfaceFormat format;
+  format.setRenderableType(QSurfaceFormat::OpenGL);
+  format.setProfile(QSurfaceFormat::CoreProfile);
+  // Drivers return the newest version compatible with the one requested.
+  format.setVersion(3, 3);
+  format.setDepthBufferSize(24);
+  return format;
+}
+
+/*******************************************************************************
+ * Private Methods
+ ******************************************************************************/
+
+void OffscreenRenderer::updateBuffers()
+{
+  if (mTarget != Q_NULLPTR && mTarget->size() == mSize) {
+    return;
+  }
+  delete mTarget;
+  delete mResolved;
+
+  QOpenGLFramebufferObjectFormat format;
+  format.setAttachment(QOpenGLFramebufferObject::CombinedDepthStencil);
+  format.setSamples(mSamples);
+  mTarget = new QOpenGLFramebufferObject(mSize, format);
+  mResolved = new QOpenGLFramebufferObject(mSize);
+}
@@ -0,0 +1,178 @@
+/*##############################################################################
+## Author: Shaun Reed                                                         ##
+## Legal: All Content (c) 2025 Shaun Reed, all rights reserved                ##
+## About: Renders a Scene to an image without a window                        ##
+##                                                                            ##
+## Contact: shaunrd0@gmail.com  | URL: www.shaunreed.com | GitHub: shaunrd0   ##
+##############################################################################*/
+
+#ifndef QTK_OFFSCREENRENDERER_H
+#define QTK_OFFSCREENRENDERER_H
+
+#include <QImage>
+#include <QMatrix4x4>
+#include <QOffscreenSurface>
+#include <QOpenGLContext>
+#include <QOpenGLExtraFunctions>
+#include <QOpenGLFramebufferObject>
+
+#include <vector>
+
+#include "qtkapi.h"
+
+namespace Qtk
+{
+  class Scene;
+
+  /**
+   * Renders a Scene into a framebuffer on a QOffscreenSurface, for use on
+   * machines without a display such as CI or render servers. On Linux this
+   * works with Mesa llvmpipe and EGL using QT_QPA_PLATFORM=offscreen.
+   *
+   * Each renderer has its own OpenGL context, so several renderers can draw
+   * in parallel on separate threads. The renderer must be constructed and
+   * deleted on the GUI thread; use `moveToThread()` before rendering from
+   * another thread, and move it back when done.
+   *
+   * Scenes drawn by a renderer must be created and deleted while its
+   * context is current. See `makeCurrent()`.
+   */
+  class QTKAPI OffscreenRenderer : protected QOpenGLExtraFunctions
+  {
+    public:
+      /*************************************************************************
+       * Constructors / Destructors
+       ************************************************************************/
+
+      /**
+       * @param size Size of the frames to render in pixels.
+       * @param samples Number of samples used for multisampling.
+       * @param shareContext Optional context to share resources with.
+       */
+      explicit OffscreenRenderer(const QSize & size,
+                                 int samples = 4,
+                                 QOpenGLContext * shareContext = Q_NULLPTR);
+
+      ~OffscreenRenderer();
+
+      /*************************************************************************
+       * Public Methods
+       ************************************************************************/
+
+      /**
+       * Make this renderer's context current on the calling thread.
+       *
+       * @return True if the context is current.
+       */
+      bool makeCurrent();
+
+      void doneCurrent();
+
+      /**
+       * Move the context to another thread. Must be called from the thread
+       * the context currently belongs to, with the context not current.
+       *
+       * @param thread The thread that will render with this renderer.
+       */
+      void moveToThread(QThread * thread);
+
+      /**
+       * Draw a frame of the scene as seen by the scene camera.
+       *
+       * @param scene The scene to draw.
+       * @return True if the frame was drawn.
+       */
+      bool render(Scene * scene);
+
+      /**
+       * Draw a frame of the scene from the given view.
+       *
+       * @param scene The scene to draw.
+       * @param view View matrix to draw with.
+       * @param projection Projection matrix to draw with.
+       * @return True if the frame was drawn.
+       */
+      bool render(Scene * scene,
+                  const QMatrix4x4 & view,
+                  const QMatrix4x4 & projection);
+
+      /**
+       * @return The last frame rendered.
+       */
+      [[nodiscard]] QImage toImage();
+
+      /**
+       * Read the last frame rendered as tightly packed RGBA8 pixels, with the
+       * first row at the bottom of the image as returned by glReadPixels.
+       *
+       * @param pixels Buffer to resize and fill with the frame.
+       */
+      void readPixels(std::vector<uchar> & pixels);
+
+      /*************************************************************************
+       * Accessors
+       ************************************************************************/
+
+      /**
+       * @return True if the context and surface were created.
+       */
+      [[nodiscard]] bool isValid() const;
+
+      [[nodiscard]] inline const QSize & getSize() const { return mSize; }
+
+      [[nodiscard]] inline QOpenGLContext * getContext() const
+      {
+        return mContext;
+      }
+
+      /**
+       * @return Number of frames rendered.
+       */
+      [[nodiscard]] inline uint64_t getFrameCount() const
+      {
+        return mFrameCount;
+      }
+
+      /**
+       * @return Surface format used for offscreen contexts by default.
+       */
+      [[nodiscard]] static QSurfaceFormat getDefaultFormat();
+
+      /*************************************************************************
+       * Setters
+       ************************************************************************/
+
+      /**
+       * @param size Size of the frames to render in pixels.
+       */
+      inline void setSize(const QSize & size) { mSize = size; }
+
+    private:
+      /*************************************************************************
+       * Private Methods
+       ************************************************************************/
+
+      /**
+       * Create framebuffers for the current size, if needed.
+       */
+      void updateBuffers();
+
+      /*************************************************************************
+       * Private Members
+       ************************************************************************/
+
+      QOpenGLContext * mContext {};
+      QOffscreenSurface * mSurface {};
+      QSize mSize {};
+      int mSamples = 0;
+      bool mInitialized = false;
+      uint64_t mFrameCount = 0;
+
+      /* Multisampled target the scene is drawn into. */
+      QOpenGLFramebufferObject * mTarget {};
+      /* Target resolved from mTarget, read back by toImage / readPixels. */
+      QOpenGLFramebufferObject * mResolved {};
+  };
+}  // namespace Qtk
+
+#endif  // QTK_OFFSCREENRENDERER_H
@@ -0,0 +1,133 @@
+/*##############################################################################
+## Author: Shaun Reed                                                         ##
+## Legal: All Content (c) 2025 Shaun Reed, all rights reserved                ##
+## About: Chain of full screen passes applied to a rendered frame             ##
+##                                                                            ##
+## Contact: shaunrd0@gmail.com  | URL: www.shaunreed.com | GitHub: shaunrd0   ##
+##############################################################################*/
+
+#include <QVector2D>
+
+#include "postprocesschain.h"
+#include "renderstats.h"
+#include "shaders.h"
+#include "tracer.h"
+
+using namespace Qtk;
+
+/*******************************************************************************
+ * UpscaleStage
+ ******************************************************************************/
+
+void UpscaleStage::apply(GLuint texture,
+                         const QSize & sourceSize,
+                         const QSize & targetSize)
+{
+  Q_UNUSED(targetSize);
+  if (mProgram == Q_NULLPTR) {
+    initializeOpenGLFunctions();
+    Tracer::Span link("Shader Link", "shader");
+    QTK_RENDER_STAT(mShaderLinks, 1);
+    mProgram = new QOpenGLShaderProgram;
+    mProgram->addShaderFromSourceCode(QOpenGLShader::Vertex,
+                                      QTK_SHADER_VERTEX_FULLSCREEN);
+    mProgram->addShaderFromSourceCode(QOpenGLShader::Fragment,
+                                      QTK_SHADER_FRAGMENT_UPSCALE);
+    if (!mProgram->link()) {
+      qDebug() << "[UpscaleStage] Failed to link shader: " << mProgram->log();
+    }
+  }
+
+  glDisable(GL_DEPTH_TEST);
+  mProgram->bind();
+  glActiveTexture(GL_TEXTURE0);
+  glBindTexture(GL_TEXTURE_2D, texture);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+  mProgram->setUniformValue("uSource", 0);
+  mProgram->setUniformValue("uTexelSize",
+                            QVector2D(1.0f / float(sourceSize.width()),
+                                      1.0f / float(sourceSize.height())));
+  mProgram->setUniformValue("uSharpness", mSharpness);
+
+  mVAO.bind();
+  glDrawArrays(GL_TRIANGLES, 0, 3);
+  mVAO.release();
+
+  glBindTexture(GL_TEXTURE_2D, 0);
+  mProgram->release();
+  glEnable(GL_DEPTH_TEST);
+}
+
+void UpscaleStage::release()
+{
+  delete mProgram;
+  mProgram = Q_NULLPTR;
+  mVAO.destroy();
+}
+
+/*******************************************************************************
+ * PostProcessChain
+ ******************************************************************************/
+
+PostProcessStage * PostProcessChain::getStage(const QString & name) const
+{
+  for (const auto & stage : mStages) {
+    if (stage->getName() == name) {
+      return stage.get();
+    }
+  }
+  return Q_NULLPTR;
+}
+
+bool PostProcessChain::process(GLuint texture,
+                               const QSize & sourceSize,
+                               GLuint target,
+                               const QSize & targetSize)
+{
+  std::vector<PostProcessStage *> stages;
+  if (mEnabled) {
+    for (const auto & stage : mStages) {
+      if (stage->isEnabled()) {
+        stages.push_back(stage.get());
+      }
+    }
+  }
+  if (stages.empty()) {
+    return false;
+  }
+
+  if (stages.size() > 1
+      && (mBuffers[0] == Q_NULLPTR || mBuffers[0]->size() != targetSize)) {
+    for (auto & buffer : mBuffers) {
+      delete buffer;
+      buffer = new QOpenGLFramebufferObject(targetSize);
+    }
+  }
+
+  auto gl = QOpenGLContext::currentContext()->functions();
+  QSize size = sourceSize;
+  for (size_t i = 0; i < stages.size(); i++) {
+    auto output = i + 1 == stages.size() ? Q_NULLPTR : mBuffers[i % 2];
+    gl->glBindFramebuffer(GL_FRAMEBUFFER,
+                          output != Q_NULLPTR ? output->handle() : target);
+    gl->glViewport(0, 0, targetSize.width(), targetSize.height());
+    stages[i]->apply(texture, size, targetSize);
+    if (output != Q_NULLPTR) {
+      texture = output->texture();
+      size = targetSize;
+    }
+  }
+  return true;
+}
+
+void PostProcessChain::release()
+{
+  for (auto & buffer : mBuffers) {
+    delete buffer;
+    buffer = Q_NULLPTR;
+  }
+  for (auto & stage : mStages) {
+    stage->release();
+  }
+}
@@ -0,0 +1,215 @@
+/*##############################################################################
+## Author: Shaun Reed                                                         ##
+## Legal: All Content (c) 2025 Shaun Reed, all rights reserved                ##
+## About: Chain of full screen passes applied to a rendered frame             ##
+##                                                                            ##
+## Contact: shaunrd0@gmail.com  | URL: www.shaunreed.com | GitHub: shaunrd0   ##
+##############################################################################*/
+
+#ifndef QTK_POSTPROCESSCHAIN_H
+#define QTK_POSTPROCESSCHAIN_H
+
+#include <QOpenGLFramebufferObject>
+#include <QOpenGLFunctions>
+#include <QOpenGLShaderProgram>
+#include <QString>
+
+#include <memory>
+#include <vector>
+
+#include "qtkapi.h"
+#include "vertexarray.h"
+
+namespace Qtk
+{
+  /**
+   * One full screen pass of a PostProcessChain.
+   */
+  class QTKAPI PostProcessStage
+  {
+    public:
+      /*************************************************************************
+       * Constructors / Destructors
+       ************************************************************************/
+
+      explicit PostProcessStage(QString name) : mName(std::move(name)) {}
+
+      virtual ~PostProcessStage() = default;
+
+      /*************************************************************************
+       * Public Methods
+       ************************************************************************/
+
+      /**
+       * Draw the source texture into the bound framebuffer, covering the
+       * viewport.
+       *
+       * @param texture Texture holding the output of the previous stage.
+       * @param sourceSize Size of the texture in pixels.
+       * @param targetSize Size of the viewport in pixels.
+       */
+      virtual void apply(GLuint texture,
+                         const QSize & sourceSize,
+                         const QSize & targetSize) = 0;
+
+      /**
+       * Delete OpenGL resources. Called with the context current.
+       */
+      virtual void release() {}
+
+      /*************************************************************************
+       * Accessors
+       ************************************************************************/
+
+      [[nodiscard]] inline const QString & getName() const { return mName; }
+
+      [[nodiscard]] inline bool isEnabled() const { return mEnabled; }
+
+      /*************************************************************************
+       * Setters
+       ************************************************************************/
+
+      inline void setEnabled(bool enabled) { mEnabled = enabled; }
+
+    private:
+      QString mName;
+      bool mEnabled = true;
+  };
+
+  /**
+   * Scales a frame to the viewport with bilinear filtering, then sharpens it
+   * to recover detail lost by drawing at a lower resolution.
+   */
+  class QTKAPI UpscaleStage : public PostProcessStage,
+                              protected QOpenGLFunctions
+  {
+    public:
+      /*************************************************************************
+       * Constructors / Destructors
+       ************************************************************************/
+
+      UpscaleStage() : PostProcessStage("Upscale") {}
+
+      /*************************************************************************
+       * Public Methods
+       ************************************************************************/
+
+      void apply(GLuint texture,
+                 const QSize & sourceSize,
+                 const QSize & targetSize) override;
+
+      void release() override;
+
+      /*************************************************************************
+       * Accessors
+       ************************************************************************/
+
+      [[nodiscard]] inline float getSharpness() const { return mSharpness; }
+
+      /*************************************************************************
+       * Setters
+       ************************************************************************/
+
+      /**
+       * @param sharpness Strength of the sharpening, 0 to only upscale.
+       */
+      inline void setSharpness(float sharpness) { mSharpness = sharpness; }
+
+    private:
+      /*************************************************************************
+       * Private Members
+       ************************************************************************/
+
+      QOpenGLShaderProgram * mProgram {};
+      /* Empty; the vertex shader generates the triangle. */
+      VertexArray mVAO;
+      float mSharpness = 0.5f;
+  };
+
+  /**
+   * Ordered list of PostProcessStages applied to a rendered frame.
+   *
+   * The first stage reads the frame and the last writes to the target
+   * framebuffer. Stages between them draw into intermediate framebuffers the
+   * size of the target. Disabling the chain, or every stage in it, leaves it
+   * to the caller to copy the frame to the target.
+   */
+  class QTKAPI PostProcessChain
+  {
+    public:
+      /*************************************************************************
+       * Constructors / Destructors
+       ************************************************************************/
+
+      PostProcessChain() = default;
+
+      PostProcessChain(const PostProcessChain &) = delete;
+      PostProcessChain & operator=(const PostProcessChain &) = delete;
+
+      /*************************************************************************
+       * Public Methods
+       ************************************************************************/
+
+      /**
+       * Append a stage to the chain. The chain takes ownership of the stage.
+       *
+       * @param stage The stage to add.
+       * @return The stage that was added.
+       */
+      template <typename T> T * addStage(T * stage)
+      {
+        mStages.emplace_back(stage);
+        return stage;
+      }
+
+      /**
+       * @param name Name of the stage to find.
+       * @return The first stage with the name, or nullptr.
+       */
+      [[nodiscard]] PostProcessStage * getStage(const QString & name) const;
+
+      /**
+       * Apply every enabled stage. Must be called with a context current.
+       *
+       * @param texture Texture holding the rendered frame.
+       * @param sourceSize Size of the texture in pixels.
+       * @param target Framebuffer to write the result to.
+       * @param targetSize Size of the target framebuffer in pixels.
+       * @return False if nothing was drawn because no stage is enabled.
+       */
+      bool process(GLuint texture,
+                   const QSize & sourceSize,
+                   GLuint target,
+                   const QSize & targetSize);
+
+      /**
+       * Delete OpenGL resources held by the chain and its stages. Must be
+       * called with a context current.
+       */
+      void release();
+
+      /*************************************************************************
+       * Accessors
+       ************************************************************************/
+
+      [[nodiscard]] inline bool isEnabled() const { return mEnabled; }
+
+      /*************************************************************************
+       * Setters
+       ************************************************************************/
+
+      inline void setEnabled(bool enabled) { mEnabled = enabled; }
+
+    private:
+      /*************************************************************************
+       * Private Members
+       ************************************************************************/
+
+      std::vector<std::unique_ptr<PostProcessStage>> mStages {};
+      /* Stages other than the last draw into these in turn. */
+      QOpenGLFramebufferObject * mBuffers[2] {};
+      bool mEnabled = true;
+  };
+}  // namespace Qtk
+
+#endif  // QTK_POSTPROCESSCHAIN_H
@@ -0,0 +1,244 @@
+/*##############################################################################
+## Author: Shaun Reed                                                         ##
+## Legal: All Content (c) 2025 Shaun Reed, all rights reserved                ##
+## About: Dense component storage for lightweight scene entities              ##
+##                                                                            ##
+## Contact: shaunrd0@gmail.com  | URL: www.shaunreed.com | GitHub: shaunrd0   ##
+##############################################################################*/
+
+#include <QVector4D>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include "registry.h"
+#include "scene.h"
+
+using namespace Qtk;
+
+/*******************************************************************************
+ * Public Methods
+ ******************************************************************************/
+
+Entity Registry::create(const QString & name)
+{
+  Entity entity;
+  if (!mFreeSlots.empty()) {
+    entity.mIndex = mFreeSlots.back();
+    mFreeSlots.pop_back();
+  } else {
+    entity.mIndex = static_cast<uint32_t>(mSlots.size());
+    mSlots.push_back(1);
+  }
+  entity.mGeneration = mSlots[entity.mIndex];
+
+  if (!name.isEmpty()) {
+    mNames.insert(entity.mIndex, name);
+    mNameIndex[name] = entity;
+  }
+  return entity;
+}
+
+void Registry::destroy(Entity entity)
+{
+  if (!isAlive(entity)) {
+    qDebug() << "[Registry] Attempt to destroy a stale entity: "
+             << entity.mIndex;
+    return;
+  }
+
+  if (mNames.contains(entity.mIndex)) {
+    if (auto it = mNameIndex.find(mNames.get(entity.mIndex));
+        it != mNameIndex.end() && it->second == entity) {
+      mNameIndex.erase(it);
+    }
+    mNames.erase(entity.mIndex);
+  }
+  if (mTransforms.contains(entity.mIndex)) {
+    mTransformStore.destroy(mTransforms.get(entity.mIndex));
+    mTransforms.erase(entity.mIndex);
+  }
+  mRenderables.erase(entity.mIndex);
+  mBounds.erase(entity.mIndex);
+
+  ++mSlots[entity.mIndex];
+  mFreeSlots.push_back(entity.mIndex);
+}
+
+TransformStore::Handle Registry::addTransform(Entity entity, Entity parent)
+{
+  if (!isAlive(entity)) {
+    qDebug() << "[Registry] Attempt to add a transform to a stale entity: "
+             << entity.mIndex;
+    return TransformStore::kInvalidHandle;
+  }
+  if (mTransforms.contains(entity.mIndex)) {
+    return mTransforms.get(entity.mIndex);
+  }
+
+  auto parentHandle = getTransform(parent);
+  if (parent.isValid() && parentHandle == TransformStore::kInvalidHandle) {
+    qDebug() << "[Registry] Parent entity has no transform: " << parent.mIndex;
+  }
+  auto handle = mTransformStore.create(parentHandle);
+  mTransforms.insert(entity.mIndex, handle);
+  return handle;
+}
+
+void Registry::addRenderable(Entity entity, const MeshRenderer * mesh)
+{
+  if (!isAlive(entity) || mesh == Q_NULLPTR) {
+    qDebug() << "[Registry] Invalid renderable for entity: " << entity.mIndex;
+    return;
+  }
+  if (!mesh->getHandle().isValid()) {
+    qDebug() << "[Registry] Mesh is not in a scene: " << mesh->getName();
+  }
+  mRenderables.insert(entity.mIndex, {mesh->getHandle()});
+  mBounds.insert(entity.mIndex,
+                 {mesh->getBounds(), mesh->getBoundsRevision()});
+  mBoundsDirty = true;
+}
+
+void Registry::update(const Scene & scene)
+{
+  // Meshes may be reallocated after their entities are created.
+  ObjectHandle lastHandle;
+  const MeshRenderer * lastMesh = Q_NULLPTR;
+  const auto & renderEntities = mRenderables.getEntities();
+  const auto & renderables = mRenderables.getData();
+  for (size_t i = 0; i < renderables.size(); i++) {
+    if (renderables[i].mMesh != lastHandle) {
+      lastHandle = renderables[i].mMesh;
+      lastMesh = scene.getObject<MeshRenderer>(lastHandle);
+    }
+    auto & box = mBounds.get(renderEntities[i]);
+    if (lastMesh != Q_NULLPTR
+        && lastMesh->getBoundsRevision() != box.mRevision) {
+      box.mLocal = lastMesh->getBounds();
+      box.mRevision = lastMesh->getBoundsRevision();
+      mBoundsDirty = true;
+    }
+  }
+
+  mTransformStore.update();
+  if (mTransformStore.getUpdateCount() == 0 && !mBoundsDirty) {
+    return;
+  }
+  mBoundsDirty = false;
+
+  // Bounds system; bounds are cheap next to the matrices, so all of them are
+  // refreshed when any transform changed.
+  const auto & entities = mBounds.getEntities();
+  auto & bounds = mBounds.getData();
+  for (size_t i = 0; i < bounds.size(); i++) {
+    auto & box = bounds[i];
+    if (!box.mLocal.mValid || !mTransforms.contains(entities[i])) {
+      continue;
+    }
+    const float * m =
+        mTransformStore.getWorldData(mTransforms.get(entities[i]));
+    const QVector3D center = box.mLocal.getCenter();
+    const QVector3D extent = (box.mLocal.mMax - box.mLocal.mMin) * 0.5f;
+    for (int row = 0; row < 3; row++) {
+      box.mCenter[row] = m[row] * center.x() + m[4 + row] * center.y()
+                         + m[8 + row] * center.z() + m[12 + row];
+      box.mExtent[row] = std::abs(m[row]) * extent.x()
+                         + std::abs(m[4 + row]) * extent.y()
+                         + std::abs(m[8 + row]) * extent.z();
+    }
+  }
+}
+
+void Registry::collectDraws(const Scene & scene,
+                            const QMatrix4x4 & viewProjection,
+                            std::vector<DrawBatch> & batches,
+                            std::vector<float> & matrices)
+{
+  batches.clear();
+  matrices.clear();
+  mVisible.clear();
+
+  // Frustum planes as (normal, distance), from the rows of the matrix.
+  QVector4D planes[6];
+  for (int i = 0; i < 3; i++) {
+    planes[i * 2] = viewProjection.row(3) + viewProjection.row(i);
+    planes[i * 2 + 1] = viewProjection.row(3) - viewProjection.row(i);
+  }
+  auto visible = [&planes](const Bounds & box) {
+    if (!box.mLocal.mValid) {
+      return true;
+    }
+    for (const auto & plane : planes) {
+      float distance = plane.x() * box.mCenter.x()
+                       + plane.y() * box.mCenter.y()
+                       + plane.z() * box.mCenter.z() + plane.w();
+      float radius = std::abs(plane.x()) * box.mExtent.x()
+                     + std::abs(plane.y()) * box.mExtent.y()
+                     + std::abs(plane.z()) * box.mExtent.z();
+      if (distance + radius < 0.0f) {
+        return false;
+      }
+    }
+    return true;
+  };
+
+  // Entities usually share a handful of meshes; resolve each handle once.
+  ObjectHandle lastHandle;
+  MeshRenderer * lastMesh = Q_NULLPTR;
+  const auto & entities = mRenderables.getEntities();
+  const auto & renderables = mRenderables.getData();
+  for (size_t i = 0; i < renderables.size(); i++) {
+    const uint32_t entity = entities[i];
+    if (!mTransforms.contains(entity) || !visible(mBounds.get(entity))) {
+      continue;
+    }
+    if (renderables[i].mMesh != lastHandle) {
+      lastHandle = renderables[i].mMesh;
+      lastMesh = scene.getObject<MeshRenderer>(lastHandle);
+    }
+    if (lastMesh != Q_NULLPTR) {
+      mVisible.emplace_back(
+          lastMesh, mTransformStore.getWorldData(mTransforms.get(entity)));
+    }
+  }
+
+  std::sort(mVisible.begin(),
+            mVisible.end(),
+            [](const auto & a, const auto & b) { return a.first < b.first; });
+  matrices.resize(mVisible.size() * 16);
+  for (size_t i = 0; i < mVisible.size(); i++) {
+    const auto & [mesh, world] = mVisible[i];
+    std::memcpy(&matrices[i * 16], world, 16 * sizeof(float));
+    if (batches.empty() || batches.back().mMesh != mesh) {
+      batches.push_back({mesh, i, 0});
+    }
+    ++batches.back().mCount;
+  }
+  mDrawnCount = mVisible.size();
+}
+
+/*******************************************************************************
+ * Accessors
+ ******************************************************************************/
+
+bool Registry::isAlive(Entity entity) const
+{
+  return entity.mIndex < mSlots.size()
+         && mSlots[entity.mIndex] == entity.mGeneration;
+}
+
+Entity Registry::find(const QString & name) const
+{
+  auto it = mNameIndex.find(name);
+  return it != mNameIndex.end() ? it->second : Entity();
+}
+
+TransformStore::Handle Registry::getTransform(Entity entity) const
+{
+  if (!isAlive(entity) || !mTransforms.contains(entity.mIndex)) {
+    return TransformStore::kInvalidHandle;
+  }
+  return mTransforms.get(entity.mIndex);
+}
@@ -0,0 +1,375 @@
+/*##############################################################################
+## Author: Shaun Reed                                                         ##
+## Legal: All Content (c) 2025 Shaun Reed, all rights reserved                ##
+## About: Dense component storage for lightweight scene entities              ##
+##                                                                            ##
+## Contact: shaunrd0@gmail.com  | URL: www.shaunreed.com | GitHub: shaunrd0   ##
+##############################################################################*/
+
+#ifndef QTK_REGISTRY_H
+#define QTK_REGISTRY_H
+
+#include <QMatrix4x4>
+#include <QString>
+
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "object.h"
+#include "qtkapi.h"
+#include "transformstore.h"
+
+namespace Qtk
+{
+  class MeshRenderer;
+  class Scene;
+
+  /**
+   * Identifier of an entity in a Registry. Like ObjectHandle, destroying the
+   * entity bumps the generation of its slot so stale ids are detected.
+   */
+  struct QTKAPI Entity {
+      static constexpr uint32_t kInvalidIndex = ~uint32_t(0);
+
+      uint32_t mIndex = kInvalidIndex;
+      uint32_t mGeneration = 0;
+
+      [[nodiscard]] inline bool isValid() const
+      {
+        return mIndex != kInvalidIndex;
+      }
+
+      inline bool operator==(const Entity & other) const
+      {
+        return mIndex == other.mIndex && mGeneration == other.mGeneration;
+      }
+
+      inline bool operator!=(const Entity & other) const
+      {
+        return !(*this == other);
+      }
+  };
+
+  /**
+   * Sparse set mapping entity indices to densely packed components.
+   *
+   * Components are stored contiguously in insertion order, and erasing one
+   * moves the last component into its place. Iterate `getData()` alongside
+   * `getEntities()` to visit every component without gaps.
+   */
+  template <typename T> class ComponentPool
+  {
+    public:
+      /*************************************************************************
+       * Public Methods
+       ************************************************************************/
+
+      /**
+       * Add or replace the component of an entity.
+       *
+       * @param entity Index of the entity.
+       * @param value The component.
+       * @return Reference to the stored component.
+       */
+      T & insert(uint32_t entity, T value)
+      {
+        if (contains(entity)) {
+          return mData[mSparse[entity]] = std::move(value);
+        }
+        if (entity >= mSparse.size()) {
+          mSparse.resize(entity + 1, kNone);
+        }
+        mSparse[entity] = static_cast<uint32_t>(mDense.size());
+        mDense.push_back(entity);
+        mData.push_back(std::move(value));
+        return mData.back();
+      }
+
+      /**
+       * Remove the component of an entity, if it has one.
+       *
+       * @param entity Index of the entity.
+       */
+      void erase(uint32_t entity)
+      {
+        if (!contains(entity)) {
+          return;
+        }
+        uint32_t dense = mSparse[entity];
+        uint32_t last = mDense.back();
+        mDense[dense] = last;
+        mData[dense] = std::move(mData.back());
+        mSparse[last] = dense;
+        mDense.pop_back();
+        mData.pop_back();
+        mSparse[entity] = kNone;
+      }
+
+      void clear()
+      {
+        mSparse.clear();
+        mDense.clear();
+        mData.clear();
+      }
+
+      /*************************************************************************
+       * Accessors
+       ************************************************************************/
+
+      [[nodiscard]] inline bool contains(uint32_t entity) const
+      {
+        return entity < mSparse.size() && mSparse[entity] != kNone;
+      }
+
+      /**
+       * @param entity Index of an entity that has this component.
+       */
+      [[nodiscard]] inline T & get(uint32_t entity)
+      {
+        return mData[mSparse[entity]];
+      }
+
+      [[nodiscard]] inline const T & get(uint32_t entity) const
+      {
+        return mData[mSparse[entity]];
+      }
+
+      [[nodiscard]] inline size_t size() const { return mData.size(); }
+
+      /**
+       * @return Entity index of each component, in the order of `getData()`.
+       */
+      [[nodiscard]] inline const std::vector<uint32_t> & getEntities() const
+      {
+        return mDense;
+      }
+
+      [[nodiscard]] inline std::vector<T> & getData() { return mData; }
+
+      [[nodiscard]] inline const std::vector<T> & getData() const
+      {
+        return mData;
+      }
+
+    private:
+      /*************************************************************************
+       * Private Members
+       ************************************************************************/
+
+      static constexpr uint32_t kNone = ~uint32_t(0);
+
+      /* Dense index for each entity index, or kNone. */
+      std::vector<uint32_t> mSparse {};
+      std::vector<uint32_t> mDense {};
+      std::vector<T> mData {};
+  };
+
+  /**
+   * Entities made of plain components stored in dense arrays, for scenes with
+   * many items that only need a transform and shared geometry.
+   *
+   * Each scene Object owns its own shader program, buffers and VAO. An entity
+   * instead refers to a MeshRenderer in the same scene for its geometry and
+   * shaders, so many entities can share one mesh. The entities of each mesh
+   * are drawn with one instanced draw call, reading their world matrices
+   * from a buffer; see MeshRenderer::drawInstanced. Meshes with custom
+   * shaders read their model matrix from a uniform, so their entities are
+   * drawn one call each. Components:
+   *    Name       QString, with a lookup index.
+   *    Transform  A handle into the registry's TransformStore.
+   *    Renderable The MeshRenderer drawn at the entity's transform.
+   *    Bounds     Local and world bounding boxes used for frustum culling.
+   *
+   * Systems run from the Scene when a frame is captured: `update()` rebuilds
+   * dirty transforms and world bounds, and `collectDraws()` culls renderables
+   * and groups them by mesh. Entity transforms are not interpolated between
+   * update steps.
+   *
+   * The registry is owned by a Scene and must only be used on the scene's
+   * thread.
+   */
+  class QTKAPI Registry
+  {
+    public:
+      /*************************************************************************
+       * Typedefs
+       ************************************************************************/
+
+      /** The MeshRenderer drawn for an entity. */
+      struct Renderable {
+          ObjectHandle mMesh {};
+      };
+
+      /** Bounding boxes of an entity's geometry. */
+      struct Bounds {
+          /* Object space, copied from the mesh by `update()`. */
+          BoundingBox mLocal {};
+          /* Object::getBoundsRevision of the mesh when mLocal was copied. */
+          uint64_t mRevision {};
+          /* World space center and half size, updated by `update()`. */
+          QVector3D mCenter {}, mExtent {};
+      };
+
+      /** Consecutive world matrices drawn with the same mesh. */
+      struct DrawBatch {
+          MeshRenderer * mMesh {};
+          /* Index of the first matrix, and the number of matrices. */
+          size_t mFirst {};
+          size_t mCount {};
+      };
+
+      /*************************************************************************
+       * Constructors / Destructors
+       ************************************************************************/
+
+      Registry() = default;
+
+      Registry(const Registry &) = delete;
+      Registry & operator=(const Registry &) = delete;
+
+      /*************************************************************************
+       * Public Methods
+       ************************************************************************/
+
+      /**
+       * @param name Optional name used to find the entity with `find()`.
+       * @return A new entity with no components besides its name.
+       */
+      Entity create(const QString & name = {});
+
+      /**
+       * Destroy an entity and all of its components. Transforms parented to
+       * this entity's transform become roots.
+       *
+       * @param entity The entity to destroy.
+       */
+      void destroy(Entity entity);
+
+      /**
+       * Give an entity a transform.
+       *
+       * @param entity The entity to modify.
+       * @param parent Entity whose transform this one is relative to. It must
+       *    already have a transform.
+       * @return Handle to the transform in `getTransformStore()`.
+       */
+      TransformStore::Handle addTransform(Entity entity, Entity parent = {});
+
+      /**
+       * Draw a mesh at the entity's transform. The entity needs a transform
+       * to be drawn. The mesh must belong to the scene owning this registry.
+       * Hide the mesh itself with Object::setVisible if it is only used as
+       * geometry for entities.
+       *
+       * @param entity The entity to modify.
+       * @param mesh The mesh to draw for the entity.
+       */
+      void addRenderable(Entity entity, const MeshRenderer * mesh);
+
+      /**
+       * Run the transform and bounds systems: rebuild dirty world matrices,
+       * copy the local bounds of meshes whose geometry changed, then rebuild
+       * world bounds if any transform, renderable or mesh changed.
+       *
+       * @param scene Scene used to resolve mesh handles.
+       */
+      void update(const Scene & scene);
+
+      /**
+       * Cull renderable entities against a view frustum and collect the world
+       * matrices of the rest, grouped by mesh. Entities whose mesh was removed
+       * from the scene are skipped.
+       *
+       * @param scene Scene used to resolve mesh handles.
+       * @param viewProjection Projection times view matrix of the frame.
+       * @param batches Receives one batch per mesh.
+       * @param matrices Receives the world matrices the batches refer to,
+       *    16 column major floats each, ready to upload to a buffer.
+       */
+      void collectDraws(const Scene & scene,
+                        const QMatrix4x4 & viewProjection,
+                        std::vector<DrawBatch> & batches,
+                        std::vector<float> & matrices);
+
+      /*************************************************************************
+       * Accessors
+       ************************************************************************/
+
+      [[nodiscard]] bool isAlive(Entity entity) const;
+
+      /**
+       * @param name Name given to `create()`.
+       * @return The most recent entity with the name, or an invalid entity.
+       */
+      [[nodiscard]] Entity find(const QString & name) const;
+
+      /**
+       * @return Handle to the entity's transform, or
+       *    TransformStore::kInvalidHandle if it has none.
+       */
+      [[nodiscard]] TransformStore::Handle getTransform(Entity entity) const;
+
+      [[nodiscard]] inline size_t getEntityCount() const
+      {
+        return mSlots.size() - mFreeSlots.size();
+      }
+
+      [[nodiscard]] inline TransformStore & getTransformStore()
+      {
+        return mTransformStore;
+      }
+
+      [[nodiscard]] inline const ComponentPool<QString> & getNames() const
+      {
+        return mNames;
+      }
+
+      [[nodiscard]] inline const ComponentPool<TransformStore::Handle> &
+          getTransforms() const
+      {
+        return mTransforms;
+      }
+
+      [[nodiscard]] inline const ComponentPool<Renderable> & getRenderables()
+          const
+      {
+        return mRenderables;
+      }
+
+      [[nodiscard]] inline const ComponentPool<Bounds> & getBounds() const
+      {
+        return mBounds;
+      }
+
+      /**
+       * @return Renderable entities drawn by the last `collectDraws()`.
+       */
+      [[nodiscard]] inline size_t getDrawnCount() const { return mDrawnCount; }
+
+    private:
+      /*************************************************************************
+       * Private Members
+       ************************************************************************/
+
+      /* Generation of each entity slot; bumped when the entity is destroyed. */
+      std::vector<uint32_t> mSlots {};
+      std::vector<uint32_t> mFreeSlots {};
+
+      ComponentPool<QString> mNames {};
+      std::unordered_map<QString, Entity> mNameIndex {};
+      ComponentPool<TransformStore::Handle> mTransforms {};
+      ComponentPool<Renderable> mRenderables {};
+      ComponentPool<Bounds> mBounds {};
+      /* True if bounds were added since the last update. */
+      bool mBoundsDirty = false;
+      TransformStore mTransformStore;
+
+      /* Scratch list of (mesh, world matrix) pairs sorted by collectDraws. */
+      std::vector<std::pair<MeshRenderer *, const float *>> mVisible {};
+      size_t mDrawnCount = 0;
+  };
+}  // namespace Qtk
+
+#endif  // QTK_REGISTRY_H
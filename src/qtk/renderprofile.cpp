@@ -0,0 +1,84 @@
+/*##############################################################################
+## Author: Shaun Reed                                                         ##
+## Legal: All Content (c) 2025 Shaun Reed, all rights reserved                ##
+## About: Named sets of surface and quality settings used for rendering       ##
+##                                                                            ##
+## Contact: shaunrd0@gmail.com  | URL: www.shaunreed.com | GitHub: shaunrd0   ##
+##############################################################################*/
+
+#include "renderprofile.h"
+
+using namespace Qtk;
+
+/*******************************************************************************
+ * Public Methods
+ ******************************************************************************/
+
+QSurfaceFormat RenderProfile::toSurfaceFormat() const
+{
+  QSurfaceFormat format;
+  format.setRenderableType(QSurfaceFormat::OpenGL);
+  format.setProfile(QSurfaceFormat::CoreProfile);
+  format.setVersion(4, 6);
+  format.setSamples(mSamples);
+  format.setDepthBufferSize(mDepthBits);
+  format.setSwapInterval(mSwapInterval);
+  format.setOption(QSurfaceFormat::DebugContext, mDebugContext);
+  return format;
+}
+
+QString RenderProfile::toString() const
+{
+  return QString("%1 (debug context %2, debug logging %3, %4x MSAA, "
+                 "swap interval %5, %6 bit depth, %7% resolution)")
+      .arg(mName)
+      .arg(mDebugContext ? "on" : "off")
+      .arg(mDebugLogging ? "on" : "off")
+      .arg(mSamples)
+      .arg(mSwapInterval)
+      .arg(mDepthBits)
+      .arg(qRound(mResolutionScale * 100.0f));
+}
+
+RenderProfile RenderProfile::debug()
+{
+  RenderProfile profile;
+  profile.mName = "debug";
+  profile.mDebugContext = true;
+  profile.mDebugLogging = true;
+  return profile;
+}
+
+RenderProfile RenderProfile::balanced()
+{
+  RenderProfile profile;
+  profile.mName = "balanced";
+  return profile;
+}
+
+RenderProfile RenderProfile::maxThroughput()
+{
+  RenderProfile profile;
+  profile.mName = "max-throughput";
+  profile.mSamples = 0;
+  profile.mSwapInterval = 0;
+  profile.mDepthBits = 16;
+  profile.mResolutionScale = 0.75f;
+  return profile;
+}
+
+bool RenderProfile::get(const QString & name, RenderProfile & profile)
+{
+  for (const auto & preset : {debug(), balanced(), maxThroughput()}) {
+    if (preset.mName == name) {
+      profile = preset;
+      return true;
+    }
+  }
+  return false;
+}
+
+QStringList RenderProfile::getNames()
+{
+  return {debug().mName, balanced().mName, maxThroughput().mName};
+}
@@ -0,0 +1,89 @@
+/*##############################################################################
+## Author: Shaun Reed                                                         ##
+## Legal: All Content (c) 2025 Shaun Reed, all rights reserved                ##
+## About: Named sets of surface and quality settings used for rendering       ##
+##                                                                            ##
+## Contact: shaunrd0@gmail.com  | URL: www.shaunreed.com | GitHub: shaunrd0   ##
+##############################################################################*/
+
+#ifndef QTK_RENDERPROFILE_H
+#define QTK_RENDERPROFILE_H
+
+#include <QString>
+#include <QStringList>
+#include <QSurfaceFormat>
+
+#include "qtkapi.h"
+
+namespace Qtk
+{
+  /**
+   * Named set of settings trading rendering quality and diagnostics for
+   * throughput.
+   *
+   * Settings that belong to the OpenGL context (debug context, depth bits)
+   * only apply to contexts created with `toSurfaceFormat()`. The rest can be
+   * applied to a running view; see QtkWidget::setRenderProfile.
+   */
+  struct QTKAPI RenderProfile {
+      /*************************************************************************
+       * Public Methods
+       ************************************************************************/
+
+      /**
+       * @return OpenGL 4.6 core surface format requesting this profile.
+       */
+      [[nodiscard]] QSurfaceFormat toSurfaceFormat() const;
+
+      /**
+       * @return One line summary of the settings, for logging.
+       */
+      [[nodiscard]] QString toString() const;
+
+      /**
+       * Debug context with every OpenGL message logged, at full quality.
+       */
+      static RenderProfile debug();
+
+      /**
+       * No validation or logging, with 4x MSAA and vsync.
+       */
+      static RenderProfile balanced();
+
+      /**
+       * No MSAA or vsync, drawn at a reduced resolution and upscaled.
+       */
+      static RenderProfile maxThroughput();
+
+      /**
+       * @param name Name of a profile, see `getNames()`.
+       * @param profile Set to the profile if the name is found.
+       * @return True if a profile with the name exists.
+       */
+      static bool get(const QString & name, RenderProfile & profile);
+
+      /**
+       * @return Names of all predefined profiles.
+       */
+      static QStringList getNames();
+
+      /*************************************************************************
+       * Public Members
+       ************************************************************************/
+
+      QString mName;
+      /* Request a debug context, which lets the driver validate every call. */
+      bool mDebugContext = false;
+      /* Forward OpenGL debug messages to the DebugConsole. */
+      bool mDebugLogging = false;
+      /* MSAA samples, or 0 to disable multisampling. */
+      int mSamples = 4;
+      /* Refresh periods between swaps; 0 disables vsync. */
+      int mSwapInterval = 1;
+      int mDepthBits = 24;
+      /* Scale of the drawn resolution relative to the view, in (0, 1]. */
+      float mResolutionScale = 1.0f;
+  };
+}  // namespace Qtk
+
+#endif  // QTK_RENDERPROFILE_H
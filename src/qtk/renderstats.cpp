@@ -0,0 +1,45 @@
+/*##############################################################################
+## Author: Shaun Reed                                                         ##
+## Legal: All Content (c) 2025 Shaun Reed, all rights reserved                ##
+## About: Counters for the OpenGL work submitted each frame                   ##
+##                                                                            ##
+## Contact: shaunrd0@gmail.com  | URL: www.shaunreed.com | GitHub: shaunrd0   ##
+##############################################################################*/
+
+#include <QOpenGLFunctions>
+
+#include <utility>
+
+#include "renderstats.h"
+
+using namespace Qtk;
+
+/* Counters of the frame being drawn on each thread. */
+static thread_local RenderStats tCurrent;
+
+/*******************************************************************************
+ * Public Methods
+ ******************************************************************************/
+
+RenderStats & RenderStats::getCurrent()
+{
+  return tCurrent;
+}
+
+RenderStats RenderStats::takeCurrent()
+{
+  return std::exchange(tCurrent, {});
+}
+
+uint64_t RenderStats::countTriangles(unsigned int mode, uint64_t count)
+{
+  switch (mode) {
+    case GL_TRIANGLES:
+      return count / 3;
+    case GL_TRIANGLE_STRIP:
+    case GL_TRIANGLE_FAN:
+      return count > 2 ? count - 2 : 0;
+    default:
+      return 0;
+  }
+}
@@ -0,0 +1,76 @@
+/*##############################################################################
+## Author: Shaun Reed                                                         ##
+## Legal: All Content (c) 2025 Shaun Reed, all rights reserved                ##
+## About: Counters for the OpenGL work submitted each frame                   ##
+##                                                                            ##
+## Contact: shaunrd0@gmail.com  | URL: www.shaunreed.com | GitHub: shaunrd0   ##
+##############################################################################*/
+
+#ifndef QTK_RENDERSTATS_H
+#define QTK_RENDERSTATS_H
+
+#include <cstdint>
+
+#include "qtkapi.h"
+
+/**
+ * Add to a counter of the frame being drawn on this thread, such as
+ * `QTK_RENDER_STAT(mDrawCalls, 1)`. Compiled out, without evaluating the
+ * value, unless QTK_RENDER_STATS is defined.
+ */
+#ifdef QTK_RENDER_STATS
+#define QTK_RENDER_STAT(counter, value) \
+  (Qtk::RenderStats::getCurrent().counter += (value))
+#else
+#define QTK_RENDER_STAT(counter, value) ((void)0)
+#endif
+
+namespace Qtk
+{
+  /**
+   * Work submitted to OpenGL while drawing one frame.
+   *
+   * Draw paths add to the counters of their thread with QTK_RENDER_STAT, so
+   * a Scene drawn on a RenderThread counts separately from the GUI thread.
+   * Scene::draw takes the counters at the end of each frame, see
+   * Scene::getFrameStats. Work done between frames, such as uploading a
+   * model loaded on the same thread, is counted in the next frame.
+   */
+  struct QTKAPI RenderStats {
+      uint64_t mDrawCalls {};
+      uint64_t mTriangles {};
+      /* Shader programs, vertex arrays and textures bound for drawing. */
+      uint64_t mProgramBinds {};
+      uint64_t mVaoBinds {};
+      uint64_t mTextureBinds {};
+      uint64_t mUniformUploads {};
+      /* Bytes written to buffers on the GPU. */
+      uint64_t mBufferBytes {};
+      /* Objects and entities drawn, and those skipped by culling. */
+      uint64_t mVisibleObjects {};
+      uint64_t mCulledObjects {};
+      /* Slow work done while drawing, reported with frame time hitches. */
+      uint64_t mModelLoads {};
+      uint64_t mShaderLinks {};
+      uint64_t mTextureUploads {};
+
+      /**
+       * @return Counters of the frame being drawn on the calling thread.
+       */
+      static RenderStats & getCurrent();
+
+      /**
+       * @return Counters of the calling thread, which are then reset.
+       */
+      static RenderStats takeCurrent();
+
+      /**
+       * @param mode Primitive mode passed to glDraw*, such as GL_TRIANGLES.
+       * @param count Number of vertices or indices drawn.
+       * @return Number of triangles drawn; 0 for points and lines.
+       */
+      static uint64_t countTriangles(unsigned int mode, uint64_t count);
+  };
+}  // namespace Qtk
+
+#endif  // QTK_RENDERSTATS_H
@@ -0,0 +1,292 @@
+/*##############################################################################
+## Author: Shaun Reed                                                         ##
+## Legal: All Content (c) 2025 Shaun Reed, all rights reserved                ##
+## About: Thread that draws a Scene with its own OpenGL context               ##
+##                                                                            ##
+## Contact: shaunrd0@gmail.com  | URL: www.shaunreed.com | GitHub: shaunrd0   ##
+##############################################################################*/
+
+#include <QElapsedTimer>
+
+#include <algorithm>
+
+#include "renderthread.h"
+#include "frameprofiler.h"
+#include "scene.h"
+
+using namespace Qtk;
+
+/*******************************************************************************
+ * Constructors / Destructors
+ ******************************************************************************/
+
+RenderThread::RenderThread(QOpenGLContext * shareContext, QObject * parent) :
+    QThread(parent)
+{
+  // Names the thread's track in traces and debuggers.
+  setObjectName("RenderThread");
+  mContext = new QOpenGLContext;
+  mContext->setFormat(shareContext->format());
+  mContext->setShareContext(shareContext);
+  if (!mContext->create()) {
+    qDebug() << "[RenderThread] Failed to create OpenGL context.";
+  }
+  mContext->moveToThread(this);
+  mSamples = std::max(mContext->format().samples(), 0);
+
+  // Offscreen surfaces must be created on the GUI thread.
+  mSurface = new QOffscreenSurface;
+  mSurface->setFormat(mContext->format());
+  mSurface->create();
+}
+
+RenderThread::~RenderThread()
+{
+  stop();
+  // Only reached without a context if the thread was never started.
+  for (auto & scene : mRetiredScenes) {
+    delete scene;
+  }
+  delete mScene;
+  delete mContext;
+  delete mSurface;
+}
+
+/*******************************************************************************
+ * Public Methods
+ ******************************************************************************/
+
+void RenderThread::requestFrame(bool wait)
+{
+  // The scene is only replaced from the thread that owns it, which is this one.
+  if (mScene != Q_NULLPTR) {
+    requestFrame(mScene->getViewMatrix(), mScene->getProjectionMatrix(), wait);
+  }
+}
+
+void RenderThread::requestFrame(const QMatrix4x4 & view,
+                                const QMatrix4x4 & projection,
+                                bool wait)
+{
+  QMutexLocker lock(&mMutex);
+  if (mScene == Q_NULLPTR || mStop) {
+    return;
+  }
+
+  mScene->captureFrame(view, projection);
+  mFrameRequested = true;
+  mWake.wakeOne();
+  if (wait && isRunning()) {
+    uint64_t frame = mFrameCount;
+    while (mFrameCount == frame && !mStop) {
+      mFrameDrawn.wait(&mMutex);
+    }
+  }
+}
+
+void RenderThread::stop()
+{
+  {
+    QMutexLocker lock(&mMutex);
+    if (mStop || !isRunning()) {
+      return;
+    }
+    mStop = true;
+    // The scene is deleted on this thread when it exits.
+    if (mScene != Q_NULLPTR) {
+      mScene->moveToThread(this);
+    }
+    mWake.wakeOne();
+  }
+  wait();
+}
+
+GLuint RenderThread::lockFrontBuffer()
+{
+  mMutex.lock();
+  if (!mFrontReady) {
+    return 0;
+  }
+  auto gl = QOpenGLContext::currentContext()->extraFunctions();
+  if (mDrawFence[mFront] != Q_NULLPTR) {
+    gl->glWaitSync(mDrawFence[mFront], 0, GL_TIMEOUT_IGNORED);
+  }
+  return mResolved[mFront]->texture();
+}
+
+void RenderThread::unlockFrontBuffer()
+{
+  if (mFrontReady) {
+    // Let the render thread know when we are done reading before it draws
+    // into this texture again.
+    auto gl = QOpenGLContext::currentContext()->extraFunctions();
+    if (mReadFence[mFront] != Q_NULLPTR) {
+      gl->glDeleteSync(mReadFence[mFront]);
+    }
+    mReadFence[mFront] = gl->glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    gl->glFlush();
+  }
+  mMutex.unlock();
+}
+
+/*******************************************************************************
+ * Setters
+ ******************************************************************************/
+
+void RenderThread::setScene(Scene * scene)
+{
+  QMutexLocker lock(&mMutex);
+  if (mScene != Q_NULLPTR) {
+    mScene->moveToThread(this);
+    mRetiredScenes.push_back(mScene);
+  }
+  mScene = scene;
+  mFrameRequested = true;
+  mWake.wakeOne();
+}
+
+void RenderThread::resize(const QSize & size)
+{
+  QMutexLocker lock(&mMutex);
+  mSize = size;
+}
+
+void RenderThread::setSamples(int samples)
+{
+  QMutexLocker lock(&mMutex);
+  mSamples = std::max(samples, 0);
+}
+
+/*******************************************************************************
+ * Protected Methods
+ ******************************************************************************/
+
+void RenderThread::run()
+{
+  mContext->makeCurrent(mSurface);
+  initializeOpenGLFunctions();
+  FrameProfiler::Bind profiler(
+      mProfiler != Q_NULLPTR ? *mProfiler : FrameProfiler::getInstance());
+
+  // Match the OpenGL settings used by QtkWidget.
+  glEnable(GL_MULTISAMPLE);
+  glEnable(GL_DEPTH_TEST);
+  glDepthMask(GL_TRUE);
+  glDepthFunc(GL_LEQUAL);
+  glDepthRangef(0.1f, 1.0f);
+  glClearDepthf(1.0f);
+  glClearColor(0.0f, 0.25f, 0.0f, 0.0f);
+
+  QMutexLocker lock(&mMutex);
+  while (true) {
+    while (!mStop && !mFrameRequested) {
+      mWake.wait(&mMutex);
+    }
+    if (mStop) {
+      break;
+    }
+    mFrameRequested = false;
+    auto retired = std::move(mRetiredScenes);
+    mRetiredScenes.clear();
+    auto scene = mScene;
+    auto size = mSize;
+    auto samples = mSamples;
+    lock.unlock();
+
+    for (auto & old : retired) {
+      delete old;
+    }
+    if (scene != Q_NULLPTR && !size.isEmpty()) {
+      render(scene, size, samples);
+    }
+
+    lock.relock();
+    ++mFrameCount;
+    mFrameDrawn.wakeAll();
+    emit frameReady();
+  }
+  lock.unlock();
+
+  for (auto & scene : mRetiredScenes) {
+    delete scene;
+  }
+  mRetiredScenes.clear();
+  delete mScene;
+  mScene = Q_NULLPTR;
+  releaseBuffers();
+  mContext->doneCurrent();
+  delete mContext;
+  mContext = Q_NULLPTR;
+  mFrameDrawn.wakeAll();
+}
+
+/*******************************************************************************
+ * Private Methods
+ ******************************************************************************/
+
+void RenderThread::render(Scene * scene, const QSize & size, int samples)
+{
+  FrameProfiler::Scope scope("Render", true);
+  QElapsedTimer timer;
+  timer.start();
+  if (mTarget == Q_NULLPTR || mTarget->size() != size
+      || mTargetSamples != samples) {
+    // The presenting thread can't read the front buffer while we hold this.
+    QMutexLocker lock(&mMutex);
+    releaseBuffers();
+    QOpenGLFramebufferObjectFormat format;
+    format.setAttachment(QOpenGLFramebufferObject::CombinedDepthStencil);
+    format.setSamples(samples);
+    mTarget = new QOpenGLFramebufferObject(size, format);
+    mTargetSamples = samples;
+    for (auto & resolved : mResolved) {
+      resolved = new QOpenGLFramebufferObject(size);
+    }
+    mFrontReady = false;
+  }
+
+  // Only this thread changes mFront, so the back buffer is ours to draw.
+  const int back = mFront ^ 1;
+  if (mReadFence[back] != Q_NULLPTR) {
+    glWaitSync(mReadFence[back], 0, GL_TIMEOUT_IGNORED);
+    glDeleteSync(mReadFence[back]);
+    mReadFence[back] = Q_NULLPTR;
+  }
+
+  mTarget->bind();
+  glViewport(0, 0, size.width(), size.height());
+  glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+  scene->draw();
+  mTarget->release();
+  QOpenGLFramebufferObject::blitFramebuffer(mResolved[back], mTarget);
+
+  if (mDrawFence[back] != Q_NULLPTR) {
+    glDeleteSync(mDrawFence[back]);
+  }
+  mDrawFence[back] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+  // Flush so the fence is visible to the presenting context.
+  glFlush();
+
+  mLastRenderNs.store(timer.nsecsElapsed(), std::memory_order_relaxed);
+  QMutexLocker lock(&mMutex);
+  mFront = back;
+  mFrontReady = true;
+}
+
+void RenderThread::releaseBuffers()
+{
+  delete mTarget;
+  mTarget = Q_NULLPTR;
+  for (int i = 0; i < 2; i++) {
+    delete mResolved[i];
+    mResolved[i] = Q_NULLPTR;
+    if (mDrawFence[i] != Q_NULLPTR) {
+      glDeleteSync(mDrawFence[i]);
+      mDrawFence[i] = Q_NULLPTR;
+    }
+    if (mReadFence[i] != Q_NULLPTR) {
+      glDeleteSync(mReadFence[i]);
+      mReadFence[i] = Q_NULLPTR;
+    }
+  }
+}
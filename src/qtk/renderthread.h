@@ -0,0 +1,234 @@
+/*##############################################################################
+## Author: Shaun Reed                                                         ##
+## Legal: All Content (c) 2025 Shaun Reed, all rights reserved                ##
+## About: Thread that draws a Scene with its own OpenGL context               ##
+##                                                                            ##
+## Contact: shaunrd0@gmail.com  | URL: www.shaunreed.com | GitHub: shaunrd0   ##
+##############################################################################*/
+
+#ifndef QTK_RENDERTHREAD_H
+#define QTK_RENDERTHREAD_H
+
+#include <QMatrix4x4>
+#include <QMutex>
+#include <QOffscreenSurface>
+#include <QOpenGLContext>
+#include <QOpenGLExtraFunctions>
+#include <QOpenGLFramebufferObject>
+#include <QThread>
+#include <QWaitCondition>
+
+#include <atomic>
+#include <vector>
+
+#include "qtkapi.h"
+
+namespace Qtk
+{
+  class FrameProfiler;
+  class Scene;
+
+  /**
+   * Draws a Scene on a dedicated thread.
+   *
+   * The thread owns an OpenGL context shared with the presenting context, and
+   * draws into a multisampled framebuffer. Each frame is resolved into one of
+   * two textures; the presenting thread draws the front texture while the
+   * next frame is drawn into the back texture. GL sync objects order access
+   * to the textures between the two contexts.
+   *
+   * The presenting thread keeps updating the scene. `requestFrame()` captures
+   * a snapshot of the scene with Scene::captureFrame, so the next update can
+   * run while the snapshot is drawn. See Scene for what may be done in
+   * `Scene::update()` when drawing on another thread.
+   */
+  class QTKAPI RenderThread : public QThread, protected QOpenGLExtraFunctions
+  {
+      Q_OBJECT
+
+    public:
+      /*************************************************************************
+       * Constructors / Destructors
+       ************************************************************************/
+
+      /**
+       * Must be constructed on the GUI thread.
+       *
+       * @param shareContext Context that presents frames from this thread.
+       * @param parent Parent QObject for this thread.
+       */
+      explicit RenderThread(QOpenGLContext * shareContext,
+                            QObject * parent = Q_NULLPTR);
+
+      /**
+       * Stops the thread and deletes the scene.
+       */
+      ~RenderThread() override;
+
+      /*************************************************************************
+       * Public Methods
+       ************************************************************************/
+
+      /**
+       * Capture the scene and wake the thread to draw it. If the thread is
+       * still drawing, the newest snapshot is drawn next and older ones are
+       * dropped. Must be called from the thread that owns the scene.
+       *
+       * @param wait True to block until the frame has been drawn.
+       */
+      void requestFrame(bool wait = false);
+
+      /**
+       * Capture the scene as seen from a view with its own camera, and wake
+       * the thread to draw it.
+       *
+       * @param view View matrix to draw the frame with.
+       * @param projection Projection matrix to draw the frame with.
+       * @param wait True to block until the frame has been drawn.
+       */
+      void requestFrame(const QMatrix4x4 & view,
+                        const QMatrix4x4 & projection,
+                        bool wait = false);
+
+      /**
+       * Stop drawing and wait for the thread to exit.
+       */
+      void stop();
+
+      /**
+       * Make the front texture available to the presenting context.
+       * Must be called with the presenting context current, and always
+       * followed by `unlockFrontBuffer()` once drawing with the texture is
+       * submitted. Buffers are not swapped while the front buffer is locked.
+       *
+       * @return Texture holding the latest frame, or 0 if none is ready.
+       */
+      GLuint lockFrontBuffer();
+
+      /**
+       * Release the texture returned by `lockFrontBuffer()`.
+       */
+      void unlockFrontBuffer();
+
+      /*************************************************************************
+       * Accessors
+       ************************************************************************/
+
+      [[nodiscard]] inline Scene * getScene() const { return mScene; }
+
+      /**
+       * @return Number of frames drawn by this thread.
+       */
+      [[nodiscard]] inline uint64_t getFrameCount() const
+      {
+        return mFrameCount;
+      }
+
+      /**
+       * @return CPU time spent drawing the latest frame, in milliseconds.
+       *    Safe to call from any thread.
+       */
+      [[nodiscard]] inline float getLastRenderMs() const
+      {
+        return float(mLastRenderNs.load(std::memory_order_relaxed)) / 1.0e6f;
+      }
+
+      /*************************************************************************
+       * Setters
+       ************************************************************************/
+
+      /**
+       * Set the scene to draw. The thread takes ownership of the scene, and
+       * the previous scene is deleted on this thread with its context current.
+       * Must be called from the thread that owns the scene.
+       *
+       * @param scene The new scene to draw.
+       */
+      void setScene(Scene * scene);
+
+      /**
+       * @param size Size of the frames to draw in pixels.
+       */
+      void resize(const QSize & size);
+
+      /**
+       * @param samples MSAA samples used to draw frames, or 0 to disable.
+       */
+      void setSamples(int samples);
+
+      /**
+       * Must be called before the thread is started.
+       *
+       * @param profiler Profiler timing frames drawn by this thread, usually
+       *    the presenting view's. FrameProfiler::getInstance() if null.
+       */
+      inline void setProfiler(FrameProfiler * profiler)
+      {
+        mProfiler = profiler;
+      }
+
+    signals:
+      /**
+       * Emitted from the render thread after a frame is ready to present.
+       */
+      void frameReady();
+
+    protected:
+      /*************************************************************************
+       * Protected Methods
+       ************************************************************************/
+
+      void run() override;
+
+    private:
+      /*************************************************************************
+       * Private Methods
+       ************************************************************************/
+
+      /**
+       * Draw a frame into the back texture.
+       */
+      void render(Scene * scene, const QSize & size, int samples);
+
+      /**
+       * Delete the framebuffers and sync objects used by this thread.
+       */
+      void releaseBuffers();
+
+      /*************************************************************************
+       * Private Members
+       ************************************************************************/
+
+      QOpenGLContext * mContext {};
+      QOffscreenSurface * mSurface {};
+
+      /* Guards all members below, and is held while the front is locked. */
+      QMutex mMutex;
+      QWaitCondition mWake;
+      QWaitCondition mFrameDrawn;
+      bool mStop = false;
+      bool mFrameRequested = false;
+      Scene * mScene {};
+      FrameProfiler * mProfiler {};
+      /* Scenes replaced by setScene waiting to be deleted on this thread. */
+      std::vector<Scene *> mRetiredScenes {};
+      QSize mSize {};
+      int mSamples = 0;
+      uint64_t mFrameCount = 0;
+
+      /* Multisampled target the scene is drawn into. */
+      QOpenGLFramebufferObject * mTarget {};
+      int mTargetSamples = 0;
+      /* Resolved frames; mFront is presented while mFront ^ 1 is drawn. */
+      QOpenGLFramebufferObject * mResolved[2] {};
+      int mFront = 0;
+      bool mFrontReady = false;
+      std::atomic<int64_t> mLastRenderNs {0};
+      /* Signaled when drawing to each texture completes. */
+      GLsync mDrawFence[2] {};
+      /* Signaled when the presenting context is done reading each texture. */
+      GLsync mReadFence[2] {};
+  };
+}  // namespace Qtk
+
+#endif  // QTK_RENDERTHREAD_H
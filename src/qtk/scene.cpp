@@ -6,13 +6,25 @@
 ## Contact: shaunrd0@gmail.com  | URL: www.shaunreed.com | GitHub: shaunrd0   ##
 ##############################################################################*/
 
+#include <QOpenGLExtraFunctions>
+#include <QThread>
+
+#include <algorithm>
+
 #include "scene.h"
 #include "camera3d.h"
+#include "frameprofiler.h"
+#include "memorytracker.h"
+#include "shaders.h"
+#include "tracer.h"
 
 using namespace Qtk;
 
-Camera3D Scene::mCamera;
-QMatrix4x4 Scene::mProjection;
+/* View of the frame being drawn, kept per thread so a render thread never
+ * reads the camera while the GUI thread is moving it. */
+static thread_local QMatrix4x4 sDrawView;
+static thread_local QMatrix4x4 sDrawProjection;
+static thread_local QVector3D sDrawCameraPosition;
 
 /*******************************************************************************
  * Constructors / Destructors
@@ -26,6 +38,33 @@ Scene::Scene() : mSceneName("Default Scene")
 
 Scene::~Scene()
 {
+  delete mStaticBatch;
+  delete mOcclusionCuller;
+  delete mDepthProgram;
+  if (auto context = QOpenGLContext::currentContext();
+      context != Q_NULLPTR && context == mQueryContext) {
+    for (auto & query : mSampleQueries) {
+      if (query.mShaded != 0) {
+        context->extraFunctions()->glDeleteQueries(1, &query.mPrepass);
+        context->extraFunctions()->glDeleteQueries(1, &query.mShaded);
+      }
+    }
+  }
+  for (auto & object : mRemovedObjects) {
+    delete object;
+  }
+  for (auto & skybox : mRemovedSkyboxes) {
+    delete skybox;
+  }
+  // Work handed to a frame that was never drawn.
+  for (auto frame : {&mPendingFrame, &mFrame}) {
+    for (auto & object : frame->mRemovedObjects) {
+      delete object;
+    }
+    for (auto & skybox : frame->mRemovedSkyboxes) {
+      delete skybox;
+    }
+  }
   for (auto & mesh : mMeshes) {
     delete mesh;
   }
@@ -41,78 +80,426 @@ Scene::~Scene()
 
 template <> MeshRenderer * Scene::addObject(MeshRenderer * object)
 {
+  // Objects created on a render thread are owned by the scene's thread.
+  if (object->thread() == QThread::currentThread()) {
+    object->moveToThread(thread());
+  }
   initSceneObjectName(object);
+  insertHandle(object, mMeshes.size());
   mMeshes.push_back(object);
-  emit sceneUpdated(mSceneName);
+  mStaticBatchDirty = true;
+  requestRender();
+  objectChanged(object->getName(), true);
   return object;
 }
 
 template <> Model * Scene::addObject(Model * object)
 {
+  if (object->thread() == QThread::currentThread()) {
+    object->moveToThread(thread());
+  }
   initSceneObjectName(object);
+  insertHandle(object, mModels.size());
   mModels.push_back(object);
-  emit sceneUpdated(mSceneName);
+  mStaticBatchDirty = true;
+  requestRender();
+  objectChanged(object->getName(), true);
   return object;
 }
 
 template <> void Scene::removeObject(MeshRenderer * object)
 {
-  auto it = std::find(mMeshes.begin(), mMeshes.end(), object);
-  if (it == mMeshes.end()) {
+  if (!eraseObject(mMeshes, object)) {
     qDebug() << "[Scene::removeObject]: Failed to remove object: "
              << object->getName() << " (" << object << ")";
     return;
   }
 
   --mObjectCount[object->getName()];
-  mMeshes.erase(it);
-  emit sceneUpdated(mSceneName);
+  releaseHandle(object);
+  // The scene graph is only modified on the scene's thread.
+  object->detachAll();
+  mStaticBatchDirty = true;
+  // GL resources are released in draw() while the context is current.
+  mRemovedObjects.push_back(object);
+  requestRender();
+  objectChanged(object->getName(), false);
 }
 
 template <> void Scene::removeObject(Model * object)
 {
-  auto it = std::find(mModels.begin(), mModels.end(), object);
-  if (it == mModels.end()) {
+  if (!eraseObject(mModels, object)) {
     qDebug() << "[Scene::removeObject]: Failed to remove object: "
              << object->getName() << " (" << object << ")";
     return;
   }
 
   --mObjectCount[object->getName()];
-  mModels.erase(it);
-  emit sceneUpdated(mSceneName);
+  releaseHandle(object);
+  // The scene graph is only modified on the scene's thread.
+  object->detachAll();
+  mStaticBatchDirty = true;
+  // GL resources are released in draw() while the context is current.
+  mRemovedObjects.push_back(object);
+  requestRender();
+  objectChanged(object->getName(), false);
+}
+
+void Scene::endUpdate()
+{
+  if (mUpdateDepth == 0) {
+    qDebug() << "[Scene::endUpdate]: Called without beginUpdate()";
+    return;
+  }
+  if (--mUpdateDepth == 0) {
+    notifyChanges();
+  }
 }
 
 void Scene::draw()
+{
+  FrameProfiler::Scope scope("Draw");
+  Tracer::Span span("Scene::draw", "render");
+  initialize();
+
+  // When drawing on the scene's own thread there is no one else to capture,
+  // unless the caller captured a frame with a view of their own.
+  if (thread() == QThread::currentThread()) {
+    mFrameMutex.lock();
+    bool pending = mFramePending;
+    mFrameMutex.unlock();
+    if (!pending) {
+      captureFrame();
+    }
+  }
+  applyFrame();
+  GpuAllocator::getInstance().collect();
+  VertexArray::deleteOrphans();
+
+  // Keep the batch in step with removed objects even while paused.
+  updateStaticBatch();
+  if (mFrame.mPause) {
+    recordFrameStats();
+    return;
+  }
+
+  beforeDraw();
+  if (mOcclusionCuller != Q_NULLPTR) {
+    FrameProfiler::Scope cull("Occlusion Cull", true);
+    mOcclusionCuller->cull(mFrame.mProjection * mFrame.mView, mFrame.mObjects);
+  }
+
+  sortDrawList();
+
+  // Entities are drawn first so their depth is in place for the prepass.
+  QTK_RENDER_STAT(mVisibleObjects, mFrame.mEntityMatrices.size() / 16);
+  QTK_RENDER_STAT(mCulledObjects,
+                  mFrame.mEntityCount - mFrame.mEntityMatrices.size() / 16);
+  if (!mFrame.mEntityBatches.empty()) {
+    FrameProfiler::Scope entities("Entities", true);
+    drawEntities();
+  }
+
+  // Queries are read a few frames after they are issued so we never wait on
+  // the GPU. Sample queries are not available on OpenGL ES.
+  auto context = QOpenGLContext::currentContext();
+  auto gl = context->extraFunctions();
+  if (mQueryContext == Q_NULLPTR && !context->isOpenGLES()) {
+    mQueryContext = context;
+    connect(context, &QOpenGLContext::aboutToBeDestroyed, this, [this]() {
+      // Query names are deleted with the context.
+      for (auto & query : mSampleQueries) {
+        query = {};
+      }
+      mQueryContext = Q_NULLPTR;
+    });
+  }
+  bool queries = context == mQueryContext;
+  auto & query = mSampleQueries[mSampleFrame];
+  if (queries) {
+    mSampleFrame = (mSampleFrame + 1) % kSampleQueryFrames;
+    readSampleQuery(query);
+    if (query.mShaded == 0) {
+      gl->glGenQueries(1, &query.mPrepass);
+      gl->glGenQueries(1, &query.mShaded);
+    }
+  }
+
+  const bool prepass = mFrame.mDepthPrepass;
+  if (prepass) {
+    if (mDepthProgram == Q_NULLPTR) {
+      Tracer::Span link("Shader Link", "shader");
+      QTK_RENDER_STAT(mShaderLinks, 1);
+      mDepthProgram = new QOpenGLShaderProgram;
+      mDepthProgram->addShaderFromSourceCode(QOpenGLShader::Vertex,
+                                             QTK_SHADER_VERTEX_DEPTH);
+      mDepthProgram->addShaderFromSourceCode(QOpenGLShader::Fragment,
+                                             QTK_SHADER_FRAGMENT_DEPTH);
+      if (!mDepthProgram->link()) {
+        qDebug() << "[Scene] Failed to link depth shader: "
+                 << mDepthProgram->log();
+      }
+    }
+
+    FrameProfiler::Scope prepassScope("Depth Prepass", true);
+    glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+    if (queries) {
+      gl->glBeginQuery(GL_SAMPLES_PASSED, query.mPrepass);
+    }
+    for (const auto & [depth, object] : mDrawList) {
+      drawObject(object, mDepthProgram);
+    }
+    if (queries) {
+      gl->glEndQuery(GL_SAMPLES_PASSED);
+    }
+    glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+
+    // Only the closest fragment at each pixel passes the depth test now.
+    glDepthFunc(GL_LEQUAL);
+    glDepthMask(GL_FALSE);
+  }
+
+  {
+    FrameProfiler::Scope shaded("Objects", true);
+    if (queries) {
+      gl->glBeginQuery(GL_SAMPLES_PASSED, query.mShaded);
+    }
+    // Objects are sorted by depth, so meshes and models are interleaved.
+    // Submission is timed per run of objects of the same type instead.
+    int64_t typeNs[2] {};
+    uint32_t typeCalls[2] {};
+    QElapsedTimer timer;
+    timer.start();
+    int64_t runStart = 0;
+    for (size_t i = 0; i < mDrawList.size(); i++) {
+      auto object = mDrawList[i].second;
+      drawObject(object, Q_NULLPTR);
+      const int type = object->getType() == Object::QTK_MODEL ? 1 : 0;
+      ++typeCalls[type];
+      if (i + 1 == mDrawList.size()
+          || mDrawList[i + 1].second->getType() != object->getType()) {
+        auto now = timer.nsecsElapsed();
+        typeNs[type] += now - runStart;
+        runStart = now;
+      }
+    }
+    auto & profiler = FrameProfiler::getCurrent();
+    if (typeCalls[0] > 0) {
+      profiler.record("Meshes", typeNs[0], typeCalls[0]);
+    }
+    if (typeCalls[1] > 0) {
+      profiler.record("Models", typeNs[1], typeCalls[1]);
+    }
+    if (queries) {
+      gl->glEndQuery(GL_SAMPLES_PASSED);
+      query.mPending = true;
+      query.mPrepassed = prepass;
+    }
+  }
+  mDrawStats.mObjects = mDrawList.size();
+
+  if (prepass) {
+    glDepthFunc(GL_LESS);
+    glDepthMask(GL_TRUE);
+  }
+
+  if (mStaticBatch != Q_NULLPTR) {
+    FrameProfiler::Scope batch("Static Batch", true);
+    mStaticBatch->draw();
+  }
+  // The skybox is drawn on the far plane, so drawing it last only shades the
+  // pixels not already covered by the scene.
+  if (mFrame.mSkybox != Q_NULLPTR) {
+    FrameProfiler::Scope skybox("Skybox", true);
+    mFrame.mSkybox->draw();
+  }
+  recordFrameStats();
+}
+
+void Scene::initialize()
 {
   if (!mInit) {
     initializeOpenGLFunctions();
+    // Report everything init() adds at once.
+    beginUpdate();
     init();
+    endUpdate();
     mInit = true;
   }
+}
 
-  // Check if there were new models added that still need to be loaded.
-  // This is for objects added at runtime via click-and-drag events, etc.
+void Scene::captureFrame(const QMatrix4x4 & view,
+                         const QMatrix4x4 & projection)
+{
+  FrameProfiler::Scope scope("Capture");
+  auto & frame = mCapture;
+  // Draw transforms part way between the last two update steps.
+  Transform3D::setInterpolation(getInterpolation());
+  frame.mView = view;
+  frame.mProjection = projection;
+  frame.mCameraPosition = view.inverted().column(3).toVector3D();
+  frame.mObjects = getObjects();
+  frame.mMatrices.clear();
+  frame.mRevisions.clear();
+  // World matrices are cached, so only moved subtrees are recomputed here.
+  const uint64_t updates = Transform3D::getMatrixUpdates();
+  for (const auto & object : frame.mObjects) {
+    auto & transform = object->getTransform();
+    frame.mMatrices.push_back(transform.toMatrix());
+    frame.mRevisions.push_back(transform.getWorldRevision());
+  }
+  mTransformUpdates = Transform3D::getMatrixUpdates() - updates;
+  mRegistry.update(*this);
+  mTransformUpdates += mRegistry.getTransformStore().getUpdateCount();
+  {
+    FrameProfiler::Scope cull("Frustum Cull");
+    mRegistry.collectDraws(
+        *this, projection * view, frame.mEntityBatches, frame.mEntityMatrices);
+  }
+  frame.mEntityCount = mRegistry.getRenderables().size();
+  frame.mMeshes = mMeshes;
+  frame.mModels = mModels;
+  frame.mSkybox = mSkybox;
+
+  frame.mRemovedObjects.swap(mRemovedObjects);
+  frame.mRemovedSkyboxes.swap(mRemovedSkyboxes);
   while (!mModelLoadQueue.empty()) {
-    auto modelSpec = mModelLoadQueue.front();
-    // Load the model and add it to the scene.
-    addObject(new Model(modelSpec.first.c_str(), modelSpec.second.c_str()));
+    frame.mModelLoads.push_back(mModelLoadQueue.front());
     mModelLoadQueue.pop();
   }
+  frame.mStaticBatchDirty = mStaticBatchDirty;
+  mStaticBatchDirty = false;
 
-  if (mPause) {
-    return;
+  frame.mStaticRevision = Object::getStaticRevision();
+  frame.mStaticBatching = mStaticBatching;
+  frame.mOcclusionCulling = mOcclusionCulling;
+  frame.mDepthPrepass = mDepthPrepass;
+  frame.mPause = mPause;
+
+  {
+    QMutexLocker lock(&mFrameMutex);
+    std::swap(mPendingFrame, mCapture);
+    if (mFramePending) {
+      // The previous frame was never drawn, so hand its work to this one.
+      auto & pending = mPendingFrame;
+      pending.mRemovedObjects.insert(pending.mRemovedObjects.end(),
+                                     mCapture.mRemovedObjects.begin(),
+                                     mCapture.mRemovedObjects.end());
+      pending.mRemovedSkyboxes.insert(pending.mRemovedSkyboxes.end(),
+                                      mCapture.mRemovedSkyboxes.begin(),
+                                      mCapture.mRemovedSkyboxes.end());
+      pending.mModelLoads.insert(pending.mModelLoads.begin(),
+                                 mCapture.mModelLoads.begin(),
+                                 mCapture.mModelLoads.end());
+      pending.mStaticBatchDirty |= mCapture.mStaticBatchDirty;
+    }
+    mFramePending = true;
   }
+  mCapture.mRemovedObjects.clear();
+  mCapture.mRemovedSkyboxes.clear();
+  mCapture.mModelLoads.clear();
+}
 
-  if (mSkybox != Q_NULLPTR) {
-    mSkybox->draw();
+void Scene::applyFrame()
+{
+  {
+    QMutexLocker lock(&mFrameMutex);
+    if (mFramePending) {
+      std::swap(mFrame, mPendingFrame);
+      mFramePending = false;
+    }
   }
-  for (const auto & model : mModels) {
-    model->draw();
+
+  sDrawView = mFrame.mView;
+  sDrawProjection = mFrame.mProjection;
+  sDrawCameraPosition = mFrame.mCameraPosition;
+  for (size_t i = 0; i < mFrame.mObjects.size(); ++i) {
+    mFrame.mObjects[i]->mDrawMatrix = mFrame.mMatrices[i];
+    mFrame.mObjects[i]->mDrawRevision = mFrame.mRevisions[i];
+  }
+
+  // Check if there were new models added that still need to be loaded.
+  // This is for objects added at runtime via click-and-drag events, etc.
+  for (const auto & [name, path] : mFrame.mModelLoads) {
+    auto model = new Model(name.c_str(), path.c_str());
+    if (thread() == QThread::currentThread()) {
+      addObject(model);
+    } else {
+      // Hand the loaded model to the scene's thread; it is captured next frame.
+      model->moveToThread(thread());
+      QMetaObject::invokeMethod(
+          this, [this, model]() { addObject(model); }, Qt::QueuedConnection);
+    }
+  }
+  mFrame.mModelLoads.clear();
+
+  // Delete objects removed since the last frame and let the allocator release
+  // or compact GPU memory they were using.
+  for (auto & object : mFrame.mRemovedObjects) {
+    if (mStaticBatch != Q_NULLPTR) {
+      mStaticBatch->release(object);
+    }
+    delete object;
+  }
+  mFrame.mRemovedObjects.clear();
+  for (auto & skybox : mFrame.mRemovedSkyboxes) {
+    delete skybox;
+  }
+  mFrame.mRemovedSkyboxes.clear();
+
+  if (mFrame.mOcclusionCulling && mOcclusionCuller == Q_NULLPTR) {
+    mOcclusionCuller = new OcclusionCuller;
+  } else if (!mFrame.mOcclusionCulling && mOcclusionCuller != Q_NULLPTR) {
+    OcclusionCuller::reset(mFrame.mObjects);
+    delete mOcclusionCuller;
+    mOcclusionCuller = Q_NULLPTR;
+  }
+}
+
+float Scene::tick()
+{
+  float elapsed = 0.0f;
+  if (mClock.isValid()) {
+    // Clamp long pauses, e.g. while a window is being dragged.
+    elapsed = std::min(float(mClock.nsecsElapsed()) / 1.0e9f,
+                       kMaxSteps * mFixedStep);
+    mClock.restart();
+  } else {
+    mClock.start();
+  }
+  tick(elapsed);
+  return elapsed;
+}
+
+void Scene::tick(float elapsed)
+{
+  if (mPause) {
+    return;
   }
-  for (const auto & mesh : mMeshes) {
-    mesh->draw();
+
+  FrameProfiler::Scope scope("Update");
+  mAccumulator += elapsed;
+  int steps = 0;
+  // Update with uninterpolated transforms so the scene sees current state.
+  Transform3D::setInterpolation(1.0f);
+  while (mAccumulator >= mFixedStep && steps < kMaxSteps) {
+    for (auto mesh : mMeshes) {
+      mesh->getTransform().storePrevious();
+    }
+    for (auto model : mModels) {
+      model->getTransform().storePrevious();
+    }
+    {
+      Tracer::Span span("Scene::update", "update");
+      update(mFixedStep);
+    }
+    mAccumulator -= mFixedStep;
+    mTime += mFixedStep;
+    ++steps;
   }
+  // Drop time we could not catch up on.
+  mAccumulator = std::min(mAccumulator, mFixedStep);
+  Transform3D::setInterpolation(getInterpolation());
 }
 
 std::vector<Object *> Scene::getObjects() const
@@ -128,20 +515,266 @@ std::vector<Object *> Scene::getObjects() const
   return objects;
 }
 
-Object * Scene::getObject(const QString & name) const
+Object * Scene::getObject(ObjectHandle handle) const
+{
+  QMutexLocker lock(&mSlotsMutex);
+  if (handle.mIndex >= mSlots.size()
+      || mSlots[handle.mIndex].mGeneration != handle.mGeneration) {
+    return Q_NULLPTR;
+  }
+  return mSlots[handle.mIndex].mObject;
+}
+
+template <> MeshRenderer * Scene::getObject(ObjectHandle handle) const
 {
-  for (const auto & object : getObjects()) {
-    if (object->getName() == name) {
-      return object;
+  auto object = getObject(handle);
+  return object != Q_NULLPTR && object->getType() == Object::QTK_MESH
+             ? static_cast<MeshRenderer *>(object)
+             : Q_NULLPTR;
+}
+
+template <> Model * Scene::getObject(ObjectHandle handle) const
+{
+  auto object = getObject(handle);
+  return object != Q_NULLPTR && object->getType() == Object::QTK_MODEL
+             ? static_cast<Model *>(object)
+             : Q_NULLPTR;
+}
+
+ObjectHandle Scene::getHandle(const QString & name) const
+{
+  QMutexLocker lock(&mSlotsMutex);
+  auto it = mNameIndex.find(name);
+  return it != mNameIndex.end() ? it->second : ObjectHandle();
+}
+
+RenderStats Scene::getFrameStats() const
+{
+  QMutexLocker lock(&mFrameStatsMutex);
+  if (mFrameStatsCount == 0) {
+    return {};
+  }
+  return mFrameStats[(mFrameStatsCount - 1) % kFrameStatsHistory];
+}
+
+std::vector<RenderStats> Scene::getFrameStatsHistory() const
+{
+  QMutexLocker lock(&mFrameStatsMutex);
+  auto count = std::min(mFrameStatsCount, kFrameStatsHistory);
+  std::vector<RenderStats> history;
+  history.reserve(count);
+  for (auto i = mFrameStatsCount - count; i < mFrameStatsCount; i++) {
+    history.push_back(mFrameStats[i % kFrameStatsHistory]);
+  }
+  return history;
+}
+
+QString Scene::getMemoryReport() const
+{
+  auto & memory = MemoryTracker::getInstance();
+  std::vector<std::pair<Object *, MemoryTracker::Usage>> objects;
+  for (auto object : getObjects()) {
+    objects.emplace_back(object, memory.getTotal(object));
+  }
+  std::sort(objects.begin(), objects.end(), [](const auto & a, const auto & b) {
+    return a.second.mLive > b.second.mLive;
+  });
+
+  QString report = memory.toString() + "\n";
+  for (const auto & [object, usage] : objects) {
+    report += QString("\n%1: %2 (peak %3)")
+                  .arg(object->getName())
+                  .arg(MemoryTracker::formatBytes(usage.mLive))
+                  .arg(MemoryTracker::formatBytes(usage.mPeak));
+    for (size_t i = 0; i < QTK_MEMORY_CATEGORY_COUNT; i++) {
+      auto category = static_cast<MemoryCategory>(i);
+      auto bytes = memory.getUsage(object, category).mLive;
+      if (bytes > 0) {
+        report += QString("\n  %1: %2")
+                      .arg(MemoryTracker::getCategoryName(category))
+                      .arg(MemoryTracker::formatBytes(bytes));
+      }
     }
   }
-  return Q_NULLPTR;
+  return report;
 }
 
 void Scene::setSkybox(Skybox * skybox)
 {
-  delete mSkybox;
+  // The old skybox may still be drawing; it is deleted with the next frame.
+  if (mSkybox != Q_NULLPTR) {
+    mRemovedSkyboxes.push_back(mSkybox);
+  }
   mSkybox = skybox;
+  requestRender();
+}
+
+const QMatrix4x4 & Scene::getDrawViewMatrix()
+{
+  return sDrawView;
+}
+
+const QMatrix4x4 & Scene::getDrawProjectionMatrix()
+{
+  return sDrawProjection;
+}
+
+const QVector3D & Scene::getDrawCameraPosition()
+{
+  return sDrawCameraPosition;
+}
+
+void Scene::updateStaticBatch()
+{
+  if (!mFrame.mStaticBatching) {
+    if (mStaticBatch != Q_NULLPTR) {
+      // Deleted here instead of in setStaticBatching so the context is current.
+      delete mStaticBatch;
+      mStaticBatch = Q_NULLPTR;
+    }
+    return;
+  }
+
+  if (mStaticBatch != Q_NULLPTR && !mFrame.mStaticBatchDirty
+      && mStaticRevision == mFrame.mStaticRevision) {
+    return;
+  }
+
+  if (!StaticBatch::isSupported()) {
+    if (mStaticRevision != mFrame.mStaticRevision || mFrame.mStaticBatchDirty) {
+      qDebug() << "[Scene] Static batching requires OpenGL 4.3.";
+    }
+    mFrame.mStaticBatchDirty = false;
+    mStaticRevision = mFrame.mStaticRevision;
+    return;
+  }
+
+  if (mStaticBatch == Q_NULLPTR) {
+    mStaticBatch = new StaticBatch;
+  }
+  mStaticBatch->build(mFrame.mMeshes, mFrame.mModels);
+  mFrame.mStaticBatchDirty = false;
+  mStaticRevision = mFrame.mStaticRevision;
+}
+
+void Scene::drawEntities()
+{
+  // Matrices of every batch are uploaded at once, replacing last frame's.
+  const auto & matrices = mFrame.mEntityMatrices;
+  const auto bytes = static_cast<int>(matrices.size() * sizeof(matrices[0]));
+  if (!mEntityBuffer.isCreated()) {
+    mEntityBuffer.create();
+    mEntityBuffer.setUsagePattern(QOpenGLBuffer::StreamDraw);
+  }
+  mEntityBuffer.bind();
+  mEntityBuffer.allocate(matrices.data(), bytes);
+  mEntityBuffer.release();
+  QTK_RENDER_STAT(mBufferBytes, bytes);
+
+  for (const auto & batch : mFrame.mEntityBatches) {
+    if (batch.mMesh->supportsInstancing()) {
+      batch.mMesh->drawInstanced(mEntityBuffer,
+                                 batch.mFirst * 16 * sizeof(matrices[0]),
+                                 static_cast<GLsizei>(batch.mCount));
+    } else {
+      batch.mMesh->draw(&matrices[batch.mFirst * 16], batch.mCount);
+    }
+  }
+}
+
+void Scene::sortDrawList()
+{
+  const auto & view = mFrame.mView;
+  auto depth = [](const QMatrix4x4 & modelView, const Object * object) {
+    return -modelView.map(object->getBounds().getCenter()).z();
+  };
+
+  mDrawList.clear();
+#ifdef QTK_RENDER_STATS
+  // Batched objects are drawn by the StaticBatch, but still count as visible.
+  for (const auto & object : mFrame.mObjects) {
+    if (object->isVisible()) {
+      QTK_RENDER_STAT(mCulledObjects, object->isCulled() ? 1 : 0);
+      QTK_RENDER_STAT(mVisibleObjects, object->isCulled() ? 0 : 1);
+    }
+  }
+#endif
+  for (const auto & model : mFrame.mModels) {
+    if (model->isVisible() && !model->isBatched() && !model->isCulled()) {
+      auto modelView = view * model->getDrawMatrix();
+      model->sortModelMeshes(modelView);
+      mDrawList.emplace_back(depth(modelView, model), model);
+    }
+  }
+  for (const auto & mesh : mFrame.mMeshes) {
+    if (mesh->isVisible() && !mesh->isBatched() && !mesh->isCulled()) {
+      auto modelView = view * mesh->getDrawMatrix();
+      mDrawList.emplace_back(depth(modelView, mesh), mesh);
+    }
+  }
+
+  std::sort(mDrawList.begin(),
+            mDrawList.end(),
+            [](const auto & a, const auto & b) { return a.first < b.first; });
+}
+
+void Scene::drawObject(Object * object, QOpenGLShaderProgram * shader)
+{
+  switch (object->getType()) {
+    case Object::QTK_MODEL: {
+      auto model = static_cast<Model *>(object);
+      if (shader != Q_NULLPTR) {
+        model->draw(*shader);
+      } else {
+        model->draw();
+      }
+      break;
+    }
+    case Object::QTK_MESH: {
+      auto mesh = static_cast<MeshRenderer *>(object);
+      if (shader != Q_NULLPTR) {
+        mesh->draw(*shader);
+      } else {
+        mesh->draw();
+      }
+      break;
+    }
+    default:
+      break;
+  }
+}
+
+void Scene::readSampleQuery(SampleQuery & query)
+{
+  if (!query.mPending) {
+    return;
+  }
+
+  auto gl = QOpenGLContext::currentContext()->extraFunctions();
+  GLuint available = GL_FALSE;
+  gl->glGetQueryObjectuiv(query.mShaded, GL_QUERY_RESULT_AVAILABLE, &available);
+  if (available == GL_FALSE) {
+    // Leave the last results in place rather than stalling.
+    return;
+  }
+
+  gl->glGetQueryObjectuiv(
+      query.mShaded, GL_QUERY_RESULT, &mDrawStats.mShadedSamples);
+  mDrawStats.mPrepassSamples = 0;
+  if (query.mPrepassed) {
+    gl->glGetQueryObjectuiv(
+        query.mPrepass, GL_QUERY_RESULT, &mDrawStats.mPrepassSamples);
+  }
+  query.mPending = false;
+}
+
+void Scene::recordFrameStats()
+{
+#ifdef QTK_RENDER_STATS
+  auto stats = RenderStats::takeCurrent();
+  QMutexLocker lock(&mFrameStatsMutex);
+  mFrameStats[mFrameStatsCount++ % kFrameStatsHistory] = stats;
+#endif
 }
 
 void Scene::initSceneObjectName(Object * object)
@@ -152,3 +785,74 @@ void Scene::initSceneObjectName(Object * object)
     object->setName(object->getName() + " (" + QString::number(count) + ")");
   }
 }
+
+void Scene::insertHandle(Object * object, size_t position)
+{
+  QMutexLocker lock(&mSlotsMutex);
+  ObjectHandle handle;
+  if (!mFreeSlots.empty()) {
+    handle.mIndex = mFreeSlots.back();
+    mFreeSlots.pop_back();
+  } else {
+    handle.mIndex = static_cast<uint32_t>(mSlots.size());
+    mSlots.emplace_back();
+  }
+  auto & slot = mSlots[handle.mIndex];
+  slot.mObject = object;
+  slot.mPosition = position;
+  handle.mGeneration = slot.mGeneration;
+  object->mHandle = handle;
+  // Names are made unique by initSceneObjectName, so the newest object wins.
+  mNameIndex[object->getName()] = handle;
+}
+
+void Scene::releaseHandle(Object * object)
+{
+  QMutexLocker lock(&mSlotsMutex);
+  auto handle = object->mHandle;
+  if (auto it = mNameIndex.find(object->getName());
+      it != mNameIndex.end() && it->second == handle) {
+    mNameIndex.erase(it);
+  }
+  auto & slot = mSlots[handle.mIndex];
+  slot.mObject = Q_NULLPTR;
+  ++slot.mGeneration;
+  mFreeSlots.push_back(handle.mIndex);
+  object->mHandle = {};
+}
+
+template <typename T>
+bool Scene::eraseObject(std::vector<T *> & objects, T * object)
+{
+  QMutexLocker lock(&mSlotsMutex);
+  auto handle = object->mHandle;
+  if (handle.mIndex >= mSlots.size()
+      || mSlots[handle.mIndex].mObject != object) {
+    return false;
+  }
+  size_t position = mSlots[handle.mIndex].mPosition;
+  objects[position] = objects.back();
+  mSlots[objects[position]->mHandle.mIndex].mPosition = position;
+  objects.pop_back();
+  return true;
+}
+
+void Scene::objectChanged(const QString & name, bool added)
+{
+  (added ? mAddedNames : mRemovedNames).append(name);
+  if (mUpdateDepth == 0) {
+    notifyChanges();
+  }
+}
+
+void Scene::notifyChanges()
+{
+  if (mAddedNames.empty() && mRemovedNames.empty()) {
+    return;
+  }
+  QStringList added, removed;
+  added.swap(mAddedNames);
+  removed.swap(mRemovedNames);
+  emit objectsChanged(mSceneName, added, removed);
+  emit sceneUpdated(mSceneName);
+}
@@ -9,17 +9,26 @@
 #ifndef QTK_SCENE_H
 #define QTK_SCENE_H
 
+#include <QElapsedTimer>
 #include <QMatrix4x4>
+#include <QMutex>
+#include <QStringList>
 #include <QUrl>
 
+#include <array>
 #include <queue>
 #include <unordered_map>
 #include <utility>
 
 #include "camera3d.h"
+#include "gpuallocator.h"
 #include "meshrenderer.h"
 #include "model.h"
+#include "occlusionculler.h"
+#include "registry.h"
+#include "renderstats.h"
 #include "skybox.h"
+#include "staticbatch.h"
 
 namespace Qtk
 {
@@ -39,16 +48,59 @@ namespace Qtk
    * `Scene::setSkybox(...)`
    *
    * If the scene is to render any kind of movement we are required to override
-   * the `update()` virtual method.
+   * the `update(float)` virtual method. It is called at a fixed rate by
+   * `tick()`, independent of how often the scene is drawn.
    *
    * If the child scene adds any objects which are not managed (drawn) by this
    * base class, the child scene class must also override the `draw()` method.
+   *
+   * Drawing works from a snapshot of the scene captured by `captureFrame()`:
+   * the camera, projection and the model matrix of every object. The thread
+   * that owns the scene captures frames, and `draw()` may run on a separate
+   * render thread (see RenderThread). Objects added, removed or loaded are
+   * handed over with the next snapshot. Code that runs while drawing should
+   * use `getDrawViewMatrix()`, `getDrawProjectionMatrix()` and
+   * `Object::getDrawMatrix()` rather than reading cameras or transforms, and
+   * OpenGL calls such as setting uniforms belong in `init()`, `beforeDraw()`
+   * or `draw()`, never in `update()`.
    */
   class Scene : public QObject, protected QOpenGLFunctions
   {
       Q_OBJECT
 
     public:
+      /*************************************************************************
+       * Typedefs
+       ************************************************************************/
+
+      /**
+       * Fill rate of the objects drawn by the scene, measured with
+       * GL_SAMPLES_PASSED queries. Results lag a few frames behind. If the
+       * scene is shown in several views, only the first view drawn is
+       * measured.
+       * Objects drawn through the StaticBatch, Registry entities and the
+       * Skybox are not included.
+       */
+      struct DrawStats {
+          /* Objects drawn individually in the last frame. */
+          size_t mObjects {};
+          /* Samples that passed the depth test during the depth prepass. This
+           * is the number that would be shaded without a prepass. */
+          GLuint mPrepassSamples {};
+          /* Samples that passed the depth test and were shaded. */
+          GLuint mShadedSamples {};
+
+          /**
+           * @return Samples that were not shaded thanks to the depth prepass.
+           */
+          [[nodiscard]] inline GLuint getSavedSamples() const
+          {
+            return mPrepassSamples > mShadedSamples
+                       ? mPrepassSamples - mShadedSamples
+                       : 0;
+          }
+      };
+
       /*************************************************************************
        * Contructors / Destructors
        ************************************************************************/
@@ -69,19 +121,81 @@ namespace Qtk
       /**
        * Function called during OpenGL drawing event.
        *
-       * This function is only called when the widget is redrawn.
+       * This function is only called when the widget is redrawn. If called
+       * from the thread that owns the scene and no frame is waiting to be
+       * drawn, a new frame is captured first. Otherwise the latest frame
+       * passed to `captureFrame()` is drawn.
        */
       virtual void draw();
 
       /**
-       * Function called to update the QOpenGLWidget. Does not trigger a redraw.
-       * This method can translate or rotate objects to simulate movement.
-       * Calling this several times will still result in only one repaint.
+       * Initialize OpenGL functions and call `init()` if not done already.
+       * Called by `draw()`. Call this before capturing the first frame to
+       * include the objects created by `init()` in it.
+       * Must be called while the OpenGL context is current.
+       */
+      void initialize();
+
+      /**
+       * Function called by `draw()` after the frame snapshot is applied and
+       * before any objects are drawn. Override to set per-frame uniforms.
+       */
+      virtual void beforeDraw() {}
+
+      /**
+       * Capture the scene camera, projection and object transforms for the
+       * next call to `draw()`. Must be called from the thread that owns the
+       * scene. Transforms are interpolated using `getInterpolation()`.
+       */
+      inline void captureFrame()
+      {
+        captureFrame(getViewMatrix(), getProjectionMatrix());
+      }
+
+      /**
+       * Capture the scene as seen from a view other than the scene camera.
+       * A scene shown in several views is captured and drawn once per view,
+       * each with its own camera.
+       *
+       * @param view View matrix to draw the frame with.
+       * @param projection Projection matrix to draw the frame with.
+       */
+      void captureFrame(const QMatrix4x4 & view,
+                        const QMatrix4x4 & projection);
+
+      /**
+       * Function called to advance the simulation by one fixed step. Does not
+       * trigger a redraw. This method can translate or rotate objects to
+       * simulate movement, and should scale all movement by `dt`.
        *
        * It's very possible a client will not want to move objects in the scene
        * using this method. This is intentially not pure virtual.
+       *
+       * @param dt Time in seconds to advance the scene. This is always equal
+       *    to `getFixedStep()`.
        */
-      virtual void update() {}
+      virtual void update(float /*dt*/) {}
+
+      /**
+       * Advance the scene clock by the real time since the last call, and
+       * call `update(float)` once for each fixed step that has elapsed.
+       * Called by the widget before drawing each frame.
+       *
+       * @return Real time in seconds since the last call, clamped.
+       */
+      float tick();
+
+      /**
+       * Advance the scene clock by a given amount of time. Use this instead
+       * of `tick()` to drive the scene deterministically, e.g. for benchmarks.
+       *
+       * At most kMaxSteps updates are made per call; if the scene falls
+       * further behind, the remaining time is dropped and the simulation runs
+       * slower than real time instead of trying to catch up indefinitely.
+       *
+       * @param elapsed Time in seconds to advance the clock.
+       */
+      void tick(float elapsed);
 
       void loadModel(const QUrl & url)
       {
@@ -95,8 +209,16 @@ namespace Qtk
         // Add the dropped model to the load queue.
         // This is consumed during rendering of the scene if not empty.
         mModelLoadQueue.emplace(name.toStdString(), path.toStdString());
+        requestRender();
       }
 
+      /**
+       * Request that the scene is drawn again. Widgets rendering on demand
+       * compare `getRevision()` to know when to repaint, so call this after
+       * changes that are not made through objects or their transforms.
+       */
+      inline void requestRender() { ++mRevision; }
+
       /*************************************************************************
        * Accessors
        ************************************************************************/
@@ -113,7 +235,38 @@ namespace Qtk
        * @param name The objectName to look for within this scene.
        * @return The found object or Q_NULLPTR if none found.
        */
-      [[nodiscard]] Object * getObject(const QString & name) const;
+      [[nodiscard]] inline Object * getObject(const QString & name) const
+      {
+        return getObject(getHandle(name));
+      }
+
+      /**
+       * Resolve a handle issued by this scene. Safe to call while drawing on
+       * another thread. Prefer this over looking objects up by name in code
+       * that runs every frame.
+       *
+       * @param handle Handle from Object::getHandle or `getHandle(name)`.
+       * @return The object, or Q_NULLPTR if it was removed from the scene.
+       */
+      [[nodiscard]] Object * getObject(ObjectHandle handle) const;
+
+      /**
+       * Resolve a handle to an object of a given type.
+       * This template provides explicit specializations for the valid types:
+       * 		MeshRenderer, Model
+       *
+       * @param handle Handle from Object::getHandle or `getHandle(name)`.
+       * @return The object, or Q_NULLPTR if it was removed from the scene or
+       *    is not of type T.
+       */
+      template <typename T>
+      [[nodiscard]] T * getObject(ObjectHandle handle) const;
+
+      /**
+       * @param name The objectName to look for within this scene.
+       * @return Handle to the object, or an invalid handle if none found.
+       */
+      [[nodiscard]] ObjectHandle getHandle(const QString & name) const;
 
       /**
        * @return The number of objects within the scene with the given name.
@@ -124,26 +277,155 @@ namespace Qtk
       }
 
       /**
+       * The scene's own camera. Views such as QtkWidget keep a camera of their
+       * own and start from a copy of this one, so set it in the constructor
+       * of a derived scene to choose where views start.
+       *
        * @return Camera attached to this scene.
        */
-      [[nodiscard]] inline static Camera3D & getCamera() { return mCamera; }
+      [[nodiscard]] inline Camera3D & getCamera() { return mCamera; }
 
       /**
        * @return View matrix for the camera attached to this scene.
        */
-      [[nodiscard]] inline static QMatrix4x4 getViewMatrix()
+      [[nodiscard]] inline QMatrix4x4 getViewMatrix()
       {
         return mCamera.toMatrix();
       }
 
       /**
-       * @return Projection matrix for the current view into the scene.
+       * @return Projection matrix used with the scene's own camera.
        */
-      [[nodiscard]] inline static QMatrix4x4 & getProjectionMatrix()
+      [[nodiscard]] inline QMatrix4x4 & getProjectionMatrix()
       {
         return mProjection;
       }
 
+      /**
+       * @return View matrix of the frame being drawn on the calling thread.
+       */
+      [[nodiscard]] static const QMatrix4x4 & getDrawViewMatrix();
+
+      /**
+       * @return Projection matrix of the frame being drawn on the calling
+       *    thread.
+       */
+      [[nodiscard]] static const QMatrix4x4 & getDrawProjectionMatrix();
+
+      /**
+       * @return Camera position of the frame being drawn on the calling
+       *    thread.
+       */
+      [[nodiscard]] static const QVector3D & getDrawCameraPosition();
+
+      /**
+       * @return Counter incremented each time the scene is modified or a
+       *    render is requested. Transform changes are tracked separately by
+       *    Transform3D::getRevision.
+       */
+      [[nodiscard]] inline uint64_t getRevision() const { return mRevision; }
+
+      /**
+       * @return Number of world matrices recomputed by the last call to
+       *    `captureFrame()`. Unchanged subtrees of the scene graph are not
+       *    recomputed; see Object::attachTo.
+       */
+      [[nodiscard]] inline uint64_t getTransformUpdates() const
+      {
+        return mTransformUpdates;
+      }
+
+      /**
+       * @return Duration of a single update step in seconds.
+       */
+      [[nodiscard]] inline float getFixedStep() const { return mFixedStep; }
+
+      /**
+       * @return Simulated time in seconds, advanced by each update step.
+       */
+      [[nodiscard]] inline double getTime() const { return mTime; }
+
+      /**
+       * @return Fraction of a step between the last update and now, used to
+       *    interpolate transforms for drawing.
+       */
+      [[nodiscard]] inline float getInterpolation() const
+      {
+        return mAccumulator / mFixedStep;
+      }
+
+      /**
+       * @return True if static objects are drawn through a StaticBatch.
+       */
+      [[nodiscard]] inline bool getStaticBatching() const
+      {
+        return mStaticBatching;
+      }
+
+      /**
+       * @return True if occlusion culling is enabled.
+       */
+      [[nodiscard]] inline bool getOcclusionCulling() const
+      {
+        return mOcclusionCulling;
+      }
+
+      /**
+       * @return The occlusion culler for this scene, or Q_NULLPTR if occlusion
+       *    culling is disabled. Owned by the thread drawing the scene.
+       */
+      [[nodiscard]] inline OcclusionCuller * getOcclusionCuller()
+      {
+        return mOcclusionCuller;
+      }
+
+      /**
+       * @return True if opaque objects are drawn in a depth-only pass first.
+       */
+      [[nodiscard]] inline bool getDepthPrepass() const
+      {
+        return mDepthPrepass;
+      }
+
+      /**
+       * @return Fill rate statistics for recent frames.
+       */
+      [[nodiscard]] inline const DrawStats & getDrawStats() const
+      {
+        return mDrawStats;
+      }
+
+      /**
+       * Counters are only kept when qtk is built with QTK_RENDER_STATS, and
+       * are zero otherwise. Thread safe.
+       *
+       * @return Work submitted to OpenGL by the last frame drawn.
+       */
+      [[nodiscard]] RenderStats getFrameStats() const;
+
+      /**
+       * @return Work submitted by up to kFrameStatsHistory recent frames,
+       *    oldest first.
+       */
+      [[nodiscard]] std::vector<RenderStats> getFrameStatsHistory() const;
+
+      /** Frames kept for `getFrameStatsHistory()`. */
+      static constexpr size_t kFrameStatsHistory = 120;
+
+      /**
+       * @return Live and peak memory of each MemoryCategory across all
+       *    scenes, followed by the memory of each object in this scene,
+       *    largest first.
+       */
+      [[nodiscard]] QString getMemoryReport() const;
+
+      /**
+       * Lightweight entities drawn with this scene. See Registry.
+       *
+       * @return The entity registry for this scene.
+       */
+      [[nodiscard]] inline Registry & getRegistry() { return mRegistry; }
+
       /**
        * @return The active skybox for this scene.
        */
@@ -202,16 +484,115 @@ namespace Qtk
        * Any other object type will cause errors.
        * TODO: Refactor to use Object base class container for scene objects.
        *
+       * The scene owns its objects, so the removed object is deleted during the
+       * next call to `draw()` and must not be used after this call.
+       *
        * @param object Pointer to the object to remove from the scene.
        */
       template <typename T> void removeObject(T * object);
 
+      /**
+       * Add several objects with a single change notification.
+       *
+       * @param objects The new objects to add to the scene.
+       */
+      template <typename T> void addObjects(const std::vector<T *> & objects)
+      {
+        beginUpdate();
+        for (const auto & object : objects) {
+          addObject(object);
+        }
+        endUpdate();
+      }
+
+      /**
+       * Remove several objects with a single change notification.
+       *
+       * @param objects Objects to remove from the scene.
+       */
+      template <typename T>
+      void removeObjects(const std::vector<T *> & objects)
+      {
+        beginUpdate();
+        for (const auto & object : objects) {
+          removeObject(object);
+        }
+        endUpdate();
+      }
+
+      /**
+       * Start a batch of changes. Objects added or removed until the matching
+       * `endUpdate()` are reported by one `objectsChanged()` and one
+       * `sceneUpdated()` signal. Batches may be nested; signals are emitted
+       * when the outermost batch ends.
+       */
+      inline void beginUpdate() { ++mUpdateDepth; }
+
+      /**
+       * End a batch of changes started with `beginUpdate()`.
+       */
+      void endUpdate();
+
       /**
        * @param name The name to use for this scene.
        */
       inline void setSceneName(QString name) { mSceneName = std::move(name); }
 
-      inline void setPause(bool pause) { mPause = pause; }
+      /**
+       * @param step Duration of a single update step in seconds.
+       */
+      inline void setFixedStep(float step)
+      {
+        mFixedStep = std::max(step, 0.001f);
+      }
+
+      inline void setPause(bool pause)
+      {
+        mPause = pause;
+        requestRender();
+      }
+
+      /**
+       * Enable drawing objects flagged with Object::setStatic through a
+       * StaticBatch. Requires OpenGL 4.3; if unsupported this has no effect.
+       *
+       * @param enabled True if static batching should be used.
+       */
+      inline void setStaticBatching(bool enabled)
+      {
+        mStaticBatching = enabled;
+        mStaticBatchDirty = true;
+        requestRender();
+      }
+
+      /**
+       * Enable hiding objects that are behind occluders before they are drawn.
+       * See OcclusionCuller for details. The culler is created or destroyed
+       * during the next call to `draw()`.
+       *
+       * @param enabled True if occlusion culling should be used.
+       */
+      inline void setOcclusionCulling(bool enabled)
+      {
+        mOcclusionCulling = enabled;
+        requestRender();
+      }
+
+      /**
+       * Draw opaque objects to the depth buffer before shading them, so each
+       * pixel runs the fragment shader at most once. This is worthwhile when
+       * fragment shaders are expensive, and costs an extra vertex pass.
+       *
+       * Shaders used by scene objects must compute gl_Position the same way
+       * as QTK_SHADER_VERTEX_DEPTH for depths to match.
+       *
+       * @param enabled True if a depth prepass should be used.
+       */
+      inline void setDepthPrepass(bool enabled)
+      {
+        mDepthPrepass = enabled;
+        requestRender();
+      }
 
     signals:
       /**
@@ -222,6 +603,19 @@ namespace Qtk
        */
       void sceneUpdated(QString sceneName);
 
+      /**
+       * Signal thrown with `sceneUpdated()`, listing the names of objects
+       * added and removed since the last notification. Receivers can apply
+       * these instead of reloading every object in the scene.
+       *
+       * @param sceneName The scene that has been updated.
+       * @param added Names of objects added to the scene.
+       * @param removed Names of objects removed from the scene.
+       */
+      void objectsChanged(QString sceneName,
+                          QStringList added,
+                          QStringList removed);
+
 
       /*************************************************************************
        * Public Members
@@ -234,6 +628,62 @@ namespace Qtk
       std::queue<std::pair<std::string, std::string>> mModelLoadQueue;
 
     private:
+      /*************************************************************************
+       * Private Types
+       ************************************************************************/
+
+      /** State captured by `captureFrame()` and applied by `draw()`. */
+      struct FrameSnapshot {
+          QMatrix4x4 mView {}, mProjection {};
+          QVector3D mCameraPosition {};
+          /* Every object in the scene, the world matrix to draw it with and
+           * the revision of that matrix. */
+          std::vector<Object *> mObjects {};
+          std::vector<QMatrix4x4> mMatrices {};
+          std::vector<uint64_t> mRevisions {};
+          std::vector<MeshRenderer *> mMeshes {};
+          std::vector<Model *> mModels {};
+          /* Visible Registry entities grouped by mesh, and their world
+           * matrices as 16 floats each. */
+          std::vector<Registry::DrawBatch> mEntityBatches {};
+          std::vector<float> mEntityMatrices {};
+          size_t mEntityCount {};
+          Skybox * mSkybox {};
+          /* Work handed to draw() once; carried over if a frame is dropped. */
+          std::vector<Object *> mRemovedObjects {};
+          std::vector<Skybox *> mRemovedSkyboxes {};
+          std::vector<std::pair<std::string, std::string>> mModelLoads {};
+          bool mStaticBatchDirty = false;
+          /* Settings at the time of capture. */
+          uint64_t mStaticRevision = 0;
+          bool mStaticBatching = false;
+          bool mOcclusionCulling = false;
+          bool mDepthPrepass = false;
+          bool mPause = false;
+      };
+
+      /** Entry in the object table indexed by ObjectHandle::mIndex. */
+      struct ObjectSlot {
+          Object * mObject {};
+          /* Index of the object in mMeshes or mModels. */
+          size_t mPosition {};
+          /* Incremented each time the slot is released. */
+          uint32_t mGeneration = 1;
+      };
+
+      /** GL_SAMPLES_PASSED queries for a single frame. */
+      struct SampleQuery {
+          GLuint mPrepass {}, mShaded {};
+          /* True if the queries were issued and have not been read yet. */
+          bool mPending = false;
+          /* True if mPrepass was used for this frame. */
+          bool mPrepassed = false;
+      };
+
+      /*************************************************************************
+       * Private Methods
+       ************************************************************************/
+
       /**
        * Initialize an object name relative to other objects already loaded.
        * Protects against having two objects with the same name.
@@ -242,16 +692,114 @@ namespace Qtk
        */
       void initSceneObjectName(Qtk::Object * object);
 
+      /**
+       * Give an object a slot in the object table and index it by name.
+       *
+       * @param object Object being added to the scene.
+       * @param position Index the object will have in mMeshes or mModels.
+       */
+      void insertHandle(Object * object, size_t position);
+
+      /**
+       * Release an object's slot so handles to it no longer resolve.
+       *
+       * @param object Object being removed from the scene.
+       */
+      void releaseHandle(Object * object);
+
+      /**
+       * Remove an object from mMeshes or mModels in constant time by moving
+       * the last object into its place.
+       *
+       * @param objects The list holding the object.
+       * @param object The object to remove.
+       * @return False if the object is not in this scene.
+       */
+      template <typename T>
+      bool eraseObject(std::vector<T *> & objects, T * object);
+
+      /**
+       * Record an added or removed object and notify receivers, unless a
+       * batch of changes is in progress.
+       *
+       * @param name Name of the object.
+       * @param added True if the object was added, false if removed.
+       */
+      void objectChanged(const QString & name, bool added);
+
+      /**
+       * Emit `objectsChanged()` and `sceneUpdated()` for recorded changes.
+       */
+      void notifyChanges();
+
+      /**
+       * Take the latest captured frame for drawing, then load, delete and
+       * apply model matrices for the objects it lists.
+       */
+      void applyFrame();
+
+      /**
+       * Rebuild or release the StaticBatch if objects in the scene changed.
+       * Must be called while the OpenGL context is current.
+       */
+      void updateStaticBatch();
+
+      /**
+       * Collect visible objects into mDrawList, sorted front to back.
+       * Meshes within each Model are also sorted.
+       */
+      void sortDrawList();
+
+      /**
+       * Upload the world matrices of visible entities to mEntityBuffer, then
+       * draw each batch of them.
+       */
+      void drawEntities();
+
+      /**
+       * Draw a Model or MeshRenderer.
+       *
+       * @param object The object to draw.
+       * @param shader Shader program to draw with, or Q_NULLPTR to use the
+       *    object's own shaders.
+       */
+      static void drawObject(Object * object, QOpenGLShaderProgram * shader);
+
+      /**
+       * Update mDrawStats from a query if its results are available.
+       */
+      void readSampleQuery(SampleQuery & query);
+
+      /**
+       * Take the render counters of the calling thread as the stats of the
+       * frame just drawn. Does nothing unless built with QTK_RENDER_STATS.
+       */
+      void recordFrameStats();
+
       /*************************************************************************
        * Private Members
        ************************************************************************/
 
-      static Camera3D mCamera;
-      static QMatrix4x4 mProjection;
+      /* Number of frames of GL_SAMPLES_PASSED queries kept in flight. */
+      static constexpr size_t kSampleQueryFrames = 3;
+      /* Maximum number of update steps made in a single tick. */
+      static constexpr int kMaxSteps = 5;
+
+      Camera3D mCamera;
+      QMatrix4x4 mProjection;
       bool mInit = false;
+      uint64_t mRevision = 0;
+      uint64_t mTransformUpdates = 0;
       /* Pause rendering of the scene. */
       bool mPause = false;
 
+      /* Measures real time between calls to tick(). */
+      QElapsedTimer mClock;
+      float mFixedStep = 1.0f / 60.0f;
+      /* Time not yet consumed by an update step. */
+      float mAccumulator = 0.0f;
+      double mTime = 0.0;
+
       QString mSceneName;
       /* The skybox for this scene. */
       Skybox * mSkybox {};
@@ -259,6 +807,62 @@ namespace Qtk
       std::vector<MeshRenderer *> mMeshes {};
       /* Track count of objects with same initial name. */
       std::unordered_map<QString, uint64_t> mObjectCount;
+      /* Objects by handle, and handles by name. Written on the scene's thread
+       * and read by any thread drawing the scene. */
+      std::vector<ObjectSlot> mSlots {};
+      std::vector<uint32_t> mFreeSlots {};
+      std::unordered_map<QString, ObjectHandle> mNameIndex {};
+      mutable QMutex mSlotsMutex;
+      /* Nesting depth of beginUpdate() calls, and changes not yet reported
+       * by objectsChanged(). */
+      int mUpdateDepth = 0;
+      QStringList mAddedNames {};
+      QStringList mRemovedNames {};
+      /* Entities stored in dense component arrays. */
+      Registry mRegistry;
+      /* Objects removed from the scene waiting to be deleted. */
+      std::vector<Object *> mRemovedObjects {};
+      /* Skyboxes replaced by setSkybox waiting to be deleted. */
+      std::vector<Skybox *> mRemovedSkyboxes {};
+
+      /* Scratch snapshot filled by captureFrame() on the owning thread. */
+      FrameSnapshot mCapture {};
+      /* The latest captured snapshot, waiting to be drawn. */
+      FrameSnapshot mPendingFrame {};
+      /* The snapshot being drawn. Only used by the drawing thread. */
+      FrameSnapshot mFrame {};
+      bool mFramePending = false;
+      /* Guards mPendingFrame and mFramePending. */
+      QMutex mFrameMutex;
+
+      /* Batch used to draw static objects if static batching is enabled. */
+      StaticBatch * mStaticBatch {};
+      bool mStaticBatching = false;
+      /* True if objects were added or removed since the batch was built. */
+      bool mStaticBatchDirty = false;
+      /* Value of Object::getStaticRevision when the batch was built. */
+      uint64_t mStaticRevision = 0;
+      /* CPU occlusion culling, if enabled. */
+      OcclusionCuller * mOcclusionCuller {};
+      bool mOcclusionCulling = false;
+
+      /* Objects to draw this frame with their distance from the camera. */
+      std::vector<std::pair<float, Object *>> mDrawList {};
+      bool mDepthPrepass = false;
+      /* Position only shader program used for the depth prepass. */
+      QOpenGLShaderProgram * mDepthProgram {};
+      /* World matrices of the entities drawn this frame. */
+      QOpenGLBuffer mEntityBuffer {QOpenGLBuffer::VertexBuffer};
+      SampleQuery mSampleQueries[kSampleQueryFrames] {};
+      /* Query objects are not shared, so only the context that created them
+       * measures fill rate. */
+      QOpenGLContext * mQueryContext {};
+      size_t mSampleFrame = 0;
+      DrawStats mDrawStats {};
+      /* Ring of the stats of recent frames, and the number recorded. */
+      std::array<RenderStats, kFrameStatsHistory> mFrameStats {};
+      size_t mFrameStatsCount = 0;
+      mutable QMutex mFrameStatsMutex;
   };
 }  // namespace Qtk
 
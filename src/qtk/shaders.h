@@ -99,7 +99,10 @@ void main()
 {
   // Strip translation column from camera's 4x4 matrix
   mat4 view = mat4(mat3(uViewMatrix));
-  gl_Position = uProjectionMatrix * view * vec4(aPosition, 1.0);
+  // Place the skybox on the far plane so it can be drawn last and only fill
+  // pixels left uncovered by the scene.
+  vec4 position = uProjectionMatrix * view * vec4(aPosition, 1.0);
+  gl_Position = position.xyww;
   vTexCoord = aPosition;
 }
 )"
@@ -117,4 +120,150 @@ void main()
 }
 )"
 
+//
+// Depth prepass
+
+// The position must be computed exactly as in the other vertex shaders so the
+// depth written here matches the depth of the shaded pass.
+#define QTK_SHADER_VERTEX_DEPTH \
+  R"(
+#version 330 core
+layout(location = 0) in vec3 aPosition;
+
+uniform mat4 uModel;
+uniform mat4 uView;
+uniform mat4 uProjection;
+
+void main()
+{
+  gl_Position = uProjection * uView * uModel * vec4(aPosition, 1.0);
+}
+)"
+
+#define QTK_SHADER_FRAGMENT_DEPTH \
+  R"(
+#version 330 core
+void main() {}
+)"
+
+//
+// StaticBatch
+
+#define QTK_SHADER_VERTEX_MESH_BATCH \
+  R"(
+#version 430 core
+layout(location = 0) in vec3 aPosition;
+layout(location = 1) in vec3 aColor;
+layout(location = 7) in float aDrawID;
+
+layout(std430, binding = 0) readonly buffer ModelMatrices
+{
+  mat4 uModels[];
+};
+
+out vec4 vColor;
+
+uniform mat4 uView;
+uniform mat4 uProjection;
+
+void main()
+{
+  mat4 model = uModels[int(aDrawID)];
+  gl_Position = uProjection * uView * model * vec4(aPosition, 1.0);
+
+  vColor = vec4(aColor, 1.0f);
+}
+)"
+
+#define QTK_SHADER_VERTEX_MODEL_BATCH \
+  R"(
+#version 430 core
+layout (location = 0) in vec3 aPosition;
+layout (location = 2) in vec2 aTextureCoord;
+layout (location = 7) in float aDrawID;
+
+layout(std430, binding = 0) readonly buffer ModelMatrices
+{
+  mat4 uModels[];
+};
+
+out vec2 vTextureCoord;
+
+uniform mat4 uView;
+uniform mat4 uProjection;
+
+void main()
+{
+    mat4 model = uModels[int(aDrawID)];
+    vTextureCoord = aTextureCoord;
+    gl_Position = uProjection * uView * model * vec4(aPosition, 1.0);
+}
+)"
+
+//
+// Registry
+
+// QTK_SHADER_VERTEX_MESH with the model matrix read for each instance, used to
+// draw all entities sharing a mesh with one draw call.
+#define QTK_SHADER_VERTEX_MESH_INSTANCED \
+  R"(
+#version 330
+layout(location = 0) in vec3 aPosition;
+layout(location = 1) in vec3 aColor;
+layout(location = 8) in mat4 aModel;
+
+out vec4 vColor;
+
+uniform mat4 uView;
+uniform mat4 uProjection;
+
+void main()
+{
+  gl_Position = uProjection * uView * aModel * vec4(aPosition, 1.0);
+
+  vColor = vec4(aColor, 1.0f);
+}
+)"
+
+//
+// Post processing
+
+// Draws a triangle covering the viewport without any vertex attributes.
+#define QTK_SHADER_VERTEX_FULLSCREEN \
+  R"(
+#version 330 core
+out vec2 vTextureCoord;
+
+void main()
+{
+  vTextureCoord = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2);
+  gl_Position = vec4(vTextureCoord * 2.0 - 1.0, 0.0, 1.0);
+}
+)"
+
+// Bilinear upscale followed by an unsharp mask over the source texel
+// neighbours, which restores edges softened by the lower resolution.
+#define QTK_SHADER_FRAGMENT_UPSCALE \
+  R"(
+#version 330 core
+out vec4 fColor;
+
+in vec2 vTextureCoord;
+
+uniform sampler2D uSource;
+uniform vec2 uTexelSize;
+uniform float uSharpness;
+
+void main()
+{
+  vec3 center = texture(uSource, vTextureCoord).rgb;
+  vec3 blur = texture(uSource, vTextureCoord + vec2(uTexelSize.x, 0.0)).rgb
+              + texture(uSource, vTextureCoord - vec2(uTexelSize.x, 0.0)).rgb
+              + texture(uSource, vTextureCoord + vec2(0.0, uTexelSize.y)).rgb
+              + texture(uSource, vTextureCoord - vec2(0.0, uTexelSize.y)).rgb;
+  vec3 color = center + (center - blur * 0.25) * uSharpness;
+  fColor = vec4(clamp(color, 0.0, 1.0), 1.0);
+}
+)"
+
 #endif  // QTK_SHADERS_H
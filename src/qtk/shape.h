@@ -168,6 +168,11 @@ namespace Qtk
         return mNormals;
       }
 
+      /**
+       * @return The draw mode this shape's data is organized for.
+       */
+      [[nodiscard]] inline DrawMode getDrawMode() const { return mDrawMode; }
+
       /**
        * @return Stride for texture coordinates on this shape.
        */
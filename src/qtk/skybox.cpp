@@ -7,9 +7,11 @@
 ##############################################################################*/
 
 #include "skybox.h"
+#include "renderstats.h"
 #include "scene.h"
 #include "shaders.h"
 #include "texture.h"
+#include "tracer.h"
 
 using namespace Qtk;
 
@@ -71,15 +73,22 @@ void Skybox::draw()
   glDepthFunc(GL_LEQUAL);
   glDepthMask(GL_FALSE);
 
-  mVAO.bind();
+  if (mVAO.bind()) {
+    bindBuffers();
+  }
   mProgram.bind();
   mTexture.bind();
 
-  mProgram.setUniformValue("uProjectionMatrix", Scene::getProjectionMatrix());
-  mProgram.setUniformValue("uViewMatrix", Scene::getCamera().toMatrix());
+  mProgram.setUniformValue("uProjectionMatrix",
+                           Scene::getDrawProjectionMatrix());
+  mProgram.setUniformValue("uViewMatrix", Scene::getDrawViewMatrix());
   mProgram.setUniformValue("uTexture", 0);
   glDrawElements(
       GL_TRIANGLES, mIndices.size(), GL_UNSIGNED_INT, mIndices.data());
+  QTK_RENDER_STAT(mProgramBinds, 1);
+  QTK_RENDER_STAT(mUniformUploads, 3);
+  QTK_RENDER_STAT(mDrawCalls, 1);
+  QTK_RENDER_STAT(mTriangles, mIndices.size() / 3);
 
   mTexture.bind();
   mProgram.release();
@@ -99,32 +108,37 @@ void Skybox::init()
   initializeOpenGLFunctions();
 
   // Set up shader program
-  mProgram.create();
-  mProgram.addShaderFromSourceCode(QOpenGLShader::Fragment,
-                                   QTK_SHADER_FRAGMENT_SKYBOX);
-  mProgram.addShaderFromSourceCode(QOpenGLShader::Vertex,
-                                   QTK_SHADER_VERTEX_SKYBOX);
-  mProgram.link();
+  {
+    Tracer::Span link("Shader Link", "shader");
+    QTK_RENDER_STAT(mShaderLinks, 1);
+    mProgram.create();
+    mProgram.addShaderFromSourceCode(QOpenGLShader::Fragment,
+                                     QTK_SHADER_FRAGMENT_SKYBOX);
+    mProgram.addShaderFromSourceCode(QOpenGLShader::Vertex,
+                                     QTK_SHADER_VERTEX_SKYBOX);
+    mProgram.link();
+  }
   mProgram.bind();
 
-  // Setup VAO
-  mVAO.create();
-  mVAO.bind();
-
   // Setup VBO for vertex position data
   mVBO.create();
   mVBO.setUsagePattern(QOpenGLBuffer::StaticDraw);
   mVBO.bind();
   // Allocate vertex positions into VBO
   mVBO.allocate(mVertices.data(), mVertices.size() * sizeof(mVertices[0]));
+  QTK_RENDER_STAT(mBufferBytes, mVertices.size() * sizeof(mVertices[0]));
+  mVBO.release();
 
-  // Enable attribute array for vertex positions
-  mProgram.enableAttributeArray(0);
-  mProgram.setAttributeBuffer(0, GL_FLOAT, 0, 3, sizeof(QVector3D));
   // Set shader texture unit to 0
   mProgram.setUniformValue("uTexture", 0);
+  mProgram.release();
+}
 
-  mVAO.release();
+void Skybox::bindBuffers()
+{
+  mVBO.bind();
+  // Enable attribute array for vertex positions
+  mProgram.enableAttributeArray(0);
+  mProgram.setAttributeBuffer(0, GL_FLOAT, 0, 3, sizeof(QVector3D));
   mVBO.release();
-  mProgram.release();
 }
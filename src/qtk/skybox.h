@@ -13,12 +13,12 @@
 #include <QOpenGLFunctions>
 #include <QOpenGLShaderProgram>
 #include <QOpenGLTexture>
-#include <QOpenGLVertexArrayObject>
 
 #include "camera3d.h"
 #include "qtkapi.h"
 #include "shape.h"
 #include "texture.h"
+#include "vertexarray.h"
 
 namespace Qtk
 {
@@ -77,7 +77,8 @@ namespace Qtk
        ************************************************************************/
 
       /**
-       * Draws the skybox.
+       * Draws the skybox on the far plane with depth testing enabled.
+       * Draw after all opaque geometry so hidden sky pixels are not shaded.
        */
       void draw();
 
@@ -91,6 +92,12 @@ namespace Qtk
        */
       void init();
 
+      /**
+       * Point the VAO position attribute at mVBO.
+       * Called with the VAO bound when `mVAO.bind()` requires it.
+       */
+      void bindBuffers();
+
       /*************************************************************************
        * Private Members
        ************************************************************************/
@@ -99,7 +106,7 @@ namespace Qtk
       Indices mIndices {};
 
       QOpenGLShaderProgram mProgram;
-      QOpenGLVertexArrayObject mVAO;
+      VertexArray mVAO;
       QOpenGLBuffer mVBO;
       Texture mTexture;
   };
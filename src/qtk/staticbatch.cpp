@@ -0,0 +1,549 @@
+/*##############################################################################
+## Author: Shaun Reed                                                         ##
+## Legal: All Content (c) 2025 Shaun Reed, all rights reserved                ##
+## About: Multi-draw-indirect batching for static scene geometry              ##
+##                                                                            ##
+## Contact: shaunrd0@gmail.com  | URL: www.shaunreed.com | GitHub: shaunrd0   ##
+##############################################################################*/
+
+#include <QImage>
+#include <QOpenGLFunctions_4_3_Core>
+#include <QOpenGLVersionFunctionsFactory>
+
+#include <algorithm>
+#include <cstring>
+#include <unordered_map>
+
+#include "meshrenderer.h"
+#include "model.h"
+#include "renderstats.h"
+#include "scene.h"
+#include "shaders.h"
+#include "staticbatch.h"
+#include "tracer.h"
+
+using namespace Qtk;
+
+/*******************************************************************************
+ * Constructors / Destructors
+ ******************************************************************************/
+
+StaticBatch::StaticBatch() = default;
+
+StaticBatch::~StaticBatch()
+{
+  clear();
+  delete mWhiteTexture;
+}
+
+/*******************************************************************************
+ * Public Methods
+ ******************************************************************************/
+
+void StaticBatch::build(const std::vector<MeshRenderer *> & meshes,
+                        const std::vector<Model *> & models)
+{
+  clear();
+  if (!isSupported()) {
+    qDebug() << "[StaticBatch] OpenGL 4.3 is required for static batching.";
+    return;
+  }
+
+  mInitialized = true;
+
+  // Stage MeshRenderers using the default shaders and no texture.
+  // Positions and colors are interleaved to match QTK_SHADER_VERTEX_MESH_BATCH
+  InstanceGroups meshGroups(1);
+  for (const auto & mesh : meshes) {
+    if (!mesh->isStatic() || !mesh->isVisible()
+        || mesh->getTexture().hasTexture()
+        || !mesh->getVertexShader().empty()
+        || !mesh->getFragmentShader().empty()
+        || mesh->getDrawType() != GL_TRIANGLES || mesh->getVertices().empty()) {
+      continue;
+    }
+
+    const auto & vertices = mesh->getVertices();
+    const auto & colors = mesh->getColors();
+    Instance instance;
+    instance.mObject = mesh;
+    instance.mStagedVertices.reserve(vertices.size() * 2);
+    for (size_t i = 0; i < vertices.size(); i++) {
+      instance.mStagedVertices.push_back(vertices[i]);
+      instance.mStagedVertices.push_back(
+          i < colors.size() ? colors[i] : QVector3D(1.0f, 1.0f, 1.0f));
+    }
+    instance.mVertexBytes = vertices.size() * 2 * sizeof(QVector3D);
+
+    if (mesh->getShape().getDrawMode() == QTK_DRAW_ARRAYS) {
+      instance.mStagedIndices.resize(vertices.size());
+      for (GLuint i = 0; i < vertices.size(); i++) {
+        instance.mStagedIndices[i] = i;
+      }
+      instance.mIndexCount = instance.mStagedIndices.size();
+    } else if (!mesh->getIndexData().empty()) {
+      instance.mIndices = mesh->getIndexData().data();
+      instance.mIndexCount = mesh->getIndexData().size();
+    } else {
+      continue;
+    }
+
+    meshGroups.front().second.push_back(std::move(instance));
+    mObjects.push_back(mesh);
+  }
+
+  // Stage Models using the default shaders, grouped by diffuse texture.
+  InstanceGroups modelGroups;
+  std::unordered_map<QOpenGLTexture *, size_t> textureGroups;
+  for (const auto & model : models) {
+    if (!model->isStatic() || !model->isVisible()
+        || !model->getVertexShader().empty()
+        || !model->getFragmentShader().empty() || model->getMeshes().empty()) {
+      continue;
+    }
+
+    for (const auto & mesh : model->getMeshes()) {
+      QOpenGLTexture * diffuse = Q_NULLPTR;
+      for (const auto & texture : mesh.mTextures) {
+        if (texture.mType == "texture_diffuse") {
+          diffuse = texture.mTexture;
+          break;
+        }
+      }
+
+      auto group = textureGroups.find(diffuse);
+      if (group == textureGroups.end()) {
+        group = textureGroups.emplace(diffuse, modelGroups.size()).first;
+        modelGroups.emplace_back(diffuse, std::vector<Instance>());
+      }
+
+      Instance instance;
+      instance.mObject = model;
+      instance.mVertices = mesh.mVertices.data();
+      instance.mVertexBytes = mesh.mVertices.size() * sizeof(ModelVertex);
+      instance.mIndices = mesh.mIndices.data();
+      instance.mIndexCount = mesh.mIndices.size();
+      modelGroups[group->second].second.push_back(std::move(instance));
+    }
+    mObjects.push_back(model);
+  }
+
+  if (mObjects.empty()) {
+    return;
+  }
+
+  buildArena(mMeshArena,
+             meshGroups,
+             2 * sizeof(QVector3D),
+             {{0, 0, 3}, {1, sizeof(QVector3D), 3}},
+             QTK_SHADER_VERTEX_MESH_BATCH,
+             QTK_SHADER_FRAGMENT_MESH);
+  buildArena(mModelArena,
+             modelGroups,
+             sizeof(ModelVertex),
+             {{0, offsetof(ModelVertex, mPosition), 3},
+              {2, offsetof(ModelVertex, mTextureCoord), 2}},
+             QTK_SHADER_VERTEX_MODEL_BATCH,
+             QTK_SHADER_FRAGMENT_MODEL);
+
+  auto gl = QOpenGLContext::currentContext()->extraFunctions();
+  // Draw IDs are read once per instance to index the transform buffer.
+  // The baseInstance of each command offsets into this buffer.
+  std::vector<GLfloat> drawIDs(mInstances.size());
+  for (size_t i = 0; i < drawIDs.size(); i++) {
+    drawIDs[i] = static_cast<GLfloat>(i);
+  }
+  gl->glGenBuffers(1, &mDrawIDs);
+  gl->glBindBuffer(GL_ARRAY_BUFFER, mDrawIDs);
+  gl->glBufferData(GL_ARRAY_BUFFER,
+                   drawIDs.size() * sizeof(drawIDs[0]),
+                   drawIDs.data(),
+                   GL_STATIC_DRAW);
+  QTK_RENDER_STAT(mBufferBytes, drawIDs.size() * sizeof(drawIDs[0]));
+  gl->glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+  gl->glGenBuffers(1, &mTransformBuffer);
+  gl->glBindBuffer(GL_SHADER_STORAGE_BUFFER, mTransformBuffer);
+  gl->glBufferData(GL_SHADER_STORAGE_BUFFER,
+                   mInstances.size() * 16 * sizeof(GLfloat),
+                   nullptr,
+                   GL_STREAM_DRAW);
+  gl->glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+  // Upload every transform on the first draw.
+  mRevisions.assign(mInstances.size(), kNoRevision);
+
+  bindArena(mMeshArena);
+  bindArena(mModelArena);
+  mEpoch = GpuAllocator::getInstance().getEpoch();
+
+  for (const auto & object : mObjects) {
+    object->mBatched = true;
+  }
+}
+
+void StaticBatch::draw()
+{
+  if (mInstances.empty()) {
+    return;
+  }
+
+  if (auto epoch = GpuAllocator::getInstance().getEpoch(); epoch != mEpoch) {
+    bindArena(mMeshArena);
+    bindArena(mModelArena);
+    mEpoch = epoch;
+  }
+
+  // Only upload the range of instances whose world matrix changed.
+  mMatrices.resize(mInstances.size() * 16);
+  mRevisions.resize(mInstances.size(), kNoRevision);
+  size_t first = mInstances.size(), last = 0;
+  for (size_t i = 0; i < mInstances.size(); i++) {
+    auto revision = mInstances[i]->getDrawRevision();
+    if (revision == mRevisions[i]) {
+      continue;
+    }
+    mRevisions[i] = revision;
+    first = std::min(first, i);
+    last = i + 1;
+    // QMatrix4x4 carries a flag for its type, so copy only the matrix data.
+    std::memcpy(&mMatrices[i * 16],
+                mInstances[i]->getDrawMatrix().constData(),
+                16 * sizeof(GLfloat));
+  }
+  auto gl = QOpenGLContext::currentContext()->extraFunctions();
+  if (first < last) {
+    gl->glBindBuffer(GL_SHADER_STORAGE_BUFFER, mTransformBuffer);
+    gl->glBufferSubData(GL_SHADER_STORAGE_BUFFER,
+                        first * 16 * sizeof(mMatrices[0]),
+                        (last - first) * 16 * sizeof(mMatrices[0]),
+                        &mMatrices[first * 16]);
+    QTK_RENDER_STAT(mBufferBytes, (last - first) * 16 * sizeof(mMatrices[0]));
+    gl->glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+  }
+  gl->glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, mTransformBuffer);
+
+  drawArena(mMeshArena);
+  drawArena(mModelArena);
+}
+
+void StaticBatch::clear()
+{
+  for (const auto & object : mObjects) {
+    object->mBatched = false;
+  }
+  mObjects.clear();
+  mInstances.clear();
+
+  // Views sharing the scene draw it from different contexts, so GL functions
+  // are resolved from whichever context is current.
+  auto context = QOpenGLContext::currentContext();
+  if (!mInitialized || context == Q_NULLPTR) {
+    return;
+  }
+  auto gl = context->extraFunctions();
+  destroyArena(mMeshArena);
+  destroyArena(mModelArena);
+  if (mDrawIDs != 0) {
+    gl->glDeleteBuffers(1, &mDrawIDs);
+    mDrawIDs = 0;
+  }
+  if (mTransformBuffer != 0) {
+    gl->glDeleteBuffers(1, &mTransformBuffer);
+    mTransformBuffer = 0;
+  }
+}
+
+void StaticBatch::release(Object * object)
+{
+  auto it = std::find(mObjects.begin(), mObjects.end(), object);
+  if (it != mObjects.end()) {
+    object->mBatched = false;
+    mObjects.erase(it);
+    // Instances may now reference a deleted object; draw nothing until the
+    // Scene rebuilds this batch.
+    mInstances.clear();
+  }
+}
+
+/*******************************************************************************
+ * Static Public Methods
+ ******************************************************************************/
+
+bool StaticBatch::isSupported()
+{
+  auto context = QOpenGLContext::currentContext();
+  if (context == Q_NULLPTR || context->isOpenGLES()) {
+    return false;
+  }
+  return context->format().version() >= qMakePair(4, 3);
+}
+
+/*******************************************************************************
+ * Private Methods
+ ******************************************************************************/
+
+void StaticBatch::buildArena(Arena & arena,
+                             const InstanceGroups & groups,
+                             GLsizei stride,
+                             std::vector<Attribute> attributes,
+                             const char * vertexShader,
+                             const char * fragmentShader)
+{
+  /** Unique geometry stored within the arena. */
+  struct Geometry {
+      const char * mVertices;
+      size_t mVertexBytes;
+      const GLuint * mIndices;
+      GLuint mCount;
+      GLint mBaseVertex;
+      GLuint mFirstIndex;
+  };
+
+  std::vector<char> vertices;
+  std::vector<GLuint> indices;
+  std::vector<DrawCommand> commands;
+  std::vector<Geometry> geometry;
+  std::unordered_map<size_t, std::vector<size_t>> lookup;
+
+  for (const auto & [texture, instances] : groups) {
+    if (instances.empty()) {
+      continue;
+    }
+    DrawGroup group {texture, commands.size(), 0};
+
+    // Instances of the same geometry within a group become one command.
+    std::vector<std::pair<size_t, std::vector<const Object *>>> batches;
+    std::unordered_map<size_t, size_t> batchIndex;
+    for (const auto & instance : instances) {
+      auto data = static_cast<const char *>(
+          instance.mVertices != nullptr ? instance.mVertices
+                                        : instance.mStagedVertices.data());
+      auto index = instance.mIndices != nullptr
+                       ? instance.mIndices
+                       : instance.mStagedIndices.data();
+      auto hash = qHashBits(data,
+                            instance.mVertexBytes,
+                            qHashBits(index, instance.mIndexCount
+                                                 * sizeof(GLuint)));
+
+      size_t found = geometry.size();
+      for (const auto & candidate : lookup[hash]) {
+        const auto & g = geometry[candidate];
+        if (g.mVertexBytes == instance.mVertexBytes
+            && g.mCount == instance.mIndexCount
+            && std::memcmp(g.mVertices, data, g.mVertexBytes) == 0
+            && std::memcmp(g.mIndices, index, g.mCount * sizeof(GLuint))
+                   == 0) {
+          found = candidate;
+          break;
+        }
+      }
+
+      if (found == geometry.size()) {
+        geometry.push_back({data,
+                            instance.mVertexBytes,
+                            index,
+                            static_cast<GLuint>(instance.mIndexCount),
+                            static_cast<GLint>(vertices.size() / stride),
+                            static_cast<GLuint>(indices.size())});
+        lookup[hash].push_back(found);
+        vertices.insert(vertices.end(), data, data + instance.mVertexBytes);
+        indices.insert(indices.end(), index, index + instance.mIndexCount);
+      }
+
+      auto batch = batchIndex.find(found);
+      if (batch == batchIndex.end()) {
+        batch = batchIndex.emplace(found, batches.size()).first;
+        batches.emplace_back(found, std::vector<const Object *>());
+      }
+      batches[batch->second].second.push_back(instance.mObject);
+    }
+
+    for (const auto & [id, objects] : batches) {
+      const auto & g = geometry[id];
+      commands.push_back({g.mCount,
+                          static_cast<GLuint>(objects.size()),
+                          g.mFirstIndex,
+                          g.mBaseVertex,
+                          static_cast<GLuint>(mInstances.size())});
+      mInstances.insert(mInstances.end(), objects.begin(), objects.end());
+      group.mTriangles += g.mCount / 3 * objects.size();
+    }
+    group.mCommandCount =
+        static_cast<GLsizei>(commands.size() - group.mFirstCommand);
+    arena.mGroups.push_back(group);
+  }
+
+  if (commands.empty()) {
+    return;
+  }
+  arena.mCommandCount = commands.size();
+  arena.mCommands = std::move(commands);
+  arena.mStride = stride;
+  arena.mAttributes = std::move(attributes);
+
+  {
+    Tracer::Span link("Shader Link", "shader");
+    QTK_RENDER_STAT(mShaderLinks, 1);
+    arena.mProgram.create();
+    arena.mProgram.addShaderFromSourceCode(QOpenGLShader::Vertex,
+                                           vertexShader);
+    arena.mProgram.addShaderFromSourceCode(QOpenGLShader::Fragment,
+                                           fragmentShader);
+    if (!arena.mProgram.link()) {
+      qDebug() << "[StaticBatch] Failed to link shader: "
+               << arena.mProgram.log();
+    }
+  }
+
+  // Untextured groups sample a white texture instead of whatever texture was
+  // left bound to unit 0 by the previous draw.
+  if (arena.mProgram.uniformLocation("texture_diffuse1") >= 0) {
+    for (auto & group : arena.mGroups) {
+      if (group.mTexture != Q_NULLPTR) {
+        continue;
+      }
+      if (mWhiteTexture == Q_NULLPTR) {
+        QImage white(1, 1, QImage::Format_RGBA8888);
+        white.fill(Qt::white);
+        mWhiteTexture =
+            new QOpenGLTexture(white, QOpenGLTexture::DontGenerateMipMaps);
+        QTK_RENDER_STAT(mTextureUploads, 1);
+      }
+      group.mTexture = mWhiteTexture;
+    }
+  }
+
+  // Vertices are aligned to the stride so offsets can be used as baseVertex.
+  auto & allocator = GpuAllocator::getInstance();
+  arena.mVertices = allocator.allocate(QTK_GPU_BATCH, vertices.size(), stride);
+  allocator.write(arena.mVertices, vertices.data(), vertices.size());
+  arena.mIndices = allocator.allocate(
+      QTK_GPU_BATCH, indices.size() * sizeof(indices[0]), sizeof(GLuint));
+  allocator.write(
+      arena.mIndices, indices.data(), indices.size() * sizeof(indices[0]));
+
+  QOpenGLContext::currentContext()->extraFunctions()->glGenBuffers(
+      1, &arena.mIndirect);
+}
+
+void StaticBatch::bindArena(Arena & arena)
+{
+  if (arena.mGroups.empty()) {
+    return;
+  }
+
+  auto & allocator = GpuAllocator::getInstance();
+  auto baseVertex = allocator.getOffset(arena.mVertices) / arena.mStride;
+  auto firstIndex = allocator.getOffset(arena.mIndices) / sizeof(GLuint);
+  arena.mVAO.invalidate();
+
+  std::vector<DrawCommand> commands(arena.mCommands);
+  for (auto & command : commands) {
+    command.mBaseVertex += baseVertex;
+    command.mFirstIndex += firstIndex;
+  }
+  auto gl = QOpenGLContext::currentContext()->extraFunctions();
+  gl->glBindBuffer(GL_DRAW_INDIRECT_BUFFER, arena.mIndirect);
+  gl->glBufferData(GL_DRAW_INDIRECT_BUFFER,
+                   commands.size() * sizeof(DrawCommand),
+                   commands.data(),
+                   GL_STATIC_DRAW);
+  QTK_RENDER_STAT(mBufferBytes, commands.size() * sizeof(DrawCommand));
+  gl->glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+}
+
+void StaticBatch::bindAttributes(Arena & arena)
+{
+  auto gl = QOpenGLContext::currentContext()->extraFunctions();
+  auto & allocator = GpuAllocator::getInstance();
+  gl->glBindBuffer(GL_ARRAY_BUFFER, allocator.getBuffer(arena.mVertices));
+  for (const auto & attribute : arena.mAttributes) {
+    arena.mProgram.enableAttributeArray(attribute.mLocation);
+    arena.mProgram.setAttributeBuffer(attribute.mLocation,
+                                      GL_FLOAT,
+                                      attribute.mOffset,
+                                      attribute.mTupleSize,
+                                      arena.mStride);
+  }
+  gl->glBindBuffer(GL_ARRAY_BUFFER, mDrawIDs);
+  gl->glEnableVertexAttribArray(7);
+  gl->glVertexAttribPointer(7, 1, GL_FLOAT, GL_FALSE, 0, nullptr);
+  gl->glVertexAttribDivisor(7, 1);
+  gl->glBindBuffer(GL_ARRAY_BUFFER, 0);
+  // The element buffer binding is stored in the VAO.
+  gl->glBindBuffer(GL_ELEMENT_ARRAY_BUFFER,
+                   allocator.getBuffer(arena.mIndices));
+}
+
+void StaticBatch::drawArena(Arena & arena)
+{
+  if (arena.mGroups.empty()) {
+    return;
+  }
+
+  auto context = QOpenGLContext::currentContext();
+  auto gl43 =
+      QOpenGLVersionFunctionsFactory::get<QOpenGLFunctions_4_3_Core>(context);
+  if (gl43 == Q_NULLPTR) {
+    qDebug() << "[StaticBatch] Failed to resolve OpenGL 4.3 functions.";
+    return;
+  }
+  auto gl = context->extraFunctions();
+
+  if (arena.mVAO.bind()) {
+    bindAttributes(arena);
+  }
+  arena.mProgram.bind();
+  arena.mProgram.setUniformValue("uView", Scene::getDrawViewMatrix());
+  arena.mProgram.setUniformValue("uProjection", Scene::getDrawProjectionMatrix());
+  QTK_RENDER_STAT(mProgramBinds, 1);
+  QTK_RENDER_STAT(mUniformUploads, 2);
+  gl->glBindBuffer(GL_DRAW_INDIRECT_BUFFER, arena.mIndirect);
+
+  for (const auto & group : arena.mGroups) {
+    if (group.mTexture != Q_NULLPTR) {
+      gl->glActiveTexture(GL_TEXTURE0);
+      group.mTexture->bind();
+      arena.mProgram.setUniformValue("texture_diffuse1", 0);
+      QTK_RENDER_STAT(mTextureBinds, 1);
+      QTK_RENDER_STAT(mUniformUploads, 1);
+    }
+
+    gl43->glMultiDrawElementsIndirect(
+        GL_TRIANGLES,
+        GL_UNSIGNED_INT,
+        reinterpret_cast<const void *>(group.mFirstCommand
+                                       * sizeof(DrawCommand)),
+        group.mCommandCount,
+        0);
+    QTK_RENDER_STAT(mDrawCalls, 1);
+    QTK_RENDER_STAT(mTriangles, group.mTriangles);
+
+    if (group.mTexture != Q_NULLPTR) {
+      group.mTexture->release();
+    }
+  }
+
+  gl->glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+  arena.mVAO.release();
+  arena.mProgram.release();
+}
+
+void StaticBatch::destroyArena(Arena & arena)
+{
+  arena.mVAO.destroy();
+  if (arena.mProgram.isLinked()) {
+    arena.mProgram.removeAllShaders();
+  }
+  if (arena.mIndirect != 0) {
+    QOpenGLContext::currentContext()->extraFunctions()->glDeleteBuffers(
+        1, &arena.mIndirect);
+    arena.mIndirect = 0;
+  }
+  GpuAllocator::free(arena.mVertices);
+  GpuAllocator::free(arena.mIndices);
+  arena.mCommands.clear();
+  arena.mGroups.clear();
+  arena.mCommandCount = 0;
+}
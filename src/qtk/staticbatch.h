@@ -0,0 +1,247 @@
+/*##############################################################################
+## Author: Shaun Reed                                                         ##
+## Legal: All Content (c) 2025 Shaun Reed, all rights reserved                ##
+## About: Multi-draw-indirect batching for static scene geometry              ##
+##                                                                            ##
+## Contact: shaunrd0@gmail.com  | URL: www.shaunreed.com | GitHub: shaunrd0   ##
+##############################################################################*/
+
+#ifndef QTK_STATICBATCH_H
+#define QTK_STATICBATCH_H
+
+#include <QOpenGLShaderProgram>
+#include <QOpenGLTexture>
+
+#include <utility>
+#include <vector>
+
+#include "gpuallocator.h"
+#include "qtkapi.h"
+#include "transform3D.h"
+#include "vertexarray.h"
+
+namespace Qtk
+{
+  class MeshRenderer;
+  class Model;
+  class Object;
+
+  /**
+   * Draws static objects from shared vertex and index arenas.
+   *
+   * Objects flagged with Object::setStatic that use the default shaders are
+   * copied into one of two arenas, one for each vertex format used by Qtk:
+   *    MeshRenderer (position, color), Model (ModelVertex)
+   * Identical geometry is stored once and drawn instanced. Transforms for each
+   * instance are uploaded to a shader storage buffer every frame, so static
+   * objects may still be moved. All draws sharing a program and texture are
+   * submitted with a single glMultiDrawElementsIndirect call.
+   * Arena storage is sub-allocated from the GpuAllocator.
+   *
+   * Requires OpenGL 4.3. See StaticBatch::isSupported.
+   * GL functions are resolved from the current context on each call, so a
+   * batch may be drawn by every view sharing the scene's context group.
+   */
+  class QTKAPI StaticBatch
+  {
+    public:
+      /*************************************************************************
+       * Constructors / Destructors
+       ************************************************************************/
+
+      StaticBatch();
+
+      ~StaticBatch();
+
+      /*************************************************************************
+       * Public Methods
+       ************************************************************************/
+
+      /**
+       * Rebuild the arenas from all eligible objects. Objects that are drawn
+       * by this batch are flagged so the Scene can skip them.
+       * Requires a current OpenGL context.
+       *
+       * @param meshes MeshRenderers to consider for batching.
+       * @param models Models to consider for batching.
+       */
+      void build(const std::vector<MeshRenderer *> & meshes,
+                 const std::vector<Model *> & models);
+
+      /**
+       * Draw all batched objects.
+       */
+      void draw();
+
+      /**
+       * Releases all GL resources and clears the batched flag on all objects
+       * previously drawn by this batch.
+       */
+      void clear();
+
+      /**
+       * Stop tracking an object that is being removed from the scene.
+       * The batch must be rebuilt before it is drawn again.
+       *
+       * @param object The object to release from this batch.
+       */
+      void release(Object * object);
+
+      /*************************************************************************
+       * Accessors
+       ************************************************************************/
+
+      /**
+       * @return True if the current OpenGL context can draw a StaticBatch.
+       */
+      [[nodiscard]] static bool isSupported();
+
+      /**
+       * @return Number of objects drawn by this batch.
+       */
+      [[nodiscard]] inline size_t getObjectCount() const
+      {
+        return mObjects.size();
+      }
+
+      /**
+       * @return Number of indirect draw commands submitted each frame.
+       */
+      [[nodiscard]] inline size_t getCommandCount() const
+      {
+        return mMeshArena.mCommandCount + mModelArena.mCommandCount;
+      }
+
+    private:
+      /*************************************************************************
+       * Private Types
+       ************************************************************************/
+
+      /** Layout defined by OpenGL for glMultiDrawElementsIndirect. */
+      struct DrawCommand {
+          GLuint mCount;
+          GLuint mInstanceCount;
+          GLuint mFirstIndex;
+          GLint mBaseVertex;
+          GLuint mBaseInstance;
+      };
+
+      /** Commands sharing a texture, submitted with a single draw call. */
+      struct DrawGroup {
+          QOpenGLTexture * mTexture {};
+          size_t mFirstCommand {};
+          GLsizei mCommandCount {};
+          /* Triangles drawn by all commands and instances of the group. */
+          uint64_t mTriangles {};
+      };
+
+      /** Vertex attribute read from an arena's vertex buffer. */
+      struct Attribute {
+          int mLocation;
+          int mOffset;
+          int mTupleSize;
+      };
+
+      /** Shared buffers and draw commands for a single vertex format. */
+      struct Arena {
+          QOpenGLShaderProgram mProgram;
+          VertexArray mVAO;
+          GpuHandle mVertices {}, mIndices {};
+          GLuint mIndirect {};
+          GLsizei mStride {};
+          std::vector<Attribute> mAttributes {};
+          /* Commands relative to the start of the arena's allocations. */
+          std::vector<DrawCommand> mCommands {};
+          std::vector<DrawGroup> mGroups {};
+          size_t mCommandCount {};
+      };
+
+      /** Geometry and transform of a single object staged for upload. */
+      struct Instance {
+          const Object * mObject {};
+          const void * mVertices {};
+          size_t mVertexBytes {};
+          const GLuint * mIndices {};
+          size_t mIndexCount {};
+          /* Storage for geometry that must be converted before upload. */
+          std::vector<QVector3D> mStagedVertices {};
+          std::vector<GLuint> mStagedIndices {};
+      };
+
+      typedef std::vector<std::pair<QOpenGLTexture *, std::vector<Instance>>>
+          InstanceGroups;
+
+      /*************************************************************************
+       * Private Methods
+       ************************************************************************/
+
+      /**
+       * Upload staged instances into an arena, merging identical geometry.
+       *
+       * @param arena The arena to fill.
+       * @param groups Instances to upload, grouped by texture.
+       * @param stride Size of a single vertex in bytes.
+       * @param attributes Vertex attributes read by the arena program.
+       * @param vertexShader Vertex shader source for the arena program.
+       * @param fragmentShader Fragment shader source for the arena program.
+       */
+      void buildArena(Arena & arena,
+                      const InstanceGroups & groups,
+                      GLsizei stride,
+                      std::vector<Attribute> attributes,
+                      const char * vertexShader,
+                      const char * fragmentShader);
+
+      /**
+       * Point the arena indirect commands at the current location of its
+       * allocations, and require each context to set up its VAO again.
+       * Called after building and whenever the GpuAllocator moves memory.
+       *
+       * @param arena The arena to bind.
+       */
+      void bindArena(Arena & arena);
+
+      /**
+       * Point the arena VAO attributes and element buffer at its allocations.
+       * Called with the VAO bound when `arena.mVAO.bind()` requires it.
+       *
+       * @param arena The arena to set up attributes for.
+       */
+      void bindAttributes(Arena & arena);
+
+      /**
+       * Submit all draw groups for an arena.
+       *
+       * @param arena The arena to draw.
+       */
+      void drawArena(Arena & arena);
+
+      void destroyArena(Arena & arena);
+
+      /*************************************************************************
+       * Private Members
+       ************************************************************************/
+
+      Arena mMeshArena, mModelArena;
+      /* Per-instance draw IDs (0..N-1) used to index the transform buffer. */
+      GLuint mDrawIDs {};
+      /* Shader storage buffer holding one model matrix per instance. */
+      GLuint mTransformBuffer {};
+      /* Object drawn by each instance, in the order transforms are stored. */
+      std::vector<const Object *> mInstances {};
+      /* Staging memory used to upload transforms each frame. */
+      std::vector<float> mMatrices {};
+      /* Object::getDrawRevision of each instance when last uploaded. */
+      std::vector<uint64_t> mRevisions {};
+      static constexpr uint64_t kNoRevision = ~uint64_t(0);
+      /* GpuAllocator epoch the arenas were last bound with. */
+      uint64_t mEpoch = 0;
+      /* Bound for draw groups of textured arenas with no diffuse texture. */
+      QOpenGLTexture * mWhiteTexture {};
+      /* Objects currently drawn by this batch. */
+      std::vector<Object *> mObjects {};
+      bool mInitialized = false;
+  };
+}  // namespace Qtk
+
+#endif  // QTK_STATICBATCH_H
@@ -10,7 +10,9 @@
 #include <QImageReader>
 #include <QPainter>
 
+#include "renderstats.h"
 #include "texture.h"
+#include "tracer.h"
 
 using namespace Qtk;
 
@@ -32,7 +34,14 @@ QOpenGLTexture * OpenGLTextureFactory::initTexture(const char * texture,
                                                    bool flipX,
                                                    bool flipY)
 {
-  QImage image = initImage(texture, flipX, flipY);
+  Tracer::Span span("OpenGLTextureFactory::initTexture", "load");
+  QImage image;
+  {
+    Tracer::Span decode("Texture Decode", "load");
+    image = initImage(texture, flipX, flipY);
+  }
+  Tracer::Span upload("Texture Upload", "gpu");
+  QTK_RENDER_STAT(mTextureUploads, 1);
   auto newTexture = new QOpenGLTexture(QOpenGLTexture::Target2D);
   newTexture->setData(image);
   newTexture->setWrapMode(QOpenGLTexture::Repeat);
@@ -126,6 +135,7 @@ QOpenGLTexture * OpenGLTextureFactory::initCubeMap(const QImage & right,
                      QOpenGLTexture::RGBA,
                      QOpenGLTexture::UInt8,
                      faceImage.constBits());
+    QTK_RENDER_STAT(mTextureUploads, 1);
     i++;
   }
 
@@ -15,6 +15,7 @@
 #include <QOpenGLTexture>
 
 #include "qtkapi.h"
+#include "renderstats.h"
 
 namespace Qtk
 {
@@ -226,6 +227,7 @@ namespace Qtk
           // TODO: It would be nice to warn here but some objects may not have
           // a texture. Factor Texture out of those objects so we don't bind.
           mOpenGLTexture->bind();
+          QTK_RENDER_STAT(mTextureBinds, 1);
           return true;
         }
         return false;
@@ -0,0 +1,258 @@
+/*##############################################################################
+## Author: Shaun Reed                                                         ##
+## Legal: All Content (c) 2025 Shaun Reed, all rights reserved                ##
+## About: Trace spans across threads exported as Chrome trace events          ##
+##                                                                            ##
+## Contact: shaunrd0@gmail.com  | URL: www.shaunreed.com | GitHub: shaunrd0   ##
+##############################################################################*/
+
+#include <QCoreApplication>
+#include <QDebug>
+#include <QFile>
+#include <QThread>
+
+#include <chrono>
+
+#include "tracer.h"
+
+using namespace Qtk;
+
+namespace Qtk
+{
+  /** Releases a thread's buffer for reuse when the thread exits. */
+  struct ThreadBuffer {
+      Tracer::Buffer * mBuffer {};
+
+      ~ThreadBuffer()
+      {
+        if (mBuffer != Q_NULLPTR) {
+          mBuffer->mOwned.store(false, std::memory_order_release);
+        }
+      }
+  };
+}  // namespace Qtk
+
+static thread_local ThreadBuffer tBuffer;
+
+/*******************************************************************************
+ * Static Helpers
+ ******************************************************************************/
+
+/**
+ * @param text Text to quote.
+ * @return The text as a quoted JSON string.
+ */
+static QByteArray quote(const QString & text)
+{
+  QByteArray json = "\"";
+  for (char c : text.toUtf8()) {
+    if (c == '"' || c == '\\') {
+      json += '\\';
+      json += c;
+    } else if (static_cast<unsigned char>(c) < 0x20) {
+      json += QString("\\u%1").arg(int(c), 4, 16, QChar('0')).toLatin1();
+    } else {
+      json += c;
+    }
+  }
+  return json + "\"";
+}
+
+/**
+ * @param ns Nanoseconds.
+ * @return Microseconds, the unit of Chrome trace event timestamps.
+ */
+static QByteArray micros(int64_t ns)
+{
+  return QByteArray::number(double(ns) / 1.0e3, 'f', 3);
+}
+
+/*******************************************************************************
+ * Span
+ ******************************************************************************/
+
+Tracer::Span::Span(const char * name, const char * category) :
+    mName(name), mCategory(category),
+    mStart(getInstance().isCapturing() ? now() : -1)
+{
+}
+
+Tracer::Span::~Span()
+{
+  if (mStart < 0) {
+    return;
+  }
+  auto & tracer = getInstance();
+  if (tracer.isCapturing()) {
+    tracer.record(mName, mCategory, mStart, now());
+  }
+}
+
+/*******************************************************************************
+ * Constructors / Destructors
+ ******************************************************************************/
+
+Tracer::Tracer() = default;
+
+Tracer::~Tracer() = default;
+
+/*******************************************************************************
+ * Public Methods
+ ******************************************************************************/
+
+Tracer & Tracer::getInstance()
+{
+  static Tracer tracer;
+  return tracer;
+}
+
+void Tracer::start()
+{
+  QMutexLocker control(&mControlMutex);
+  mStart.store(now(), std::memory_order_relaxed);
+  // Buffers left over from the last capture are reset by their threads.
+  mCapture.fetch_add(1, std::memory_order_release);
+  mCapturing.store(true, std::memory_order_release);
+}
+
+bool Tracer::stop(const QString & path)
+{
+  QMutexLocker control(&mControlMutex);
+  if (!mCapturing.exchange(false, std::memory_order_acq_rel)) {
+    qDebug() << "[Tracer] No capture to stop.";
+    return false;
+  }
+
+  const auto capture = mCapture.load(std::memory_order_relaxed);
+  std::vector<Event> events;
+  std::map<uint32_t, QString> names;
+  size_t dropped = 0;
+  {
+    QMutexLocker lock(&mMutex);
+    names = mThreadNames;
+    for (const auto & buffer : mBuffers) {
+      if (buffer->mCapture.load(std::memory_order_acquire) != capture) {
+        continue;
+      }
+      auto count = buffer->mCount.load(std::memory_order_acquire);
+      events.insert(events.end(),
+                    buffer->mEvents.get(),
+                    buffer->mEvents.get() + count);
+      dropped += buffer->mDropped.load(std::memory_order_relaxed);
+    }
+  }
+  if (dropped > 0) {
+    qDebug() << "[Tracer] Dropped" << dropped
+             << "spans from threads over the limit of" << kMaxEvents;
+  }
+
+  QFile file(path);
+  if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+    qDebug() << "[Tracer] Failed to open" << path << "for writing.";
+    return false;
+  }
+
+  const auto pid = QByteArray::number(QCoreApplication::applicationPid());
+  QByteArray json = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+  json += "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":" + pid
+          + ",\"args\":{\"name\":" + quote(QCoreApplication::applicationName())
+          + "}}";
+  for (const auto & [thread, name] : names) {
+    json += ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" + pid
+            + ",\"tid\":" + QByteArray::number(thread)
+            + ",\"args\":{\"name\":" + quote(name) + "}}";
+  }
+  for (const auto & event : events) {
+    json += ",\n{\"name\":" + quote(event.mName)
+            + ",\"cat\":" + quote(event.mCategory)
+            + ",\"ph\":\"X\",\"pid\":" + pid
+            + ",\"tid\":" + QByteArray::number(event.mThread)
+            + ",\"ts\":" + micros(event.mStart)
+            + ",\"dur\":" + micros(event.mDuration) + "}";
+  }
+  json += "\n]}\n";
+
+  if (file.write(json) != json.size()) {
+    qDebug() << "[Tracer] Failed to write" << path;
+    return false;
+  }
+  qDebug() << "[Tracer] Wrote" << events.size() << "spans to" << path;
+  return true;
+}
+
+/*******************************************************************************
+ * Private Methods
+ ******************************************************************************/
+
+int64_t Tracer::now()
+{
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+Tracer::Buffer * Tracer::getBuffer()
+{
+  if (tBuffer.mBuffer != Q_NULLPTR) {
+    return tBuffer.mBuffer;
+  }
+
+  QMutexLocker lock(&mMutex);
+  Buffer * buffer = Q_NULLPTR;
+  for (const auto & candidate : mBuffers) {
+    if (!candidate->mOwned.load(std::memory_order_acquire)) {
+      buffer = candidate.get();
+      break;
+    }
+  }
+  if (buffer == Q_NULLPTR) {
+    mBuffers.push_back(std::make_unique<Buffer>());
+    buffer = mBuffers.back().get();
+    buffer->mEvents.reset(new Event[kMaxEvents]);
+  }
+  buffer->mOwned.store(true, std::memory_order_relaxed);
+  // Spans already in a reused buffer keep the ID of the thread that exited.
+  buffer->mThread = mNextThread++;
+
+  auto thread = QThread::currentThread();
+  auto name = thread->objectName();
+  if (name.isEmpty()) {
+    auto app = QCoreApplication::instance();
+    name = app != Q_NULLPTR && app->thread() == thread
+               ? QString("Main")
+               : QString("Thread %1").arg(buffer->mThread);
+  }
+  mThreadNames[buffer->mThread] = name;
+  tBuffer.mBuffer = buffer;
+  return buffer;
+}
+
+void Tracer::record(const char * name,
+                    const char * category,
+                    int64_t start,
+                    int64_t end)
+{
+  // Skip spans that started before a capture restarted.
+  const auto origin = mStart.load(std::memory_order_relaxed);
+  if (start < origin) {
+    return;
+  }
+
+  const auto capture = mCapture.load(std::memory_order_acquire);
+  auto buffer = getBuffer();
+  if (buffer->mCapture.load(std::memory_order_relaxed) != capture) {
+    buffer->mCount.store(0, std::memory_order_relaxed);
+    buffer->mDropped.store(0, std::memory_order_relaxed);
+    buffer->mCapture.store(capture, std::memory_order_release);
+  }
+
+  auto count = buffer->mCount.load(std::memory_order_relaxed);
+  if (count == kMaxEvents) {
+    buffer->mDropped.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+  buffer->mEvents[count] = {
+      name, category, start - origin, end - start, buffer->mThread};
+  // Publish the event to stop().
+  buffer->mCount.store(count + 1, std::memory_order_release);
+}
@@ -0,0 +1,183 @@
+/*##############################################################################
+## Author: Shaun Reed                                                         ##
+## Legal: All Content (c) 2025 Shaun Reed, all rights reserved                ##
+## About: Trace spans across threads exported as Chrome trace events          ##
+##                                                                            ##
+## Contact: shaunrd0@gmail.com  | URL: www.shaunreed.com | GitHub: shaunrd0   ##
+##############################################################################*/
+
+#ifndef QTK_TRACER_H
+#define QTK_TRACER_H
+
+#include <QMutex>
+#include <QString>
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <vector>
+
+#include "qtkapi.h"
+
+namespace Qtk
+{
+  /**
+   * Records spans of time on any thread and writes them as Chrome trace
+   * event JSON, which opens in Perfetto (ui.perfetto.dev) or
+   * chrome://tracing with one track per thread.
+   *
+   * Spans are only recorded between `start()` and `stop()`; otherwise a span
+   * costs a single atomic load. Each thread writes to a buffer of its own
+   * without locking. A lock is only taken the first time a thread records a
+   * span, to register its buffer. Buffers of threads that exit keep their
+   * spans and are reused by new threads.
+   */
+  class QTKAPI Tracer
+  {
+    public:
+      /*************************************************************************
+       * Typedefs
+       ************************************************************************/
+
+      /**
+       * Records the enclosing block as a span on the calling thread.
+       */
+      class QTKAPI Span
+      {
+        public:
+          /**
+           * @param name Static name of the span, such as "Model::loadModel".
+           * @param category Static category used to filter spans in a viewer.
+           */
+          explicit Span(const char * name, const char * category = "qtk");
+
+          ~Span();
+
+          Span(const Span &) = delete;
+          Span & operator=(const Span &) = delete;
+
+        private:
+          const char * mName;
+          const char * mCategory;
+          /* Negative if the span started outside of a capture. */
+          int64_t mStart;
+      };
+
+      /*************************************************************************
+       * Constructors / Destructors
+       ************************************************************************/
+
+      ~Tracer();
+
+      /*************************************************************************
+       * Public Methods
+       ************************************************************************/
+
+      static Tracer & getInstance();
+
+      /**
+       * Begin a new capture, discarding spans from any previous capture.
+       */
+      void start();
+
+      /**
+       * End the capture and write its spans as Chrome trace event JSON.
+       *
+       * @param path File to write the trace to.
+       * @return False if no capture was started or the file can't be written.
+       */
+      bool stop(const QString & path);
+
+      /*************************************************************************
+       * Accessors
+       ************************************************************************/
+
+      /**
+       * @return True between calls to `start()` and `stop()`.
+       */
+      [[nodiscard]] inline bool isCapturing() const
+      {
+        return mCapturing.load(std::memory_order_relaxed);
+      }
+
+      /** Spans kept for each thread in a capture; later spans are dropped. */
+      static constexpr size_t kMaxEvents = 1 << 16;
+
+    private:
+      /*************************************************************************
+       * Private Types
+       ************************************************************************/
+
+      struct Event {
+          const char * mName;
+          const char * mCategory;
+          /* Nanoseconds since the capture started. */
+          int64_t mStart;
+          int64_t mDuration;
+          uint32_t mThread;
+      };
+
+      /** Events written by a single thread. */
+      struct Buffer {
+          std::unique_ptr<Event[]> mEvents {};
+          /* Events published to `stop()`; only the owner thread writes. */
+          std::atomic<size_t> mCount {0};
+          /* Capture the events belong to. */
+          std::atomic<uint64_t> mCapture {0};
+          std::atomic<size_t> mDropped {0};
+          /* False once the thread that owns the buffer exits. */
+          std::atomic<bool> mOwned {true};
+          uint32_t mThread {};
+      };
+
+      friend struct ThreadBuffer;
+
+      /*************************************************************************
+       * Constructors / Destructors
+       ************************************************************************/
+
+      Tracer();
+
+      /*************************************************************************
+       * Private Methods
+       ************************************************************************/
+
+      /**
+       * @return Nanoseconds on a monotonic clock.
+       */
+      [[nodiscard]] static int64_t now();
+
+      /**
+       * @return Buffer of the calling thread, registered on first use.
+       */
+      Buffer * getBuffer();
+
+      /**
+       * Add a span to the calling thread's buffer.
+       */
+      void record(const char * name,
+                  const char * category,
+                  int64_t start,
+                  int64_t end);
+
+      /*************************************************************************
+       * Private Members
+       ************************************************************************/
+
+      std::atomic<bool> mCapturing {false};
+      /* Incremented by each call to `start()`. */
+      std::atomic<uint64_t> mCapture {0};
+      /* Time the capture started, from `now()`. */
+      std::atomic<int64_t> mStart {0};
+      /* Serializes start() and stop(). */
+      QMutex mControlMutex;
+      /* Guards mBuffers and mThreadNames. */
+      QMutex mMutex;
+      std::vector<std::unique_ptr<Buffer>> mBuffers {};
+      std::map<uint32_t, QString> mThreadNames {};
+      uint32_t mNextThread = 1;
+  };
+}  // namespace Qtk
+
+#endif  // QTK_TRACER_H
@@ -7,13 +7,54 @@
 ## Contact: shaunrd0@gmail.com	| URL: www.shaunreed.com | GitHub: shaunrd0   ##
 ##############################################################################*/
 
+#include <algorithm>
+
 #include "transform3D.h"
+#include "transformstore.h"
 
 using namespace Qtk;
 
 const QVector3D Transform3D::LocalForward(0.0f, 0.0f, 1.0f);
 const QVector3D Transform3D::LocalUp(0.0f, 1.0f, 0.0f);
 const QVector3D Transform3D::LocalRight(1.0f, 0.0f, 0.0f);
+std::atomic<uint64_t> Transform3D::sRevision = 0;
+thread_local float Transform3D::sInterpolation = 1.0f;
+thread_local uint64_t Transform3D::sMatrixUpdates = 0;
+
+/*******************************************************************************
+ * Constructors, Destructors
+ ******************************************************************************/
+
+Transform3D::Transform3D(const Transform3D & other) : m_dirty(true)
+{
+  *this = other;
+}
+
+Transform3D & Transform3D::operator=(const Transform3D & other)
+{
+  if (this == &other) {
+    return *this;
+  }
+  markDirty();
+  mTranslation = other.mTranslation;
+  mRotation = other.mRotation;
+  mScale = other.mScale;
+  mPreviousTranslation = other.mPreviousTranslation;
+  mPreviousRotation = other.mPreviousRotation;
+  mPreviousScale = other.mPreviousScale;
+  mHasPrevious = other.mHasPrevious;
+  mInterpolating = other.mInterpolating;
+  return *this;
+}
+
+Transform3D::~Transform3D()
+{
+  setParent(nullptr);
+  for (auto & child : mChildren) {
+    child->mParent = nullptr;
+    child->markDirty();
+  }
+}
 
 /*******************************************************************************
  * Public Methods
@@ -21,55 +62,127 @@ const QVector3D Transform3D::LocalRight(1.0f, 0.0f, 0.0f);
 
 void Transform3D::translate(const QVector3D & dt)
 {
-  m_dirty = true;
+  markDirty();
   mTranslation += dt;
 }
 
 void Transform3D::scale(const QVector3D & ds)
 {
-  m_dirty = true;
+  markDirty();
   mScale *= ds;
 }
 
 
 void Transform3D::grow(const QVector3D & ds)
 {
-  m_dirty = true;
+  markDirty();
   mScale += ds;
 }
 
 void Transform3D::rotate(const QQuaternion & dr)
 {
-  m_dirty = true;
+  markDirty();
   mRotation = dr * mRotation;
 }
 
 void Transform3D::setTranslation(const QVector3D & t)
 {
-  m_dirty = true;
+  markDirty();
   mTranslation = t;
 }
 
 void Transform3D::setScale(const QVector3D & s)
 {
-  m_dirty = true;
+  markDirty();
   mScale = s;
 }
 
 void Transform3D::setRotation(const QQuaternion & r)
 {
-  m_dirty = true;
+  markDirty();
   mRotation = r;
 }
 
+bool Transform3D::setParent(Transform3D * parent)
+{
+  for (auto ancestor = parent; ancestor != nullptr;
+       ancestor = ancestor->mParent) {
+    if (ancestor == this) {
+      return false;
+    }
+  }
+  if (parent == mParent) {
+    return true;
+  }
+
+  if (mParent != nullptr) {
+    auto & siblings = mParent->mChildren;
+    siblings.erase(std::remove(siblings.begin(), siblings.end(), this),
+                   siblings.end());
+  }
+  mParent = parent;
+  if (mParent != nullptr) {
+    mParent->mChildren.push_back(this);
+  }
+  markDirty();
+  return true;
+}
+
+void Transform3D::storePrevious()
+{
+  // Transforms that did not move draw the current state at any interpolation
+  // factor, so their cached matrix stays valid.
+  bool moved = mInterpolating
+               && (mPreviousTranslation != mTranslation
+                   || mPreviousRotation != mRotation
+                   || mPreviousScale != mScale);
+  mPreviousTranslation = mTranslation;
+  mPreviousRotation = mRotation;
+  mPreviousScale = mScale;
+  mHasPrevious = true;
+  mInterpolating = false;
+  if (moved) {
+    // The matrix was blended toward this state and now shows it unblended.
+    m_dirty = true;
+    ++sRevision;
+  }
+}
+
 const QMatrix4x4 & Transform3D::toMatrix()
 {
-  if (m_dirty) {
+  float alpha = mInterpolating ? sInterpolation : 1.0f;
+  bool local = m_dirty || mWorldInterpolation != alpha;
+  if (local) {
     m_dirty = false;
-    mWorld.setToIdentity();
-    mWorld.translate(mTranslation);
-    mWorld.rotate(mRotation);
-    mWorld.scale(mScale);
+    mWorldInterpolation = alpha;
+    // Writes T * R * S directly instead of three matrix multiplies.
+    if (alpha < 1.0f) {
+      TransformStore::compose(
+          mPreviousTranslation + (mTranslation - mPreviousTranslation) * alpha,
+          QQuaternion::nlerp(mPreviousRotation, mRotation, alpha),
+          mPreviousScale + (mScale - mPreviousScale) * alpha,
+          mLocal.data());
+    } else {
+      TransformStore::compose(mTranslation, mRotation, mScale, mLocal.data());
+    }
+  }
+
+  if (mParent == nullptr) {
+    if (local) {
+      mWorld = mLocal;
+      ++mWorldRevision;
+      ++sMatrixUpdates;
+    }
+    return mWorld;
+  }
+
+  // Bring the parent up to date first; it is cached if nothing changed.
+  const QMatrix4x4 & parent = mParent->toMatrix();
+  if (local || mParent->mWorldRevision != mParentRevision) {
+    mParentRevision = mParent->mWorldRevision;
+    mWorld = parent * mLocal;
+    ++mWorldRevision;
+    ++sMatrixUpdates;
   }
   return mWorld;
 }
@@ -128,7 +241,7 @@ namespace Qtk
     in >> transform.mTranslation;
     in >> transform.mScale;
     in >> transform.mRotation;
-    transform.m_dirty = true;
+    transform.markDirty();
     return in;
   }
 
@@ -14,6 +14,9 @@
 #include <QQuaternion>
 #include <QVector3D>
 
+#include <atomic>
+#include <vector>
+
 #ifndef QT_NO_DEBUG_STREAM
 #include <QDebug>
 #endif
@@ -24,6 +27,17 @@ namespace Qtk
 {
   /**
    * Transform3D class to represent and modify object position in 3D space.
+   *
+   * A transform may have a parent, in which case its translation, rotation
+   * and scale are relative to the parent and `toMatrix()` returns the product
+   * of the parent's world matrix and this transform's local matrix. World
+   * matrices are cached: a transform is only recomputed when it was modified,
+   * or when its parent's world matrix changed since it was last computed, so
+   * reading an unchanged subtree costs one comparison per transform.
+   *
+   * Each transform is computed on its own when read. For many instances,
+   * Registry entities keep their transforms in a TransformStore that is
+   * updated in batches instead.
    */
   class QTKAPI Transform3D
   {
@@ -38,6 +52,18 @@ namespace Qtk
       {
       }
 
+      /**
+       * Copies the local state only; the copy has no parent or children.
+       */
+      Transform3D(const Transform3D & other);
+
+      Transform3D & operator=(const Transform3D & other);
+
+      /**
+       * Children of this transform become roots, keeping their local state.
+       */
+      ~Transform3D();
+
       /*************************************************************************
        * Public Methods
        ************************************************************************/
@@ -202,6 +228,34 @@ namespace Qtk
         setRotation(QQuaternion::fromAxisAndAngle(ax, ay, az, angle));
       }
 
+      /**
+       * Attach this transform to a parent. The local state is kept, so the
+       * world position changes to be relative to the new parent.
+       *
+       * @param parent The new parent, or nullptr to make this a root.
+       * @return False if the parent is a descendant of this transform.
+       */
+      bool setParent(Transform3D * parent);
+
+      /**
+       * Save the current state as the previous simulation step.
+       * `toMatrix()` blends from this state to the current state using the
+       * global interpolation factor. Called by Scene before each fixed step.
+       * Transforms that did not move since the last step keep their cached
+       * matrix and world revision.
+       */
+      void storePrevious();
+
+      /**
+       * @param alpha Blend factor between the previous and current state used
+       *    by `toMatrix()` for every transform, in the range [0, 1]. The value
+       *    is kept per thread.
+       */
+      inline static void setInterpolation(float alpha)
+      {
+        sInterpolation = alpha;
+      }
+
       /*************************************************************************
        * Getters
        ************************************************************************/
@@ -228,11 +282,56 @@ namespace Qtk
       }
 
       /**
-       * @return Model to world matrix for this transform.
-       *    transformation * rotation * scale = ModelToWorld
+       * @return Model to world matrix for this transform, interpolated
+       *    between the previous and current state if `storePrevious()` was
+       *    called. parent * transformation * rotation * scale = ModelToWorld
        */
       const QMatrix4x4 & toMatrix();
 
+      /**
+       * @return The parent of this transform, or nullptr for a root.
+       */
+      [[nodiscard]] inline Transform3D * getParent() const { return mParent; }
+
+      [[nodiscard]] inline const std::vector<Transform3D *> & getChildren()
+          const
+      {
+        return mChildren;
+      }
+
+      /**
+       * @return Counter incremented each time this transform's world matrix
+       *    is recomputed. Compare against a previous value to know if the
+       *    matrix returned by `toMatrix()` changed.
+       */
+      [[nodiscard]] inline uint64_t getWorldRevision() const
+      {
+        return mWorldRevision;
+      }
+
+      /**
+       * @return Number of world matrices recomputed by `toMatrix()` on the
+       *    calling thread.
+       */
+      [[nodiscard]] inline static uint64_t getMatrixUpdates()
+      {
+        return sMatrixUpdates;
+      }
+
+      /**
+       * @return Counter incremented each time any transform is modified.
+       *    Compare against a previous value to know if anything moved.
+       */
+      [[nodiscard]] inline static uint64_t getRevision() { return sRevision; }
+
+      /**
+       * @return Blend factor between previous and current state.
+       */
+      [[nodiscard]] inline static float getInterpolation()
+      {
+        return sInterpolation;
+      }
+
       /**
        * @return Forward vector for this transform.
        */
@@ -255,14 +354,47 @@ namespace Qtk
       static const QVector3D LocalForward, LocalUp, LocalRight;
 
     private:
+      /*************************************************************************
+       * Private Methods
+       ************************************************************************/
+
+      inline void markDirty()
+      {
+        m_dirty = true;
+        mInterpolating = mHasPrevious;
+        ++sRevision;
+      }
+
       /*************************************************************************
        * Private Members
        ************************************************************************/
 
+      static std::atomic<uint64_t> sRevision;
+      static thread_local float sInterpolation;
+      static thread_local uint64_t sMatrixUpdates;
+
+      Transform3D * mParent {};
+      std::vector<Transform3D *> mChildren {};
+      /* Parent's world revision when mWorld was computed. */
+      uint64_t mParentRevision = 0;
+      uint64_t mWorldRevision = 0;
+
       QVector3D mTranslation;
       QQuaternion mRotation;
       QVector3D mScale;
+      /* Cached local matrix, and the parent's world matrix times it. */
+      QMatrix4x4 mLocal;
       QMatrix4x4 mWorld;
+      /* State saved by storePrevious(), used for interpolation. */
+      QVector3D mPreviousTranslation;
+      QQuaternion mPreviousRotation;
+      QVector3D mPreviousScale;
+      bool mHasPrevious = false;
+      /* False while the previous state equals the current state, so the
+       * matrix does not depend on the interpolation factor. */
+      bool mInterpolating = false;
+      /* Interpolation factor mWorld was computed with. */
+      float mWorldInterpolation = 1.0f;
 
       bool m_dirty;
 
@@ -284,6 +416,8 @@ namespace Qtk
 #endif
 }  // namespace Qtk
 
-Q_DECLARE_TYPEINFO(Qtk::Transform3D, Q_MOVABLE_TYPE);
+// Parents and children point at each other, so transforms can't be moved
+// with memcpy.
+Q_DECLARE_TYPEINFO(Qtk::Transform3D, Q_COMPLEX_TYPE);
 
 #endif  // QTK_TRANSFORM3D_H
@@ -0,0 +1,521 @@
+/*##############################################################################
+## Author: Shaun Reed                                                         ##
+## Legal: All Content (c) 2025 Shaun Reed, all rights reserved                ##
+## About: Contiguous store of transforms updated in batches                   ##
+##                                                                            ##
+## Contact: shaunrd0@gmail.com  | URL: www.shaunreed.com | GitHub: shaunrd0   ##
+##############################################################################*/
+
+#include <QSemaphore>
+#include <QThreadPool>
+
+#include <algorithm>
+#include <cstring>
+
+#include "transformstore.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define QTK_TRANSFORM_X86
+#include <immintrin.h>
+#define QTK_TARGET(isa) __attribute__((target(isa)))
+#endif
+
+using namespace Qtk;
+
+/**
+ * Raw pointers into the store's arrays, shared by every kernel.
+ */
+struct SoaView {
+    const float *tx, *ty, *tz;
+    const float *qx, *qy, *qz, *qw;
+    const float *sx, *sy, *sz;
+    const uint8_t * dirty;
+    float * world;
+    float * normal;
+};
+
+/**
+ * Write the local world and normal matrices of one transform.
+ */
+static void composeOne(const SoaView & v, size_t i)
+{
+  const float x2 = v.qx[i] + v.qx[i], y2 = v.qy[i] + v.qy[i],
+              z2 = v.qz[i] + v.qz[i];
+  const float xx = v.qx[i] * x2, yy = v.qy[i] * y2, zz = v.qz[i] * z2;
+  const float xy = v.qx[i] * y2, xz = v.qx[i] * z2, yz = v.qy[i] * z2;
+  const float wx = v.qw[i] * x2, wy = v.qw[i] * y2, wz = v.qw[i] * z2;
+  // Rotation matrix columns.
+  const float r[9] = {1.0f - (yy + zz),
+                      xy + wz,
+                      xz - wy,
+                      xy - wz,
+                      1.0f - (xx + zz),
+                      yz + wx,
+                      xz + wy,
+                      yz - wx,
+                      1.0f - (xx + yy)};
+  const float s[3] = {v.sx[i], v.sy[i], v.sz[i]};
+
+  float * m = v.world + i * 16;
+  float * n = v.normal + i * 9;
+  for (int c = 0; c < 3; c++) {
+    // (R * S)^-T = R * S^-1 since R is orthonormal.
+    const float inverse = s[c] != 0.0f ? 1.0f / s[c] : 0.0f;
+    for (int row = 0; row < 3; row++) {
+      m[c * 4 + row] = r[c * 3 + row] * s[c];
+      n[c * 3 + row] = r[c * 3 + row] * inverse;
+    }
+    m[c * 4 + 3] = 0.0f;
+  }
+  m[12] = v.tx[i];
+  m[13] = v.ty[i];
+  m[14] = v.tz[i];
+  m[15] = 1.0f;
+}
+
+static void updateScalar(const SoaView & v, size_t first, size_t last)
+{
+  for (size_t i = first; i < last; i++) {
+    if (v.dirty[i] != 0) {
+      composeOne(v, i);
+    }
+  }
+}
+
+#ifdef QTK_TRANSFORM_X86
+
+QTK_TARGET("sse2")
+static void updateSse(const SoaView & v, size_t first, size_t last)
+{
+  size_t i = first;
+  for (; i + 4 <= last; i += 4) {
+    uint32_t dirty;
+    std::memcpy(&dirty, v.dirty + i, sizeof(dirty));
+    if (dirty == 0) {
+      continue;
+    }
+
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 qx = _mm_loadu_ps(v.qx + i), qy = _mm_loadu_ps(v.qy + i),
+                 qz = _mm_loadu_ps(v.qz + i), qw = _mm_loadu_ps(v.qw + i);
+    const __m128 x2 = _mm_add_ps(qx, qx), y2 = _mm_add_ps(qy, qy),
+                 z2 = _mm_add_ps(qz, qz);
+    const __m128 xx = _mm_mul_ps(qx, x2), yy = _mm_mul_ps(qy, y2),
+                 zz = _mm_mul_ps(qz, z2);
+    const __m128 xy = _mm_mul_ps(qx, y2), xz = _mm_mul_ps(qx, z2),
+                 yz = _mm_mul_ps(qy, z2);
+    const __m128 wx = _mm_mul_ps(qw, x2), wy = _mm_mul_ps(qw, y2),
+                 wz = _mm_mul_ps(qw, z2);
+    const __m128 r[9] = {_mm_sub_ps(one, _mm_add_ps(yy, zz)),
+                         _mm_add_ps(xy, wz),
+                         _mm_sub_ps(xz, wy),
+                         _mm_sub_ps(xy, wz),
+                         _mm_sub_ps(one, _mm_add_ps(xx, zz)),
+                         _mm_add_ps(yz, wx),
+                         _mm_add_ps(xz, wy),
+                         _mm_sub_ps(yz, wx),
+                         _mm_sub_ps(one, _mm_add_ps(xx, yy))};
+    const __m128 s[3] = {_mm_loadu_ps(v.sx + i),
+                         _mm_loadu_ps(v.sy + i),
+                         _mm_loadu_ps(v.sz + i)};
+
+    // Columns of each lane's matrix, one vector per element.
+    __m128 m[16], n[9];
+    for (int c = 0; c < 3; c++) {
+      const __m128 zero = _mm_setzero_ps();
+      const __m128 valid = _mm_cmpneq_ps(s[c], zero);
+      const __m128 inverse = _mm_and_ps(_mm_div_ps(one, s[c]), valid);
+      for (int row = 0; row < 3; row++) {
+        m[c * 4 + row] = _mm_mul_ps(r[c * 3 + row], s[c]);
+        n[c * 3 + row] = _mm_mul_ps(r[c * 3 + row], inverse);
+      }
+      m[c * 4 + 3] = zero;
+    }
+    m[12] = _mm_loadu_ps(v.tx + i);
+    m[13] = _mm_loadu_ps(v.ty + i);
+    m[14] = _mm_loadu_ps(v.tz + i);
+    m[15] = one;
+
+    // Transpose so each vector holds four consecutive floats of one lane.
+    for (int c = 0; c < 4; c++) {
+      _MM_TRANSPOSE4_PS(m[c * 4], m[c * 4 + 1], m[c * 4 + 2], m[c * 4 + 3]);
+    }
+    _MM_TRANSPOSE4_PS(n[0], n[1], n[2], n[3]);
+    _MM_TRANSPOSE4_PS(n[4], n[5], n[6], n[7]);
+    alignas(16) float n8[4];
+    _mm_store_ps(n8, n[8]);
+
+    for (int lane = 0; lane < 4; lane++) {
+      if (v.dirty[i + lane] == 0) {
+        continue;
+      }
+      float * world = v.world + (i + lane) * 16;
+      for (int c = 0; c < 4; c++) {
+        _mm_storeu_ps(world + c * 4, m[c * 4 + lane]);
+      }
+      float * normal = v.normal + (i + lane) * 9;
+      _mm_storeu_ps(normal, n[lane]);
+      _mm_storeu_ps(normal + 4, n[4 + lane]);
+      normal[8] = n8[lane];
+    }
+  }
+  updateScalar(v, i, last);
+}
+
+QTK_TARGET("avx")
+static void updateAvx(const SoaView & v, size_t first, size_t last)
+{
+  size_t i = first;
+  for (; i + 8 <= last; i += 8) {
+    uint64_t dirty;
+    std::memcpy(&dirty, v.dirty + i, sizeof(dirty));
+    if (dirty == 0) {
+      continue;
+    }
+
+    const __m256 one = _mm256_set1_ps(1.0f);
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 qx = _mm256_loadu_ps(v.qx + i), qy = _mm256_loadu_ps(v.qy + i),
+                 qz = _mm256_loadu_ps(v.qz + i), qw = _mm256_loadu_ps(v.qw + i);
+    const __m256 x2 = _mm256_add_ps(qx, qx), y2 = _mm256_add_ps(qy, qy),
+                 z2 = _mm256_add_ps(qz, qz);
+    const __m256 xx = _mm256_mul_ps(qx, x2), yy = _mm256_mul_ps(qy, y2),
+                 zz = _mm256_mul_ps(qz, z2);
+    const __m256 xy = _mm256_mul_ps(qx, y2), xz = _mm256_mul_ps(qx, z2),
+                 yz = _mm256_mul_ps(qy, z2);
+    const __m256 wx = _mm256_mul_ps(qw, x2), wy = _mm256_mul_ps(qw, y2),
+                 wz = _mm256_mul_ps(qw, z2);
+    const __m256 r[9] = {_mm256_sub_ps(one, _mm256_add_ps(yy, zz)),
+                         _mm256_add_ps(xy, wz),
+                         _mm256_sub_ps(xz, wy),
+                         _mm256_sub_ps(xy, wz),
+                         _mm256_sub_ps(one, _mm256_add_ps(xx, zz)),
+                         _mm256_add_ps(yz, wx),
+                         _mm256_add_ps(xz, wy),
+                         _mm256_sub_ps(yz, wx),
+                         _mm256_sub_ps(one, _mm256_add_ps(xx, yy))};
+    const __m256 s[3] = {_mm256_loadu_ps(v.sx + i),
+                         _mm256_loadu_ps(v.sy + i),
+                         _mm256_loadu_ps(v.sz + i)};
+
+    // One row per matrix element, one column per lane.
+    alignas(32) float m[16][8], n[9][8];
+    for (int c = 0; c < 3; c++) {
+      const __m256 valid = _mm256_cmp_ps(s[c], zero, _CMP_NEQ_OQ);
+      const __m256 inverse = _mm256_and_ps(_mm256_div_ps(one, s[c]), valid);
+      for (int row = 0; row < 3; row++) {
+        _mm256_store_ps(m[c * 4 + row], _mm256_mul_ps(r[c * 3 + row], s[c]));
+        _mm256_store_ps(n[c * 3 + row],
+                        _mm256_mul_ps(r[c * 3 + row], inverse));
+      }
+      _mm256_store_ps(m[c * 4 + 3], zero);
+    }
+    _mm256_store_ps(m[12], _mm256_loadu_ps(v.tx + i));
+    _mm256_store_ps(m[13], _mm256_loadu_ps(v.ty + i));
+    _mm256_store_ps(m[14], _mm256_loadu_ps(v.tz + i));
+    _mm256_store_ps(m[15], one);
+
+    for (int lane = 0; lane < 8; lane++) {
+      if (v.dirty[i + lane] == 0) {
+        continue;
+      }
+      float * world = v.world + (i + lane) * 16;
+      for (int e = 0; e < 16; e++) {
+        world[e] = m[e][lane];
+      }
+      float * normal = v.normal + (i + lane) * 9;
+      for (int e = 0; e < 9; e++) {
+        normal[e] = n[e][lane];
+      }
+    }
+  }
+  updateScalar(v, i, last);
+}
+
+#endif  // QTK_TRANSFORM_X86
+
+/**
+ * out = a * b for column major 4x4 matrices. out may alias b.
+ */
+static void multiply4(const float * a, float * b)
+{
+  float out[16];
+  for (int c = 0; c < 4; c++) {
+    for (int row = 0; row < 4; row++) {
+      out[c * 4 + row] = a[row] * b[c * 4] + a[4 + row] * b[c * 4 + 1]
+                         + a[8 + row] * b[c * 4 + 2]
+                         + a[12 + row] * b[c * 4 + 3];
+    }
+  }
+  std::memcpy(b, out, sizeof(out));
+}
+
+/**
+ * out = a * b for column major 3x3 matrices. out may alias b.
+ */
+static void multiply3(const float * a, float * b)
+{
+  float out[9];
+  for (int c = 0; c < 3; c++) {
+    for (int row = 0; row < 3; row++) {
+      out[c * 3 + row] = a[row] * b[c * 3] + a[3 + row] * b[c * 3 + 1]
+                         + a[6 + row] * b[c * 3 + 2];
+    }
+  }
+  std::memcpy(b, out, sizeof(out));
+}
+
+/*******************************************************************************
+ * Public Methods
+ ******************************************************************************/
+
+TransformStore::Handle TransformStore::create(Handle parent)
+{
+  // Parents are updated before their children by keeping parent < child.
+  Handle handle;
+  if (!mFree.empty() && (parent == kInvalidHandle || mFree.back() > parent)) {
+    handle = mFree.back();
+    mFree.pop_back();
+  } else {
+    handle = static_cast<Handle>(mParent.size());
+    for (auto array : {&mTx, &mTy, &mTz, &mQx, &mQy, &mQz, &mSx, &mSy, &mSz}) {
+      array->push_back(0.0f);
+    }
+    mQw.push_back(1.0f);
+    mParent.push_back(kInvalidHandle);
+    mChildCount.push_back(0);
+    mDirty.push_back(0);
+    mWorld.resize(mWorld.size() + 16);
+    mNormal.resize(mNormal.size() + 9);
+  }
+
+  mTx[handle] = mTy[handle] = mTz[handle] = 0.0f;
+  mQx[handle] = mQy[handle] = mQz[handle] = 0.0f;
+  mQw[handle] = 1.0f;
+  mSx[handle] = mSy[handle] = mSz[handle] = 1.0f;
+  mParent[handle] = parent;
+  mChildCount[handle] = 0;
+  if (parent != kInvalidHandle) {
+    mHierarchy = true;
+    ++mChildCount[parent];
+  }
+  markDirty(handle);
+  return handle;
+}
+
+void TransformStore::destroy(Handle handle)
+{
+  // Children always follow their parent, and become roots like the children
+  // of a destroyed Transform3D.
+  if (mChildCount[handle] > 0) {
+    for (size_t i = size_t(handle) + 1; i < mParent.size(); i++) {
+      if (mParent[i] == handle) {
+        mParent[i] = kInvalidHandle;
+        markDirty(static_cast<Handle>(i));
+      }
+    }
+    mChildCount[handle] = 0;
+  }
+  if (mParent[handle] != kInvalidHandle) {
+    --mChildCount[mParent[handle]];
+  }
+  mParent[handle] = kInvalidHandle;
+  mDirty[handle] = 0;
+  mFree.push_back(handle);
+}
+
+void TransformStore::update()
+{
+  const size_t count = mParent.size();
+  if (count == 0) {
+    mUpdateCount = 0;
+    return;
+  }
+
+  // Parents come first, so one pass carries dirty flags down the hierarchy.
+  if (mHierarchy) {
+    for (size_t i = 0; i < count; i++) {
+      if (mParent[i] != kInvalidHandle && mDirty[mParent[i]] != 0) {
+        mDirty[i] = 1;
+      }
+    }
+  }
+
+  auto kernel = std::min(mKernel, getKernel());
+  const int threads = QThreadPool::globalInstance()->maxThreadCount();
+  if (count >= mThreadThreshold && threads > 1) {
+    // Keep chunks a multiple of the widest kernel so SIMD lanes never span
+    // two threads.
+    const size_t chunks = std::min<size_t>(threads, count / 1024 + 1);
+    const size_t chunk = ((count + chunks - 1) / chunks + 7) & ~size_t(7);
+    QSemaphore done;
+    int started = 0;
+    for (size_t first = chunk; first < count; first += chunk) {
+      const size_t last = std::min(first + chunk, count);
+      QThreadPool::globalInstance()->start([this, &done, first, last, kernel]() {
+        updateRange(first, last, kernel);
+        done.release();
+      });
+      ++started;
+    }
+    updateRange(0, std::min(chunk, count), kernel);
+    done.acquire(started);
+  } else {
+    updateRange(0, count, kernel);
+  }
+
+  if (mHierarchy) {
+    for (size_t i = 0; i < count; i++) {
+      if (mDirty[i] != 0 && mParent[i] != kInvalidHandle) {
+        multiply4(&mWorld[size_t(mParent[i]) * 16], &mWorld[i * 16]);
+        multiply3(&mNormal[size_t(mParent[i]) * 9], &mNormal[i * 9]);
+      }
+    }
+  }
+
+  mUpdateCount = std::count(mDirty.begin(), mDirty.end(), 1);
+  std::fill(mDirty.begin(), mDirty.end(), 0);
+}
+
+void TransformStore::compose(const QVector3D & t,
+                             const QQuaternion & r,
+                             const QVector3D & s,
+                             float * matrix)
+{
+  const float tx = t.x(), ty = t.y(), tz = t.z();
+  const float qx = r.x(), qy = r.y(), qz = r.z(), qw = r.scalar();
+  const float sx = s.x(), sy = s.y(), sz = s.z();
+  const uint8_t dirty = 1;
+  float normal[9];
+  const SoaView view {
+      &tx, &ty, &tz, &qx, &qy, &qz, &qw, &sx, &sy, &sz, &dirty, matrix, normal};
+  composeOne(view, 0);
+}
+
+/*******************************************************************************
+ * Accessors
+ ******************************************************************************/
+
+QVector3D TransformStore::getTranslation(Handle handle) const
+{
+  return {mTx[handle], mTy[handle], mTz[handle]};
+}
+
+QQuaternion TransformStore::getRotation(Handle handle) const
+{
+  return {mQw[handle], mQx[handle], mQy[handle], mQz[handle]};
+}
+
+QVector3D TransformStore::getScale(Handle handle) const
+{
+  return {mSx[handle], mSy[handle], mSz[handle]};
+}
+
+QMatrix4x4 TransformStore::getWorldMatrix(Handle handle) const
+{
+  QMatrix4x4 matrix;
+  std::memcpy(matrix.data(), getWorldData(handle), 16 * sizeof(float));
+  return matrix;
+}
+
+QMatrix3x3 TransformStore::getNormalMatrix(Handle handle) const
+{
+  QMatrix3x3 matrix;
+  std::memcpy(matrix.data(), getNormalData(handle), 9 * sizeof(float));
+  return matrix;
+}
+
+TransformStore::Kernel TransformStore::getKernel()
+{
+#ifdef QTK_TRANSFORM_X86
+  static const Kernel kernel = []() {
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx")) {
+      return QTK_KERNEL_AVX;
+    }
+    if (__builtin_cpu_supports("sse2")) {
+      return QTK_KERNEL_SSE;
+    }
+    return QTK_KERNEL_SCALAR;
+  }();
+  return kernel;
+#else
+  return QTK_KERNEL_SCALAR;
+#endif
+}
+
+const char * TransformStore::getKernelName(Kernel kernel)
+{
+  switch (kernel) {
+    case QTK_KERNEL_AVX:
+      return "AVX";
+    case QTK_KERNEL_SSE:
+      return "SSE";
+    default:
+      return "scalar";
+  }
+}
+
+/*******************************************************************************
+ * Setters
+ ******************************************************************************/
+
+void TransformStore::setTranslation(Handle handle, const QVector3D & t)
+{
+  mTx[handle] = t.x();
+  mTy[handle] = t.y();
+  mTz[handle] = t.z();
+  markDirty(handle);
+}
+
+void TransformStore::setRotation(Handle handle, const QQuaternion & r)
+{
+  auto normalized = r.normalized();
+  mQx[handle] = normalized.x();
+  mQy[handle] = normalized.y();
+  mQz[handle] = normalized.z();
+  mQw[handle] = normalized.scalar();
+  markDirty(handle);
+}
+
+void TransformStore::setScale(Handle handle, const QVector3D & s)
+{
+  mSx[handle] = s.x();
+  mSy[handle] = s.y();
+  mSz[handle] = s.z();
+  markDirty(handle);
+}
+
+/*******************************************************************************
+ * Private Methods
+ ******************************************************************************/
+
+void TransformStore::updateRange(size_t first, size_t last, Kernel kernel)
+{
+  const SoaView view {mTx.data(),
+                      mTy.data(),
+                      mTz.data(),
+                      mQx.data(),
+                      mQy.data(),
+                      mQz.data(),
+                      mQw.data(),
+                      mSx.data(),
+                      mSy.data(),
+                      mSz.data(),
+                      mDirty.data(),
+                      mWorld.data(),
+                      mNormal.data()};
+  switch (kernel) {
+#ifdef QTK_TRANSFORM_X86
+    case QTK_KERNEL_AVX:
+      updateAvx(view, first, last);
+      break;
+    case QTK_KERNEL_SSE:
+      updateSse(view, first, last);
+      break;
+#endif
+    default:
+      updateScalar(view, first, last);
+      break;
+  }
+}
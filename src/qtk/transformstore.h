@@ -0,0 +1,227 @@
+/*##############################################################################
+## Author: Shaun Reed                                                         ##
+## Legal: All Content (c) 2025 Shaun Reed, all rights reserved                ##
+## About: Contiguous store of transforms updated in batches                   ##
+##                                                                            ##
+## Contact: shaunrd0@gmail.com  | URL: www.shaunreed.com | GitHub: shaunrd0   ##
+##############################################################################*/
+
+#ifndef QTK_TRANSFORMSTORE_H
+#define QTK_TRANSFORMSTORE_H
+
+#include <QMatrix3x3>
+#include <QMatrix4x4>
+#include <QQuaternion>
+#include <QVector3D>
+
+#include <cstdint>
+#include <vector>
+
+#include "qtkapi.h"
+
+namespace Qtk
+{
+  /**
+   * Structure of arrays holding translation, rotation and scale for many
+   * transforms, with world and normal matrices computed in batches.
+   *
+   * Meant for scenes with many moving instances such as particles or crowds,
+   * where one Transform3D per object would scatter state across the heap.
+   * Setters only flag a transform dirty. `update()` then rebuilds the world
+   * and normal matrices of dirty transforms with SSE or AVX, picked at
+   * runtime with a scalar fallback, and splits the work across threads when
+   * there are many transforms.
+   *
+   * A transform may have a parent created before it. Its matrices are then
+   * relative to the parent, and it is updated when the parent is.
+   *
+   * Registry keeps entity transforms in a store, which the Scene updates in
+   * one batch each time a frame is captured. Scene Objects keep a
+   * Transform3D each and only share `compose()` with the store, since they
+   * do not fit a batch: they are moved before they join a scene, reparented
+   * at any time by Object::attachTo while the store needs parents created
+   * before children, read back within the step that moved them, and
+   * interpolated between fixed steps.
+   *
+   * The store is not thread safe; create, modify and update it on one
+   * thread.
+   */
+  class QTKAPI TransformStore
+  {
+    public:
+      /*************************************************************************
+       * Typedefs
+       ************************************************************************/
+
+      /** Index of a transform in the store. */
+      using Handle = uint32_t;
+      static constexpr Handle kInvalidHandle = ~Handle(0);
+
+      /** Instruction set used by the batch kernel. */
+      enum Kernel { QTK_KERNEL_SCALAR, QTK_KERNEL_SSE, QTK_KERNEL_AVX };
+
+      /*************************************************************************
+       * Public Methods
+       ************************************************************************/
+
+      /**
+       * Create an identity transform.
+       *
+       * @param parent Parent of the new transform, or kInvalidHandle.
+       * @return Handle to the new transform.
+       */
+      Handle create(Handle parent = kInvalidHandle);
+
+      /**
+       * Release a transform so its handle can be reused. Children of the
+       * transform become roots, keeping their local state.
+       *
+       * @param handle The transform to destroy.
+       */
+      void destroy(Handle handle);
+
+      /**
+       * Rebuild the world and normal matrices of every dirty transform, and
+       * of every transform whose parent was rebuilt.
+       */
+      void update();
+
+      /**
+       * Compose a column major model matrix from translation, rotation and
+       * scale. Used by `update()` for the scalar kernel and by Transform3D.
+       *
+       * @param t Translation.
+       * @param r Rotation; must be normalized.
+       * @param s Scale.
+       * @param matrix Receives 16 floats in column major order.
+       */
+      static void compose(const QVector3D & t,
+                          const QQuaternion & r,
+                          const QVector3D & s,
+                          float * matrix);
+
+      /*************************************************************************
+       * Accessors
+       ************************************************************************/
+
+      [[nodiscard]] QVector3D getTranslation(Handle handle) const;
+
+      [[nodiscard]] QQuaternion getRotation(Handle handle) const;
+
+      [[nodiscard]] QVector3D getScale(Handle handle) const;
+
+      [[nodiscard]] inline Handle getParent(Handle handle) const
+      {
+        return mParent[handle];
+      }
+
+      /**
+       * @return Column major world matrix as of the last `update()`.
+       */
+      [[nodiscard]] inline const float * getWorldData(Handle handle) const
+      {
+        return &mWorld[size_t(handle) * 16];
+      }
+
+      /**
+       * @return Column major inverse transpose of the world matrix's upper
+       *    3x3, used to transform normals, as of the last `update()`.
+       */
+      [[nodiscard]] inline const float * getNormalData(Handle handle) const
+      {
+        return &mNormal[size_t(handle) * 9];
+      }
+
+      [[nodiscard]] QMatrix4x4 getWorldMatrix(Handle handle) const;
+
+      [[nodiscard]] QMatrix3x3 getNormalMatrix(Handle handle) const;
+
+      /**
+       * @return Number of handles in use, including destroyed ones that have
+       *    not been reused yet.
+       */
+      [[nodiscard]] inline size_t getCapacity() const { return mParent.size(); }
+
+      /**
+       * @return Number of transforms rebuilt by the last `update()`.
+       */
+      [[nodiscard]] inline size_t getUpdateCount() const
+      {
+        return mUpdateCount;
+      }
+
+      /**
+       * @return The kernel `update()` uses on this CPU.
+       */
+      [[nodiscard]] static Kernel getKernel();
+
+      /**
+       * @return Human readable name of a kernel.
+       */
+      [[nodiscard]] static const char * getKernelName(Kernel kernel);
+
+      /*************************************************************************
+       * Setters
+       ************************************************************************/
+
+      void setTranslation(Handle handle, const QVector3D & t);
+
+      /**
+       * @param handle The transform to modify.
+       * @param r New rotation; normalized before it is stored.
+       */
+      void setRotation(Handle handle, const QQuaternion & r);
+
+      void setScale(Handle handle, const QVector3D & s);
+
+      /**
+       * Force a kernel, e.g. to compare against the scalar fallback. Kernels
+       * the CPU does not support fall back to the best supported one.
+       *
+       * @param kernel The kernel to use for this store.
+       */
+      inline void setKernel(Kernel kernel) { mKernel = kernel; }
+
+      /**
+       * @param count Transforms above which `update()` uses several threads.
+       */
+      inline void setThreadThreshold(size_t count) { mThreadThreshold = count; }
+
+    private:
+      /*************************************************************************
+       * Private Methods
+       ************************************************************************/
+
+      /**
+       * Rebuild matrices for dirty transforms in [first, last), relative to
+       * their parent. Called from worker threads on disjoint ranges.
+       */
+      void updateRange(size_t first, size_t last, Kernel kernel);
+
+      inline void markDirty(Handle handle) { mDirty[handle] = 1; }
+
+      /*************************************************************************
+       * Private Members
+       ************************************************************************/
+
+      /* Local state, one entry per handle. */
+      std::vector<float> mTx {}, mTy {}, mTz {};
+      std::vector<float> mQx {}, mQy {}, mQz {}, mQw {};
+      std::vector<float> mSx {}, mSy {}, mSz {};
+      std::vector<Handle> mParent {};
+      /* Number of live children of each handle. */
+      std::vector<uint32_t> mChildCount {};
+      std::vector<uint8_t> mDirty {};
+      /* 16 and 9 floats per handle, column major. */
+      std::vector<float> mWorld {}, mNormal {};
+
+      std::vector<Handle> mFree {};
+      /* True if any live transform has a parent. */
+      bool mHierarchy = false;
+      size_t mUpdateCount = 0;
+      Kernel mKernel = getKernel();
+      size_t mThreadThreshold = 16384;
+  };
+}  // namespace Qtk
+
+#endif  // QTK_TRANSFORMSTORE_H
@@ -0,0 +1,146 @@
+/*##############################################################################
+## Author: Shaun Reed                                                         ##
+## Legal: All Content (c) 2025 Shaun Reed, all rights reserved                ##
+## About: Vertex array object usable from every context in a share group      ##
+##                                                                            ##
+## Contact: shaunrd0@gmail.com  | URL: www.shaunreed.com | GitHub: shaunrd0   ##
+##############################################################################*/
+
+#include <QDebug>
+#include <QOpenGLExtraFunctions>
+
+#include <vector>
+
+#include "renderstats.h"
+#include "vertexarray.h"
+
+using namespace Qtk;
+
+/* VAOs destroyed while another context was current, waiting to be deleted
+ * by the context that owns them. */
+static QMutex sOrphansMutex;
+static std::unordered_map<QOpenGLContext *, std::vector<GLuint>> sOrphans;
+/* Number of VAOs in sOrphans, so frames with none skip the lock. */
+static std::atomic<size_t> sOrphanCount = 0;
+
+/**
+ * Queue a VAO to be deleted by `deleteOrphans()` in its context.
+ */
+static void orphan(QOpenGLContext * context, GLuint vao)
+{
+  QMutexLocker lock(&sOrphansMutex);
+  auto [it, inserted] = sOrphans.try_emplace(context);
+  if (inserted) {
+    // Names are deleted with the context, so forget them then.
+    QObject::connect(
+        context, &QOpenGLContext::aboutToBeDestroyed, [context]() {
+          QMutexLocker lock(&sOrphansMutex);
+          if (auto it = sOrphans.find(context); it != sOrphans.end()) {
+            sOrphanCount -= it->second.size();
+            sOrphans.erase(it);
+          }
+        });
+  }
+  it->second.push_back(vao);
+  ++sOrphanCount;
+}
+
+/*******************************************************************************
+ * Constructors / Destructors
+ ******************************************************************************/
+
+VertexArray::~VertexArray()
+{
+  destroy();
+}
+
+/*******************************************************************************
+ * Public Methods
+ ******************************************************************************/
+
+bool VertexArray::bind()
+{
+  auto context = QOpenGLContext::currentContext();
+  if (context == Q_NULLPTR) {
+    qDebug() << "[VertexArray] Attempt to bind without a current context.";
+    return false;
+  }
+  auto gl = context->extraFunctions();
+
+  GLuint vao = 0;
+  bool setup = false;
+  {
+    QMutexLocker lock(&mMutex);
+    bool created = false;
+    if (context != mLastContext) {
+      auto [it, inserted] = mArrays.try_emplace(context);
+      created = inserted;
+      if (created) {
+        gl->glGenVertexArrays(1, &it->second.mVAO);
+        // Emitted on the thread destroying the context, so lock here too.
+        it->second.mDestroyed = QObject::connect(
+            context, &QOpenGLContext::aboutToBeDestroyed, [this, context]() {
+              QMutexLocker lock(&mMutex);
+              mArrays.erase(context);
+              if (mLastContext == context) {
+                mLastContext = Q_NULLPTR;
+                mLastArray = Q_NULLPTR;
+              }
+            });
+      }
+      mLastContext = context;
+      mLastArray = &it->second;
+    }
+    auto & array = *mLastArray;
+    const auto revision = mRevision.load(std::memory_order_relaxed);
+    setup = created || array.mRevision != revision;
+    array.mRevision = revision;
+    vao = array.mVAO;
+  }
+  gl->glBindVertexArray(vao);
+  QTK_RENDER_STAT(mVaoBinds, 1);
+  return setup;
+}
+
+void VertexArray::release()
+{
+  if (auto context = QOpenGLContext::currentContext(); context != Q_NULLPTR) {
+    context->extraFunctions()->glBindVertexArray(0);
+  }
+}
+
+void VertexArray::destroy()
+{
+  auto current = QOpenGLContext::currentContext();
+  QMutexLocker lock(&mMutex);
+  for (auto & [context, array] : mArrays) {
+    QObject::disconnect(array.mDestroyed);
+    if (context == current) {
+      current->extraFunctions()->glDeleteVertexArrays(1, &array.mVAO);
+    } else {
+      orphan(context, array.mVAO);
+    }
+  }
+  mArrays.clear();
+  mLastContext = Q_NULLPTR;
+  mLastArray = Q_NULLPTR;
+}
+
+void VertexArray::deleteOrphans()
+{
+  if (sOrphanCount.load(std::memory_order_relaxed) == 0) {
+    return;
+  }
+  auto context = QOpenGLContext::currentContext();
+  if (context == Q_NULLPTR) {
+    return;
+  }
+  QMutexLocker lock(&sOrphansMutex);
+  auto it = sOrphans.find(context);
+  if (it != sOrphans.end() && !it->second.empty()) {
+    context->extraFunctions()->glDeleteVertexArrays(
+        static_cast<GLsizei>(it->second.size()), it->second.data());
+    sOrphanCount -= it->second.size();
+    it->second.clear();
+  }
+}
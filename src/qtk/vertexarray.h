@@ -0,0 +1,118 @@
+/*##############################################################################
+## Author: Shaun Reed                                                         ##
+## Legal: All Content (c) 2025 Shaun Reed, all rights reserved                ##
+## About: Vertex array object usable from every context in a share group      ##
+##                                                                            ##
+## Contact: shaunrd0@gmail.com  | URL: www.shaunreed.com | GitHub: shaunrd0   ##
+##############################################################################*/
+
+#ifndef QTK_VERTEXARRAY_H
+#define QTK_VERTEXARRAY_H
+
+#include <QMutex>
+#include <QOpenGLContext>
+
+#include <atomic>
+#include <unordered_map>
+
+#include "qtkapi.h"
+
+namespace Qtk
+{
+  /**
+   * Vertex array object that can be drawn from any context in a share group.
+   *
+   * Buffers, textures and shader programs are shared between contexts in a
+   * group but vertex array objects are not. This class keeps one VAO for each
+   * context that binds it. `bind()` reports when the VAO for the current
+   * context is new or out of date, and the caller then sets up attributes:
+   *
+   *    if (mVAO.bind()) {
+   *      bindBuffers();  // glVertexAttribPointer, element buffer, ...
+   *    }
+   *
+   * Call `invalidate()` when buffers move so each context sets up again.
+   * Call `deleteOrphans()` once per frame in each context, so VAOs destroyed
+   * from other contexts are deleted without a global lock on every bind.
+   *
+   * One VertexArray may be bound from several threads, each with its own
+   * context, so the VAOs of each context are guarded by a mutex per object.
+   */
+  class QTKAPI VertexArray
+  {
+    public:
+      /*************************************************************************
+       * Constructors / Destructors
+       ************************************************************************/
+
+      VertexArray() = default;
+
+      VertexArray(const VertexArray &) = delete;
+      VertexArray & operator=(const VertexArray &) = delete;
+
+      ~VertexArray();
+
+      /*************************************************************************
+       * Public Methods
+       ************************************************************************/
+
+      /**
+       * Bind the VAO for the current context, creating it if needed.
+       * Only locks this VertexArray, so it is uncontended unless the same
+       * object is drawn from two threads at once.
+       *
+       * @return True if attributes must be set up while the VAO is bound.
+       *    False if no context is current.
+       */
+      bool bind();
+
+      void release();
+
+      /**
+       * Require attributes to be set up again in every context.
+       */
+      inline void invalidate()
+      {
+        mRevision.fetch_add(1, std::memory_order_relaxed);
+      }
+
+      /**
+       * Delete the VAO for the current context. VAOs for other contexts are
+       * deleted by the next call to `deleteOrphans()` in that context.
+       */
+      void destroy();
+
+      /**
+       * Delete VAOs that were destroyed while the current context was not
+       * current. Called by Scene::draw once per frame.
+       */
+      static void deleteOrphans();
+
+    private:
+      /*************************************************************************
+       * Private Types
+       ************************************************************************/
+
+      struct ContextArray {
+          GLuint mVAO {};
+          /* Value of mRevision when attributes were last set up. */
+          uint64_t mRevision {};
+          QMetaObject::Connection mDestroyed {};
+      };
+
+      /*************************************************************************
+       * Private Members
+       ************************************************************************/
+
+      /* Guards mArrays and the last context cached below. */
+      QMutex mMutex;
+      std::unordered_map<QOpenGLContext *, ContextArray> mArrays {};
+      std::atomic<uint64_t> mRevision {0};
+      /* Last context bound and its entry in mArrays, skipping the lookup
+       * while the same context draws. Map entries are stable on insert. */
+      QOpenGLContext * mLastContext {};
+      ContextArray * mLastArray {};
+  };
+}  // namespace Qtk
+
+#endif  // QTK_VERTEXARRAY_H
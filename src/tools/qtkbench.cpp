@@ -0,0 +1,499 @@
+/*##############################################################################
+## Author: Shaun Reed                                                         ##
+## Legal: All Content (c) 2025 Shaun Reed, all rights reserved                ##
+## About: Command line tool to benchmark rendering of fixed scenes            ##
+##                                                                            ##
+## Contact: shaunrd0@gmail.com  | URL: www.shaunreed.com | GitHub: shaunrd0   ##
+##############################################################################*/
+
+#include <QColor>
+#include <QCommandLineParser>
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QGuiApplication>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+#include <algorithm>
+#include <cmath>
+
+#include "qtk/frametimes.h"
+#include "qtk/memorytracker.h"
+#include "qtk/offscreenrenderer.h"
+#include "qtk/scene.h"
+
+using namespace Qtk;
+
+struct BenchOptions {
+    QSize mSize;
+    int mSamples = 4;
+    /* Frames drawn before timing starts, to settle caches and uploads. */
+    int mWarmup = 30;
+    int mFrames = 300;
+    int mCubes = 1000;
+    int mModels = 16;
+    int mTextures = 64;
+    QString mModel;
+};
+
+/**
+ * Scene filled by one of the benchmark scenarios, with a camera that
+ * orbits the area the scenario placed objects in.
+ */
+class BenchScene : public Scene
+{
+  public:
+    typedef void (*Builder)(BenchScene & scene, const BenchOptions & options);
+
+    BenchScene(const char * name, Builder build, const BenchOptions & options) :
+        mBuild(build), mOptions(options)
+    {
+      setSceneName(name);
+    }
+
+    void init() override { mBuild(*this, mOptions); }
+
+    /**
+     * @param center Point the camera looks at.
+     * @param radius Distance of the camera from the center.
+     */
+    inline void setOrbit(const QVector3D & center, float radius)
+    {
+      mCenter = center;
+      mRadius = radius;
+    }
+
+    /**
+     * @return View for one frame of a full orbit over `frames` frames.
+     */
+    [[nodiscard]] QMatrix4x4 getFrameView(int frame, int frames) const
+    {
+      const float angle = 2.0f * float(M_PI) * float(frame) / frames;
+      const QVector3D direction(std::sin(angle), 0.35f, std::cos(angle));
+      QMatrix4x4 view;
+      view.lookAt(
+          mCenter + direction * mRadius, mCenter, QVector3D(0.0f, 1.0f, 0.0f));
+      return view;
+    }
+
+  private:
+    Builder mBuild;
+    const BenchOptions & mOptions;
+    QVector3D mCenter {};
+    float mRadius = 10.0f;
+};
+
+/*******************************************************************************
+ * Scenarios
+ ******************************************************************************/
+
+static const char * const kTextures[] = {
+    ":/textures/crate.png", ":/textures/stone.png", ":/textures/wood.png"};
+
+/**
+ * Place objects on a square grid in the XZ plane, centered on the origin.
+ *
+ * @return Position of the object at `index` of `count`.
+ */
+static QVector3D getGridPosition(int index, int count, float spacing)
+{
+  const int side = std::max(int(std::ceil(std::sqrt(float(count)))), 1);
+  const float offset = float(side - 1) / 2.0f;
+  return {(float(index % side) - offset) * spacing,
+          0.0f,
+          (float(index / side) - offset) * spacing};
+}
+
+/**
+ * @return Camera distance that keeps a grid of `count` objects in view.
+ */
+static float getGridRadius(int count, float spacing)
+{
+  return std::max(std::sqrt(float(count)) * spacing * 1.25f, 5.0f);
+}
+
+static MeshRenderer * addCube(BenchScene & scene,
+                              const QString & name,
+                              const QVector3D & position)
+{
+  auto cube = scene.addObject(new MeshRenderer(
+      name.toStdString().c_str(), Cube(QTK_DRAW_ELEMENTS)));
+  cube->getTransform().setTranslation(position);
+  return cube;
+}
+
+static MeshRenderer * addTexturedCube(BenchScene & scene,
+                                      const QString & name,
+                                      const QVector3D & position,
+                                      const char * texture)
+{
+  auto cube = scene.addObject(new MeshRenderer(name.toStdString().c_str(),
+                                               Cube(QTK_DRAW_ARRAYS)));
+  cube->getTransform().setTranslation(position);
+  cube->setShaders(":/shaders/texture2d.vert", ":/shaders/texture2d.frag");
+  // Each cube uploads its own copy of the texture.
+  cube->setTexture(texture);
+  cube->setUniform("uTexture", 0);
+  cube->reallocateTexCoords(cube->getTexCoords());
+  return cube;
+}
+
+static void addSkybox(BenchScene & scene)
+{
+  scene.setSkybox(new Skybox(":/textures/skybox/right.png",
+                             ":/textures/skybox/top.png",
+                             ":/textures/skybox/front.png",
+                             ":/textures/skybox/left.png",
+                             ":/textures/skybox/bottom.png",
+                             ":/textures/skybox/back.png",
+                             "Skybox"));
+}
+
+/** Colored cubes drawn with the default MeshRenderer shaders. */
+static void buildCubes(BenchScene & scene, const BenchOptions & options)
+{
+  const float spacing = 2.5f;
+  for (int i = 0; i < options.mCubes; i++) {
+    auto cube = addCube(scene,
+                        QString("cube %1").arg(i),
+                        getGridPosition(i, options.mCubes, spacing));
+    auto color = QColor::fromHsvF(float(i % 36) / 36.0f, 0.8f, 0.9f);
+    cube->setColor({color.redF(), color.greenF(), color.blueF()});
+  }
+  scene.setOrbit({}, getGridRadius(options.mCubes, spacing));
+}
+
+/** Copies of a model, each loaded separately. */
+static void buildModels(BenchScene & scene, const BenchOptions & options)
+{
+  const auto path = options.mModel.toStdString();
+  float spacing = 1.0f;
+  std::vector<Model *> models;
+  for (int i = 0; i < options.mModels; i++) {
+    auto name = QString("model %1").arg(i).toStdString();
+    models.push_back(scene.addObject(new Model(name.c_str(), path.c_str())));
+    const auto & bounds = models.back()->getBounds();
+    if (bounds.mValid) {
+      auto size = bounds.mMax - bounds.mMin;
+      spacing = std::max({spacing, size.x() + 1.0f, size.z() + 1.0f});
+    }
+  }
+  for (int i = 0; i < options.mModels; i++) {
+    models[i]->getTransform().setTranslation(
+        getGridPosition(i, options.mModels, spacing));
+  }
+  scene.setOrbit({}, getGridRadius(options.mModels, spacing));
+}
+
+/** Cubes that each upload their own texture. */
+static void buildTextures(BenchScene & scene, const BenchOptions & options)
+{
+  const float spacing = 2.5f;
+  for (int i = 0; i < options.mTextures; i++) {
+    addTexturedCube(scene,
+                    QString("textured cube %1").arg(i),
+                    getGridPosition(i, options.mTextures, spacing),
+                    kTextures[i % std::size(kTextures)]);
+  }
+  scene.setOrbit({}, getGridRadius(options.mTextures, spacing));
+}
+
+/** Only a skybox, to measure the fixed cost of a frame. */
+static void buildSkybox(BenchScene & scene, const BenchOptions &)
+{
+  addSkybox(scene);
+  scene.setOrbit({}, 5.0f);
+}
+
+/**
+ * A skybox, shaded and textured cubes and a model if one is found, like
+ * the example QtkScene.
+ */
+static void buildMixed(BenchScene & scene, const BenchOptions & options)
+{
+  addSkybox(scene);
+  const int count = 100;
+  const float spacing = 3.0f;
+  for (int i = 0; i < count; i++) {
+    auto name = QString("mixed %1").arg(i);
+    auto position = getGridPosition(i, count, spacing);
+    if (i % 4 == 0) {
+      addTexturedCube(scene, name, position, kTextures[i % 3]);
+    } else if (i % 4 == 1) {
+      auto cube = addCube(scene, name, position);
+      cube->setShaders(":/shaders/rgb-normals.vert",
+                       ":/shaders/rgb-normals.frag");
+      cube->reallocateNormals(cube->getNormals());
+    } else {
+      addCube(scene, name, position)->setColor({0.8f, 0.1f, 0.1f});
+    }
+  }
+  if (QFileInfo::exists(options.mModel)) {
+    auto model = scene.addObject(
+        new Model("mixed model", options.mModel.toStdString().c_str()));
+    model->getTransform().setTranslation(0.0f, spacing, 0.0f);
+  }
+  scene.setOrbit({}, getGridRadius(count, spacing));
+}
+
+struct Scenario {
+    const char * mName;
+    BenchScene::Builder mBuild;
+    /* Skipped if the model passed with --model does not exist. */
+    bool mNeedsModel = false;
+};
+
+static const Scenario kScenarios[] = {
+    {"cubes", buildCubes},
+    {"models", buildModels, true},
+    {"textures", buildTextures},
+    {"skybox", buildSkybox},
+    {"mixed", buildMixed},
+};
+
+/*******************************************************************************
+ * Benchmark
+ ******************************************************************************/
+
+/**
+ * @return Live bytes of each MemoryCategory, keyed by name.
+ */
+static QJsonObject getMemoryJson()
+{
+  auto & tracker = MemoryTracker::getInstance();
+  QJsonObject json;
+  for (size_t i = 0; i < QTK_MEMORY_CATEGORY_COUNT; i++) {
+    auto category = static_cast<MemoryCategory>(i);
+    json[MemoryTracker::getCategoryName(category)] =
+        qint64(tracker.getUsage(category).mLive);
+  }
+  json["Total"] = qint64(tracker.getTotal().mLive);
+  return json;
+}
+
+/**
+ * Draw a scenario for the warmup and timed frames, waiting for the GPU to
+ * finish each frame so the time covers all of its work.
+ *
+ * @return Results of the scenario, with an "error" if a frame failed.
+ */
+static QJsonObject runScenario(OffscreenRenderer & renderer,
+                               const Scenario & scenario,
+                               const BenchOptions & options)
+{
+  QJsonObject json;
+  json["name"] = scenario.mName;
+  if (scenario.mNeedsModel && !QFileInfo::exists(options.mModel)) {
+    qWarning() << "[qtk_bench] Skipping" << scenario.mName << "without model"
+               << options.mModel;
+    json["skipped"] = QString("Model not found: %1").arg(options.mModel);
+    return json;
+  }
+  qInfo() << "[qtk_bench] Running" << scenario.mName;
+
+  auto gl = renderer.getContext()->functions();
+  QMatrix4x4 projection;
+  projection.perspective(45.0f,
+                         float(options.mSize.width()) / options.mSize.height(),
+                         0.1f,
+                         1000.0f);
+
+  FrameTimes times;
+  RenderStats totals;
+  double totalMs = 0.0;
+  {
+    // The scene is created and deleted while the context is current.
+    BenchScene scene(scenario.mName, scenario.mBuild, options);
+    QElapsedTimer timer;
+    timer.start();
+    scene.initialize();
+    gl->glFinish();
+    json["loadMs"] = double(timer.nsecsElapsed()) / 1.0e6;
+    json["objects"] = qint64(scene.getObjects().size());
+
+    const int frames = options.mWarmup + options.mFrames;
+    for (int i = 0; i < frames; i++) {
+      // Advance the scene by a fixed step so every run draws the same frames.
+      scene.tick(1.0f / 60.0f);
+      timer.restart();
+      if (!renderer.render(&scene, scene.getFrameView(i, frames), projection)) {
+        json["error"] = QString("Failed to render frame %1").arg(i);
+        return json;
+      }
+      gl->glFinish();
+      const float ms = float(timer.nsecsElapsed()) / 1.0e6f;
+      const auto stats = scene.getFrameStats();
+      if (i < options.mWarmup) {
+        continue;
+      }
+
+      times.record(ms, -1.0f, 0);
+      totalMs += ms;
+      totals.mDrawCalls += stats.mDrawCalls;
+      totals.mTriangles += stats.mTriangles;
+      totals.mProgramBinds += stats.mProgramBinds;
+      totals.mTextureBinds += stats.mTextureBinds;
+      totals.mBufferBytes += stats.mBufferBytes;
+    }
+    // Memory is read while the scene is still alive.
+    json["memory"] = getMemoryJson();
+  }
+
+  const auto & cpu = times.getCpu();
+  const double frames = std::max(options.mFrames, 1);
+  json["msPerFrame"] = QJsonObject {
+      {"mean", totalMs / frames},
+      {"p50", cpu.getPercentile(50.0f)},
+      {"p95", cpu.getPercentile(95.0f)},
+      {"p99", cpu.getPercentile(99.0f)},
+      {"max", cpu.getMax()},
+  };
+  json["perFrame"] = QJsonObject {
+      {"drawCalls", double(totals.mDrawCalls) / frames},
+      {"triangles", double(totals.mTriangles) / frames},
+      {"programBinds", double(totals.mProgramBinds) / frames},
+      {"textureBinds", double(totals.mTextureBinds) / frames},
+      {"bufferBytes", double(totals.mBufferBytes) / frames},
+  };
+  return json;
+}
+
+int main(int argc, char * argv[])
+{
+  QGuiApplication app(argc, argv);
+  QCoreApplication::setApplicationName("qtk_bench");
+
+  QStringList names;
+  for (const auto & scenario : kScenarios) {
+    names << scenario.mName;
+  }
+
+  QCommandLineParser parser;
+  parser.setApplicationDescription(
+      "Render fixed scenes without a window and report frame times, draw "
+      "calls and memory as JSON.\n"
+      "Without a display server, run with QT_QPA_PLATFORM=offscreen. "
+      "Compare results from the same machine, such as Mesa llvmpipe with "
+      "LIBGL_ALWAYS_SOFTWARE=1.");
+  parser.addHelpOption();
+  QCommandLineOption scenarioOption(
+      "scenario",
+      QString("Scenario to run; may be repeated. One of: %1. "
+              "Runs all scenarios by default.")
+          .arg(names.join(", ")),
+      "name");
+  QCommandLineOption outputOption(
+      {"o", "output"}, "File to write JSON results to, or stdout.", "file");
+  QCommandLineOption framesOption(
+      {"n", "frames"}, "Number of timed frames per scenario.", "count", "300");
+  QCommandLineOption warmupOption(
+      "warmup", "Frames drawn before timing each scenario.", "count", "30");
+  QCommandLineOption sizeOption(
+      {"s", "size"}, "Size of each frame.", "WxH", "1280x720");
+  QCommandLineOption samplesOption(
+      "samples", "Number of samples used for multisampling.", "count", "4");
+  QCommandLineOption cubesOption(
+      "cubes", "Number of cubes in the cubes scenario.", "count", "1000");
+  QCommandLineOption modelsOption(
+      "models", "Number of models in the models scenario.", "count", "16");
+  QCommandLineOption texturesOption(
+      "textures",
+      "Number of textured cubes in the textures scenario.",
+      "count",
+      "64");
+  QCommandLineOption modelOption(
+      "model",
+      "Model loaded by the models and mixed scenarios.",
+      "file",
+      "resources/models/spartan/spartan.obj");
+  parser.addOptions({scenarioOption,
+                     outputOption,
+                     framesOption,
+                     warmupOption,
+                     sizeOption,
+                     samplesOption,
+                     cubesOption,
+                     modelsOption,
+                     texturesOption,
+                     modelOption});
+  parser.process(app);
+
+  BenchOptions options;
+  auto size = parser.value(sizeOption).split('x');
+  options.mSize = QSize(size.value(0).toInt(), size.value(1).toInt());
+  if (options.mSize.isEmpty()) {
+    qWarning() << "[qtk_bench] Invalid size" << parser.value(sizeOption);
+    return 1;
+  }
+  options.mSamples = std::max(parser.value(samplesOption).toInt(), 0);
+  options.mWarmup = std::max(parser.value(warmupOption).toInt(), 0);
+  options.mFrames = std::max(parser.value(framesOption).toInt(), 1);
+  options.mCubes = std::max(parser.value(cubesOption).toInt(), 1);
+  options.mModels = std::max(parser.value(modelsOption).toInt(), 1);
+  options.mTextures = std::max(parser.value(texturesOption).toInt(), 1);
+  options.mModel = parser.value(modelOption);
+
+  auto selected = parser.values(scenarioOption);
+  for (const auto & name : selected) {
+    if (!names.contains(name)) {
+      qWarning() << "[qtk_bench] Unknown scenario" << name;
+      return 1;
+    }
+  }
+
+  OffscreenRenderer renderer(options.mSize, options.mSamples);
+  if (!renderer.isValid() || !renderer.makeCurrent()) {
+    qWarning() << "[qtk_bench] Failed to create an OpenGL context.";
+    return 1;
+  }
+
+  auto gl = renderer.getContext()->functions();
+  QJsonObject json;
+  json["date"] = QDateTime::currentDateTime().toString(Qt::ISODate);
+  json["renderer"] =
+      reinterpret_cast<const char *>(gl->glGetString(GL_RENDERER));
+  json["version"] = reinterpret_cast<const char *>(gl->glGetString(GL_VERSION));
+  json["size"] = parser.value(sizeOption);
+  json["samples"] = options.mSamples;
+  json["frames"] = options.mFrames;
+  json["warmup"] = options.mWarmup;
+#ifdef QTK_RENDER_STATS
+  json["renderStats"] = true;
+#else
+  // Per frame counters are zero without render stats.
+  json["renderStats"] = false;
+#endif
+
+  bool failed = false;
+  QJsonArray results;
+  for (const auto & scenario : kScenarios) {
+    if (!selected.isEmpty() && !selected.contains(scenario.mName)) {
+      continue;
+    }
+    auto result = runScenario(renderer, scenario, options);
+    failed |= result.contains("error");
+    results.append(result);
+  }
+  json["scenarios"] = results;
+  renderer.doneCurrent();
+
+  auto data = QJsonDocument(json).toJson();
+  QFile file;
+  if (parser.isSet(outputOption)) {
+    file.setFileName(parser.value(outputOption));
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+      qWarning() << "[qtk_bench] Failed to open" << file.fileName();
+      return 1;
+    }
+  } else if (!file.open(stdout, QIODevice::WriteOnly)) {
+    return 1;
+  }
+  if (file.write(data) != data.size()) {
+    qWarning() << "[qtk_bench] Failed to write results.";
+    return 1;
+  }
+  return failed ? 1 : 0;
+}
@@ -0,0 +1,325 @@
+/*##############################################################################
+## Author: Shaun Reed                                                         ##
+## Legal: All Content (c) 2025 Shaun Reed, all rights reserved                ##
+## About: Command line tool to render models without a display               ##
+##                                                                            ##
+## Contact: shaunrd0@gmail.com  | URL: www.shaunreed.com | GitHub: shaunrd0   ##
+##############################################################################*/
+
+#include <QCommandLineParser>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QGuiApplication>
+#include <QTextStream>
+#include <QThread>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <memory>
+
+#include "qtk/offscreenrenderer.h"
+#include "qtk/scene.h"
+#include "qtk/tracer.h"
+
+using namespace Qtk;
+
+/**
+ * Scene with each model passed on the command line placed side by side.
+ */
+class ModelListScene : public Scene
+{
+  public:
+    explicit ModelListScene(QStringList paths) : mPaths(std::move(paths))
+    {
+      setSceneName("Render Scene");
+    }
+
+    void init() override
+    {
+      float offset = 0.0f;
+      for (const auto & path : mPaths) {
+        auto name = QFileInfo(path).baseName().toStdString();
+        auto model = addObject(
+            new Model(name.c_str(), path.toStdString().c_str()));
+        const auto & bounds = model->getBounds();
+        if (!bounds.mValid) {
+          continue;
+        }
+        // Line models up along the X axis, centered on the origin in Z.
+        const QVector3D translation(offset - bounds.mMin.x(),
+                                    0.0f,
+                                    -bounds.getCenter().z());
+        model->getTransform().setTranslation(translation);
+        offset += bounds.mMax.x() - bounds.mMin.x() + 1.0f;
+        mBounds.expand(bounds.mMin + translation);
+        mBounds.expand(bounds.mMax + translation);
+      }
+    }
+
+    /**
+     * @return World space bounds of all models in the scene.
+     */
+    [[nodiscard]] inline const BoundingBox & getSceneBounds() const
+    {
+      return mBounds;
+    }
+
+  private:
+    QStringList mPaths;
+    BoundingBox mBounds {};
+};
+
+/** Camera position and the point it looks at. */
+struct CameraKey {
+    QVector3D mPosition, mTarget;
+};
+
+struct RenderOptions {
+    QStringList mModels;
+    QString mOutput;
+    QSize mSize;
+    int mFrames = 1;
+    /* If set, one frame is rendered for each camera. */
+    std::vector<CameraKey> mPath;
+    bool mRaw = false;
+};
+
+/**
+ * @return View for a frame; cameras from the path, or an orbit of the scene.
+ */
+static QMatrix4x4 getFrameView(const RenderOptions & options,
+                               const ModelListScene & scene,
+                               int frame)
+{
+  CameraKey camera;
+  if (!options.mPath.empty()) {
+    camera = options.mPath[frame];
+  } else {
+    const auto & bounds = scene.getSceneBounds();
+    const float radius =
+        bounds.mValid ? std::max((bounds.mMax - bounds.mMin).length(), 1.0f)
+                      : 10.0f;
+    const float angle = 2.0f * float(M_PI) * float(frame) / options.mFrames;
+    camera.mTarget = bounds.getCenter();
+    camera.mPosition =
+        camera.mTarget
+        + QVector3D(std::sin(angle), 0.35f, std::cos(angle)) * radius * 1.5f;
+  }
+
+  QMatrix4x4 view;
+  view.lookAt(camera.mPosition, camera.mTarget, QVector3D(0.0f, 1.0f, 0.0f));
+  return view;
+}
+
+/**
+ * Render every `step` frames starting at `first`, writing each to disk.
+ * Runs on a worker thread that owns the renderer's context.
+ *
+ * @return True if all frames were written.
+ */
+static bool renderFrames(OffscreenRenderer & renderer,
+                         const RenderOptions & options,
+                         int first,
+                         int step)
+{
+  if (!renderer.makeCurrent()) {
+    return false;
+  }
+
+  bool written = true;
+  {
+    // The scene is created and deleted while this context is current.
+    ModelListScene scene(options.mModels);
+    scene.initialize();
+    QMatrix4x4 projection;
+    projection.perspective(45.0f,
+                           float(options.mSize.width()) / options.mSize.height(),
+                           0.1f,
+                           1000.0f);
+
+    std::vector<uchar> pixels;
+    for (int i = first; i < options.mFrames && written; i += step) {
+      if (!renderer.render(&scene, getFrameView(options, scene, i), projection)) {
+        written = false;
+        break;
+      }
+
+      auto path = QDir(options.mOutput)
+                      .filePath(QString("frame_%1.%2")
+                                    .arg(i, 4, 10, QChar('0'))
+                                    .arg(options.mRaw ? "rgba" : "png"));
+      if (options.mRaw) {
+        renderer.readPixels(pixels);
+        QFile file(path);
+        written = file.open(QIODevice::WriteOnly)
+                  && file.write(reinterpret_cast<const char *>(pixels.data()),
+                                qint64(pixels.size()))
+                         == qint64(pixels.size());
+      } else {
+        written = renderer.toImage().save(path);
+      }
+
+      if (written) {
+        qInfo() << "[qtk_render] Wrote" << path;
+      } else {
+        qWarning() << "[qtk_render] Failed to write" << path;
+      }
+    }
+  }
+  renderer.doneCurrent();
+  return written;
+}
+
+/**
+ * Read a camera path with one camera per line: 'x y z targetX targetY
+ * targetZ'. Empty lines and lines starting with '#' are skipped.
+ */
+static bool readCameraPath(const QString & fileName,
+                           std::vector<CameraKey> & path)
+{
+  QFile file(fileName);
+  if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+    qWarning() << "[qtk_render] Failed to open camera path" << fileName;
+    return false;
+  }
+
+  QTextStream in(&file);
+  for (int line = 1; !in.atEnd(); line++) {
+    auto text = in.readLine().trimmed();
+    if (text.isEmpty() || text.startsWith('#')) {
+      continue;
+    }
+    auto values = text.split(' ', Qt::SkipEmptyParts);
+    if (values.size() != 6) {
+      qWarning() << "[qtk_render] Expected 6 values on line" << line << "of"
+                 << fileName;
+      return false;
+    }
+    float v[6];
+    for (int i = 0; i < 6; i++) {
+      v[i] = values[i].toFloat();
+    }
+    path.push_back({{v[0], v[1], v[2]}, {v[3], v[4], v[5]}});
+  }
+  return true;
+}
+
+int main(int argc, char * argv[])
+{
+  QGuiApplication app(argc, argv);
+  QCoreApplication::setApplicationName("qtk_render");
+
+  QCommandLineParser parser;
+  parser.setApplicationDescription(
+      "Render models to images without a window.\n"
+      "Without a display server, run with QT_QPA_PLATFORM=offscreen.");
+  parser.addHelpOption();
+  parser.addPositionalArgument(
+      "models", "Model files to load into the scene.", "<model>...");
+  QCommandLineOption outputOption(
+      {"o", "output"}, "Directory to write frames to.", "dir", ".");
+  QCommandLineOption framesOption(
+      {"n", "frames"},
+      "Number of frames to render while orbiting the scene.",
+      "count",
+      "1");
+  QCommandLineOption pathOption(
+      {"p", "camera-path"},
+      "File with one camera per line: 'x y z targetX targetY targetZ'. "
+      "One frame is rendered for each camera.",
+      "file");
+  QCommandLineOption sizeOption(
+      {"s", "size"}, "Size of each frame.", "WxH", "1280x720");
+  QCommandLineOption jobsOption(
+      {"j", "jobs"},
+      "Number of OpenGL contexts rendering frames in parallel.",
+      "count",
+      "1");
+  QCommandLineOption rawOption(
+      "raw", "Write raw RGBA8 buffers, bottom row first, instead of PNGs.");
+  QCommandLineOption traceOption(
+      "trace",
+      "Write a Chrome trace of model loading and rendering on every thread, "
+      "which opens in Perfetto.",
+      "file");
+  parser.addOptions({outputOption,
+                     framesOption,
+                     pathOption,
+                     sizeOption,
+                     jobsOption,
+                     rawOption,
+                     traceOption});
+  parser.process(app);
+
+  RenderOptions options;
+  options.mModels = parser.positionalArguments();
+  if (options.mModels.isEmpty()) {
+    parser.showHelp(1);
+  }
+  options.mOutput = parser.value(outputOption);
+  options.mRaw = parser.isSet(rawOption);
+
+  auto size = parser.value(sizeOption).split('x');
+  options.mSize = QSize(size.value(0).toInt(), size.value(1).toInt());
+  if (options.mSize.isEmpty()) {
+    qWarning() << "[qtk_render] Invalid size" << parser.value(sizeOption);
+    return 1;
+  }
+
+  if (parser.isSet(pathOption)) {
+    if (!readCameraPath(parser.value(pathOption), options.mPath)) {
+      return 1;
+    }
+    options.mFrames = static_cast<int>(options.mPath.size());
+  } else {
+    options.mFrames = std::max(parser.value(framesOption).toInt(), 1);
+  }
+
+  if (!QDir().mkpath(options.mOutput)) {
+    qWarning() << "[qtk_render] Failed to create" << options.mOutput;
+    return 1;
+  }
+
+  if (parser.isSet(traceOption)) {
+    Tracer::getInstance().start();
+  }
+
+  // Each job renders every Nth frame with its own context and scene.
+  const int jobs =
+      std::clamp(parser.value(jobsOption).toInt(), 1, options.mFrames);
+  std::vector<std::unique_ptr<OffscreenRenderer>> renderers;
+  std::vector<QThread *> threads;
+  std::atomic<int> failures = 0;
+  for (int job = 0; job < jobs; job++) {
+    // Renderers are created on the GUI thread and handed to their worker.
+    auto renderer = std::make_unique<OffscreenRenderer>(options.mSize);
+    if (!renderer->isValid()) {
+      qWarning() << "[qtk_render] Failed to create an OpenGL context.";
+      return 1;
+    }
+
+    auto thread = QThread::create([&, job, r = renderer.get()]() {
+      QThread::currentThread()->setObjectName(QString("Render %1").arg(job));
+      if (!renderFrames(*r, options, job, jobs)) {
+        ++failures;
+      }
+      r->moveToThread(app.thread());
+    });
+    renderer->moveToThread(thread);
+    renderers.push_back(std::move(renderer));
+    threads.push_back(thread);
+    thread->start();
+  }
+
+  for (auto & thread : threads) {
+    thread->wait();
+    delete thread;
+  }
+  if (parser.isSet(traceOption)
+      && !Tracer::getInstance().stop(parser.value(traceOption))) {
+    ++failures;
+  }
+  return failures == 0 ? 0 : 1;
+}